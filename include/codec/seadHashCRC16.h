@@ -34,15 +34,12 @@ public:
         return calcStringHashWithContext(ctx, str.cstr());
     }
 
-    static void initialize();
+    // Tables are generated at compile time, kept for compatibility
+    static void initialize() {}
 
 private:
-    static const u32 cTableSize = 256;
     static const u16 cTableMask = 0xA001;
     static const u16 cContext = 0x0;
-
-    static u16 sTable[256];
-    static bool sInitialized;
 };
 
 } // namespace sead
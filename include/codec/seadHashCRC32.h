@@ -34,15 +34,12 @@ public:
         return calcStringHashWithContext(ctx, str.cstr());
     }
 
-    static void initialize();
+    // Tables are generated at compile time, kept for compatibility
+    static void initialize() {}
 
 private:
-    static const u32 cTableSize = 256;
     static const u32 cTableMask = 0xEDB88320;
     static const u32 cContext = 0xFFFFFFFF;
-
-    static u32 sTable[cTableSize];
-    static bool sInitialized;
 };
 
 } // namespace sead
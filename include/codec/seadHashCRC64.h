@@ -34,15 +34,12 @@ public:
         return calcStringHashWithContext(ctx, str.cstr());
     }
 
-    static void initialize();
+    // Tables are generated at compile time, kept for compatibility
+    static void initialize() {}
 
 private:
-    static const u32 cTableSize = 256;
     static const u64 cTableMask = 0xC96C5795D7870F42;
     static const u64 cContext = 0xFFFFFFFFFFFFFFFF;
-
-    static u64 sTable[256];
-    static bool sInitialized;
 };
 
 } // namespace sead
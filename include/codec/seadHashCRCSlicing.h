@@ -0,0 +1,92 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+
+#include <bit>
+#include <cstring>
+
+namespace sead {
+
+// Slicing-by-8 kernel shared by the reflected HashCRC variants.
+// The tables are generated at compile time, update() takes and returns the raw register without the final xor.
+template <typename T, T Poly>
+class HashCRCSlicing8
+{
+public:
+    static T update(T r, const void* dataptr, size_t datasize)
+    {
+        const u8* data = static_cast<const u8*>(dataptr);
+
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            while (datasize >= 8)
+            {
+                u64 v;
+                std::memcpy(&v, data, sizeof(v));
+                v ^= r;
+
+                r = static_cast<T>(cTable.t[7][v & 0xFF] ^
+                                   cTable.t[6][(v >> 8) & 0xFF] ^
+                                   cTable.t[5][(v >> 16) & 0xFF] ^
+                                   cTable.t[4][(v >> 24) & 0xFF] ^
+                                   cTable.t[3][(v >> 32) & 0xFF] ^
+                                   cTable.t[2][(v >> 40) & 0xFF] ^
+                                   cTable.t[1][(v >> 48) & 0xFF] ^
+                                   cTable.t[0][v >> 56]);
+
+                data += 8;
+                datasize -= 8;
+            }
+        }
+
+        for (size_t i = 0; i < datasize; i++)
+        {
+            r = static_cast<T>((r >> 8) ^ cTable.t[0][(r ^ data[i]) & 0xFF]);
+        }
+
+        return r;
+    }
+
+    static T updateString(T r, const char* str)
+    {
+        return update(r, str, std::strlen(str));
+    }
+
+private:
+    struct Table
+    {
+        T t[8][256];
+    };
+
+    static constexpr Table makeTable_()
+    {
+        Table table = {};
+
+        for (u32 i = 0; i < 256; i++)
+        {
+            T r = static_cast<T>(i);
+            for (u32 j = 0; j < 8; j++)
+            {
+                r = (r & 1) ? static_cast<T>((r >> 1) ^ Poly) : static_cast<T>(r >> 1);
+            }
+
+            table.t[0][i] = r;
+        }
+
+        // t[n][i] is the register after byte i followed by n zero bytes
+        for (u32 n = 1; n < 8; n++)
+        {
+            for (u32 i = 0; i < 256; i++)
+            {
+                T prev = table.t[n - 1][i];
+                table.t[n][i] = static_cast<T>((prev >> 8) ^ table.t[0][prev & 0xFF]);
+            }
+        }
+
+        return table;
+    }
+
+    static constexpr Table cTable = makeTable_();
+};
+
+} // namespace sead
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <basis/seadNew.h>
+#include <codec/seadHashCRC32.h>
+#include <container/seadFreeList.h>
+#include <prim/seadSafeString.h>
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+namespace sead {
+
+template <typename Key>
+struct HashMapKeyTraits
+{
+    using KeyType = Key;
+    using ArgType = Key;
+
+    static u32 calcHash(const Key& key)
+    {
+        if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>)
+        {
+            u64 x;
+            if constexpr (std::is_pointer_v<Key>)
+                x = reinterpret_cast<uintptr_t>(key);
+            else
+                x = static_cast<u64>(key);
+
+            // Finalizer of MurmurHash3, spreads close integers over the whole table
+            x ^= x >> 33;
+            x *= 0xFF51AFD7ED558CCDull;
+            x ^= x >> 33;
+            x *= 0xC4CEB9FE1A85EC53ull;
+            x ^= x >> 33;
+
+            return static_cast<u32>(x);
+        }
+        else
+        {
+            // Other keys are hashed as raw bytes, so they must not contain padding
+            return HashCRC32::calcHash(&key, sizeof(Key));
+        }
+    }
+
+    static bool isEqual(const KeyType& key, const ArgType& arg)
+    {
+        return key == arg;
+    }
+
+    static void construct(KeyType* key, const ArgType& arg)
+    {
+        new(key) KeyType(arg);
+    }
+
+    static const Key& getArg(const KeyType& key)
+    {
+        return key;
+    }
+};
+
+// Keys are copied into the node, longer ones are cut off at KeyStrN characters
+template <s32 KeyStrN>
+struct HashMapStrKeyTraits
+{
+    struct KeyType
+    {
+        char str[KeyStrN + 1];
+    };
+
+    using ArgType = SafeString;
+
+    static u32 calcHash(const SafeString& arg)
+    {
+        s32 length = arg.calcLength();
+        if (length > KeyStrN)
+            length = KeyStrN;
+
+        return HashCRC32::calcHash(arg.cstr(), static_cast<u32>(length));
+    }
+
+    static bool isEqual(const KeyType& key, const SafeString& arg)
+    {
+        return std::strncmp(key.str, arg.cstr(), KeyStrN) == 0;
+    }
+
+    static void construct(KeyType* key, const SafeString& arg)
+    {
+        BufferedSafeString buf(key->str, KeyStrN + 1);
+        buf.cutOffCopy(arg);
+    }
+
+    static SafeString getArg(const KeyType& key)
+    {
+        return SafeString(key.str);
+    }
+};
+
+// Open addressing with robin hood probing and backward shift deletion.
+// Nodes live in a fixed pool like TreeMap, so pointers returned by insert stay valid until erased.
+// The probe table only holds hash and node index pairs, keys are compared only when the hashes match.
+template <typename Traits, typename Value>
+class HashMapImpl
+{
+    SEAD_NO_COPY(HashMapImpl);
+
+public:
+    using KeyType = typename Traits::KeyType;
+    using ArgType = typename Traits::ArgType;
+
+    struct alignas(cPtrSize) Node
+    {
+        KeyType key;
+        Value value;
+    };
+
+protected:
+    struct Slot
+    {
+        u32 hash;
+        s32 index;
+    };
+
+    static const u32 cEmptyHash = 0;
+
+public:
+    HashMapImpl()
+        : mFreeList()
+        , mNodes(nullptr)
+        , mSlots(nullptr)
+        , mSlotMask(0)
+        , mSize(0)
+        , mNodeMax(0)
+    {
+    }
+
+    ~HashMapImpl()
+    {
+        clear();
+    }
+
+    static constexpr size_t calcBufferSize(s32 nodeMax)
+    {
+        return nodeMax * sizeof(Node) + calcSlotNum_(nodeMax) * sizeof(Slot);
+    }
+
+    void allocBuffer(s32 nodeMax, s32 alignment = cDefaultAlignment)
+    {
+        if (!tryAllocBuffer(nodeMax, alignment))
+        {
+            AllocFailAssert(nullptr, calcBufferSize(nodeMax), alignment);
+        }
+    }
+
+    void allocBuffer(s32 nodeMax, Heap* heap, s32 alignment = cDefaultAlignment)
+    {
+        if (!tryAllocBuffer(nodeMax, heap, alignment))
+        {
+            AllocFailAssert(heap, calcBufferSize(nodeMax), alignment);
+        }
+    }
+
+    bool tryAllocBuffer(s32 nodeMax, s32 alignment = cDefaultAlignment)
+    {
+        SEAD_ASSERT(mFreeList.work() == nullptr);
+
+        if (nodeMax <= 0)
+        {
+            SEAD_ASSERT_MSG(false, "nodeMax[%d] must be larger than zero", nodeMax);
+            return false;
+        }
+
+        void* buf = new(alignment, std::nothrow) u8[calcBufferSize(nodeMax)];
+        if (!buf)
+        {
+            return false;
+        }
+
+        setBuffer(nodeMax, buf);
+        return true;
+    }
+
+    bool tryAllocBuffer(s32 nodeMax, Heap* heap, s32 alignment = cDefaultAlignment)
+    {
+        SEAD_ASSERT(mFreeList.work() == nullptr);
+
+        if (nodeMax <= 0)
+        {
+            SEAD_ASSERT_MSG(false, "nodeMax[%d] must be larger than zero", nodeMax);
+            return false;
+        }
+
+        void* buf = new(heap, alignment, std::nothrow) u8[calcBufferSize(nodeMax)];
+        if (!buf)
+        {
+            return false;
+        }
+
+        setBuffer(nodeMax, buf);
+        return true;
+    }
+
+    void freeBuffer()
+    {
+        if (isBufferReady())
+        {
+            clear();
+
+            delete[] static_cast<u8*>(mFreeList.work());
+
+            mNodes = nullptr;
+            mSlots = nullptr;
+            mSlotMask = 0;
+            mNodeMax = 0;
+            mFreeList.cleanup();
+        }
+    }
+
+    // buf must be at least calcBufferSize(nodeMax) bytes
+    void setBuffer(s32 nodeMax, void* buf)
+    {
+        if (nodeMax <= 0)
+        {
+            SEAD_ASSERT_MSG(false, "nodeMax[%d] must be larger than zero", nodeMax);
+            return;
+        }
+
+        if (!buf)
+        {
+            SEAD_ASSERT_MSG(false, "buf is null");
+            return;
+        }
+
+        mNodeMax = nodeMax;
+        mNodes = static_cast<Node*>(buf);
+        mSlots = reinterpret_cast<Slot*>(mNodes + nodeMax);
+        mSlotMask = calcSlotNum_(nodeMax) - 1;
+
+        for (u32 i = 0; i <= mSlotMask; i++)
+        {
+            mSlots[i].hash = cEmptyHash;
+        }
+
+        mFreeList.init(buf, sizeof(Node), nodeMax);
+    }
+
+    bool isBufferReady() const { return mFreeList.work() != nullptr; }
+    bool isEmpty() const { return mSize == 0; }
+    bool isFull() const { return mSize >= mNodeMax; }
+
+    s32 size() const { return mSize; }
+    s32 getSize() const { return mSize; }
+    s32 maxSize() const { return mNodeMax; }
+
+    Value* find(const ArgType& key) const
+    {
+        s32 slot = findSlot_(key, calcHash_(key));
+        if (slot < 0)
+        {
+            return nullptr;
+        }
+
+        return &mNodes[mSlots[slot].index].value;
+    }
+
+    bool contains(const ArgType& key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    Value* insert(const ArgType& key)
+    {
+        Node* node = insertNode_(key);
+        if (!node)
+        {
+            return nullptr;
+        }
+
+        new(&node->value) Value();
+        return &node->value;
+    }
+
+    Value* insert(const ArgType& key, const Value& value)
+    {
+        Node* node = insertNode_(key);
+        if (!node)
+        {
+            return nullptr;
+        }
+
+        new(&node->value) Value(value);
+        return &node->value;
+    }
+
+    bool erase(const ArgType& key)
+    {
+        s32 slot = findSlot_(key, calcHash_(key));
+        if (slot < 0)
+        {
+            return false;
+        }
+
+        Node* node = &mNodes[mSlots[slot].index];
+        destroyNode_(node);
+        mFreeList.put(node);
+        mSize--;
+
+        // Pull back the following entries until one is at its home slot
+        u32 index = static_cast<u32>(slot);
+        for (;;)
+        {
+            u32 next = (index + 1) & mSlotMask;
+            if (mSlots[next].hash == cEmptyHash || calcProbeLength_(mSlots[next].hash, next) == 0)
+            {
+                break;
+            }
+
+            mSlots[index] = mSlots[next];
+            index = next;
+        }
+
+        mSlots[index].hash = cEmptyHash;
+        return true;
+    }
+
+    void clear()
+    {
+        if (!isBufferReady())
+        {
+            return;
+        }
+
+        for (u32 i = 0; i <= mSlotMask; i++)
+        {
+            if (mSlots[i].hash != cEmptyHash)
+            {
+                destroyNode_(&mNodes[mSlots[i].index]);
+                mSlots[i].hash = cEmptyHash;
+            }
+        }
+
+        mSize = 0;
+        mFreeList.init(mNodes, sizeof(Node), mNodeMax);
+    }
+
+    template <typename T>
+    void forEach(const T& fun) const
+    {
+        for (u32 i = 0; i <= mSlotMask; i++)
+        {
+            if (mSlots[i].hash != cEmptyHash)
+            {
+                Node* node = &mNodes[mSlots[i].index];
+                fun(Traits::getArg(node->key), node->value);
+            }
+        }
+    }
+
+protected:
+    static constexpr u32 calcSlotNum_(s32 nodeMax)
+    {
+        // Keeps the load factor at 80% or less
+        return std::bit_ceil(static_cast<u32>(nodeMax) + static_cast<u32>(nodeMax) / 4 + 1);
+    }
+
+    static u32 calcHash_(const ArgType& key)
+    {
+        u32 hash = Traits::calcHash(key);
+        return hash != cEmptyHash ? hash : 1;
+    }
+
+    u32 calcProbeLength_(u32 hash, u32 index) const
+    {
+        return (index - hash) & mSlotMask;
+    }
+
+    s32 findSlot_(const ArgType& key, u32 hash) const
+    {
+        if (mSize == 0)
+        {
+            return -1;
+        }
+
+        u32 index = hash & mSlotMask;
+        for (u32 length = 0;; length++)
+        {
+            const Slot& slot = mSlots[index];
+
+            // A richer entry means the key would have been placed before it
+            if (slot.hash == cEmptyHash || calcProbeLength_(slot.hash, index) < length)
+            {
+                return -1;
+            }
+
+            if (slot.hash == hash && Traits::isEqual(mNodes[slot.index].key, key))
+            {
+                return static_cast<s32>(index);
+            }
+
+            index = (index + 1) & mSlotMask;
+        }
+    }
+
+    // Returns a node with the key constructed and the value left for the caller to construct
+    Node* insertNode_(const ArgType& key)
+    {
+        u32 hash = calcHash_(key);
+
+        s32 found = findSlot_(key, hash);
+        if (found >= 0)
+        {
+            Node* node = &mNodes[mSlots[found].index];
+            node->value.~Value();
+            return node;
+        }
+
+        if (isFull())
+        {
+            SEAD_ASSERT_MSG(false, "map is full.");
+            return nullptr;
+        }
+
+        Node* node = static_cast<Node*>(mFreeList.get());
+        Traits::construct(&node->key, key);
+        mSize++;
+
+        Slot entry;
+        entry.hash = hash;
+        entry.index = static_cast<s32>(node - mNodes);
+
+        u32 index = hash & mSlotMask;
+        for (u32 length = 0;; length++)
+        {
+            Slot& slot = mSlots[index];
+            if (slot.hash == cEmptyHash)
+            {
+                slot = entry;
+                break;
+            }
+
+            // Take the place of entries closer to their home slot and carry them on
+            u32 slotLength = calcProbeLength_(slot.hash, index);
+            if (slotLength < length)
+            {
+                Slot tmp = slot;
+                slot = entry;
+                entry = tmp;
+                length = slotLength;
+            }
+
+            index = (index + 1) & mSlotMask;
+        }
+
+        return node;
+    }
+
+    static void destroyNode_(Node* node)
+    {
+        node->value.~Value();
+        node->key.~KeyType();
+    }
+
+protected:
+    FreeList mFreeList;
+    Node* mNodes;
+    Slot* mSlots;
+    u32 mSlotMask;
+    s32 mSize;
+    s32 mNodeMax;
+};
+
+template <typename Key, typename Value>
+class HashMap : public HashMapImpl<HashMapKeyTraits<Key>, Value>
+{
+public:
+    HashMap()
+        : HashMapImpl<HashMapKeyTraits<Key>, Value>()
+    {
+    }
+};
+
+template <typename Key, typename Value, s32 N>
+class FixedHashMap : public HashMap<Key, Value>
+{
+public:
+    FixedHashMap()
+        : HashMap<Key, Value>()
+    {
+        HashMap<Key, Value>::setBuffer(N, mWork);
+    }
+
+    void allocBuffer(s32 nodeMax, s32 alignment = cDefaultAlignment) = delete;
+    void allocBuffer(s32 nodeMax, Heap* heap, s32 alignment = cDefaultAlignment) = delete;
+    bool tryAllocBuffer(s32 nodeMax, s32 alignment = cDefaultAlignment) = delete;
+    bool tryAllocBuffer(s32 nodeMax, Heap* heap, s32 alignment = cDefaultAlignment) = delete;
+    void freeBuffer() = delete;
+    void setBuffer(s32 nodeMax, void* buf) = delete;
+
+protected:
+    alignas(typename HashMap<Key, Value>::Node) u8 mWork[HashMap<Key, Value>::calcBufferSize(N)];
+};
+
+template <s32 KeyStrN, typename Value>
+class StrHashMap : public HashMapImpl<HashMapStrKeyTraits<KeyStrN>, Value>
+{
+public:
+    StrHashMap()
+        : HashMapImpl<HashMapStrKeyTraits<KeyStrN>, Value>()
+    {
+    }
+};
+
+template <s32 KeyStrN, typename Value, s32 N>
+class FixedStrHashMap : public StrHashMap<KeyStrN, Value>
+{
+public:
+    FixedStrHashMap()
+        : StrHashMap<KeyStrN, Value>()
+    {
+        StrHashMap<KeyStrN, Value>::setBuffer(N, mWork);
+    }
+
+    void allocBuffer(s32 nodeMax, s32 alignment = cDefaultAlignment) = delete;
+    void allocBuffer(s32 nodeMax, Heap* heap, s32 alignment = cDefaultAlignment) = delete;
+    bool tryAllocBuffer(s32 nodeMax, s32 alignment = cDefaultAlignment) = delete;
+    bool tryAllocBuffer(s32 nodeMax, Heap* heap, s32 alignment = cDefaultAlignment) = delete;
+    void freeBuffer() = delete;
+    void setBuffer(s32 nodeMax, void* buf) = delete;
+
+protected:
+    alignas(typename StrHashMap<KeyStrN, Value>::Node) u8 mWork[StrHashMap<KeyStrN, Value>::calcBufferSize(N)];
+};
+
+} // namespace sead
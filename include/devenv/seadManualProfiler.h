@@ -1 +1,177 @@
-// TODO
\ No newline at end of file
+#pragma once
+
+#include <container/seadPtrArray.h>
+#include <devenv/seadStackTrace.h>
+#include <heap/seadDisposer.h>
+#include <heap/seadHeapMgr.h>
+#include <prim/seadDelegate.h>
+#include <prim/seadSafeString.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadCriticalSection.h>
+
+namespace sead {
+
+class WriteStream;
+
+// Allocation profiler fed by the callbacks of HeapMgr, so it only records in builds with SEAD_TARGET_DEBUG.
+// Allocations are sampled by size: roughly one allocation every getSampleInterval() bytes is recorded with its call stack
+// and stands in for the bytes allocated since the previous sample, the counts are exact only with an interval of zero.
+// Sampled allocations still alive when their heap is destroyed are reported as leaks.
+// Every table is allocated by initialize(), recording never allocates.
+class ManualProfiler
+{
+    SEAD_SINGLETON_DISPOSER(ManualProfiler);
+
+public:
+    struct Stats
+    {
+        u64 allocNum;
+        u64 allocSize;
+        u64 liveNum;
+        u64 liveSize;
+        u64 peakLiveSize;
+        u64 leakNum;
+        u64 leakSize;
+    };
+
+    struct CallSite
+    {
+        StackTrace stackTrace;
+        u32 hash;
+        s32 heapIndex;
+        Stats stats;
+    };
+
+    struct HeapEntry
+    {
+        // Null once the heap is destroyed
+        Heap* heap;
+        FixedSafeString<32> name;
+        Stats stats;
+    };
+
+    enum class EventType : u8
+    {
+        eAlloc = 0,
+        eFree,
+        eLeak
+    };
+
+    // One sampled allocation or free in the trace
+    struct Event
+    {
+        u64 tick;
+        u64 address;
+        u64 size;
+        s32 callSiteIndex;
+        u16 heapIndex;
+        EventType type;
+    };
+
+    static const size_t cDefaultSampleInterval = 256 * 1024;
+    static const s32 cDefaultStackSkipNum = 2;
+    static const u32 cTraceSignature = 0x53505246; // SPRF
+    static const u32 cTraceVersion = 1;
+
+public:
+    ManualProfiler();
+    ~ManualProfiler();
+
+    // heap is where the tables live, the current heap when null
+    void initialize(s32 callSiteNumMax, s32 liveAllocNumMax, s32 heapNumMax, s32 eventNumMax, Heap* heap = nullptr);
+
+    void start();
+    void stop();
+    bool isRunning() const { return mIsRunning; }
+    void clear();
+
+    void setSampleInterval(size_t interval) { mSampleInterval = interval; }
+    size_t getSampleInterval() const { return mSampleInterval; }
+
+    // Frames between the allocating code and the callback, such as the heap and operator new, to leave out of the call sites
+    void setStackSkipNum(s32 num) { mStackSkipNum = num; }
+    s32 getStackSkipNum() const { return mStackSkipNum; }
+
+    s32 getCallSiteNum() const { return mCallSiteNum; }
+    const CallSite& getCallSite(s32 idx) const;
+    s32 getHeapNum() const { return mHeapNum; }
+    const HeapEntry& getHeapEntry(s32 idx) const;
+    // Samples that did not fit in a table
+    u32 getDroppedNum() const { return mDroppedNum; }
+
+    void reportLeaks(s32 heapIndex) const;
+    // Summary of the heaps and of the callSiteNumMax call sites with the most bytes allocated
+    void dumpYAML(WriteStream& stream, s32 indent, s32 callSiteNumMax = 32);
+    // Compact binary trace of the heaps, call sites and the latest events for tools to symbolize offline
+    void writeTrace(WriteStream& stream);
+
+protected:
+    struct LiveAlloc
+    {
+        const void* ptr;
+        u64 size;
+        s32 callSiteIndex;
+        u32 numWeight;
+        u64 sizeWeight;
+    };
+
+    using AllocCallback = Delegate1<ManualProfiler, const HeapMgr::AllocCallbackArg*>;
+    using FreeCallback = Delegate1<ManualProfiler, const HeapMgr::FreeCallbackArg*>;
+    using DestroyCallback = Delegate1<ManualProfiler, const HeapMgr::DestroyCallbackArg*>;
+
+    void onAlloc_(const HeapMgr::AllocCallbackArg* arg);
+    void onFree_(const HeapMgr::FreeCallbackArg* arg);
+    void onDestroy_(const HeapMgr::DestroyCallbackArg* arg);
+
+    s32 findHeap_(const Heap* heap) const;
+    s32 findOrAddHeap_(Heap* heap);
+    s32 findOrAddCallSite_(const StackTrace& stackTrace, s32 heapIndex);
+    void addLiveAlloc_(const void* ptr, u64 size, s32 callSiteIndex, u32 numWeight, u64 sizeWeight);
+    bool removeLiveAlloc_(const void* ptr, LiveAlloc* removed);
+    void removeLiveAllocAt_(s32 slot);
+    void releaseLiveAlloc_(const LiveAlloc& alloc, EventType type);
+    void pushEvent_(EventType type, const void* ptr, u64 size, s32 callSiteIndex);
+
+    u32 getLiveAllocSlot_(const void* ptr) const;
+
+protected:
+    mutable CriticalSection mCS;
+    bool mIsRunning;
+    size_t mSampleInterval;
+    s32 mStackSkipNum;
+    AtomicBase64<s64> mBytesUntilSample;
+    u32 mDroppedNum;
+
+    CallSite* mCallSites;
+    s32 mCallSiteNum;
+    s32 mCallSiteNumMax;
+    // Open addressing on the stack hash, -1 when empty
+    s32* mCallSiteSlots;
+    u32 mCallSiteSlotMask;
+    PtrArray<CallSite> mSortedCallSites;
+
+    // Open addressing on the address with linear probing, ptr is null when empty
+    LiveAlloc* mLiveAllocs;
+    s32 mLiveAllocNum;
+    s32 mLiveAllocNumMax;
+    u32 mLiveAllocSlotMask;
+
+    HeapEntry* mHeaps;
+    s32 mHeapNum;
+    s32 mHeapNumMax;
+
+    // Ring buffer
+    Event* mEvents;
+    s32 mEventNumMax;
+    s32 mEventHead;
+    s32 mEventNum;
+
+    AllocCallback mAllocCallback;
+    FreeCallback mFreeCallback;
+    DestroyCallback mDestroyCallback;
+    IDelegate1<const HeapMgr::AllocCallbackArg*>* mPrevAllocCallback;
+    IDelegate1<const HeapMgr::FreeCallbackArg*>* mPrevFreeCallback;
+    IDelegate1<const HeapMgr::DestroyCallbackArg*>* mPrevDestroyCallback;
+};
+
+} // namespace sead
@@ -1 +1,47 @@
-// TODO
\ No newline at end of file
+#pragma once
+
+#include <basis/seadAssert.h>
+#include <basis/seadTypes.h>
+#include <prim/seadSafeString.h>
+
+namespace sead {
+
+// Return addresses of the calling thread, innermost frame first
+class StackTrace
+{
+public:
+    static const s32 cDepthMax = 16;
+    static const s32 cSkipNumMax = 16;
+
+public:
+    StackTrace()
+        : mDepth(0)
+    {
+    }
+
+    // skipNum frames above the caller of capture() are left out, the caller itself included
+    s32 capture(s32 skipNum = 0);
+    void clear() { mDepth = 0; }
+
+    s32 getDepth() const { return mDepth; }
+
+    uintptr_t getAddress(s32 idx) const
+    {
+        SEAD_ASSERT(0 <= idx && idx < mDepth);
+        return mAddresses[idx];
+    }
+
+    u32 calcHash() const;
+    bool isEqual(const StackTrace& other) const;
+
+    // Function name with the offset into it where the platform can tell (Windows needs the pdb next to the module),
+    // the module with the offset into it or the bare address otherwise
+    void getSymbolName(BufferedSafeString* name, s32 idx) const;
+    void print() const;
+
+private:
+    uintptr_t mAddresses[cDepthMax];
+    s32 mDepth;
+};
+
+} // namespace sead
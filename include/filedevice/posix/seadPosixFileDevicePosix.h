@@ -40,16 +40,19 @@ protected:
         return true;
     }
 
+    u8* doLoad_(LoadArg& arg) override;
+    void doUnmap_(u8* data, u32 size) override;
     FileDevice* doOpen_(FileHandle* handle, const SafeString& filename, FileOpenFlag flag) override;
     bool doClose_(FileHandle* handle) override;
     bool doFlush_(FileHandle* handle) override;
     bool doRemove_(const SafeString& path) override;
     bool doRead_(u32* readSize, FileHandle* handle, u8* buf, u32 size) override;
+    bool doReadAt_(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset) override;
     bool doWrite_(u32* writeSize, FileHandle* handle, const u8* buf, u32 size) override;
-    bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin) override;
-    bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle) override;
-    bool doGetFileSize_(u32* size, const SafeString& path) override;
-    bool doGetFileSize_(u32* size, FileHandle* handle) override;
+    bool doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin) override;
+    bool doGetCurrentSeekPos_(u64* pos, FileHandle* handle) override;
+    bool doGetFileSize_(u64* size, const SafeString& path) override;
+    bool doGetFileSize_(u64* size, FileHandle* handle) override;
     bool doIsExistFile_(bool* isExist, const SafeString& path) override;
     bool doIsExistDirectory_(bool* isExist, const SafeString& path) override;
     FileDevice* doOpenDirectory_(DirectoryHandle* handle, const SafeString& dirname) override;
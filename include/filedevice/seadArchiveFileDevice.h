@@ -0,0 +1,61 @@
+#pragma once
+
+#include <filedevice/seadFileDevice.h>
+
+namespace sead {
+
+class ArchiveRes;
+
+// Read only device over the files of an ArchiveRes.
+// Loads hand out pointers into the archive data instead of copies when the caller does not provide a buffer, the
+// archive has to outlive every file loaded from it.
+class ArchiveFileDevice : public FileDevice
+{
+    SEAD_RTTI_OVERRIDE(ArchiveFileDevice, FileDevice);
+
+public:
+    explicit ArchiveFileDevice(ArchiveRes* archive);
+    ~ArchiveFileDevice() override;
+
+    void setArchive(ArchiveRes* archive)
+    {
+        mArchive = archive;
+    }
+
+    ArchiveRes* getArchive() const
+    {
+        return mArchive;
+    }
+
+protected:
+    bool doIsAvailable_() const override;
+    u8* doLoad_(LoadArg& arg) override;
+    FileDevice* doOpen_(FileHandle* handle, const SafeString& filename, FileOpenFlag flag) override;
+    bool doClose_(FileHandle* handle) override;
+    bool doFlush_(FileHandle* handle) override;
+    bool doRemove_(const SafeString& path) override;
+    bool doRead_(u32* readSize, FileHandle* handle, u8* buf, u32 size) override;
+    bool doWrite_(u32* writeSize, FileHandle* handle, const u8* buf, u32 size) override;
+    bool doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin) override;
+    bool doGetCurrentSeekPos_(u64* pos, FileHandle* handle) override;
+    bool doGetFileSize_(u64* size, const SafeString& path) override;
+    bool doGetFileSize_(u64* size, FileHandle* handle) override;
+    bool doIsExistFile_(bool* isExist, const SafeString& path) override;
+    bool doIsExistDirectory_(bool* isExist, const SafeString& path) override;
+    FileDevice* doOpenDirectory_(DirectoryHandle* handle, const SafeString& dirname) override;
+    bool doCloseDirectory_(DirectoryHandle* handle) override;
+    bool doReadDirectory_(u32* readNum, DirectoryHandle* handle, DirectoryEntry* entry, u32 num) override;
+    bool doMakeDirectory_(const SafeString& path, u32 permission) override;
+    RawErrorCode doGetLastRawError_() const override;
+
+    bool doSave_(SaveArg& arg) override
+    {
+        SEAD_UNUSED(arg);
+        return false;
+    }
+
+protected:
+    ArchiveRes* mArchive;
+};
+
+} // namespace sead
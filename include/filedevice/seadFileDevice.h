@@ -53,6 +53,8 @@ public:
             , read_size(0)
             , roundup_size(0)
             , need_unload(false)
+            , use_map(false)
+            , map_device(nullptr)
         {
         }
 
@@ -70,6 +72,10 @@ public:
         u32 read_size;
         u32 roundup_size;
         bool need_unload;
+        // When set and buffer is null, devices that support it return a read only mapping of the file instead of a heap copy.
+        // map_device is then set to the device owning the mapping, which has to be released with map_device->unmap().
+        bool use_map;
+        FileDevice* map_device;
     };
 
     struct SaveArg
@@ -161,6 +167,9 @@ public:
         delete data;
     }
 
+    // Releases a mapping returned by tryLoad() with LoadArg::use_map
+    void unmap(u8* data, u32 size);
+
     bool save(SaveArg& arg)
     {
         bool success = trySave(arg);
@@ -220,6 +229,17 @@ public:
 
     bool tryRead(u32* readSize, FileHandle* handle, u8* buf, u32 size);
 
+    // Reads at offset without moving the seek position of handle
+    u32 readAt(FileHandle* handle, u8* buf, u32 size, u64 offset)
+    {
+        u32 readSize = 0;
+        bool success = tryReadAt(&readSize, handle, buf, size, offset);
+        SEAD_ASSERT_MSG(success, "file read error");
+        return readSize;
+    }
+
+    bool tryReadAt(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset);
+
     u32 write(FileHandle* handle, const u8* buf, u32 size)
     {
         u32 writeSize = 0;
@@ -230,43 +250,48 @@ public:
 
     bool tryWrite(u32* writeSize, FileHandle* handle, const u8* buf, u32 size);
 
-    bool seek(FileHandle* handle, s32 offset, SeekOrigin origin)
+    bool seek(FileHandle* handle, s64 offset, SeekOrigin origin)
     {
         bool success = trySeek(handle, offset, origin);
         SEAD_ASSERT_MSG(success, "file seek error");
         return success;
     }
 
-    bool trySeek(FileHandle* handle, s32 offset, SeekOrigin origin);
+    bool trySeek(FileHandle* handle, s64 offset, SeekOrigin origin);
 
-    u32 getCurrentSeekPos(FileHandle* handle)
+    u64 getCurrentSeekPos(FileHandle* handle)
     {
-        u32 pos = 0;
+        u64 pos = 0;
         bool success = tryGetCurrentSeekPos(&pos, handle);
         SEAD_ASSERT_MSG(success, "getCurrentSeekPos error");
         return pos;
     }
 
+    bool tryGetCurrentSeekPos(u64* pos, FileHandle* handle);
+    // Fails when the position does not fit in 32 bits
     bool tryGetCurrentSeekPos(u32* pos, FileHandle* handle);
 
-    u32 getFileSize(const SafeString& path)
+    u64 getFileSize(const SafeString& path)
     {
-        u32 size = 0;
+        u64 size = 0;
         bool success = tryGetFileSize(&size, path);
         SEAD_ASSERT_MSG(success, "getFileSize error");
         return size;
     }
 
+    bool tryGetFileSize(u64* size, const SafeString& path);
+    // Fails when the size does not fit in 32 bits
     bool tryGetFileSize(u32* size, const SafeString& path);
 
-    u32 getFileSize(FileHandle* handle)
+    u64 getFileSize(FileHandle* handle)
     {
-        u32 size = 0;
+        u64 size = 0;
         bool success = tryGetFileSize(&size, handle);
         SEAD_ASSERT_MSG(success, "getFileSize error");
         return size;
     }
 
+    bool tryGetFileSize(u64* size, FileHandle* handle);
     bool tryGetFileSize(u32* size, FileHandle* handle);
 
     bool isExistFile(const SafeString& path)
@@ -355,6 +380,7 @@ public:
 protected:
     virtual bool doIsAvailable_() const = 0;
     virtual u8* doLoad_(LoadArg& arg);
+    virtual void doUnmap_(u8* data, u32 size);
     virtual bool doSave_(SaveArg& arg);
     virtual FileDevice* doOpen_(FileHandle* handle, const SafeString& filename, FileOpenFlag flag) = 0;
     virtual bool doClose_(FileHandle* handle) = 0;
@@ -362,10 +388,11 @@ protected:
     virtual bool doRemove_(const SafeString& path) = 0;
     virtual bool doRead_(u32* readSize, FileHandle* handle, u8* buf, u32 size) = 0;
     virtual bool doWrite_(u32* writeSize, FileHandle* handle, const u8* buf, u32 size) = 0;
-    virtual bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin) = 0;
-    virtual bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle) = 0;
-    virtual bool doGetFileSize_(u32* size, const SafeString& path) = 0;
-    virtual bool doGetFileSize_(u32* size, FileHandle* handle) = 0;
+    virtual bool doReadAt_(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset);
+    virtual bool doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin) = 0;
+    virtual bool doGetCurrentSeekPos_(u64* pos, FileHandle* handle) = 0;
+    virtual bool doGetFileSize_(u64* size, const SafeString& path) = 0;
+    virtual bool doGetFileSize_(u64* size, FileHandle* handle) = 0;
     virtual bool doIsExistFile_(bool* isExist, const SafeString& path) = 0;
     virtual bool doIsExistDirectory_(bool* isExist, const SafeString& path) = 0;
     virtual FileDevice* doOpenDirectory_(DirectoryHandle* handle, const SafeString& dirname) = 0;
@@ -454,16 +481,21 @@ public:
     u32 read(u8* buf, u32 size);
     bool tryRead(u32* readSize, u8* buf, u32 size);
 
+    u32 readAt(u8* buf, u32 size, u64 offset);
+    bool tryReadAt(u32* readSize, u8* buf, u32 size, u64 offset);
+
     u32 write(const u8* buf, u32 size);
     bool tryWrite(u32* writeSize, const u8* buf, u32 size);
 
-    bool seek(s32 offset, FileDevice::SeekOrigin origin);
-    bool trySeek(s32 offset, FileDevice::SeekOrigin origin);
+    bool seek(s64 offset, FileDevice::SeekOrigin origin);
+    bool trySeek(s64 offset, FileDevice::SeekOrigin origin);
 
-    u32 getCurrentSeekPos();
+    u64 getCurrentSeekPos();
+    bool tryGetCurrentSeekPos(u64* pos);
     bool tryGetCurrentSeekPos(u32* pos);
 
-    u32 getFileSize();
+    u64 getFileSize();
+    bool tryGetFileSize(u64* size);
     bool tryGetFileSize(u32* size);
 
 protected:
@@ -23,6 +23,15 @@ protected:
         return mFileDevice->isAvailable();
     }
 
+    u8* doLoad_(LoadArg& arg) override
+    {
+        // Let the platform device map the file itself
+        if (arg.use_map)
+            return mFileDevice->tryLoad(arg);
+
+        return FileDevice::doLoad_(arg);
+    }
+
     FileDevice* doOpen_(FileHandle* handle, const SafeString& filename, FileOpenFlag flag) override
     {
         return mFileDevice->tryOpen(handle, filename, flag, handle->getDivSize());
@@ -48,27 +57,32 @@ protected:
         return mFileDevice->tryRead(readSize, handle, buf, size);
     }
 
+    bool doReadAt_(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset) override
+    {
+        return mFileDevice->tryReadAt(readSize, handle, buf, size, offset);
+    }
+
     bool doWrite_(u32* writeSize, FileHandle* handle, const u8* buf, u32 size) override
     {
         return mFileDevice->tryWrite(writeSize, handle, buf, size);
     }
 
-    bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin) override
+    bool doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin) override
     {
         return mFileDevice->trySeek(handle, offset, origin);
     }
 
-    bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle) override
+    bool doGetCurrentSeekPos_(u64* pos, FileHandle* handle) override
     {
         return mFileDevice->tryGetCurrentSeekPos(pos, handle);
     }
 
-    bool doGetFileSize_(u32* size, const SafeString& path) override
+    bool doGetFileSize_(u64* size, const SafeString& path) override
     {
         return mFileDevice->tryGetFileSize(size, path);
     }
 
-    bool doGetFileSize_(u32* size, FileHandle* handle) override
+    bool doGetFileSize_(u64* size, FileHandle* handle) override
     {
         return mFileDevice->tryGetFileSize(size, handle);
     }
@@ -16,6 +16,9 @@ public:
     static bool getDirectoryName(BufferedSafeString* dst, const SafeString& src);
     static void join(BufferedSafeString* dst, const char* a, const char* b);
     static void changeDelimiter(BufferedSafeString* path, char delimiter);
+    // Uses '/' as the delimiter, drops empty and "." parts and resolves ".." against the part before it.
+    // The drive is kept as is, so paths naming the same file compare equal after this.
+    static void normalize(BufferedSafeString* dst, const SafeString& src);
 };
 
 } // namespace sead
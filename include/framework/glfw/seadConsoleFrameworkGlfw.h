@@ -1,6 +1,7 @@
 #pragma once
 
 #include <framework/seadFramework.h>
+#include <time/seadFramePacer.h>
 
 namespace sead {
 
@@ -17,9 +18,17 @@ public:
     FrameBuffer* getMethodFrameBuffer(s32) const override { return nullptr; }
     bool setProcessPriority(ProcessPriority priority) override;
 
+    void setFps(f32 fps) { mFramePacer.setFps(fps); }
+    // Calc steps a late frame may catch up on
+    void setMaxFrameBacklog(s32 num) { mFramePacer.setMaxBacklogNum(num); }
+    FramePacer& getFramePacer() { return mFramePacer; }
+
 protected:
     void runImpl_() override;
     MethodTreeMgr* createMethodTreeMgr_(Heap* heap) override;
+
+protected:
+    FramePacer mFramePacer;
 };
 
 } // namespace sead
@@ -2,6 +2,7 @@
 
 #include <basis/glfw/seadGlfw.h>
 #include <framework/seadGameFramework.h>
+#include <time/seadFramePacer.h>
 
 namespace sead {
 
@@ -21,6 +22,7 @@ public:
             // , window_ex_style(0)
             , clear_color(Color4f::cGray)
             , create_default_framebuffer(true)
+            , max_frame_backlog(FramePacer::cDefaultMaxBacklogNum)
         {
         }
 
@@ -32,6 +34,8 @@ public:
         // DWORD window_ex_style;
         Color4f clear_color;
         bool create_default_framebuffer;
+        // Calc steps a late frame may catch up on when not waiting for vblank
+        s32 max_frame_backlog;
     };
 
 public:
@@ -55,6 +59,7 @@ public:
     void setFps(f32 fps)
     {
         mFrameTime = TickSpan::makeFromMicroSeconds(static_cast<s64>(1000000 / fps));
+        mFramePacer.setFrameTime(mFrameTime);
         mArg.fps = fps;
     }
 
@@ -132,6 +137,7 @@ protected:
     TickTime mLastUpdateTime;
     TickSpan mFrameTime;
     TickSpan mLastDiffTime;
+    FramePacer mFramePacer;
     bool mExit;
     // WNDPROC mMsgProcCallback;
     FrameBuffer* mDefaultFrameBuffer;
@@ -2,6 +2,7 @@
 
 #include <container/seadTreeNode.h>
 #include <heap/seadDisposer.h>
+#include <mc/seadJob.h>
 #include <prim/seadBitFlag.h>
 #include <prim/seadDelegate.h>
 #include <prim/seadNamable.h>
@@ -10,6 +11,8 @@
 namespace sead {
 
 class CriticalSection;
+class JobQueue;
+class ProcessMeterBarBase;
 
 class MethodTreeNode : public TTreeNode<MethodTreeNode*>, public INamable, public IDisposer
 {
@@ -42,6 +45,9 @@ public:
         , mPauseFlag(eNone)
         , mPauseEventDelegate(nullptr)
         , mUserID(nullptr)
+        , mIsParallel(false)
+        , mProcessMeterBar(nullptr)
+        , mCallJob(this)
     {
     }
 
@@ -62,6 +68,8 @@ public:
     }
 
     void call();
+    // Parallel subtrees run on queue while the calling thread helps out, the whole tree runs on the calling thread when null
+    void call(JobQueue* queue);
     void detachAll();
     void pushBackChild(MethodTreeNode* o);
     void pushFrontChild(MethodTreeNode* o);
@@ -101,6 +109,33 @@ public:
         return mUserID;
     }
 
+    // The subtree shares no data with its siblings, so it may be called on a worker at the same time as them.
+    // The parent waits for it before returning. The tree stays locked meanwhile, so the subtree must not modify it.
+    void setParallel(bool parallel)
+    {
+        lock_();
+        mIsParallel = parallel;
+        unlock_();
+    }
+
+    bool isParallel() const
+    {
+        return mIsParallel;
+    }
+
+    // Measures every call of the subtree, bar must not be shared with a subtree that may run at the same time
+    void setProcessMeterBar(ProcessMeterBarBase* bar)
+    {
+        lock_();
+        mProcessMeterBar = bar;
+        unlock_();
+    }
+
+    ProcessMeterBarBase* getProcessMeterBar() const
+    {
+        return mProcessMeterBar;
+    }
+
     MethodTreeNode* getParent()
     {
         return parent() ? parent()->val() : nullptr;
@@ -142,7 +177,27 @@ public:
     }
 
 protected:
-    void callRec_();
+    class CallJob : public Job
+    {
+    public:
+        explicit CallJob(MethodTreeNode* node)
+            : Job()
+            , mNode(node)
+            , mQueue(nullptr)
+        {
+        }
+
+        void invoke() override { mNode->callRec_(mQueue); }
+
+    protected:
+        MethodTreeNode* mNode;
+        JobQueue* mQueue;
+
+        friend class MethodTreeNode;
+    };
+
+protected:
+    void callRec_(JobQueue* queue);
     void attachMutexRec_(CriticalSection* m) const;
 
     void lock_();
@@ -155,6 +210,9 @@ protected:
     BitFlag32 mPauseFlag;
     PauseEventDelegate* mPauseEventDelegate;
     void* mUserID;
+    bool mIsParallel;
+    ProcessMeterBarBase* mProcessMeterBar;
+    CallJob mCallJob;
 };
 
 } // namespace sead
@@ -5,6 +5,7 @@
 
 namespace sead {
 
+class JobQueue;
 class MethodTreeNode;
 
 class MethodTreeMgr
@@ -25,8 +26,20 @@ public:
         return &mCS;
     }
 
+    // Calc subtrees marked with MethodTreeNode::setParallel() run on queue, everything runs on the calling thread when null
+    void setJobQueue(JobQueue* queue)
+    {
+        mJobQueue = queue;
+    }
+
+    JobQueue* getJobQueue() const
+    {
+        return mJobQueue;
+    }
+
 protected:
     CriticalSection mCS;
+    JobQueue* mJobQueue;
 };
 
 } // namespace sead
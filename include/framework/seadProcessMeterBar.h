@@ -68,6 +68,8 @@ public:
     static u32 getListNodeOffset() { return offsetof(ProcessMeterBarBase, mListNode); }
 
 protected:
+    // Also true while ProcessMeterTracer records, which does not need a ProcessMeter
+    bool isMeasuring_() const;
     void measureBeginImpl_(const TickTime& t, Color4f color);
     void measureEndImpl_(const TickTime& arg);
 
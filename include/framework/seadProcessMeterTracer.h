@@ -0,0 +1,99 @@
+#pragma once
+
+#include <heap/seadDisposer.h>
+#include <prim/seadSafeString.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadThreadLocalStorage.h>
+#include <time/seadTickTime.h>
+
+namespace sead {
+
+class Heap;
+class WriteStream;
+
+// Records the sections of every ProcessMeterBarBase on the thread measuring them, attached to a ProcessMeter or not,
+// and streams them out as Chrome Trace Event JSON for chrome://tracing or the Perfetto UI.
+// Each thread writes to a ring of its own without locking, markFrame() drains the rings into the stream once a frame.
+// A section finding its ring full is dropped and counted along with everything nested in it and its end, the ring keeps
+// room for the ends of the sections it holds so that the trace stays balanced.
+class ProcessMeterTracer
+{
+    SEAD_SINGLETON_DISPOSER(ProcessMeterTracer);
+
+public:
+    static const s32 cDefaultThreadNumMax = 32;
+    static const s32 cDefaultEventNumMax = 16 * 1024;
+
+public:
+    ProcessMeterTracer();
+    ~ProcessMeterTracer();
+
+    // eventNumMax is the size of the ring of every thread and is rounded up to a power of two
+    void initialize(s32 threadNumMax = cDefaultThreadNumMax, s32 eventNumMax = cDefaultEventNumMax, Heap* heap = nullptr);
+
+    // stream must stay alive until end(), it is only written by the thread calling markFrame() and end()
+    void begin(WriteStream* stream);
+    void end();
+    bool isRecording() const { return mIsRecording.getValue() != 0; }
+
+    // name must stay alive until the event is written, bar names are
+    void recordBegin(const char* name, const TickTime& t);
+    void recordEnd(const TickTime& t);
+
+    // Called by the framework loop at the start of every frame
+    void markFrame();
+
+    u32 getFrameNum() const { return mFrameNum; }
+    u32 getDroppedNum() const;
+
+protected:
+    enum class EventType : u8
+    {
+        eBegin = 0,
+        eEnd,
+        eFrame
+    };
+
+    struct Event
+    {
+        u64 tick;
+        const char* name;
+        EventType type;
+    };
+
+    // head and the depths are only written by its thread and tail only by the thread draining the rings
+    struct ThreadBuffer
+    {
+        Event* events;
+        AtomicU32 head;
+        AtomicU32 tail;
+        AtomicU32 droppedNum;
+        AtomicU32 isReady;
+        u32 openDepth;
+        u32 droppedDepth;
+        u32 captureNum;
+        FixedSafeString<32> name;
+        bool isNameWritten;
+    };
+
+    ThreadBuffer* getThreadBuffer_();
+    void push_(EventType type, const char* name, const TickTime& t);
+    void flush_();
+    void writeEvent_(s32 tid, const Event& event);
+    void writeEntry_(const SafeString& entry);
+
+protected:
+    ThreadLocalStorage mBufferTLS;
+    ThreadBuffer* mThreadBuffers;
+    s32 mThreadNumMax;
+    AtomicU32 mThreadNum;
+    u32 mEventMask;
+    AtomicU32 mIsRecording;
+    WriteStream* mStream;
+    u64 mBeginTick;
+    u32 mCaptureNum;
+    u32 mFrameNum;
+    bool mIsFirstEntry;
+};
+
+} // namespace sead
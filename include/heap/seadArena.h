@@ -7,11 +7,27 @@ namespace sead {
 
 class Arena
 {
+public:
+    enum class PageType
+    {
+        eNormal = 0,
+        // Normal pages with a hint to back them with huge pages, see transparent huge pages on Linux
+        eTransparentHuge,
+        // Huge pages from the reserved pool, falls back to eTransparentHuge when the pool is exhausted.
+        // On Windows these are large pages, which need SeLockMemoryPrivilege, and the fallback is eNormal.
+        eHuge
+    };
+
+    static const s32 cNumaNodeAny = -1;
+
 public:
     Arena();
     ~Arena();
 
     void initialize(size_t size);
+    // Reserves the address space up front, pages are only committed when first touched where the platform allows it.
+    // numaNode binds the pages to that node on Linux and Windows, getPageType() and getNumaNode() tell what was granted.
+    void initialize(size_t size, PageType pageType, s32 numaNode = cNumaNodeAny);
     void initialize(u8* start, size_t size);
     void destroy();
 
@@ -19,9 +35,19 @@ public:
     size_t getSize() const { return mSize; }
     bool isInclude(void* ptr) const { return PtrUtil::isInclude(ptr, mStart, mStart + mSize); }
 
+    PageType getPageType() const { return mPageType; }
+    s32 getNumaNode() const { return mNumaNode; }
+    // Size of the address space reserved, not smaller than getSize()
+    size_t getReservedSize() const { return mReservedSize; }
+    // Size actually backed by physical memory, walks the page table so it is not cheap
+    size_t getResidentSize() const;
+
 private:
     u8* mStart;
     size_t mSize;
+    size_t mReservedSize;
+    PageType mPageType;
+    s32 mNumaNode;
     bool mInitWithStartAddress;
 };
 
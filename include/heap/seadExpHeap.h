@@ -2,9 +2,13 @@
 
 #include <heap/seadHeap.h>
 #include <heap/seadMemBlock.h>
+#include <thread/seadAtomic.h>
+#include <time/seadTickSpan.h>
 
 namespace sead {
 
+class ThreadHeapCache;
+
 class ExpHeap : public Heap
 {
     SEAD_RTTI_OVERRIDE(ExpHeap, Heap);
@@ -13,7 +17,8 @@ public:
     enum class AllocMode
     {
         eFirstFit = 0,
-        eBestFit
+        eBestFit,
+        eSegregatedFit
     };
 
     enum class FindMode
@@ -23,9 +28,32 @@ public:
         eMaxSize
     };
 
+    // Free blocks grouped by powers of two, bucket i holds sizes in [16 << i, 32 << i), the last one everything above
+    static const s32 cFreeBlockHistogramNum = 16;
+
+    struct FragmentationInfo
+    {
+        size_t freeSize;
+        size_t maxFreeBlockSize;
+        u32 freeBlockNum;
+        u32 freeBlockHistogram[cFreeBlockHistogramNum];
+        // 1 - maxFreeBlockSize / freeSize, 0 when all the free memory is in one block
+        f32 externalFragmentation;
+    };
+
+    // Relocatable allocation, 0 is never a valid handle
+    using Handle = u32;
+
+    static const Handle cInvalidHandle = 0;
+    static const s32 cHandleNumMax = 0xFFFF;
+
 private:
     using constIterator = MemBlockList::constIterator;
 
+protected:
+    struct FreeBinTable;
+    struct HandleTable;
+
 public:
     static ExpHeap* create(size_t size, const SafeString& name, Heap* parent, HeapDirection direction = HeapDirection::eForward, bool enableLock = false);
 
@@ -65,10 +93,9 @@ public:
     bool isResizable() const override;
     bool isAdjustable() const override;
 
-    virtual void setAllocMode(AllocMode mode)
-    {
-        mAllocMode = mode;
-    }
+    // eSegregatedFit keeps free blocks in size class bins instead of the address ordered free list.
+    // The bin table is carved from this heap, so switching to it may fail when the heap is full.
+    virtual void setAllocMode(AllocMode mode);
 
     virtual AllocMode getAllocMode() const
     {
@@ -89,12 +116,37 @@ public:
 
     bool tryCheckUseList() const;
 
-    size_t getFreeListSize() const { return mFreeList.size(); }
+    size_t getFreeListSize() const;
     size_t getUseListSize() const { return mUseList.size(); }
     size_t getAllocatedSize(void* ptr);
 
     void dumpYAML(WriteStream& stream, s32 indent) const override;
 
+    void calcFragmentationInfo(FragmentationInfo* info) const;
+
+    // Relocatable allocations are reached through handles so that compact() may move them.
+    // The handle table is carved from this heap like the free bin table, freeAll() frees every handle.
+    // Their memory is aligned to cMinAlignment and must be released with freeHandle(), never with free().
+    bool createHandleTable(s32 handleNumMax);
+    void destroyHandleTable();
+    bool isHandleTableCreated() const { return mHandleTable != nullptr; }
+
+    Handle tryAllocHandle(size_t size);
+    void freeHandle(Handle handle);
+    bool isValidHandle(Handle handle) const;
+    // Address of the memory, only valid until the next compact() unless the handle is locked
+    void* getHandleAddress(Handle handle) const;
+    // Locked handles are never moved, locks nest
+    void* lockHandle(Handle handle);
+    void unlockHandle(Handle handle);
+
+    // Slides unlocked relocatable allocations toward the start of the heap until budget runs out and picks up where it left off on
+    // the next call, so it can be spread over frames. Returns true once a whole pass found nothing to move.
+    bool compact(TickSpan budget);
+
+    ThreadHeapCache* getThreadHeapCache() const { return mThreadHeapCache.getValueAcquire(); }
+
+    // Free list iteration is only available in eFirstFit and eBestFit
     constIterator constBeginFreeList() const { return mFreeList.constBegin(); }
     constIterator constEndFreeList() const { return mFreeList.constEnd(); }
     constIterator constBeginUseList() const { return mUseList.constBegin(); }
@@ -104,6 +156,11 @@ protected:
     static void doCreate(ExpHeap* heap, Heap* parent);
     static void createMaxSizeFreeMemBlock_(ExpHeap* heap);
 
+    FindMode getAllocFindMode_() const
+    {
+        return mAllocMode == AllocMode::eBestFit ? FindMode::eBestFit : FindMode::eFirstFit;
+    }
+
     MemBlock* findFreeMemBlockFromHead_(size_t size, FindMode mode) const;
     MemBlock* findFreeMemBlockFromHead_(size_t size, s32 alignment, FindMode mode) const;
     MemBlock* findFreeMemBlockFromTail_(size_t size, FindMode mode) const;
@@ -113,12 +170,41 @@ protected:
 
     void pushToUseList_(MemBlock* memBlock);
     void pushToFreeList_(MemBlock* memBlock);
+    void eraseFromFreeList_(MemBlock* memBlock);
+    void resizeFreeMemBlock_(MemBlock* memBlock, size_t newSize);
+    void markMemBlockUsed_(MemBlock* memBlock, bool prevFree);
+
+    void* getAreaStart_() const override;
+    void* getAreaEnd_() const override;
+    MemBlock* getNextMemBlock_(const MemBlock* memBlock) const;
+
+    bool createFreeBinTable_();
+    void destroyFreeBinTable_();
+    MemBlock* findFreeBinMemBlock_(size_t size, s32 alignment, bool fromTail, FindMode mode) const;
+    void pushToFreeBin_(MemBlock* memBlock);
+    void insertToFreeBin_(MemBlock* memBlock);
+    void eraseFromFreeBin_(MemBlock* memBlock);
+    bool tryCheckFreeBin_() const;
+
+    struct HandleEntry;
+
+    HandleEntry* findHandleEntry_(Handle handle) const;
+    MemBlock* getHandleMemBlock_(const HandleEntry* entry) const;
+    // Moves a relocatable block down, freeBlock receives the free block left where it was
+    bool compactMemBlock_(MemBlock* memBlock, MemBlock* prevFreeBlock, MemBlock** freeBlock);
 
 #if defined(SEAD_TARGET_DEBUG)
     void fillMemBlockDebugFillFree_(void* addr);
+
+    void genInformation_(hostio::Context* context) override;
 #endif // SEAD_TARGET_DEBUG
 
     static s32 compareMemBlockAddr_(const MemBlock* a, const MemBlock* b);
+    static bool isMemBlockFit_(const MemBlock* memBlock, size_t size, s32 alignment, bool fromTail);
+
+    // Neither takes the heap lock, alignment is signed as in tryAlloc after applying the direction
+    MemBlock* allocMemBlock_(size_t size, s32 alignment);
+    void freeMemBlock_(MemBlock* memBlock);
 
     MemBlock* allocFromHead_(size_t size);
     MemBlock* allocFromHead_(size_t size, s32 alignment);
@@ -131,11 +217,16 @@ protected:
     void* realloc_(void* ptr, u8* oldMem, size_t copySize, size_t newSize, s32 alignment);
 
     friend class PrintFormatter;
+    friend class ThreadHeapCache;
 
 protected:
     AllocMode mAllocMode;
     MemBlockList mFreeList;
     MemBlockList mUseList;
+    FreeBinTable* mFreeBinTable;
+    // Read without the heap lock by tryAlloc() and free()
+    AtomicPtr<ThreadHeapCache*> mThreadHeapCache;
+    HandleTable* mHandleTable;
 };
 
 } // namespace sead
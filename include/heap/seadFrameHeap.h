@@ -63,8 +63,8 @@ public:
 protected:
     void initialize_();
 
-    void* getAreaStart_() const;
-    void* getAreaEnd_() const;
+    void* getAreaStart_() const override;
+    void* getAreaEnd_() const override;
 
     size_t getAreaSize_() const
     {
@@ -200,6 +200,10 @@ protected:
     Heap* findContainHeap_(const void* ptr);
     bool hasNoChild_() const { return mChildren.size() == 0; }
 
+    // Range isInclude() accepts, the heap management area excluded
+    virtual void* getAreaStart_() const { return mStart; }
+    virtual void* getAreaEnd_() const { return static_cast<u8*>(mStart) + mSize; }
+
 #if defined(SEAD_TARGET_DEBUG)
     static void setEnableDebugFillSystem_(Heap* heap, bool enable)
     {
@@ -246,6 +250,7 @@ protected:
     mutable CriticalSection mCS;
     BitFlag16 mFlag;
     u16 mHeapCheckTag;
+    u16 mHeapId;
 #if defined(SEAD_TARGET_DEBUG)
     Thread* mAccessThread;
 #endif // SEAD_TARGET_DEBUG
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <thread/seadAtomic.h>
+
+namespace sead {
+
+class Heap;
+
+// Page granular radix tree mapping an address to the innermost heap whose area contains it.
+// Each page entry is a step function of up to cSegmentMax heaps guarded by a sequence number, so readers never lock.
+// Pages with more heap boundaries than that are marked as not indexed and have to be looked up in the heap tree.
+// Writers must be serialized by the caller, HeapMgr does it with the heap tree lock.
+class HeapAddressIndex
+{
+    SEAD_NO_COPY(HeapAddressIndex);
+
+public:
+    static const s32 cPageShift = 12;
+    static const size_t cPageSize = static_cast<size_t>(1) << cPageShift;
+    static const s32 cSegmentMax = 4;
+    static const s32 cHeapNumMax = 0x1000;
+
+public:
+    HeapAddressIndex();
+    ~HeapAddressIndex();
+
+    // Returns false when addr is not indexed, otherwise heap is set to the owner or null when no heap contains addr
+    bool find(Heap** heap, const void* addr) const;
+
+    // Makes heap, which may be null, the owner of [start, end)
+    void assign(const void* start, const void* end, Heap* heap);
+    // Frees the id of heap, it must not own any page anymore
+    void release(Heap* heap);
+
+    // Returns the id of heap, which is registered if needed, or 0 when there is no free id left
+    u16 registerHeap(Heap* heap);
+    Heap* getHeap(u16 id) const { return id < cHeapNumMax ? mHeaps[id].getValue() : nullptr; }
+
+    // Frees all tables, no reader may run concurrently
+    void clear();
+
+protected:
+    static const s32 cLeafBits = 12;
+    static const s32 cIndexBits = (sizeof(void*) == 8 ? 48 : 32) - cPageShift;
+    static const s32 cNodeBits = cIndexBits - cLeafBits < 12 ? cIndexBits - cLeafBits : 12;
+    static const s32 cRootBits = cIndexBits - cLeafBits - cNodeBits;
+
+    static const u16 cComplexId = 0xFFFF;
+    static const u32 cComplexNum = 0xF;
+
+    // layout: sequence (16) | segment num (4) | split offsets (3 * 12), ids: heap id of each segment (4 * 16)
+    struct Entry
+    {
+        AtomicBase64<u64> layout;
+        AtomicBase64<u64> ids;
+    };
+
+    struct Leaf
+    {
+        Entry entries[1 << cLeafBits];
+    };
+
+    struct Node
+    {
+        AtomicPtr<Leaf*> leaves[1 << cNodeBits];
+    };
+
+    Entry* getEntry_(uintptr_t page, bool create);
+    void assignPage_(Entry* entry, u32 begin, u32 end, u16 id);
+    u16 getId_(Heap* heap);
+
+protected:
+    AtomicPtr<Node*> mRoot[1 << cRootBits];
+    AtomicPtr<Heap*> mHeaps[cHeapNumMax];
+    s32 mHeapIdEnd;
+};
+
+} // namespace sead
@@ -3,6 +3,7 @@
 #include <basis/seadRawPrint.h>
 #include <container/seadPtrArray.h>
 #include <heap/seadArena.h>
+#include <heap/seadHeapAddressIndex.h>
 #include <hostio/seadHostIONode.h>
 #include <prim/seadDelegate.h>
 #include <prim/seadSafeString.h>
@@ -178,6 +179,15 @@ public:
 
     static void removeFromFindContainHeapCache_(Heap* heap);
 
+    // Keep the address index in sync with the area of heap, called on create, destroy and adjust
+    static void addToAddressIndex_(Heap* heap);
+    static void removeFromAddressIndex_(Heap* heap);
+    static void updateAddressIndex_(Heap* heap, const void* prevAreaStart, const void* prevAreaEnd);
+
+    // Innermost heap containing ptr found through the heap id of its MemBlock header, null if it can not be trusted.
+    // Without sHeapTreeLockCS held only heaps without children are trusted.
+    static Heap* findHeapFromMemBlockTag_(const void* ptr, bool isTreeLocked);
+
 #if defined(SEAD_TARGET_DEBUG)
     static void dumpFindContainHeapCacheStatistics();
     static void clearFindContainHeapCacheStatistics();
@@ -197,6 +207,7 @@ protected:
 
     friend class ExpHeap;
     friend class FrameHeap;
+    friend class SlabHeap;
     friend class UnboundHeap;
     friend class CurrentHeapSetter;
 
@@ -213,6 +224,7 @@ protected:
     static RootHeaps sRootHeaps;
     static CriticalSection sHeapTreeLockCS;
     static IndependentHeaps sIndependentHeaps;
+    static HeapAddressIndex sAddressIndex;
 
 #if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
     static Heap* sUnboundHeap;
@@ -3,6 +3,7 @@
 #include <basis/seadNew.h>
 #include <basis/seadRawPrint.h>
 #include <container/seadOffsetList.h>
+#include <prim/seadBitFlag.h>
 #include <prim/seadMemUtil.h>
 #include <prim/seadPtrUtil.h>
 
@@ -15,10 +16,21 @@ protected:
         : mListNode()
         , mHeapCheckTag(0)
         , mOffset(0)
+        , mHeapId(0)
+        , mFlag()
         , mSize(0)
     {
     }
 
+    // Boundary tags, only maintained while the owning ExpHeap is in AllocMode::eSegregatedFit.
+    // eRelocatable marks memory owned by an ExpHeap handle and is cleared when the block is freed.
+    enum Flag
+    {
+        eFree = 0,
+        ePrevFree,
+        eRelocatable
+    };
+
     u8* memory() const
     {
         return static_cast<u8*>(PtrUtil::addOffset(this, mOffset + sizeof(MemBlock)));
@@ -34,6 +46,12 @@ protected:
         mHeapCheckTag = tag;
     }
 
+    // Id of the owning heap in the address index of HeapMgr, 0 if it has none
+    void setHeapId(u16 id)
+    {
+        mHeapId = id;
+    }
+
     void setSize(size_t size)
     {
         SEAD_ASSERT(size % cPtrSize == 0);
@@ -53,6 +71,36 @@ protected:
         }
     }
 
+    void setFree(bool free)
+    {
+        mFlag.changeBit(Flag::eFree, free);
+    }
+
+    bool isFree() const
+    {
+        return mFlag.isOnBit(Flag::eFree);
+    }
+
+    void setPrevFree(bool prevFree)
+    {
+        mFlag.changeBit(Flag::ePrevFree, prevFree);
+    }
+
+    bool isPrevFree() const
+    {
+        return mFlag.isOnBit(Flag::ePrevFree);
+    }
+
+    void setRelocatable(bool relocatable)
+    {
+        mFlag.changeBit(Flag::eRelocatable, relocatable);
+    }
+
+    bool isRelocatable() const
+    {
+        return mFlag.isOnBit(Flag::eRelocatable);
+    }
+
     void fill(u8 val)
     {
         MemUtil::fill(memory(), val, mSize);
@@ -160,13 +208,44 @@ public:
         return block;
     }
 
+    // Same as FindManageArea, but returns null instead of asserting when ptr can not be the memory of a block.
+    // The header found is not guaranteed to be a live block, its fields must be validated by the caller.
+    //
+    // Layout written by the heaps and setOffset:
+    //    [MemBlock][optional padding, last word = this|1][user data]
+    //                                                     ^ ptr
+    // When mOffset == 0: ptr - cPtrSize overlaps the tail of MemBlock (mSize).
+    //    mSize is always pointer-aligned, so bit 0 == 0 -> block = ptr - sizeof(MemBlock).
+    // When mOffset > 0:  ptr - cPtrSize holds (MemBlock* this)|1, bit 0 == 1.
+    static const MemBlock* TryFindManageArea(const void* ptr)
+    {
+        uintptr_t offsetTail = *reinterpret_cast<const uintptr_t*>(reinterpret_cast<intptr_t>(ptr) - cPtrSize);
+
+        uintptr_t block;
+        if ((offsetTail & 1) == 0)
+            block = reinterpret_cast<uintptr_t>(ptr) - sizeof(MemBlock);
+        else
+            block = offsetTail - 1;
+
+        // The header ends at or before ptr, at most the range of mOffset away from it
+        uintptr_t blockEnd = block + sizeof(MemBlock);
+        if (block % cPtrSize != 0 || blockEnd > reinterpret_cast<uintptr_t>(ptr) || reinterpret_cast<uintptr_t>(ptr) - blockEnd > 0xFFFF)
+            return nullptr;
+
+        return reinterpret_cast<const MemBlock*>(block);
+    }
+
 protected:
     ListNode mListNode;
     u16 mHeapCheckTag;
     u16 mOffset;
-    size_t mSize;
+    u16 mHeapId;
+    BitFlag8 mFlag;
+    size_t mSize; // Must stay the last member, see FindManageArea
 
     friend class ExpHeap;
+    friend class HeapMgr;
+    friend class ThreadHeapCache;
     friend class UnboundHeap;
 };
 
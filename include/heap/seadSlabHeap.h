@@ -0,0 +1,125 @@
+#pragma once
+
+#include <heap/seadHeap.h>
+#include <prim/seadPtrUtil.h>
+#include <thread/seadAtomic.h>
+
+namespace sead {
+
+// Heap of fixed size elements, for objects allocated in large numbers such as list nodes, events and messages.
+// The area is split into slabs of the same size, each slab is handed to one size class on demand and carved into its elements.
+// Allocations are served by the smallest fitting size class and freeing needs no header, both are O(1).
+// When the lock is enabled, elements are popped and pushed with lock free free lists and only slab refills take the lock.
+// Slabs stay with their size class until freeAll().
+class SlabHeap : public Heap
+{
+    SEAD_RTTI_OVERRIDE(SlabHeap, Heap);
+
+public:
+    static const s32 cSizeClassNumMax = 16;
+    static const size_t cDefaultSlabSize = 0x4000;
+    static const s32 cSlabAlignment = 64;
+
+public:
+    // elemSizes are sorted ascending multiples of 8 not larger than slabSize, the default size classes are used when null
+    static SlabHeap* create(size_t size, const SafeString& name, Heap* parent, const u32* elemSizes = nullptr, s32 sizeClassNum = 0,
+                            size_t slabSize = cDefaultSlabSize, bool enableLock = false);
+
+    static SlabHeap* tryCreate(size_t size, const SafeString& name, Heap* parent, const u32* elemSizes = nullptr, s32 sizeClassNum = 0,
+                               size_t slabSize = cDefaultSlabSize, bool enableLock = false);
+
+    // Size needed on top of the slabs themselves
+    static size_t getManagementAreaSize(s32 slabNum);
+
+protected:
+    SlabHeap(const SafeString& name, Heap* parent, void* start, size_t size, size_t slabSize, bool enableLock);
+    ~SlabHeap() override;
+
+public:
+    void destroy() override;
+    // Gives the slabs not handed to any size class yet back to the parent
+    size_t adjust() override;
+    void* tryAlloc(size_t size, s32 alignment = cDefaultAlignment) override;
+    void free(void* ptr) override;
+    void* resizeFront(void* ptr, size_t newSize) override;
+    void* resizeBack(void* ptr, size_t newSize) override;
+    void freeAll() override;
+    const void* getStartAddress() const override;
+    const void* getEndAddress() const override;
+    size_t getSize() const override;
+    size_t getFreeSize() const override;
+    size_t getMaxAllocatableSize(s32 alignment = cDefaultAlignment) const override;
+    bool isInclude(const void* ptr) const override;
+    bool isEmpty() const override;
+    bool isFreeable() const override;
+    bool isResizable() const override;
+    bool isAdjustable() const override;
+    void dump() const override;
+    void dumpYAML(WriteStream& stream, s32 indent) const override;
+
+    size_t getSlabSize() const { return mSlabSize; }
+    s32 getSlabNum() const { return mSlabNum; }
+    s32 getSlabUsedNum() const { return static_cast<s32>(mSlabUsedNum.getValue()); }
+
+    s32 getSizeClassNum() const { return mSizeClassNum; }
+    // Smallest size class able to hold size with the alignment, -1 if there is none
+    s32 findSizeClass(size_t size, s32 alignment = cDefaultAlignment) const;
+
+    size_t getElemSize(s32 sizeClass) const;
+    s32 getElemSlabNum(s32 sizeClass) const;
+    u32 getElemUsedNum(s32 sizeClass) const;
+    u32 getElemPeakNum(s32 sizeClass) const;
+
+protected:
+    struct SizeClass
+    {
+        // Tag in the upper and element index in the lower 32 bits
+        AtomicBase64<u64> head;
+        AtomicU32 usedNum;
+        AtomicU32 peakNum;
+        u32 elemSize;
+        u32 elemNumPerSlab;
+        s32 slabNum;
+    };
+
+    static const u32 cNullIndex = 0xFFFFFFFF;
+    static const u8 cNullSizeClass = 0xFF;
+    static const s32 cIndexShift = 3;
+
+    void initialize_(const u32* elemSizes, s32 sizeClassNum);
+
+    void* getAreaStart_() const override;
+    void* getAreaEnd_() const override;
+
+    u32 getElemIndex_(const void* ptr) const
+    {
+        return static_cast<u32>(PtrUtil::diff(ptr, mSlabStart) >> cIndexShift);
+    }
+
+    void* getElem_(u32 index) const
+    {
+        return PtrUtil::addOffset(mSlabStart, static_cast<intptr_t>(index) << cIndexShift);
+    }
+
+    s32 getSlabIndex_(const void* ptr) const
+    {
+        return static_cast<s32>(PtrUtil::diff(ptr, mSlabStart) >> mSlabShift);
+    }
+
+    void* popElem_(SizeClass* sizeClass);
+    void pushElems_(SizeClass* sizeClass, u32 headIndex, u32* tailNext);
+    bool refill_(s32 sizeClass);
+
+protected:
+    SizeClass mSizeClasses[cSizeClassNumMax];
+    s32 mSizeClassNum;
+    size_t mSlabSize;
+    s32 mSlabShift;
+    void* mSlabStart;
+    s32 mSlabNum;
+    AtomicU32 mSlabUsedNum;
+    // Size class of each slab
+    u8* mSlabSizeClasses;
+};
+
+} // namespace sead
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <container/seadFreeList.h>
+#include <thread/seadCriticalSection.h>
+#include <thread/seadThreadLocalStorage.h>
+
+namespace sead {
+
+class ExpHeap;
+class Heap;
+
+// Per thread magazines of small blocks sitting in front of an ExpHeap.
+// Once created, small allocations with up to cDefaultAlignment and frees of such blocks
+// on the target heap go through the calling thread's magazine without taking the heap lock.
+// Refills and flushes are done in batches under the heap lock.
+// Blocks kept in a magazine are still counted as used by the heap.
+// A thread's magazines go back to the heap and its slot is released when the thread exits.
+class ThreadHeapCache
+{
+    SEAD_NO_COPY(ThreadHeapCache);
+
+public:
+    static const s32 cSizeClassNum = 16;
+    static const size_t cSizeClassUnit = 16;
+    static const size_t cMaxCacheSize = cSizeClassUnit * cSizeClassNum;
+    static const s32 cAlignment = cDefaultAlignment;
+    static const s32 cRefillNum = 16;
+    static const s32 cMagazineNumMax = 64;
+
+private:
+    struct Magazine
+    {
+        FreeList list;
+        s32 num;
+    };
+
+    struct ThreadCache
+    {
+        Magazine magazines[cSizeClassNum];
+        ThreadHeapCache* owner;
+        bool isUsed;
+    };
+
+public:
+    // Threads beyond threadNumMax simply bypass the cache
+    static ThreadHeapCache* create(ExpHeap* heap, s32 threadNumMax, Heap* workHeap = nullptr);
+
+    // Returns every cached block to the heap, no other thread may use the heap meanwhile
+    void destroy();
+
+    // Returns the calling thread's cached blocks to the heap and releases its slot ahead of the thread's exit
+    void flush();
+
+    ExpHeap* getHeap() const { return mHeap; }
+    s32 getThreadNumMax() const { return mThreadNumMax; }
+
+protected:
+    ThreadHeapCache(ExpHeap* heap, ThreadCache* threadCaches, s32 threadNumMax);
+    ~ThreadHeapCache();
+
+    void* tryAlloc_(size_t size, s32 alignment);
+    bool tryFree_(void* ptr, size_t size);
+
+    ThreadCache* getThreadCache_();
+    void releaseThreadCache_(ThreadCache* threadCache);
+    void refill_(Magazine* magazine, s32 index);
+    void flush_(Magazine* magazine, s32 num);
+    void flushThreadCache_(ThreadCache* threadCache);
+    void purge_();
+    void detachHeap_();
+
+#if defined(SEAD_PLATFORM_WINDOWS)
+    static void __stdcall onThreadExit_(void* threadCache);
+#elif defined(SEAD_PLATFORM_POSIX)
+    static void onThreadExit_(void* threadCache);
+#endif // SEAD_PLATFORM_WINDOWS
+
+    static s32 calcSizeClass_(size_t size)
+    {
+        return static_cast<s32>((size + cSizeClassUnit - 1) / cSizeClassUnit) - 1;
+    }
+
+    static size_t getSizeClassSize_(s32 index)
+    {
+        return (index + 1) * cSizeClassUnit;
+    }
+
+    friend class ExpHeap;
+
+protected:
+    ExpHeap* mHeap;
+    ThreadCache* mThreadCaches;
+    s32 mThreadNumMax;
+    // Outlives mThreadCacheTLS, whose destruction runs onThreadExit_() on Windows
+    CriticalSection mCS;
+    ThreadLocalStorage mThreadCacheTLS;
+};
+
+} // namespace sead
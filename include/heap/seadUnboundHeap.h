@@ -50,6 +50,12 @@ public:
         return mMemBlockList.size();
     }
 
+protected:
+    // Whether ptr is in one of the blocks of this heap, children excluded
+    bool isIncludeMemBlock_(const void* ptr) const;
+
+    friend class HeapMgr;
+
 protected:
     MemBlockList mMemBlockList;
     size_t mAllocedSize;
@@ -4,6 +4,8 @@
 
 #if defined(SEAD_PLATFORM_WINDOWS)
 #include <basis/win/seadWindows.h>
+#elif defined(SEAD_PLATFORM_POSIX)
+#include <sched.h>
 #endif // SEAD_PLATFORM_WINDOWS
 
 namespace sead {
@@ -147,7 +149,15 @@ public:
 #if defined(SEAD_PLATFORM_WINDOWS)
         return getCoreIdFromPlatformCoreId(GetCurrentProcessorNumber());
 #elif defined(SEAD_PLATFORM_POSIX)
-        return cMain; // TODO
+#if !defined(SEAD_PLATFORM_MACOSX)
+        s32 id = sched_getcpu();
+        if (id < 0 || static_cast<u32>(id) >= cPlatformCoreIdMax)
+            return cUndef;
+
+        return getCoreIdFromPlatformCoreId(id);
+#else
+        return cMain;
+#endif // SEAD_PLATFORM_MACOSX
 #else
     #error "Unsupported platform"
 #endif // SEAD_PLATFORM_WINDOWS
@@ -168,7 +178,7 @@ public:
     static CoreIdMask getMaskAll()
     {
         CoreIdMask m;
-        m.set((1 << sNumCores) - 1);
+        m.set(static_cast<u32>((1ull << sNumCores) - 1));
         return m;
     }
 
@@ -180,9 +190,16 @@ public:
     }
 
 protected:
+#if defined(SEAD_PLATFORM_POSIX)
+    // Cores the process may run on are not numbered from zero, platform ids go up to CPU_SETSIZE
+    static const u32 cPlatformCoreIdMax = CPU_SETSIZE;
+#else
+    static const u32 cPlatformCoreIdMax = 32;
+#endif // SEAD_PLATFORM_POSIX
+
     static u32 sNumCores;
     static u32 sPlatformCoreId[32];
-    static CoreId sCoreIdFromPlatformCoreIdTable[32];
+    static CoreId sCoreIdFromPlatformCoreIdTable[cPlatformCoreIdMax];
 };
 
 } // namespace sead
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <prim/seadDelegate.h>
+#include <thread/seadAtomic.h>
+
+namespace sead {
+
+class JobCounter;
+class JobQueue;
+
+// Unit of work run by a JobQueue, owned by the caller and must stay alive until its counter is done
+class Job
+{
+public:
+    Job()
+        : mCounter(nullptr)
+        , mNext(nullptr)
+    {
+    }
+
+    virtual ~Job() {}
+
+    virtual void invoke() = 0;
+
+protected:
+    JobCounter* mCounter;
+    Job* mNext;
+
+    friend class JobQueue;
+};
+
+class DelegateJob : public Job
+{
+public:
+    DelegateJob()
+        : Job()
+        , mDelegate(nullptr)
+    {
+    }
+
+    explicit DelegateJob(IDelegate* deleg)
+        : Job()
+        , mDelegate(deleg)
+    {
+    }
+
+    void setDelegate(IDelegate* deleg) { mDelegate = deleg; }
+    IDelegate* getDelegate() const { return mDelegate; }
+
+    void invoke() override
+    {
+        if (mDelegate)
+            mDelegate->invoke();
+    }
+
+protected:
+    IDelegate* mDelegate;
+};
+
+template <typename T>
+class DelegateJob1 : public Job
+{
+public:
+    DelegateJob1()
+        : Job()
+        , mDelegate(nullptr)
+        , mArg()
+    {
+    }
+
+    DelegateJob1(IDelegate1<T>* deleg, T arg)
+        : Job()
+        , mDelegate(deleg)
+        , mArg(arg)
+    {
+    }
+
+    void setDelegate(IDelegate1<T>* deleg) { mDelegate = deleg; }
+    IDelegate1<T>* getDelegate() const { return mDelegate; }
+
+    void setArg(T arg) { mArg = arg; }
+    T getArg() const { return mArg; }
+
+    void invoke() override
+    {
+        if (mDelegate)
+            mDelegate->invoke(mArg);
+    }
+
+protected:
+    IDelegate1<T>* mDelegate;
+    T mArg;
+};
+
+// Counts the unfinished jobs enqueued with it, jobs may also be enqueued to start after a counter is done
+class JobCounter
+{
+    SEAD_NO_COPY(JobCounter);
+
+public:
+    JobCounter()
+        : mCount(0)
+        , mFinishingNum(0)
+        , mWaitingJobs(nullptr)
+        , mWaiters(nullptr)
+    {
+    }
+
+    // A finishing worker may still touch the counter after the count reached zero
+    bool isDone() const { return mCount.getValue() == 0 && mFinishingNum.getValue() == 0; }
+    u32 getCount() const { return mCount.getValue(); }
+
+protected:
+    // Threads blocked in JobQueue::wait(), defined there
+    struct Waiter;
+
+    AtomicU32 mCount;
+    AtomicU32 mFinishingNum;
+    Job* mWaitingJobs;
+    Waiter* mWaiters;
+
+    friend class JobQueue;
+};
+
+} // namespace sead
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mc/seadCoreInfo.h>
+#include <mc/seadJob.h>
+#include <thread/seadCriticalSection.h>
+#include <thread/seadMessageQueue.h>
+#include <thread/seadThread.h>
+#include <thread/seadThreadLocalStorage.h>
+
+namespace sead {
+
+class Heap;
+class Worker;
+
+// Work stealing job system with one Worker per core.
+// Jobs enqueued from a worker go to its own deque, jobs from any other thread go through a shared lock free queue.
+// Idle workers steal from the others and sleep when there is nothing left.
+class JobQueue
+{
+    SEAD_NO_COPY(JobQueue);
+
+public:
+    static const s32 cDefaultDequeSize = 1024;
+    static const s32 cDefaultInjectQueueSize = 1024;
+    static const s32 cDefaultWorkerStackSize = 0x10000;
+    // Empty polls of the queues in wait() before the thread blocks until the counter is done
+    static const s32 cWaitSpinNum = 64;
+    // A blocked worker wakes up this often to run jobs pushed meanwhile, other workers may all be blocked too
+    static const s64 cWorkerWaitMilliSeconds = 1;
+
+public:
+    JobQueue();
+    ~JobQueue();
+
+    // Creates and starts one worker per core in coreMask
+    void initialize(const CoreIdMask& coreMask, Heap* heap, s32 platformPriority = Thread::cDefaultPriority,
+                    s32 stackSize = cDefaultWorkerStackSize, s32 dequeSize = cDefaultDequeSize, s32 injectQueueSize = cDefaultInjectQueueSize);
+    // Every enqueued job must be done
+    void finalize();
+
+    // counter may be null. When dependency is given the job is held back until it is done,
+    // so the jobs of dependency have to be enqueued first
+    void enqueue(Job* job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+    void enqueue(Job** jobs, s32 num, JobCounter* counter = nullptr);
+
+    // Runs enqueued jobs on the calling thread until counter is done, blocks once there is nothing left to run
+    void wait(JobCounter* counter);
+
+    s32 getWorkerNum() const { return mWorkerNum; }
+    Worker* getWorker(s32 index) const;
+    // Returns the worker of the calling thread, or null when called from outside this queue
+    Worker* getCurrentWorker() const { return reinterpret_cast<Worker*>(mWorkerTLS.getValue()); }
+
+protected:
+    void push_(Job* job);
+    Job* acquireJob_(Worker* worker);
+    void execute_(Job* job);
+    void finish_(JobCounter* counter);
+    void block_(JobCounter* counter, Worker* worker);
+    bool hasJob_() const;
+    void wakeupWorker_();
+    void sleepWorker_(Worker* worker);
+
+    friend class Worker;
+
+protected:
+    Worker** mWorkers;
+    s32 mWorkerNum;
+    MessageQueue mInjectQueue;
+    AtomicU32 mSleepingMask;
+    AtomicU32 mIsFinalizing;
+    ThreadLocalStorage mWorkerTLS;
+    CriticalSection mDependencyCS;
+};
+
+} // namespace sead
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mc/seadCoreInfo.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadEvent.h>
+#include <thread/seadThread.h>
+
+namespace sead {
+
+class Job;
+class JobQueue;
+
+// Thread of a JobQueue bound to one core, owns a Chase-Lev deque of jobs.
+// The owner pushes and pops at the bottom, other workers steal from the top.
+class Worker : public Thread
+{
+public:
+    Worker(JobQueue* jobQueue, s32 index, CoreId coreId, s32 dequeSize, Heap* heap, s32 platformPriority, s32 stackSize);
+    ~Worker() override;
+
+    s32 getIndex() const { return mIndex; }
+    CoreId getCoreId() const { return mCoreId; }
+
+protected:
+    void run_() override;
+    void calc_(MessageQueue::Element) override {}
+
+    bool pushJob_(Job* job);
+    Job* popJob_();
+    Job* stealJob_();
+    bool hasJob_() const { return mBottom.getValue() > mTop.getValue(); }
+
+    void wakeup_() { mWakeEvent.setSignal(); }
+
+    friend class JobQueue;
+
+protected:
+    JobQueue* mJobQueue;
+    s32 mIndex;
+    CoreId mCoreId;
+    Event mWakeEvent;
+    AtomicPtr<Job*>* mDeque;
+    s64 mDequeMask;
+    AtomicBase64<s64> mTop;
+    AtomicBase64<s64> mBottom;
+};
+
+} // namespace sead
@@ -3,9 +3,12 @@
 #include <basis/seadAssert.h>
 #include <basis/seadTypes.h>
 
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
 #if defined(SEAD_COMPILER_MSVC)
-#pragma warning(push)
-#pragma warning(disable : 6011)
+#include <cstdlib>
 #endif // SEAD_COMPILER_MSVC
 
 namespace sead {
@@ -20,68 +23,68 @@ public:
     };
 
 public:
-    static u8  swapU8 (u8  x) { return cConvFuncTable.conv8 [1](x); }
-    static u16 swapU16(u16 x) { return cConvFuncTable.conv16[1](x); }
-    static u32 swapU32(u32 x) { return cConvFuncTable.conv32[1](x); }
-    static u64 swapU64(u64 x) { return cConvFuncTable.conv64[1](x); }
+    // Byte swaps fold to a single instruction and to nothing at all when the endianness is known to match
+    static constexpr u8  swapU8 (u8  x) { return x; }
+    static constexpr u16 swapU16(u16 x) { return swap16_(x); }
+    static constexpr u32 swapU32(u32 x) { return swap32_(x); }
+    static constexpr u64 swapU64(u64 x) { return swap64_(x); }
 
-    static s8  swapS8 (s8  x) { return cConvFuncTable.conv8 [1](x); }
-    static s16 swapS16(s16 x) { return cConvFuncTable.conv16[1](x); }
-    static s32 swapS32(s32 x) { return cConvFuncTable.conv32[1](x); }
-    static s64 swapS64(s64 x) { return cConvFuncTable.conv64[1](x); }
+    static constexpr s8  swapS8 (s8  x) { return x; }
+    static constexpr s16 swapS16(s16 x) { return static_cast<s16>(swap16_(static_cast<u16>(x))); }
+    static constexpr s32 swapS32(s32 x) { return static_cast<s32>(swap32_(static_cast<u32>(x))); }
+    static constexpr s64 swapS64(s64 x) { return static_cast<s64>(swap64_(static_cast<u64>(x))); }
 
-    static f32 swapF32(f32 x)
-    {
-        union { u32* ui; f32* f; } x_ = { .f = &x };
-        *x_.ui = cConvFuncTable.conv32[1](*x_.ui);
-        return *x_.f;
-    }
+    static constexpr f32 swapF32(f32 x) { return std::bit_cast<f32>(swap32_(std::bit_cast<u32>(x))); }
 
-    static u8  convertU8 (Types from, Types to, u8  x) { return cConvFuncTable.conv8 [from ^ to](x); }
-    static u16 convertU16(Types from, Types to, u16 x) { return cConvFuncTable.conv16[from ^ to](x); }
-    static u32 convertU32(Types from, Types to, u32 x) { return cConvFuncTable.conv32[from ^ to](x); }
-    static u64 convertU64(Types from, Types to, u64 x) { return cConvFuncTable.conv64[from ^ to](x); }
+    static constexpr u8  convertU8 (Types, Types, u8  x) { return x; }
+    static constexpr u16 convertU16(Types from, Types to, u16 x) { return from == to ? x : swapU16(x); }
+    static constexpr u32 convertU32(Types from, Types to, u32 x) { return from == to ? x : swapU32(x); }
+    static constexpr u64 convertU64(Types from, Types to, u64 x) { return from == to ? x : swapU64(x); }
 
-    static s8  convertS8 (Types from, Types to, s8  x) { return cConvFuncTable.conv8 [from ^ to](x); }
-    static s16 convertS16(Types from, Types to, s16 x) { return cConvFuncTable.conv16[from ^ to](x); }
-    static s32 convertS32(Types from, Types to, s32 x) { return cConvFuncTable.conv32[from ^ to](x); }
-    static s64 convertS64(Types from, Types to, s64 x) { return cConvFuncTable.conv64[from ^ to](x); }
+    static constexpr s8  convertS8 (Types, Types, s8  x) { return x; }
+    static constexpr s16 convertS16(Types from, Types to, s16 x) { return from == to ? x : swapS16(x); }
+    static constexpr s32 convertS32(Types from, Types to, s32 x) { return from == to ? x : swapS32(x); }
+    static constexpr s64 convertS64(Types from, Types to, s64 x) { return from == to ? x : swapS64(x); }
 
     static u32 convertF32(Types from, Types to, const void* x)
     {
-        union { const u32* ui; const f32*  f; } x_ = { .f = static_cast<const f32*>(x) };
-        return cConvFuncTable.conv32[from ^ to](*x_.ui);
+        u32 ui;
+        std::memcpy(&ui, x, sizeof(u32));
+        return convertU32(from, to, ui);
     }
 
-    static u8  toHostU8 (Types from, u8  x) { return convertU8 (from, cHostEndian, x); }
-    static u16 toHostU16(Types from, u16 x) { return convertU16(from, cHostEndian, x); }
-    static u32 toHostU32(Types from, u32 x) { return convertU32(from, cHostEndian, x); }
-    static u64 toHostU64(Types from, u64 x) { return convertU64(from, cHostEndian, x); }
+    // Swaps num elements from src into dst with SIMD where the CPU has it.
+    // dst and src may be the same but must not overlap otherwise, neither needs to be aligned.
+    static void swapArrayU16(void* dst, const void* src, size_t num);
+    static void swapArrayU32(void* dst, const void* src, size_t num);
+    static void swapArrayU64(void* dst, const void* src, size_t num);
+    static void swapArrayF32(void* dst, const void* src, size_t num) { swapArrayU32(dst, src, num); }
 
-    static u8  fromHostU8 (Types to, u8  x) { return convertU8 (cHostEndian, to, x); }
-    static u16 fromHostU16(Types to, u16 x) { return convertU16(cHostEndian, to, x); }
-    static u32 fromHostU32(Types to, u32 x) { return convertU32(cHostEndian, to, x); }
-    static u64 fromHostU64(Types to, u64 x) { return convertU64(cHostEndian, to, x); }
+    static constexpr u8  toHostU8 (Types from, u8  x) { return convertU8 (from, cHostEndian, x); }
+    static constexpr u16 toHostU16(Types from, u16 x) { return convertU16(from, cHostEndian, x); }
+    static constexpr u32 toHostU32(Types from, u32 x) { return convertU32(from, cHostEndian, x); }
+    static constexpr u64 toHostU64(Types from, u64 x) { return convertU64(from, cHostEndian, x); }
 
-    static s8  toHostS8 (Types from, s8  x) { return convertS8 (from, cHostEndian, x); }
-    static s16 toHostS16(Types from, s16 x) { return convertS16(from, cHostEndian, x); }
-    static s32 toHostS32(Types from, s32 x) { return convertS32(from, cHostEndian, x); }
-    static s64 toHostS64(Types from, s64 x) { return convertS64(from, cHostEndian, x); }
+    static constexpr u8  fromHostU8 (Types to, u8  x) { return convertU8 (cHostEndian, to, x); }
+    static constexpr u16 fromHostU16(Types to, u16 x) { return convertU16(cHostEndian, to, x); }
+    static constexpr u32 fromHostU32(Types to, u32 x) { return convertU32(cHostEndian, to, x); }
+    static constexpr u64 fromHostU64(Types to, u64 x) { return convertU64(cHostEndian, to, x); }
 
-    static s8  fromHostS8 (Types to, s8  x) { return convertS8 (cHostEndian, to, x); }
-    static s16 fromHostS16(Types to, s16 x) { return convertS16(cHostEndian, to, x); }
-    static s32 fromHostS32(Types to, s32 x) { return convertS32(cHostEndian, to, x); }
-    static s64 fromHostS64(Types to, s64 x) { return convertS64(cHostEndian, to, x); }
+    static constexpr s8  toHostS8 (Types from, s8  x) { return convertS8 (from, cHostEndian, x); }
+    static constexpr s16 toHostS16(Types from, s16 x) { return convertS16(from, cHostEndian, x); }
+    static constexpr s32 toHostS32(Types from, s32 x) { return convertS32(from, cHostEndian, x); }
+    static constexpr s64 toHostS64(Types from, s64 x) { return convertS64(from, cHostEndian, x); }
 
-    static f32 toHostF32(Types from, const u32* x)
-    {
-        union { u32 ui; f32 f; } x_ = { .ui = convertF32(from, cHostEndian, x) };
-        return x_.f;
-    }
+    static constexpr s8  fromHostS8 (Types to, s8  x) { return convertS8 (cHostEndian, to, x); }
+    static constexpr s16 fromHostS16(Types to, s16 x) { return convertS16(cHostEndian, to, x); }
+    static constexpr s32 fromHostS32(Types to, s32 x) { return convertS32(cHostEndian, to, x); }
+    static constexpr s64 fromHostS64(Types to, s64 x) { return convertS64(cHostEndian, to, x); }
+
+    static f32 toHostF32(Types from, const u32* x) { return std::bit_cast<f32>(convertF32(from, cHostEndian, x)); }
 
     static u32 fromHostF32(Types to, const f32* x) { return convertF32(cHostEndian, to, x); }
 
-    static Types getHostEndian() { return cHostEndian; }
+    static constexpr Types getHostEndian() { return cHostEndian; }
 
     static Types markToEndian(u16 mark)
     {
@@ -102,25 +105,47 @@ public:
     }
 
 private:
-    using CONV8FUNC = u8 (*)(u8);
-    using CONV16FUNC = u16 (*)(u16);
-    using CONV32FUNC = u32 (*)(u32);
-    using CONV64FUNC = u64 (*)(u64);
-
-    struct ConvFuncTable
+    static constexpr u16 swap16_(u16 x)
     {
-        CONV8FUNC conv8[2];
-        CONV16FUNC conv16[2];
-        CONV32FUNC conv32[2];
-        CONV64FUNC conv64[2];
-    };
+#if defined(SEAD_COMPILER_MSVC)
+        if (!std::is_constant_evaluated())
+            return _byteswap_ushort(x);
 
-    static const Types cHostEndian;
-    static const ConvFuncTable cConvFuncTable;
-};
+        return static_cast<u16>(x << 8 | x >> 8);
+#else
+        return __builtin_bswap16(x);
+#endif // SEAD_COMPILER_MSVC
+    }
 
-} // namespace sead
+    static constexpr u32 swap32_(u32 x)
+    {
+#if defined(SEAD_COMPILER_MSVC)
+        if (!std::is_constant_evaluated())
+            return _byteswap_ulong(x);
+
+        return x << 24 | (x & 0xFF00) << 8 | (x >> 8 & 0xFF00) | x >> 24;
+#else
+        return __builtin_bswap32(x);
+#endif // SEAD_COMPILER_MSVC
+    }
 
+    static constexpr u64 swap64_(u64 x)
+    {
 #if defined(SEAD_COMPILER_MSVC)
-#pragma warning(pop)
+        if (!std::is_constant_evaluated())
+            return _byteswap_uint64(x);
+
+        return static_cast<u64>(swap32_(static_cast<u32>(x))) << 32 | swap32_(static_cast<u32>(x >> 32));
+#else
+        return __builtin_bswap64(x);
 #endif // SEAD_COMPILER_MSVC
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static constexpr Types cHostEndian = eBig;
+#else
+    static constexpr Types cHostEndian = eLittle;
+#endif // __BYTE_ORDER__
+};
+
+} // namespace sead
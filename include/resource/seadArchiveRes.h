@@ -0,0 +1,65 @@
+#pragma once
+
+#include <filedevice/seadFileDevice.h>
+#include <resource/seadResource.h>
+
+namespace sead {
+
+// Packed archive of files, the files are handed out as pointers into the archive data.
+// Paths are relative to the archive root and use '/' as the separator.
+class ArchiveRes : public DirectResource
+{
+    SEAD_RTTI_OVERRIDE(ArchiveRes, DirectResource);
+
+public:
+    struct FileInfo
+    {
+        u32 startOffset;
+        u32 length;
+    };
+
+public:
+    ArchiveRes();
+    ~ArchiveRes() override;
+
+    bool isEnable() const
+    {
+        return mEnable;
+    }
+
+    // Returns null when path is not in the archive
+    void* getFile(const SafeString& path, FileInfo* info = nullptr);
+    void* getFileFast(s32 entryID, FileInfo* info = nullptr);
+
+    // Returns -1 when path is not in the archive
+    s32 convertPathToEntryID(const SafeString& path);
+    s32 getFileNum() const;
+
+    bool isExistDirectory(const SafeString& path);
+
+    // The handle is the HandleBuffer of a DirectoryHandle, readDirectory() lists the files and subdirectories of path
+    bool openDirectory(HandleBuffer* handle, const SafeString& path);
+    bool closeDirectory(HandleBuffer* handle);
+    u32 readDirectory(HandleBuffer* handle, DirectoryEntry* entries, u32 num);
+
+protected:
+    void doCreate_(u8* data, u32 size, Heap* instanceHeap) override;
+
+    virtual bool prepareArchive_(const void* archive, u32 size, Heap* heap) = 0;
+    virtual void* getFileImpl_(const SafeString& path, FileInfo* info) = 0;
+    virtual void* getFileFastImpl_(s32 entryID, FileInfo* info) = 0;
+    virtual s32 convertPathToEntryIDImpl_(const SafeString& path) = 0;
+    virtual s32 getFileNumImpl_() const = 0;
+    virtual bool isExistDirectoryImpl_(const SafeString& path) = 0;
+    virtual bool openDirectoryImpl_(HandleBuffer* handle, const SafeString& path) = 0;
+    virtual bool closeDirectoryImpl_(HandleBuffer* handle) = 0;
+    virtual u32 readDirectoryImpl_(HandleBuffer* handle, DirectoryEntry* entries, u32 num) = 0;
+
+    // Drops the leading separators, archives store their paths without them
+    static SafeString trimPath_(const SafeString& path);
+
+protected:
+    bool mEnable;
+};
+
+} // namespace sead
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <prim/seadDelegate.h>
+#include <prim/seadSafeString.h>
+#include <resource/seadResourceMgr.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadMessageQueue.h>
+#include <thread/seadThread.h>
+
+namespace sead {
+
+class AsyncLoadHandle;
+class AsyncResourceLoader;
+class Decompressor;
+
+using AsyncLoadCallback = IDelegate1<AsyncLoadHandle*>;
+
+// Request and result of one asynchronous load, owned by the caller.
+// It must stay alive until isDone() since the loader threads still refer to it before that.
+class AsyncLoadHandle
+{
+    SEAD_NO_COPY(AsyncLoadHandle);
+
+public:
+    enum class State
+    {
+        eIdle = 0,
+        eQueued,
+        eLoading,
+        eLoaded,
+        eFailed,
+        eCancelled
+    };
+
+    enum class Priority
+    {
+        eHigh = 0,
+        eNormal,
+        eLow
+    };
+
+    static const s32 cPriorityNum = 3;
+    static const s32 cPathBufferSize = 256;
+
+public:
+    AsyncLoadHandle();
+    ~AsyncLoadHandle();
+
+    State getState() const { return static_cast<State>(mState.getValue()); }
+    Priority getPriority() const { return mPriority; }
+
+    bool isBusy() const;
+    // The state only becomes final in AsyncResourceLoader::calc()
+    bool isDone() const;
+    bool isSucceeded() const { return getState() == State::eLoaded; }
+
+    // The resource belongs to the caller once loaded
+    ResourcePtr getResource() const { return mResource; }
+
+    // Queued requests are skipped, a resource loaded after the cancel is unloaded again
+    void cancel() { mIsCancelRequested.setValue(1); }
+    bool isCancelRequested() const { return mIsCancelRequested.getValue() != 0; }
+
+protected:
+    void load_();
+
+    friend class AsyncResourceLoader;
+
+protected:
+    FixedSafeString<cPathBufferSize> mPath;
+    FixedSafeString<32> mConvertExt;
+    ResourceMgr::LoadArg mArg;
+    Decompressor* mDecomp;
+    bool mIsUseDecomp;
+    Priority mPriority;
+    AsyncLoadCallback* mCallback;
+    Resource* mResource;
+    AtomicU32 mState;
+    AtomicU32 mIsCancelRequested;
+};
+
+// Pool of loader threads running ResourceMgr::tryLoad() in the background.
+// Several requests are in flight at once, so the file read of one overlaps the decompression and creation of others.
+// Finished requests are handed back through calc(), which also invokes their callbacks on the calling thread.
+class AsyncResourceLoader
+{
+    SEAD_NO_COPY(AsyncResourceLoader);
+
+public:
+    static const s32 cDefaultQueueSize = 256;
+    static const s32 cDefaultStackSize = 0x10000;
+
+public:
+    AsyncResourceLoader();
+    ~AsyncResourceLoader();
+
+    void initialize(Heap* heap, s32 threadNum, s32 queueSize = cDefaultQueueSize, s32 platformPriority = Thread::cDefaultPriority,
+                    s32 stackSize = cDefaultStackSize);
+    // Waits for the requests being loaded, the remaining ones are cancelled
+    void finalize();
+
+    bool isInitialized() const { return mThreads != nullptr; }
+
+    bool requestLoad(AsyncLoadHandle* handle, const ResourceMgr::LoadArg& arg,
+                     AsyncLoadHandle::Priority priority = AsyncLoadHandle::Priority::eNormal, AsyncLoadCallback* callback = nullptr);
+
+    // Same as ResourceMgr::tryLoad(), decomp may be null to look it up from the extension
+    bool requestLoadWithDecomp(AsyncLoadHandle* handle, const ResourceMgr::LoadArg& arg, const SafeString& convertExt, Decompressor* decomp,
+                               AsyncLoadHandle::Priority priority = AsyncLoadHandle::Priority::eNormal, AsyncLoadCallback* callback = nullptr);
+
+    // Finishes up to maxNum completed requests and invokes their callbacks, call once per frame.
+    // Returns the number of finished requests.
+    s32 calc(s32 maxNum = -1);
+
+    s32 getThreadNum() const { return mThreadNum; }
+    s32 getRequestNum() const { return static_cast<s32>(mRequestNum.getValue()); }
+
+protected:
+    class LoaderThread : public Thread
+    {
+    public:
+        LoaderThread(AsyncResourceLoader* loader, Heap* heap, s32 platformPriority, s32 stackSize);
+
+    protected:
+        void run_() override;
+        void calc_(MessageQueue::Element) override {}
+
+    protected:
+        AsyncResourceLoader* mLoader;
+        Heap* mHeap;
+    };
+
+    static const MessageQueue::Element cRequestMsg = 1;
+    static const MessageQueue::Element cQuitMsg = 2;
+
+    bool request_(AsyncLoadHandle* handle, const ResourceMgr::LoadArg& arg, AsyncLoadHandle::Priority priority, AsyncLoadCallback* callback);
+    AsyncLoadHandle* popRequest_();
+    void finish_(AsyncLoadHandle* handle);
+
+protected:
+    LoaderThread** mThreads;
+    s32 mThreadNum;
+    MessageQueue mRequestQueue[AsyncLoadHandle::cPriorityNum];
+    MessageQueue mWakeQueue;
+    MessageQueue mDoneQueue;
+    AtomicU32 mRequestNum;
+    s32 mRequestNumMax;
+};
+
+} // namespace sead
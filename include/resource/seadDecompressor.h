@@ -4,6 +4,8 @@
 
 namespace sead {
 
+class FileHandle;
+
 class Decompressor : public TListNode<Decompressor*>, IDisposer
 {
 public:
@@ -35,6 +37,15 @@ public:
         mExt.copy(ext);
     }
 
+protected:
+    FileDevice* tryOpen_(FileHandle* handle, const ResourceMgr::LoadArg& arg) const;
+    // Returns load_data_buffer when set, otherwise a buffer from load_data_heap aligned like DirectResourceFactoryBase::tryCreate()
+    // does, dataAlignment is the alignment stored in the file and comes first when not zero
+    u8* tryAllocLoadData_(u32* outBufferSize, bool* outNeedDelete, const ResourceMgr::LoadArg& arg, Resource* res, u32 decompSize,
+                          u32 dataAlignment) const;
+    // Taken from the other end of load_data_heap so it does not split the free space around the load data
+    u8* tryAllocWork_(const ResourceMgr::LoadArg& arg, u32 size) const;
+
 protected:
     FixedSafeString<32> mExt;
 };
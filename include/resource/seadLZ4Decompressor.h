@@ -0,0 +1,82 @@
+#pragma once
+
+#include <resource/seadDecompressor.h>
+#include <thread/seadAtomic.h>
+#include <thread/seadCriticalSection.h>
+#include <time/seadTickSpan.h>
+
+namespace sead {
+
+class JobQueue;
+
+// Decompressor for LZ4 frames, registered under "lz4" by default.
+// The frame has to carry its content size (lz4 --content-size) so the destination can be allocated up front, dictionaries
+// are not supported and checksums are skipped without being verified.
+// The file is read one block at a time and each block is decoded straight into the destination. With a JobQueue set,
+// frames of independent blocks are read a batch of blocks at a time and the blocks of a batch are decoded in parallel.
+class LZ4Decompressor : public Decompressor
+{
+public:
+    struct FrameInfo
+    {
+        u64 contentSize;
+        u32 blockMaxSize;
+        u32 headerSize;
+        bool hasContentSize;
+        bool isBlockIndependent;
+        bool hasBlockChecksum;
+        bool hasContentChecksum;
+    };
+
+    static const u32 cMagic = 0x184D2204;
+    static const u32 cFrameHeaderSizeMin = 7;
+    static const u32 cFrameHeaderSizeMax = 19;
+    static const u32 cDefaultWorkSize = 64 * 1024;
+    static const s32 cDefaultBatchNumMax = 8;
+
+    static const s32 cErrorInvalidHeader = -1;
+    static const s32 cErrorInvalidData = -2;
+
+public:
+    // The work buffer has to hold a whole block, a buffer of the block size is allocated for each load when workBuffer is
+    // null, the frame has larger blocks than workSize or another load is using it
+    explicit LZ4Decompressor(u32 workSize = cDefaultWorkSize, u8* workBuffer = nullptr);
+
+    u8* tryDecompFromDevice(const ResourceMgr::LoadArg& arg, Resource* res, u32* outSize, u32* outBufferSize, bool* outNeedDelete) override;
+
+    // Blocks are decoded on the calling thread when null
+    void setJobQueue(JobQueue* queue) { mJobQueue = queue; }
+    JobQueue* getJobQueue() const { return mJobQueue; }
+
+    // Upper bound of the blocks read and decoded at once, the work buffer of a load takes up to this many blocks
+    void setBatchNumMax(s32 num) { mBatchNumMax = num; }
+    s32 getBatchNumMax() const { return mBatchNumMax; }
+
+    // Totals of the successful loads since the last resetStats(), the time covers reading as well as decoding
+    u64 getTotalDecompSize() const { return mTotalDecompSize.getValue(); }
+    TickSpan getTotalDecompTime() const { return TickSpan(static_cast<s64>(mTotalDecompTick.getValue())); }
+    // Decompressed bytes per second
+    f64 calcThroughput() const;
+    void resetStats();
+
+    // Returns false when src does not start with a complete and supported frame header
+    static bool parseFrameHeader(FrameInfo* info, const void* src, u32 srcSize);
+
+    // Decodes one compressed block. Returns the decompressed size or one of the negative error codes.
+    static s32 decompBlock(void* dst, u32 dstSize, const void* src, u32 srcSize);
+
+    // Decodes a frame held in memory as a whole.
+    // Returns the decompressed size or one of the negative error codes.
+    static s32 decomp(void* dst, u32 dstSize, const void* src, u32 srcSize);
+
+protected:
+    u32 mWorkSize;
+    u8* mWorkBuffer;
+    CriticalSection mWorkBufferCS;
+    JobQueue* mJobQueue;
+    s32 mBatchNumMax;
+    AtomicU64 mTotalDecompSize;
+    AtomicU64 mTotalDecompTick;
+};
+
+} // namespace sead
@@ -7,6 +7,7 @@
 
 namespace sead {
 
+class FileDevice;
 class Heap;
 class ReadStream;
 
@@ -38,6 +39,28 @@ public:
     }
 
     void create(u8* data, u32 size, u32 bufferSize, bool needDelete, Heap* instanceHeap);
+    // data is a read only mapping owned by mapDevice, it is unmapped when the resource is destroyed
+    void createOnMap(u8* data, u32 size, u32 bufferSize, FileDevice* mapDevice, Heap* instanceHeap);
+
+    bool isMapped() const
+    {
+        return mMapDevice != nullptr;
+    }
+
+    u8* getRawData() const
+    {
+        return mRawData;
+    }
+
+    u32 getRawSize() const
+    {
+        return mRawSize;
+    }
+
+    u32 getBufferSize() const
+    {
+        return mBufferSize;
+    }
 
 protected:
     virtual void doCreate_(u8* data, u32 size, Heap* instanceHeap)
@@ -52,6 +75,7 @@ protected:
     u32 mRawSize;
     u32 mBufferSize;
     BitFlag32 mSettingFlag;
+    FileDevice* mMapDevice;
 };
 
 class IndirectResource : public Resource
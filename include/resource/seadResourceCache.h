@@ -0,0 +1,194 @@
+#pragma once
+
+#include <container/seadHashMap.h>
+#include <container/seadTList.h>
+#include <heap/seadDisposer.h>
+#include <hostio/seadHostIONode.h>
+#include <resource/seadResourceMgr.h>
+#include <thread/seadCriticalSection.h>
+
+namespace sead {
+
+// Shares the resources loaded by ResourceMgr between loads of the same file.
+// Resources are keyed by normalized path, factory, device, decompressor and the heaps and alignment they were loaded
+// with. Every load hands out a new reference and
+// ResourceMgr::unload() drops one, a resource nobody refers to stays cached until it is evicted.
+// Only loads on heaps given a budget with setBudget() are cached. Resources are charged to the heap with the size of
+// their load buffer, and the unreferenced ones are evicted least recently used first while the heap is over budget.
+class ResourceCache : public hostio::Node
+{
+    SEAD_NO_COPY(ResourceCache);
+
+public:
+    static const s32 cPathBufferSize = 256;
+    static const s32 cHeapBudgetMax = 16;
+
+public:
+    ResourceCache();
+    virtual ~ResourceCache();
+
+    void initialize(Heap* heap, s32 entryMax);
+    // Unreferenced resources are unloaded, referenced ones are handed over to their owners
+    void finalize();
+
+    bool isInitialized() const { return mEntries != nullptr; }
+
+    // A budget of zero stops caching loads on heap
+    bool setBudget(Heap* heap, size_t budget);
+    size_t getBudget(const Heap* heap) const;
+    size_t getUsedSize(const Heap* heap) const;
+
+    // Unloads every unreferenced resource
+    void purge();
+
+    s32 getEntryNum() const { return mEntryMap.size(); }
+    s32 getEntryMax() const { return mEntryMax; }
+
+    u64 getHitNum() const { return mHitNum; }
+    u64 getMissNum() const { return mMissNum; }
+    u64 getEvictNum() const { return mEvictNum; }
+    // Sum of the sizes of the resources found in the cache instead of being loaded again
+    u64 getSavedSize() const { return mSavedSize; }
+    f32 calcHitRate() const;
+    void resetStats();
+
+    void initHostIO();
+
+#if defined(SEAD_TARGET_DEBUG)
+    void listenPropertyEvent(const hostio::PropertyEvent* ev) override;
+    void genMessage(hostio::Context* context) override;
+#endif // SEAD_TARGET_DEBUG
+
+protected:
+    struct Key
+    {
+        const char* path;
+        ResourceFactory* factory;
+        FileDevice* device;
+        Decompressor* decomp;
+        Heap* instanceHeap;
+        Heap* loadDataHeap;
+        s32 loadDataAlignment;
+    };
+
+    // Keys in the map point to the path of their entry
+    struct KeyTraits
+    {
+        using KeyType = Key;
+        using ArgType = Key;
+
+        static u32 calcHash(const Key& key);
+        static bool isEqual(const Key& key, const Key& arg);
+
+        static void construct(Key* key, const Key& arg)
+        {
+            new(key) Key(arg);
+        }
+
+        static const Key& getArg(const Key& key)
+        {
+            return key;
+        }
+    };
+
+    struct HeapBudget;
+
+    struct Entry
+    {
+        Entry()
+            : path()
+            , factory(nullptr)
+            , device(nullptr)
+            , decomp(nullptr)
+            , loadDataHeap(nullptr)
+            , loadDataAlignment(0)
+            , resource(nullptr)
+            , budget(nullptr)
+            , refCount(0)
+            , size(0)
+            , listNode(this)
+        {
+        }
+
+        Key getKey() const;
+
+        FixedSafeString<cPathBufferSize> path;
+        ResourceFactory* factory;
+        FileDevice* device;
+        Decompressor* decomp;
+        Heap* loadDataHeap;
+        s32 loadDataAlignment;
+        Resource* resource;
+        HeapBudget* budget;
+        s32 refCount;
+        size_t size;
+        // Links the entry in the free list or in the LRU list of its heap when unreferenced
+        TListNode<Entry*> listNode;
+    };
+
+    // Lives in the heap it watches, so the cached resources are dropped when the heap is destroyed
+    class HeapDisposer : public IDisposer
+    {
+    public:
+        HeapDisposer(ResourceCache* cache, Heap* heap);
+        ~HeapDisposer() override;
+
+    protected:
+        ResourceCache* mCache;
+        Heap* mHeap;
+
+        friend class ResourceCache;
+    };
+
+    struct HeapBudget
+    {
+        HeapBudget()
+            : heap(nullptr)
+            , budget(0)
+            , usedSize(0)
+            , disposer(nullptr)
+            , lruList()
+        {
+        }
+
+        Heap* heap;
+        size_t budget;
+        size_t usedSize;
+        HeapDisposer* disposer;
+        // Unreferenced entries, least recently used first
+        TList<Entry*> lruList;
+    };
+
+    friend class ResourceMgr;
+
+    // Returns a new reference to the cached resource, null when it has to be loaded
+    Resource* tryObtain_(const ResourceMgr::LoadArg& arg, ResourceFactory* factory, Decompressor* decomp);
+    // Caches a freshly loaded resource, returns the one to hand out which is a cached one if another load finished first
+    Resource* add_(const ResourceMgr::LoadArg& arg, ResourceFactory* factory, Decompressor* decomp, Resource* resource);
+    // Drops a reference, false when resource is not cached
+    bool release_(Resource* resource);
+
+    bool makeKey_(Key* key, BufferedSafeString* path, const ResourceMgr::LoadArg& arg, ResourceFactory* factory,
+                  Decompressor* decomp) const;
+    HeapBudget* findBudget_(const Heap* heap);
+    const HeapBudget* findBudget_(const Heap* heap) const;
+    void evict_(HeapBudget* budget, size_t limit);
+    // Removes the entries of budget and frees it, unreferenced resources are unloaded
+    void removeBudget_(HeapBudget* budget);
+    void removeEntry_(Entry* entry);
+
+protected:
+    Entry* mEntries;
+    s32 mEntryMax;
+    TList<Entry*> mFreeEntryList;
+    HashMapImpl<KeyTraits, Entry*> mEntryMap;
+    HashMap<Resource*, Entry*> mResourceMap;
+    HeapBudget mBudgets[cHeapBudgetMax];
+    CriticalSection mCS;
+    u64 mHitNum;
+    u64 mMissNum;
+    u64 mEvictNum;
+    u64 mSavedSize;
+};
+
+} // namespace sead
@@ -6,9 +6,11 @@
 
 namespace sead {
 
+class AsyncResourceLoader;
 class Decompressor;
 class FileDevice;
 class Resource;
+class ResourceCache;
 class ResourceFactory;
 
 class ResourcePtr
@@ -58,6 +60,8 @@ public:
         FileDevice* device;
         u32 div_size;
         bool enable_alloc_assert;
+        // DirectResource is created on top of a read only mapping of the file when the device supports it
+        bool use_map;
     };
 
     struct CreateArg
@@ -100,6 +104,7 @@ public:
 
     ResourcePtr tryLoad(const LoadArg& arg, const SafeString& convertExt, Decompressor* decomp);
 
+    // Cached resources are only unloaded once the last reference is dropped and they get evicted
     void unload(Resource* resource);
 
     void registerFactory(ResourceFactory* factory, const SafeString& extName);
@@ -116,11 +121,26 @@ public:
     // void postCreate();
     ResourcePtr create(const CreateArg& arg);
 
+    // Starts threadNum loader threads for AsyncResourceLoader::requestLoad()
+    void initializeAsyncLoader(Heap* heap, s32 threadNum);
+    void finalizeAsyncLoader();
+    AsyncResourceLoader* getAsyncLoader() const { return mAsyncLoader; }
+
+    // Loads of the same file share one resource while cached, see ResourceCache
+    void initializeCache(Heap* heap, s32 entryMax);
+    void finalizeCache();
+    ResourceCache* getCache() const { return mCache; }
+
+protected:
+    Resource* tryCreate_(const LoadArg& arg, ResourceFactory* factory, Decompressor* decomp);
+
 protected:
     FactoryList mFactoryList;
     DecompressorList mDecompList;
     ResourceFactory* mNullResourceFactory;
     ResourceFactory* mDefaultResourceFactory;
+    AsyncResourceLoader* mAsyncLoader;
+    ResourceCache* mCache;
 };
 
 } // namespace sead
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <resource/seadDecompressor.h>
+#include <thread/seadCriticalSection.h>
+
+namespace sead {
+
+// Decompressor for Yaz0 compressed files, registered under "szs" by default.
+// The file is read through a small work buffer in chunks of LoadArg::div_size (the whole work buffer when zero) and each
+// chunk is decoded straight into the destination before the next is read, so the compressed file is never held in
+// memory as a whole.
+class SZSDecompressor : public Decompressor
+{
+public:
+    // Decoder state carried over from one chunk of compressed data to the next
+    struct DecompContext
+    {
+        DecompContext();
+        explicit DecompContext(void* dst);
+
+        void initialize(void* dst);
+
+        u8* dst;
+        u32 destSize;
+        u32 destPos;
+        u32 headerSize;
+        u8 header[16];
+        u8 flags;
+        u8 flagMask;
+        // Bytes of the back reference read so far, 0 when not inside one
+        u8 step;
+        u8 packHigh;
+        u8 packLow;
+    };
+
+    static const u32 cHeaderSize = 16;
+    static const u32 cDefaultWorkSize = 16 * 1024;
+
+    static const s32 cErrorInvalidHeader = -1;
+    static const s32 cErrorInvalidData = -2;
+
+public:
+    // workBuffer has to be at least workSize bytes, a work buffer is allocated for each load when it is null or another
+    // load is using it
+    explicit SZSDecompressor(u32 workSize = cDefaultWorkSize, u8* workBuffer = nullptr);
+
+    u8* tryDecompFromDevice(const ResourceMgr::LoadArg& arg, Resource* res, u32* outSize, u32* outBufferSize, bool* outNeedDelete) override;
+
+    // src has to hold at least the cHeaderSize bytes of the header, they return zero for anything but Yaz0 data
+    static u32 getDecompSize(const void* src);
+    static u32 getDecompAlignment(const void* src);
+
+    // Decodes the next srcSize bytes of the compressed data, the first call with the header included.
+    // context->dst has to hold getDecompSize() bytes by the time the header is complete.
+    // Returns the number of bytes left to decode, zero once done, or one of the negative error codes.
+    static s32 streamDecomp(DecompContext* context, const void* src, u32 srcSize);
+
+    // Decodes a compressed file held in memory as a whole.
+    // Returns the decompressed size or one of the negative error codes.
+    static s32 decomp(void* dst, u32 dstSize, const void* src, u32 srcSize);
+
+protected:
+    u32 mWorkSize;
+    u8* mWorkBuffer;
+    CriticalSection mWorkBufferCS;
+};
+
+} // namespace sead
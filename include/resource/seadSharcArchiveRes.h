@@ -0,0 +1,106 @@
+#pragma once
+
+#include <container/seadPtrArray.h>
+#include <prim/seadEndian.h>
+#include <resource/seadArchiveRes.h>
+
+namespace sead {
+
+// SARC archive of either byte order.
+// Files are looked up by binary search in the name hash table, which the format keeps sorted. Directories are not part
+// of the format, they are listed from a table of the file names sorted by name, built when the archive is created.
+class SharcArchiveRes : public ArchiveRes
+{
+    SEAD_RTTI_OVERRIDE(SharcArchiveRes, ArchiveRes);
+
+public:
+    struct ArchiveBlockHeader
+    {
+        u32 signature;
+        u16 header_size;
+        u16 byte_order;
+        u32 file_size;
+        u32 data_block_offset;
+        u16 version;
+        u16 reserved;
+    };
+
+    struct FATBlockHeader
+    {
+        u32 signature;
+        u16 header_size;
+        u16 file_num;
+        u32 hash_key;
+    };
+
+    struct FATEntry
+    {
+        u32 hash;
+        // Upper 8 bits are non zero when the file has a name, lower 24 bits are its offset in the name table in words
+        u32 name_offset;
+        u32 data_start_offset;
+        u32 data_end_offset;
+    };
+
+    struct FNTBlockHeader
+    {
+        u32 signature;
+        u16 header_size;
+        u16 reserved;
+    };
+
+    static const u32 cArchiveVersion = 0x0100;
+    static const u32 cDefaultHashKey = 0x65;
+
+public:
+    SharcArchiveRes();
+    ~SharcArchiveRes() override;
+
+    s32 getLoadDataAlignment() const override
+    {
+        return 0x80;
+    }
+
+    static u32 calcHash(const SafeString& path, u32 key);
+
+protected:
+    bool prepareArchive_(const void* archive, u32 size, Heap* heap) override;
+    void* getFileImpl_(const SafeString& path, FileInfo* info) override;
+    void* getFileFastImpl_(s32 entryID, FileInfo* info) override;
+    s32 convertPathToEntryIDImpl_(const SafeString& path) override;
+    s32 getFileNumImpl_() const override;
+    bool isExistDirectoryImpl_(const SafeString& path) override;
+    bool openDirectoryImpl_(HandleBuffer* handle, const SafeString& path) override;
+    bool closeDirectoryImpl_(HandleBuffer* handle) override;
+    u32 readDirectoryImpl_(HandleBuffer* handle, DirectoryEntry* entries, u32 num) override;
+
+    u32 toHost_(u32 x) const
+    {
+        return Endian::toHostU32(mEndianType, x);
+    }
+
+    u16 toHost_(u16 x) const
+    {
+        return Endian::toHostU16(mEndianType, x);
+    }
+
+    const char* getName_(const FATEntry& entry) const;
+    // Index of the first name in mSortedNames not ordered before prefix
+    s32 findFirstName_(const char* prefix, s32 prefixLen) const;
+    // Index of the first name in mSortedNames after the ones starting with prefix
+    s32 findEndName_(const char* prefix, s32 prefixLen) const;
+    // Range of the names in the directory, false when there is none
+    bool findDirectory_(s32* start, s32* end, s32* prefixLen, const SafeString& path) const;
+
+protected:
+    const ArchiveBlockHeader* mArchiveBlockHeader;
+    const FATBlockHeader* mFATBlockHeader;
+    const FATEntry* mFATEntries;
+    const char* mFNTBlock;
+    u32 mFNTBlockSize;
+    const u8* mDataBlock;
+    Endian::Types mEndianType;
+    PtrArray<char> mSortedNames;
+};
+
+} // namespace sead
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <resource/seadDecompressor.h>
+#include <thread/seadAtomic.h>
+#include <time/seadTickSpan.h>
+
+namespace sead {
+
+class JobQueue;
+
+// Decompressor for Zstandard files, registered under "zs" by default.
+// Every frame has to carry its content size (the default of the zstd tool) so the destination can be allocated up front,
+// skippable frames are ignored and dictionaries are not supported.
+// Frame boundaries are only known once the data is read, so the compressed file is read as a whole in chunks of
+// LoadArg::div_size before decoding. With a JobQueue set, files made of several independent frames (pzstd output or
+// concatenated files) have a batch of frames decoded in parallel.
+class ZstdDecompressor : public Decompressor
+{
+public:
+    static const s32 cDefaultBatchNumMax = 8;
+
+    static const s32 cErrorInvalidHeader = -1;
+    static const s32 cErrorInvalidData = -2;
+
+public:
+    ZstdDecompressor();
+
+    u8* tryDecompFromDevice(const ResourceMgr::LoadArg& arg, Resource* res, u32* outSize, u32* outBufferSize, bool* outNeedDelete) override;
+
+    // Frames are decoded on the calling thread when null
+    void setJobQueue(JobQueue* queue) { mJobQueue = queue; }
+    JobQueue* getJobQueue() const { return mJobQueue; }
+
+    // Upper bound of the frames decoded at once, each of them takes a decoder context from load_data_heap
+    void setBatchNumMax(s32 num) { mBatchNumMax = num; }
+    s32 getBatchNumMax() const { return mBatchNumMax; }
+
+    // Totals of the successful loads since the last resetStats(), the time covers reading as well as decoding
+    u64 getTotalDecompSize() const { return mTotalDecompSize.getValue(); }
+    TickSpan getTotalDecompTime() const { return TickSpan(static_cast<s64>(mTotalDecompTick.getValue())); }
+    // Decompressed bytes per second
+    f64 calcThroughput() const;
+    void resetStats();
+
+    // Returns the sum of the content sizes of the frames in src, zero when a frame is broken or has no content size
+    static u32 getDecompSize(const void* src, u32 srcSize);
+
+    // Decodes data held in memory as a whole on the calling thread, the decoder context is allocated from heap.
+    // Returns the decompressed size or one of the negative error codes.
+    static s32 decomp(void* dst, u32 dstSize, const void* src, u32 srcSize, Heap* heap);
+
+protected:
+    JobQueue* mJobQueue;
+    s32 mBatchNumMax;
+    AtomicU64 mTotalDecompSize;
+    AtomicU64 mTotalDecompTick;
+};
+
+} // namespace sead
@@ -16,6 +16,15 @@ public:
     s32 readS32(StreamSrc* src, Endian::Types endian) override;
     s64 readS64(StreamSrc* src, Endian::Types endian) override;
     f32 readF32(StreamSrc* src, Endian::Types endian) override;
+    void readU8Array(StreamSrc* src, Endian::Types endian, u8* dst, u32 num) override;
+    void readU16Array(StreamSrc* src, Endian::Types endian, u16* dst, u32 num) override;
+    void readU32Array(StreamSrc* src, Endian::Types endian, u32* dst, u32 num) override;
+    void readU64Array(StreamSrc* src, Endian::Types endian, u64* dst, u32 num) override;
+    void readS8Array(StreamSrc* src, Endian::Types endian, s8* dst, u32 num) override;
+    void readS16Array(StreamSrc* src, Endian::Types endian, s16* dst, u32 num) override;
+    void readS32Array(StreamSrc* src, Endian::Types endian, s32* dst, u32 num) override;
+    void readS64Array(StreamSrc* src, Endian::Types endian, s64* dst, u32 num) override;
+    void readF32Array(StreamSrc* src, Endian::Types endian, f32* dst, u32 num) override;
     void readBit(StreamSrc* src, void* data, u32 bitnum) override;
     void readString(StreamSrc* src, BufferedSafeString* dst, u32 size) override;
     u32 readMemBlock(StreamSrc* src, void* dst, u32 size) override;
@@ -28,6 +37,15 @@ public:
     void writeS32(StreamSrc* src, Endian::Types endian, s32 value) override;
     void writeS64(StreamSrc* src, Endian::Types endian, s64 value) override;
     void writeF32(StreamSrc* src, Endian::Types endian, f32 value) override;
+    void writeU8Array(StreamSrc* src, Endian::Types endian, const u8* values, u32 num) override;
+    void writeU16Array(StreamSrc* src, Endian::Types endian, const u16* values, u32 num) override;
+    void writeU32Array(StreamSrc* src, Endian::Types endian, const u32* values, u32 num) override;
+    void writeU64Array(StreamSrc* src, Endian::Types endian, const u64* values, u32 num) override;
+    void writeS8Array(StreamSrc* src, Endian::Types endian, const s8* values, u32 num) override;
+    void writeS16Array(StreamSrc* src, Endian::Types endian, const s16* values, u32 num) override;
+    void writeS32Array(StreamSrc* src, Endian::Types endian, const s32* values, u32 num) override;
+    void writeS64Array(StreamSrc* src, Endian::Types endian, const s64* values, u32 num) override;
+    void writeF32Array(StreamSrc* src, Endian::Types endian, const f32* values, u32 num) override;
     void writeBit(StreamSrc* src, const void* data, u32 bitnum) override;
     void writeString(StreamSrc* src, const SafeString& str, u32 size) override;
     void writeMemBlock(StreamSrc* src, const void* data, u32 size) override;
@@ -18,6 +18,7 @@ public:
     void rewind() override;
     bool isEOF() override { return mStreamSrc->isEOF(); }
     bool flush() override;
+    void* writeDirect(u32 size) override;
 
 protected:
     StreamSrc* mStreamSrc;
@@ -36,6 +37,8 @@ public:
     }
 
     u32 write(const void* src, u32 size) override;
+    // Direct writes could split multi byte characters
+    void* writeDirect(u32) override { return nullptr; }
 };
 
 class BufferMultiByteNullTerminatedTextWriteStreamSrc : public BufferMultiByteTextWriteStreamSrc
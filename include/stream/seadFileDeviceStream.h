@@ -25,10 +25,10 @@ public:
 
 protected:
     FileHandle* mHandle;
-    u32 mBeginPos;
+    u64 mBeginPos;
     FileHandle mHandleTemp;
     bool mNeedClose;
-    u32 mFileSize;
+    u64 mFileSize;
 };
 
 class FileDeviceReadStream : public ReadStream
@@ -16,6 +16,8 @@ public:
     u32 skip(s32 byte) override;
     void rewind() override { mCurPos = 0; }
     bool isEOF() override { return mCurPos >= mSize; }
+    const void* readDirect(u32 size) override;
+    void* writeDirect(u32 size) override;
 
     u8* getCurrentAddres() const { return mStartAddr + mCurPos; }
     u32 getCurrentPosition() const { return mCurPos; }
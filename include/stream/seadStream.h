@@ -133,6 +133,16 @@ public:
     f32 readF32();
     void readF32(f32& dst);
 
+    void readU8Array(u8* dst, u32 num);
+    void readU16Array(u16* dst, u32 num);
+    void readU32Array(u32* dst, u32 num);
+    void readU64Array(u64* dst, u32 num);
+    void readS8Array(s8* dst, u32 num);
+    void readS16Array(s16* dst, u32 num);
+    void readS32Array(s32* dst, u32 num);
+    void readS64Array(s64* dst, u32 num);
+    void readF32Array(f32* dst, u32 num);
+
     void readBit(void* dst, u32 bitnum);
     void readString(BufferedSafeString* dst, u32 size);
     u32 readMemBlock(void* dst, u32 size);
@@ -183,6 +193,16 @@ public:
 
     void writeF32(f32 value);
 
+    void writeU8Array(const u8* values, u32 num);
+    void writeU16Array(const u16* values, u32 num);
+    void writeU32Array(const u32* values, u32 num);
+    void writeU64Array(const u64* values, u32 num);
+    void writeS8Array(const s8* values, u32 num);
+    void writeS16Array(const s16* values, u32 num);
+    void writeS32Array(const s32* values, u32 num);
+    void writeS64Array(const s64* values, u32 num);
+    void writeF32Array(const f32* values, u32 num);
+
     void writeBit(const void* src, u32 bitnum);
     void writeString(const SafeString& src, u32 size);
     void writeMemBlock(const void* src, u32 size);
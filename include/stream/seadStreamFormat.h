@@ -20,6 +20,16 @@ public:
     virtual s32 readS32(StreamSrc* src, Endian::Types endian) = 0;
     virtual s64 readS64(StreamSrc* src, Endian::Types endian) = 0;
     virtual f32 readF32(StreamSrc* src, Endian::Types endian) = 0;
+    // Array variants default to one scalar call per element
+    virtual void readU8Array(StreamSrc* src, Endian::Types endian, u8* dst, u32 num);
+    virtual void readU16Array(StreamSrc* src, Endian::Types endian, u16* dst, u32 num);
+    virtual void readU32Array(StreamSrc* src, Endian::Types endian, u32* dst, u32 num);
+    virtual void readU64Array(StreamSrc* src, Endian::Types endian, u64* dst, u32 num);
+    virtual void readS8Array(StreamSrc* src, Endian::Types endian, s8* dst, u32 num);
+    virtual void readS16Array(StreamSrc* src, Endian::Types endian, s16* dst, u32 num);
+    virtual void readS32Array(StreamSrc* src, Endian::Types endian, s32* dst, u32 num);
+    virtual void readS64Array(StreamSrc* src, Endian::Types endian, s64* dst, u32 num);
+    virtual void readF32Array(StreamSrc* src, Endian::Types endian, f32* dst, u32 num);
     virtual void readBit(StreamSrc* src, void* data, u32 bitnum) = 0;
     virtual void readString(StreamSrc* src, BufferedSafeString* dst, u32 size) = 0;
     virtual u32 readMemBlock(StreamSrc* src, void* dst, u32 size) = 0;
@@ -32,6 +42,15 @@ public:
     virtual void writeS32(StreamSrc* src, Endian::Types endian, s32 value) = 0;
     virtual void writeS64(StreamSrc* src, Endian::Types endian, s64 value) = 0;
     virtual void writeF32(StreamSrc* src, Endian::Types endian, f32 value) = 0;
+    virtual void writeU8Array(StreamSrc* src, Endian::Types endian, const u8* values, u32 num);
+    virtual void writeU16Array(StreamSrc* src, Endian::Types endian, const u16* values, u32 num);
+    virtual void writeU32Array(StreamSrc* src, Endian::Types endian, const u32* values, u32 num);
+    virtual void writeU64Array(StreamSrc* src, Endian::Types endian, const u64* values, u32 num);
+    virtual void writeS8Array(StreamSrc* src, Endian::Types endian, const s8* values, u32 num);
+    virtual void writeS16Array(StreamSrc* src, Endian::Types endian, const s16* values, u32 num);
+    virtual void writeS32Array(StreamSrc* src, Endian::Types endian, const s32* values, u32 num);
+    virtual void writeS64Array(StreamSrc* src, Endian::Types endian, const s64* values, u32 num);
+    virtual void writeF32Array(StreamSrc* src, Endian::Types endian, const f32* values, u32 num);
     virtual void writeBit(StreamSrc* src, const void* data, u32 bitnum) = 0;
     virtual void writeString(StreamSrc* src, const SafeString& str, u32 size) = 0;
     virtual void writeMemBlock(StreamSrc* src, const void* data, u32 size) = 0;
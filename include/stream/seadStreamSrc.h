@@ -13,6 +13,11 @@ public:
     virtual void rewind() = 0;
     virtual bool isEOF() = 0;
     virtual bool flush() { return true; }
+
+    // Memory backed sources return the address of the next size bytes and move past them,
+    // null means the data has to go through read/write
+    virtual const void* readDirect(u32) { return nullptr; }
+    virtual void* writeDirect(u32) { return nullptr; }
 };
 
 } // namespace sead
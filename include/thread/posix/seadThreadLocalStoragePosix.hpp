@@ -12,6 +12,13 @@ inline ThreadLocalStorage::ThreadLocalStorage()
     SEAD_ASSERT_MSG(ret == 0, "pthread_key_create failed");
 }
 
+inline ThreadLocalStorage::ThreadLocalStorage(DestructFunc destructFunc)
+    : mPthreadKey(0)
+{
+    s32 ret = pthread_key_create(&mPthreadKey, destructFunc);
+    SEAD_ASSERT_MSG(ret == 0, "pthread_key_create failed");
+}
+
 inline ThreadLocalStorage::~ThreadLocalStorage()
 {
     s32 ret = pthread_key_delete(mPthreadKey);
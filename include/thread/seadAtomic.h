@@ -242,6 +242,17 @@ public:
         mValue.store(value);
     }
 
+    // Pairs with setValueRelease(), what was written before the store is visible once the pointer is
+    T getValueAcquire() const
+    {
+        return mValue.load(std::memory_order_acquire);
+    }
+
+    void setValueRelease(T value)
+    {
+        mValue.store(value, std::memory_order_release);
+    }
+
     void setValueNonAtomic(T value)
     {
         volatile T* ptr = reinterpret_cast<volatile T*>(&mValue);
@@ -4,6 +4,7 @@
 
 #if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
 #include <container/seadRingBuffer.h>
+#include <thread/seadAtomic.h>
 #include <thread/seadCriticalSection.h>
 #include <thread/seadEvent.h>
 #endif // SEAD_PLATFORM_WINDOWS
@@ -26,8 +27,14 @@ public:
     ~MessageQueue();
 
     void allocate(s32 size, Heap* heap);
+    // Bounded multi producer multi consumer queue without locks, size is rounded up to a power of two.
+    // At most one jammed message is held at a time, further jams wait for it to be popped.
+    void allocateLockFree(s32 size, Heap* heap);
     void free();
 
+    s32 getSize() const;
+    bool isLockFree() const { return mCells != nullptr; }
+
     bool push(Element message, BlockType blockType);
     Element pop(BlockType blockType);
     Element peek(BlockType blockType) const;
@@ -37,17 +44,44 @@ public:
 
 #if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
 protected:
+    static const s32 cCacheLineSize = 64;
+
+    struct Cell
+    {
+        AtomicU32 sequence;
+        AtomicBase32<Element> message;
+    };
+
     bool push_(Element message);
     Element pop_();
     Element peek_() const;
     bool jam_(Element message);
+
+    bool pushLockFree_(Element message);
+    Element popLockFree_();
+    Element peekLockFree_() const;
+    bool jamLockFree_(Element message);
+
+    void signalNotFull_();
+    void signalNotEmpty_();
 #endif // SEAD_PLATFORM_WINDOWS
 
 protected:
 #if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
     mutable CriticalSection mCriticalSection;
-    mutable Event mEvent;
+    mutable Event mNotFullEvent;
+    mutable Event mNotEmptyEvent;
+    mutable AtomicU32 mNotFullWaiterNum;
+    mutable AtomicU32 mNotEmptyWaiterNum;
     RingBuffer<Element> mBuffer;
+
+    // Lock free mode
+    Cell* mCells;
+    u32 mCellMask;
+    AtomicBase32<Element> mJamMessage;
+    AtomicU32 mPushPos;
+    u8 mPadding[cCacheLineSize - sizeof(AtomicU32)];
+    AtomicU32 mPopPos;
 #else
 #error "Unsupported platform"
 #endif // SEAD_PLATFORM_WINDOWS
@@ -4,6 +4,7 @@
 #include <heap/seadDisposer.h>
 #include <heap/seadHeapMgr.h>
 #include <hostio/seadHostIONode.h>
+#include <mc/seadCoreInfo.h>
 #include <prim/seadNamable.h>
 #include <prim/seadScopedLock.h>
 #include <thread/seadCriticalSection.h>
@@ -61,6 +62,8 @@ public:
     virtual bool sendMessage(MessageQueue::Element msg, MessageQueue::BlockType blockType);
     virtual MessageQueue::Element recvMessage(MessageQueue::BlockType blockType);
     virtual const MessageQueue& getMessageQueue() const { return mMessageQueue; }
+    // Rebuilds the message queue as the lock free variant with the same size, only possible before start()
+    bool changeToLockFreeMessageQueue(Heap* heap);
     virtual bool start();
     virtual void quit(bool isJam);
 
@@ -83,6 +86,10 @@ public:
     virtual s32 getStackSize() const { return mStackSize; }
     virtual s32 calcStackUsedSizePeak() const;
 
+    // Cores the thread may run on, can be set before start()
+    virtual void setAffinity(const CoreIdMask& affinity);
+    const CoreIdMask& getAffinity() const { return mAffinity; }
+
 #if defined(SEAD_TARGET_DEBUG)
     void listenPropertyEvent(const hostio::PropertyEvent* ev) override;
     void genMessage(hostio::Context* context) override;
@@ -129,6 +136,7 @@ protected:
     MessageQueue::Element mQuitMsg;
     u32 mID;
     State mState;
+    CoreIdMask mAffinity;
 #if defined(SEAD_PLATFORM_WINDOWS)
     HANDLE mHandle;
 #elif defined(SEAD_PLATFORM_POSIX)
@@ -168,6 +176,9 @@ public:
     Thread* getMainThread() const { return mMainThread; }
     bool isMainThread() const;
 
+    // Core the calling thread is running on at the moment
+    static CoreId getCurrentCoreId() { return CoreInfo::getCurrentCoreId(); }
+
     ThreadList::constIterator constBegin() const { return mList.constBegin(); }
     ThreadList::constIterator constEnd() const { return mList.constEnd(); }
 
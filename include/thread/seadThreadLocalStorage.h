@@ -14,8 +14,18 @@ class ThreadLocalStorage
 {
     SEAD_NO_COPY(ThreadLocalStorage);
 
+public:
+#if defined(SEAD_PLATFORM_WINDOWS)
+    using DestructFunc = void(__stdcall*)(void* value);
+#elif defined(SEAD_PLATFORM_POSIX)
+    using DestructFunc = void (*)(void* value);
+#endif // SEAD_PLATFORM_WINDOWS
+
 public:
     ThreadLocalStorage();
+    // destructFunc is called with the value of each thread that exits while its value is not zero.
+    // On Windows it is also called for every such thread when the storage is destroyed.
+    explicit ThreadLocalStorage(DestructFunc destructFunc);
     ~ThreadLocalStorage();
 
     void setValue(uintptr_t value);
@@ -24,6 +34,8 @@ public:
 private:
 #if defined(SEAD_PLATFORM_WINDOWS)
     DWORD mTlsInner;
+    // Fiber local storage is the only kind with a destructor on Windows
+    bool mIsFls;
 #elif defined(SEAD_PLATFORM_POSIX) 
     pthread_key_t mPthreadKey;
 #else
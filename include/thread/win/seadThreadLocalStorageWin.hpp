@@ -7,25 +7,37 @@ namespace sead {
 
 inline ThreadLocalStorage::ThreadLocalStorage()
     : mTlsInner(TlsAlloc())
+    , mIsFls(false)
 {
     SEAD_ASSERT_MSG(mTlsInner != TLS_OUT_OF_INDEXES, "TlsAlloc failed");
     setValue(reinterpret_cast<uintptr_t>(nullptr));
 }
 
+inline ThreadLocalStorage::ThreadLocalStorage(DestructFunc destructFunc)
+    : mTlsInner(FlsAlloc(destructFunc))
+    , mIsFls(true)
+{
+    SEAD_ASSERT_MSG(mTlsInner != FLS_OUT_OF_INDEXES, "FlsAlloc failed");
+    setValue(reinterpret_cast<uintptr_t>(nullptr));
+}
+
 inline ThreadLocalStorage::~ThreadLocalStorage()
 {
-    bool success = TlsFree(mTlsInner);
+    bool success = mIsFls ? FlsFree(mTlsInner) : TlsFree(mTlsInner);
     SEAD_ASSERT_MSG(success, "TlsFree failed");
 }
 
 inline void ThreadLocalStorage::setValue(uintptr_t value)
 {
-    bool success = TlsSetValue(mTlsInner, reinterpret_cast<LPVOID>(value));
+    bool success = mIsFls ? FlsSetValue(mTlsInner, reinterpret_cast<PVOID>(value)) : TlsSetValue(mTlsInner, reinterpret_cast<LPVOID>(value));
     SEAD_ASSERT_MSG(success, "TlsSetValue failed");
 }
 
 inline uintptr_t ThreadLocalStorage::getValue() const
 {
+    if (mIsFls)
+        return reinterpret_cast<uintptr_t>(FlsGetValue(mTlsInner));
+
     return reinterpret_cast<uintptr_t>(TlsGetValue(mTlsInner));
 }
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <time/seadTickSpan.h>
+#include <time/seadTickTime.h>
+
+namespace sead {
+
+// Paces a loop to a fixed frame time against absolute deadlines, so the error of one wait does not carry into the next.
+// The thread sleeps until shortly before the deadline and spins the rest of the way, the spin tail adapts to how late
+// the sleeps of this system wake up.
+class FramePacer
+{
+public:
+    static const s32 cDefaultMaxBacklogNum = 0;
+
+public:
+    FramePacer();
+
+    void setFrameTime(TickSpan frameTime);
+    void setFps(f32 fps);
+    TickSpan getFrameTime() const { return mFrameTime; }
+
+    // Frames a late loop may catch up on through the step count of wait(), frames beyond that are dropped
+    void setMaxBacklogNum(s32 num);
+    s32 getMaxBacklogNum() const { return mMaxBacklogNum; }
+
+    // Starts the next frame deadline one frame time from now
+    void reset();
+
+    // Blocks until the next frame deadline. Returns the number of fixed steps to run this frame, which is above one
+    // only when the loop fell behind and allowed a backlog.
+    s32 wait();
+
+    // Time between the ends of the two latest waits
+    TickSpan getLastFrameSpan() const { return mLastFrameSpan; }
+    TickSpan getSpinTime() const { return mSpinTime; }
+    u32 getDroppedFrameNum() const { return mDroppedFrameNum; }
+
+private:
+    // Returns how late the platform woke up
+    static TickSpan sleepUntil_(const TickTime& deadline);
+
+    void calibrate_(TickSpan oversleep);
+
+private:
+    TickSpan mFrameTime;
+    s32 mMaxBacklogNum;
+    TickTime mDeadline;
+    TickTime mLastFrameTime;
+    TickSpan mLastFrameSpan;
+    TickSpan mSpinTime;
+    u32 mDroppedFrameNum;
+};
+
+} // namespace sead
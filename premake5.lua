@@ -15,6 +15,7 @@ project "sead"
 
     includedirs {
         "include",
+        "libs/zstd/lib",
     }
 
     files {
@@ -33,6 +34,10 @@ project "sead"
 
     defines { "_CRT_SECURE_NO_WARNINGS" }
 
+    links {
+        "zstd",
+    }
+
     filter "system:windows"
         systemversion "latest"
 
@@ -45,6 +50,7 @@ project "sead"
             "Winmm.lib",
             "Ws2_32.lib",
             "opengl32.lib",
+            "Dbghelp.lib",
             -- "glad",
         }
 
@@ -120,6 +126,7 @@ project "sead"
             "Winmm.lib",
             "Ws2_32.lib",
             "opengl32.lib",
+            "Dbghelp.lib",
             -- "glad",
         }
 
@@ -257,3 +264,147 @@ project "glfw"
         optimize "speed"
         symbols "off"
         linktimeoptimization "on"
+
+project "zstd"
+    kind "StaticLib"
+    language "C"
+
+    multiprocessorcompile "on"
+    staticruntime "on"
+    warnings "off"
+
+    targetdir "bin/%{prj.name}-%{cfg.platform}-%{cfg.buildcfg}/out"
+    objdir "bin/%{prj.name}-%{cfg.platform}-%{cfg.buildcfg}/int"
+
+    -- Decoder only, without the x86-64 assembly Huffman loops
+    defines {
+        "ZSTD_DISABLE_ASM",
+    }
+
+    files {
+        "libs/zstd/lib/zstd.h",
+        "libs/zstd/lib/zstd_errors.h",
+        "libs/zstd/lib/common/debug.c",
+        "libs/zstd/lib/common/entropy_common.c",
+        "libs/zstd/lib/common/error_private.c",
+        "libs/zstd/lib/common/fse_decompress.c",
+        "libs/zstd/lib/common/xxhash.c",
+        "libs/zstd/lib/common/zstd_common.c",
+        "libs/zstd/lib/decompress/huf_decompress.c",
+        "libs/zstd/lib/decompress/zstd_ddict.c",
+        "libs/zstd/lib/decompress/zstd_decompress.c",
+        "libs/zstd/lib/decompress/zstd_decompress_block.c"
+    }
+
+    filter "configurations:Debug"
+        runtime "debug"
+        optimize "off"
+        symbols "on"
+        linktimeoptimization "off"
+
+    filter "configurations:Develop"
+        runtime "release"
+        optimize "speed"
+        symbols "on"
+        linktimeoptimization "off"
+
+    filter "configurations:Release"
+        defines { "NDEBUG" }
+        runtime "release"
+        optimize "speed"
+        symbols "off"
+        linktimeoptimization "on"
+
+project "benchmark"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+
+    multiprocessorcompile "on"
+    staticruntime "on"
+    exceptionhandling "off"
+    rtti "off"
+
+    targetdir "bin/%{prj.name}-%{cfg.platform}-%{cfg.buildcfg}/out"
+    objdir "bin/%{prj.name}-%{cfg.platform}-%{cfg.buildcfg}/int"
+
+    includedirs {
+        "include",
+        "libs/zstd/lib",
+    }
+
+    files {
+        "tools/benchmark/**",
+    }
+
+    links {
+        "sead",
+        "zstd",
+    }
+
+    defines { "_CRT_SECURE_NO_WARNINGS" }
+
+    filter "system:windows"
+        systemversion "latest"
+        defines { "SEAD_PLATFORM_WINDOWS" }
+        links {
+            "Winmm.lib",
+            "Ws2_32.lib",
+            "opengl32.lib",
+            "Dbghelp.lib",
+        }
+
+    filter "system:linux"
+        systemversion "latest"
+        defines { "SEAD_PLATFORM_POSIX", "SEAD_PLATFORM_LINUX" }
+        links { "pthread" }
+
+    filter "system:macosx"
+        systemversion "11.0"
+        defines { "SEAD_PLATFORM_POSIX", "SEAD_PLATFORM_MACOSX" }
+
+    filter "platforms:GLFW_*"
+        defines {
+            "SEAD_PLATFORM_GLFW",
+            "SEAD_USE_GL",
+        }
+
+        includedirs {
+            "libs/glad/include",
+            "libs/glfw/include",
+        }
+
+        links {
+            "glfw",
+        }
+
+    filter "platforms:Win_*"
+        defines {
+            "SEAD_PLATFORM_WINDOWS",
+            "SEAD_USE_GL",
+        }
+
+        includedirs {
+            "libs/glad/include",
+        }
+
+    filter "configurations:Debug"
+        defines { "SEAD_TARGET_DEBUG" }
+        runtime "debug"
+        optimize "off"
+        symbols "on"
+        linktimeoptimization "off"
+
+    filter "configurations:Develop"
+        defines { "SEAD_TARGET_DEBUG" }
+        runtime "release"
+        optimize "speed"
+        symbols "on"
+        linktimeoptimization "off"
+
+    filter "configurations:Release"
+        defines { "SEAD_TARGET_RELEASE", "NDEBUG" }
+        runtime "release"
+        optimize "speed"
+        symbols "off"
+        linktimeoptimization "on"
@@ -1,32 +1,8 @@
 #include <codec/seadHashCRC16.h>
 
-namespace sead {
-
-u16 HashCRC16::sTable[cTableSize];
-bool HashCRC16::sInitialized = false;
+#include <codec/seadHashCRCSlicing.h>
 
-void HashCRC16::initialize()
-{
-    u16 r = 0;
-    for (u32 i = 0; i < cTableSize; i++)
-    {
-        r = i;
-        for (u32 j = 0; j < 8; j++)
-        {
-            if (r & 1)
-            {
-                r = (r >> 1) ^ cTableMask;
-            }
-            else
-            {
-                r >>= 1;
-            }
-        }
-        sTable[i] = r;
-    }
-
-    sInitialized = true;
-}
+namespace sead {
 
 u16 HashCRC16::calcHash(const void* dataptr, u32 datasize)
 {
@@ -36,19 +12,7 @@ u16 HashCRC16::calcHash(const void* dataptr, u32 datasize)
 
 u16 HashCRC16::calcHashWithContext(Context* ctx, const void* dataptr, u32 datasize)
 {
-    if (!sInitialized)
-    {
-        initialize();
-    }
-
-    u16 r = ctx->hash;
-    const u8* data = static_cast<const u8*>(dataptr);
-
-    for (u32 i = 0; i < datasize; i++)
-    {
-        u16 t = sTable[(r ^ *data++) & 0xFF];
-        r = (r >> 8) ^ t;
-    }
+    u16 r = HashCRCSlicing8<u16, cTableMask>::update(ctx->hash, dataptr, datasize);
 
     ctx->hash = r;
     return r;
@@ -62,19 +26,7 @@ u16 HashCRC16::calcStringHash(const char* str)
 
 u16 HashCRC16::calcStringHashWithContext(Context* ctx, const char* str)
 {
-    if (!sInitialized)
-    {
-        initialize();
-    }
-
-    u16 r = ctx->hash;
-    const u8* data = reinterpret_cast<const u8*>(str);
-
-    while (*data)
-    {
-        u16 t = sTable[(r ^ *data++) & 0xFF];
-        r = (r >> 8) ^ t;
-    }
+    u16 r = HashCRCSlicing8<u16, cTableMask>::updateString(ctx->hash, str);
 
     ctx->hash = r;
     return r;
@@ -1,54 +1,213 @@
 #include <codec/seadHashCRC32.h>
 
+#include <codec/seadHashCRCSlicing.h>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SEAD_HASH_CRC32_PCLMUL
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif // _MSC_VER
+#elif defined(__ARM_FEATURE_CRC32)
+#define SEAD_HASH_CRC32_ARM
+#include <arm_acle.h>
+#endif
+
 namespace sead {
 
-u32 HashCRC32::sTable[cTableSize];
-bool HashCRC32::sInitialized = false;
+namespace {
+
+#if defined(SEAD_HASH_CRC32_PCLMUL)
+
+#if defined(__GNUC__)
+#define SEAD_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#else
+#define SEAD_TARGET_PCLMUL
+#endif // __GNUC__
 
-void HashCRC32::initialize()
+// Folding needs at least four 128 bit blocks to pay off
+const size_t cPclmulMinSize = 64;
+
+bool IsPclmulSupported()
 {
-    u32 r = 0;
-    for (u32 i = 0; i < cTableSize; i++)
+    static const bool cSupported = []()
     {
-        r = i;
-        for (u32 j = 0; j < 8; j++)
-        {
-            if (r & 1)
-            {
-                r = (r >> 1) ^ cTableMask;
-            }
-            else
-            {
-                r >>= 1;
-            }
-        }
-        sTable[i] = r;
-    }
+        u32 ecx = 0;
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        ecx = static_cast<u32>(info[2]);
+#else
+        u32 eax, ebx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+#endif // _MSC_VER
 
-    sInitialized = true;
+        // PCLMULQDQ and SSE4.1
+        return (ecx & (1u << 1)) != 0 && (ecx & (1u << 19)) != 0;
+    }();
+
+    return cSupported;
 }
 
-u32 HashCRC32::calcHash(const void* dataptr, u32 datasize)
+// Carry-less multiplication folding from "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+// size must be a multiple of 16 and at least cPclmulMinSize, r is the raw register.
+SEAD_TARGET_PCLMUL u32 UpdatePclmul(u32 r, const u8* data, size_t size)
 {
-    Context ctx;
-    return calcHashWithContext(&ctx, dataptr, datasize);
+    alignas(16) static const u64 cK1K2[2] = { 0x0154442BD4, 0x01C6E41596 };
+    alignas(16) static const u64 cK3K4[2] = { 0x01751997D0, 0x00CCAA009E };
+    alignas(16) static const u64 cK5K0[2] = { 0x0163CD6124, 0x0000000000 };
+    alignas(16) static const u64 cPoly[2] = { 0x01DB710641, 0x01F7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<s32>(r)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(cK1K2));
+
+    data += 64;
+    size -= 64;
+
+    // Fold four blocks in parallel
+    while (size >= 64)
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+
+        data += 64;
+        size -= 64;
+    }
+
+    // Fold into a single block
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(cK3K4));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    while (size >= 16)
+    {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        data += 16;
+        size -= 16;
+    }
+
+    // Fold 128 bits down to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cK5K0));
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(cPoly));
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<u32>(_mm_extract_epi32(x1, 1));
 }
 
-u32 HashCRC32::calcHashWithContext(Context* ctx, const void* dataptr, u32 datasize)
+#undef SEAD_TARGET_PCLMUL
+
+#endif // SEAD_HASH_CRC32_PCLMUL
+
+#if defined(SEAD_HASH_CRC32_ARM)
+
+// The ARMv8 CRC32 instructions use the same polynomial, unlike the SSE4.2 ones which are CRC-32C
+u32 UpdateArm(u32 r, const u8* data, size_t size)
 {
-    if (!sInitialized)
+    while (size >= 8)
+    {
+        u64 v;
+        std::memcpy(&v, data, sizeof(v));
+        r = __crc32d(r, v);
+
+        data += 8;
+        size -= 8;
+    }
+
+    while (size > 0)
     {
-        initialize();
+        r = __crc32b(r, *data++);
+        size--;
     }
 
-    u32 r = ctx->hash;
-    const u8* data = static_cast<const u8*>(dataptr);
+    return r;
+}
+
+#endif // SEAD_HASH_CRC32_ARM
 
-    for (u32 i = 0; i < datasize; i++)
+u32 Update(u32 r, const void* dataptr, size_t datasize)
+{
+#if defined(SEAD_HASH_CRC32_PCLMUL)
+    if (datasize >= cPclmulMinSize && IsPclmulSupported())
     {
-        u32 t = sTable[(r ^ *data++) & 0xFF];
-        r = (r >> 8) ^ t;
+        size_t size = datasize & ~static_cast<size_t>(15);
+        r = UpdatePclmul(r, static_cast<const u8*>(dataptr), size);
+
+        dataptr = static_cast<const u8*>(dataptr) + size;
+        datasize -= size;
     }
+#elif defined(SEAD_HASH_CRC32_ARM)
+    return UpdateArm(r, static_cast<const u8*>(dataptr), datasize);
+#endif // SEAD_HASH_CRC32_PCLMUL
+
+    return HashCRCSlicing8<u32, 0xEDB88320>::update(r, dataptr, datasize);
+}
+
+} // namespace
+
+u32 HashCRC32::calcHash(const void* dataptr, u32 datasize)
+{
+    Context ctx;
+    return calcHashWithContext(&ctx, dataptr, datasize);
+}
+
+u32 HashCRC32::calcHashWithContext(Context* ctx, const void* dataptr, u32 datasize)
+{
+    u32 r = Update(ctx->hash, dataptr, datasize);
 
     ctx->hash = r;
     return ~r;
@@ -62,19 +221,7 @@ u32 HashCRC32::calcStringHash(const char* str)
 
 u32 HashCRC32::calcStringHashWithContext(Context* ctx, const char* str)
 {
-    if (!sInitialized)
-    {
-        initialize();
-    }
-
-    u32 r = ctx->hash;
-    const u8* data = reinterpret_cast<const u8*>(str);
-
-    while (*data)
-    {
-        u32 t = sTable[(r ^ *data++) & 0xFF];
-        r = (r >> 8) ^ t;
-    }
+    u32 r = Update(ctx->hash, str, std::strlen(str));
 
     ctx->hash = r;
     return ~r;
@@ -1,32 +1,8 @@
 #include <codec/seadHashCRC64.h>
 
-namespace sead {
-
-u64 HashCRC64::sTable[cTableSize];
-bool HashCRC64::sInitialized = false;
+#include <codec/seadHashCRCSlicing.h>
 
-void HashCRC64::initialize()
-{
-    u64 r = 0;
-    for (u32 i = 0; i < cTableSize; i++)
-    {
-        r = i;
-        for (u32 j = 0; j < 8; j++)
-        {
-            if (r & 1)
-            {
-                r = (r >> 1) ^ cTableMask;
-            }
-            else
-            {
-                r >>= 1;
-            }
-        }
-        sTable[i] = r;
-    }
-
-    sInitialized = true;
-}
+namespace sead {
 
 u64 HashCRC64::calcHash(const void* dataptr, u32 datasize)
 {
@@ -36,19 +12,7 @@ u64 HashCRC64::calcHash(const void* dataptr, u32 datasize)
 
 u64 HashCRC64::calcHashWithContext(Context* ctx, const void* dataptr, u32 datasize)
 {
-    if (!sInitialized)
-    {
-        initialize();
-    }
-
-    u64 r = ctx->hash;
-    const u8* data = static_cast<const u8*>(dataptr);
-
-    for (u32 i = 0; i < datasize; i++)
-    {
-        u64 t = sTable[(r ^ *data++) & 0xFF];
-        r = (r >> 8) ^ t;
-    }
+    u64 r = HashCRCSlicing8<u64, cTableMask>::update(ctx->hash, dataptr, datasize);
 
     ctx->hash = r;
     return ~r;
@@ -62,19 +26,7 @@ u64 HashCRC64::calcStringHash(const char* str)
 
 u64 HashCRC64::calcStringHashWithContext(Context* ctx, const char* str)
 {
-    if (!sInitialized)
-    {
-        initialize();
-    }
-
-    u64 r = ctx->hash;
-    const u8* data = reinterpret_cast<const u8*>(str);
-
-    while (*data)
-    {
-        u64 t = sTable[(r ^ *data++) & 0xFF];
-        r = (r >> 8) ^ t;
-    }
+    u64 r = HashCRCSlicing8<u64, cTableMask>::updateString(ctx->hash, str);
 
     ctx->hash = r;
     return ~r;
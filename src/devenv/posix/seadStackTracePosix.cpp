@@ -0,0 +1,54 @@
+#include <devenv/seadStackTrace.h>
+
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+namespace sead {
+
+s32 StackTrace::capture(s32 skipNum)
+{
+    SEAD_ASSERT(0 <= skipNum && skipNum <= cSkipNumMax);
+
+    // One more for capture() itself
+    void* frames[cDepthMax + cSkipNumMax + 1];
+    s32 frameNum = backtrace(frames, cDepthMax + skipNum + 1);
+
+    mDepth = 0;
+    for (s32 i = skipNum + 1; i < frameNum; i++)
+        mAddresses[mDepth++] = reinterpret_cast<uintptr_t>(frames[i]);
+
+    return mDepth;
+}
+
+void StackTrace::getSymbolName(BufferedSafeString* name, s32 idx) const
+{
+    SEAD_ASSERT(name);
+
+    uintptr_t address = getAddress(idx);
+
+    Dl_info info;
+    if (!dladdr(reinterpret_cast<void*>(address), &info))
+    {
+        name->format("0x%p", reinterpret_cast<void*>(address));
+        return;
+    }
+
+    if (info.dli_sname)
+    {
+        s32 status = -1;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+
+        name->format("%s+0x%zx", status == 0 ? demangled : info.dli_sname, static_cast<size_t>(address - reinterpret_cast<uintptr_t>(info.dli_saddr)));
+
+        std::free(demangled);
+    }
+    else
+    {
+        const char* module = info.dli_fname ? info.dli_fname : "?";
+        name->format("%s+0x%zx", module, static_cast<size_t>(address - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+    }
+}
+
+} // namespace sead
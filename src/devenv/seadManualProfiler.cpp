@@ -0,0 +1,670 @@
+#include <devenv/seadManualProfiler.h>
+
+#include <basis/seadRawPrint.h>
+#include <basis/seadWarning.h>
+#include <heap/seadHeap.h>
+#include <prim/seadScopedLock.h>
+#include <stream/seadStream.h>
+#include <time/seadTickTime.h>
+
+#include <bit>
+
+namespace sead {
+
+namespace {
+
+u32 CalcSlotNum(s32 num)
+{
+    return std::bit_ceil(static_cast<u32>(num) * 2);
+}
+
+void ClearStats(ManualProfiler::Stats* stats)
+{
+    stats->allocNum = 0;
+    stats->allocSize = 0;
+    stats->liveNum = 0;
+    stats->liveSize = 0;
+    stats->peakLiveSize = 0;
+    stats->leakNum = 0;
+    stats->leakSize = 0;
+}
+
+void AddAlloc(ManualProfiler::Stats* stats, u64 num, u64 size)
+{
+    stats->allocNum += num;
+    stats->allocSize += size;
+    stats->liveNum += num;
+    stats->liveSize += size;
+
+    if (stats->liveSize > stats->peakLiveSize)
+        stats->peakLiveSize = stats->liveSize;
+}
+
+void RemoveLive(ManualProfiler::Stats* stats, u64 num, u64 size, bool isLeak)
+{
+    stats->liveNum -= num < stats->liveNum ? num : stats->liveNum;
+    stats->liveSize -= size < stats->liveSize ? size : stats->liveSize;
+
+    if (isLeak)
+    {
+        stats->leakNum += num;
+        stats->leakSize += size;
+    }
+}
+
+s32 CompareAllocSize(const ManualProfiler::CallSite* a, const ManualProfiler::CallSite* b)
+{
+    if (a->stats.allocSize < b->stats.allocSize)
+        return 1;
+
+    if (a->stats.allocSize > b->stats.allocSize)
+        return -1;
+
+    return 0;
+}
+
+void WriteStats(WriteStream& stream, const ManualProfiler::Stats& stats)
+{
+    stream.writeU64(stats.allocNum);
+    stream.writeU64(stats.allocSize);
+    stream.writeU64(stats.liveNum);
+    stream.writeU64(stats.liveSize);
+    stream.writeU64(stats.peakLiveSize);
+    stream.writeU64(stats.leakNum);
+    stream.writeU64(stats.leakSize);
+}
+
+} // namespace
+
+SEAD_SINGLETON_DISPOSER_IMPL(ManualProfiler);
+
+ManualProfiler::ManualProfiler()
+    : mCS()
+    , mIsRunning(false)
+    , mSampleInterval(cDefaultSampleInterval)
+    , mStackSkipNum(cDefaultStackSkipNum)
+    , mBytesUntilSample(0)
+    , mDroppedNum(0)
+    , mCallSites(nullptr)
+    , mCallSiteNum(0)
+    , mCallSiteNumMax(0)
+    , mCallSiteSlots(nullptr)
+    , mCallSiteSlotMask(0)
+    , mSortedCallSites()
+    , mLiveAllocs(nullptr)
+    , mLiveAllocNum(0)
+    , mLiveAllocNumMax(0)
+    , mLiveAllocSlotMask(0)
+    , mHeaps(nullptr)
+    , mHeapNum(0)
+    , mHeapNumMax(0)
+    , mEvents(nullptr)
+    , mEventNumMax(0)
+    , mEventHead(0)
+    , mEventNum(0)
+    , mAllocCallback(this, &ManualProfiler::onAlloc_)
+    , mFreeCallback(this, &ManualProfiler::onFree_)
+    , mDestroyCallback(this, &ManualProfiler::onDestroy_)
+    , mPrevAllocCallback(nullptr)
+    , mPrevFreeCallback(nullptr)
+    , mPrevDestroyCallback(nullptr)
+{
+}
+
+ManualProfiler::~ManualProfiler()
+{
+    stop();
+
+    mSortedCallSites.freeBuffer();
+
+    delete[] mCallSites;
+    delete[] mCallSiteSlots;
+    delete[] mLiveAllocs;
+    delete[] mHeaps;
+    delete[] mEvents;
+}
+
+void ManualProfiler::initialize(s32 callSiteNumMax, s32 liveAllocNumMax, s32 heapNumMax, s32 eventNumMax, Heap* heap)
+{
+    SEAD_ASSERT_MSG(!mCallSites, "initialize twice");
+    SEAD_ASSERT(callSiteNumMax > 0 && liveAllocNumMax > 0 && eventNumMax >= 0);
+    SEAD_ASSERT_MSG(0 < heapNumMax && heapNumMax <= 0xFFFF, "heapNumMax[%d] is out of range", heapNumMax);
+
+    u32 callSiteSlotNum = CalcSlotNum(callSiteNumMax);
+    u32 liveAllocSlotNum = CalcSlotNum(liveAllocNumMax);
+
+    mCallSites = new(heap) CallSite[callSiteNumMax];
+    mCallSiteSlots = new(heap) s32[callSiteSlotNum];
+    mCallSiteNumMax = callSiteNumMax;
+    mCallSiteSlotMask = callSiteSlotNum - 1;
+    mSortedCallSites.allocBuffer(callSiteNumMax, heap);
+
+    mLiveAllocs = new(heap) LiveAlloc[liveAllocSlotNum];
+    mLiveAllocNumMax = liveAllocNumMax;
+    mLiveAllocSlotMask = liveAllocSlotNum - 1;
+
+    mHeaps = new(heap) HeapEntry[heapNumMax];
+    mHeapNumMax = heapNumMax;
+
+    if (eventNumMax > 0)
+        mEvents = new(heap) Event[eventNumMax];
+
+    mEventNumMax = eventNumMax;
+
+    clear();
+
+    // The first unwind may allocate while loading the unwinder, keep that out of the callbacks
+    StackTrace warmUp;
+    warmUp.capture();
+}
+
+void ManualProfiler::start()
+{
+    SEAD_ASSERT_MSG(mCallSites, "not initialized");
+
+    if (mIsRunning)
+        return;
+
+#if defined(SEAD_TARGET_DEBUG)
+    HeapMgr* mgr = HeapMgr::instance();
+    SEAD_ASSERT(mgr);
+
+    mBytesUntilSample.setValue(static_cast<s64>(mSampleInterval));
+
+    mPrevAllocCallback = mgr->setAllocCallback(&mAllocCallback);
+    mPrevFreeCallback = mgr->setFreeCallback(&mFreeCallback);
+    mPrevDestroyCallback = mgr->setDestroyCallback(&mDestroyCallback);
+
+    mIsRunning = true;
+#else
+    SEAD_WARNING("ManualProfiler needs the heap callbacks of SEAD_TARGET_DEBUG");
+#endif // SEAD_TARGET_DEBUG
+}
+
+void ManualProfiler::stop()
+{
+    if (!mIsRunning)
+        return;
+
+#if defined(SEAD_TARGET_DEBUG)
+    HeapMgr* mgr = HeapMgr::instance();
+    if (mgr)
+    {
+        // Callbacks set on top of ours own the chain now, leave them alone
+        if (mgr->getAllocCallback() == &mAllocCallback)
+            mgr->setAllocCallback(mPrevAllocCallback);
+        else
+            SEAD_WARNING("alloc callback was replaced while profiling");
+
+        if (mgr->getFreeCallback() == &mFreeCallback)
+            mgr->setFreeCallback(mPrevFreeCallback);
+        else
+            SEAD_WARNING("free callback was replaced while profiling");
+
+        if (mgr->getDestroyCallback() == &mDestroyCallback)
+            mgr->setDestroyCallback(mPrevDestroyCallback);
+        else
+            SEAD_WARNING("destroy callback was replaced while profiling");
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    mPrevAllocCallback = nullptr;
+    mPrevFreeCallback = nullptr;
+    mPrevDestroyCallback = nullptr;
+
+    mIsRunning = false;
+}
+
+void ManualProfiler::clear()
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    mCallSiteNum = 0;
+    for (u32 i = 0; i <= mCallSiteSlotMask && mCallSiteSlots; i++)
+        mCallSiteSlots[i] = -1;
+
+    mLiveAllocNum = 0;
+    for (u32 i = 0; i <= mLiveAllocSlotMask && mLiveAllocs; i++)
+        mLiveAllocs[i].ptr = nullptr;
+
+    mHeapNum = 0;
+
+    mEventHead = 0;
+    mEventNum = 0;
+
+    mDroppedNum = 0;
+}
+
+const ManualProfiler::CallSite& ManualProfiler::getCallSite(s32 idx) const
+{
+    SEAD_ASSERT(0 <= idx && idx < mCallSiteNum);
+    return mCallSites[idx];
+}
+
+const ManualProfiler::HeapEntry& ManualProfiler::getHeapEntry(s32 idx) const
+{
+    SEAD_ASSERT(0 <= idx && idx < mHeapNum);
+    return mHeaps[idx];
+}
+
+void ManualProfiler::reportLeaks(s32 heapIndex) const
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    const HeapEntry& entry = getHeapEntry(heapIndex);
+    if (entry.stats.leakNum == 0)
+        return;
+
+    SEAD_WARNING("heap [%s] leaked about %llu bytes in %llu allocations", entry.name.cstr(),
+                 static_cast<unsigned long long>(entry.stats.leakSize), static_cast<unsigned long long>(entry.stats.leakNum));
+
+    for (s32 i = 0; i < mCallSiteNum; i++)
+    {
+        const CallSite& site = mCallSites[i];
+        if (site.heapIndex != heapIndex || site.stats.leakNum == 0)
+            continue;
+
+        SEAD_PRINT("[%s] about %llu bytes in %llu allocations leaked from\n", entry.name.cstr(),
+                   static_cast<unsigned long long>(site.stats.leakSize), static_cast<unsigned long long>(site.stats.leakNum));
+
+        site.stackTrace.print();
+    }
+}
+
+void ManualProfiler::dumpYAML(WriteStream& stream, s32 indent, s32 callSiteNumMax)
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    FixedSafeString<512> buf("");
+    buf.append(' ', indent);
+    buf.appendWithFormat("sample_interval: %zu\n", mSampleInterval);
+    stream.writeDecorationText(buf);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("dropped_num: %u\n", mDroppedNum);
+    stream.writeDecorationText(buf);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("heaps:\n");
+    stream.writeDecorationText(buf);
+
+    for (s32 i = 0; i < mHeapNum; i++)
+    {
+        const HeapEntry& entry = mHeaps[i];
+
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("  - { name: \"%s\", destroyed: %s, alloc_num: %llu, alloc_size: %llu, live_num: %llu, live_size: %llu, "
+                             "peak_live_size: %llu, leak_num: %llu, leak_size: %llu }\n",
+                             entry.name.cstr(), entry.heap ? "false" : "true", static_cast<unsigned long long>(entry.stats.allocNum),
+                             static_cast<unsigned long long>(entry.stats.allocSize), static_cast<unsigned long long>(entry.stats.liveNum),
+                             static_cast<unsigned long long>(entry.stats.liveSize),
+                             static_cast<unsigned long long>(entry.stats.peakLiveSize),
+                             static_cast<unsigned long long>(entry.stats.leakNum),
+                             static_cast<unsigned long long>(entry.stats.leakSize));
+        stream.writeDecorationText(buf);
+    }
+
+    mSortedCallSites.clear();
+    for (s32 i = 0; i < mCallSiteNum; i++)
+        mSortedCallSites.pushBack(&mCallSites[i]);
+
+    mSortedCallSites.heapSort(&CompareAllocSize);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("call_sites:\n");
+    stream.writeDecorationText(buf);
+
+    FixedSafeString<256> name;
+
+    for (s32 i = 0; i < mSortedCallSites.size() && i < callSiteNumMax; i++)
+    {
+        const CallSite& site = *mSortedCallSites[i];
+
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("  - heap: \"%s\"\n", mHeaps[site.heapIndex].name.cstr());
+        stream.writeDecorationText(buf);
+
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("    stats: { alloc_num: %llu, alloc_size: %llu, live_num: %llu, live_size: %llu, peak_live_size: %llu, "
+                             "leak_num: %llu, leak_size: %llu }\n",
+                             static_cast<unsigned long long>(site.stats.allocNum), static_cast<unsigned long long>(site.stats.allocSize),
+                             static_cast<unsigned long long>(site.stats.liveNum), static_cast<unsigned long long>(site.stats.liveSize),
+                             static_cast<unsigned long long>(site.stats.peakLiveSize),
+                             static_cast<unsigned long long>(site.stats.leakNum), static_cast<unsigned long long>(site.stats.leakSize));
+        stream.writeDecorationText(buf);
+
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("    stack:\n");
+        stream.writeDecorationText(buf);
+
+        for (s32 j = 0; j < site.stackTrace.getDepth(); j++)
+        {
+            site.stackTrace.getSymbolName(&name, j);
+
+            buf.clear();
+            buf.append(' ', indent);
+            buf.appendWithFormat("      - \"%s\"\n", name.cstr());
+            stream.writeDecorationText(buf);
+        }
+    }
+}
+
+void ManualProfiler::writeTrace(WriteStream& stream)
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    stream.writeU32(cTraceSignature);
+    stream.writeU32(cTraceVersion);
+    stream.writeU64(mSampleInterval);
+    stream.writeU32(static_cast<u32>(mHeapNum));
+    stream.writeU32(static_cast<u32>(mCallSiteNum));
+    stream.writeU32(static_cast<u32>(mEventNum));
+    stream.writeU32(mDroppedNum);
+
+    for (s32 i = 0; i < mHeapNum; i++)
+    {
+        const HeapEntry& entry = mHeaps[i];
+
+        stream.writeU8(static_cast<u8>(entry.name.calcLength()));
+        stream.writeMemBlock(entry.name.cstr(), static_cast<u32>(entry.name.calcLength()));
+        WriteStats(stream, entry.stats);
+    }
+
+    for (s32 i = 0; i < mCallSiteNum; i++)
+    {
+        const CallSite& site = mCallSites[i];
+
+        stream.writeU16(static_cast<u16>(site.heapIndex));
+        stream.writeU8(static_cast<u8>(site.stackTrace.getDepth()));
+
+        for (s32 j = 0; j < site.stackTrace.getDepth(); j++)
+            stream.writeU64(site.stackTrace.getAddress(j));
+
+        WriteStats(stream, site.stats);
+    }
+
+    // Oldest first
+    s32 first = mEventHead - mEventNum;
+    if (first < 0)
+        first += mEventNumMax;
+
+    for (s32 i = 0; i < mEventNum; i++)
+    {
+        const Event& event = mEvents[(first + i) % mEventNumMax];
+
+        stream.writeU8(static_cast<u8>(event.type));
+        stream.writeU16(event.heapIndex);
+        stream.writeS32(event.callSiteIndex);
+        stream.writeU64(event.tick);
+        stream.writeU64(event.address);
+        stream.writeU64(event.size);
+    }
+}
+
+void ManualProfiler::onAlloc_(const HeapMgr::AllocCallbackArg* arg)
+{
+    if (mPrevAllocCallback)
+        mPrevAllocCallback->invoke(arg);
+
+    u64 size = arg->request_size;
+    u64 sizeWeight = size;
+    u32 numWeight = 1;
+
+    if (mSampleInterval != 0)
+    {
+        s64 interval = static_cast<s64>(mSampleInterval);
+
+        s64 remaining = static_cast<s64>(mBytesUntilSample.add(-static_cast<s64>(size))) - static_cast<s64>(size);
+        if (remaining > 0)
+            return;
+
+        // Every sample hands the next interval to the threads racing with it
+        mBytesUntilSample.add(interval * (-remaining / interval + 1));
+
+        // Smaller allocations are less likely to be sampled and stand for more of them
+        if (size < static_cast<u64>(interval))
+        {
+            sizeWeight = interval;
+            numWeight = size != 0 ? static_cast<u32>(interval / size) : 1;
+        }
+    }
+
+    StackTrace stackTrace;
+    stackTrace.capture(mStackSkipNum);
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    s32 heapIndex = findOrAddHeap_(arg->heap);
+    if (heapIndex < 0)
+    {
+        mDroppedNum++;
+        return;
+    }
+
+    s32 callSiteIndex = findOrAddCallSite_(stackTrace, heapIndex);
+    if (callSiteIndex < 0)
+    {
+        mDroppedNum++;
+        return;
+    }
+
+    // An address can come back without a free callback, e.g. after FrameHeap::freeAll()
+    LiveAlloc stale;
+    if (removeLiveAlloc_(arg->ptr, &stale))
+        releaseLiveAlloc_(stale, EventType::eFree);
+
+    if (mLiveAllocNum >= mLiveAllocNumMax)
+    {
+        mDroppedNum++;
+        return;
+    }
+
+    addLiveAlloc_(arg->ptr, size, callSiteIndex, numWeight, sizeWeight);
+
+    AddAlloc(&mCallSites[callSiteIndex].stats, numWeight, sizeWeight);
+    AddAlloc(&mHeaps[heapIndex].stats, numWeight, sizeWeight);
+
+    pushEvent_(EventType::eAlloc, arg->ptr, size, callSiteIndex);
+}
+
+void ManualProfiler::onFree_(const HeapMgr::FreeCallbackArg* arg)
+{
+    if (mPrevFreeCallback)
+        mPrevFreeCallback->invoke(arg);
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    if (mLiveAllocNum == 0)
+        return;
+
+    LiveAlloc alloc;
+    if (removeLiveAlloc_(arg->ptr, &alloc))
+        releaseLiveAlloc_(alloc, EventType::eFree);
+}
+
+void ManualProfiler::onDestroy_(const HeapMgr::DestroyCallbackArg* arg)
+{
+    if (mPrevDestroyCallback)
+        mPrevDestroyCallback->invoke(arg);
+
+    s32 heapIndex;
+
+    {
+        ScopedLock<CriticalSection> lock(&mCS);
+
+        heapIndex = findHeap_(arg->heap);
+        if (heapIndex < 0)
+            return;
+
+        // Backward shift deletion may move an entry into the current slot, look at it again then
+        for (u32 i = 0; i <= mLiveAllocSlotMask;)
+        {
+            const LiveAlloc& alloc = mLiveAllocs[i];
+            if (alloc.ptr && mCallSites[alloc.callSiteIndex].heapIndex == heapIndex)
+            {
+                LiveAlloc leaked = alloc;
+                removeLiveAllocAt_(static_cast<s32>(i));
+                releaseLiveAlloc_(leaked, EventType::eLeak);
+                continue;
+            }
+
+            i++;
+        }
+
+        mHeaps[heapIndex].heap = nullptr;
+    }
+
+    reportLeaks(heapIndex);
+}
+
+s32 ManualProfiler::findHeap_(const Heap* heap) const
+{
+    for (s32 i = 0; i < mHeapNum; i++)
+    {
+        if (mHeaps[i].heap == heap)
+            return i;
+    }
+
+    return -1;
+}
+
+s32 ManualProfiler::findOrAddHeap_(Heap* heap)
+{
+    s32 idx = findHeap_(heap);
+    if (idx >= 0)
+        return idx;
+
+    if (mHeapNum >= mHeapNumMax)
+        return -1;
+
+    HeapEntry& entry = mHeaps[mHeapNum];
+    entry.heap = heap;
+    entry.name = heap->getName();
+    ClearStats(&entry.stats);
+
+    return mHeapNum++;
+}
+
+s32 ManualProfiler::findOrAddCallSite_(const StackTrace& stackTrace, s32 heapIndex)
+{
+    u32 hash = stackTrace.calcHash();
+
+    for (u32 slot = hash & mCallSiteSlotMask;; slot = (slot + 1) & mCallSiteSlotMask)
+    {
+        s32 idx = mCallSiteSlots[slot];
+        if (idx < 0)
+        {
+            if (mCallSiteNum >= mCallSiteNumMax)
+                return -1;
+
+            CallSite& site = mCallSites[mCallSiteNum];
+            site.stackTrace = stackTrace;
+            site.hash = hash;
+            site.heapIndex = heapIndex;
+            ClearStats(&site.stats);
+
+            mCallSiteSlots[slot] = mCallSiteNum;
+            return mCallSiteNum++;
+        }
+
+        const CallSite& site = mCallSites[idx];
+        if (site.hash == hash && site.heapIndex == heapIndex && site.stackTrace.isEqual(stackTrace))
+            return idx;
+    }
+}
+
+u32 ManualProfiler::getLiveAllocSlot_(const void* ptr) const
+{
+    u64 key = reinterpret_cast<uintptr_t>(ptr) >> 3;
+    return static_cast<u32>((key * 0x9E3779B97F4A7C15ull) >> 32) & mLiveAllocSlotMask;
+}
+
+void ManualProfiler::addLiveAlloc_(const void* ptr, u64 size, s32 callSiteIndex, u32 numWeight, u64 sizeWeight)
+{
+    u32 slot = getLiveAllocSlot_(ptr);
+    while (mLiveAllocs[slot].ptr)
+        slot = (slot + 1) & mLiveAllocSlotMask;
+
+    LiveAlloc& alloc = mLiveAllocs[slot];
+    alloc.ptr = ptr;
+    alloc.size = size;
+    alloc.callSiteIndex = callSiteIndex;
+    alloc.numWeight = numWeight;
+    alloc.sizeWeight = sizeWeight;
+
+    mLiveAllocNum++;
+}
+
+bool ManualProfiler::removeLiveAlloc_(const void* ptr, LiveAlloc* removed)
+{
+    for (u32 slot = getLiveAllocSlot_(ptr); mLiveAllocs[slot].ptr; slot = (slot + 1) & mLiveAllocSlotMask)
+    {
+        if (mLiveAllocs[slot].ptr == ptr)
+        {
+            *removed = mLiveAllocs[slot];
+            removeLiveAllocAt_(static_cast<s32>(slot));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ManualProfiler::removeLiveAllocAt_(s32 slot)
+{
+    // Shift the following entries of the cluster back so no probe sequence is broken
+    u32 hole = static_cast<u32>(slot);
+
+    for (u32 next = (hole + 1) & mLiveAllocSlotMask; mLiveAllocs[next].ptr; next = (next + 1) & mLiveAllocSlotMask)
+    {
+        u32 home = getLiveAllocSlot_(mLiveAllocs[next].ptr);
+
+        // Move it when its home slot is not cyclically within (hole, next]
+        if (((next - home) & mLiveAllocSlotMask) >= ((next - hole) & mLiveAllocSlotMask))
+        {
+            mLiveAllocs[hole] = mLiveAllocs[next];
+            hole = next;
+        }
+    }
+
+    mLiveAllocs[hole].ptr = nullptr;
+    mLiveAllocNum--;
+}
+
+void ManualProfiler::releaseLiveAlloc_(const LiveAlloc& alloc, EventType type)
+{
+    CallSite& site = mCallSites[alloc.callSiteIndex];
+    bool isLeak = type == EventType::eLeak;
+
+    RemoveLive(&site.stats, alloc.numWeight, alloc.sizeWeight, isLeak);
+    RemoveLive(&mHeaps[site.heapIndex].stats, alloc.numWeight, alloc.sizeWeight, isLeak);
+
+    pushEvent_(type, alloc.ptr, alloc.size, alloc.callSiteIndex);
+}
+
+void ManualProfiler::pushEvent_(EventType type, const void* ptr, u64 size, s32 callSiteIndex)
+{
+    if (mEventNumMax == 0)
+        return;
+
+    Event& event = mEvents[mEventHead];
+    event.tick = TickTime().toU64();
+    event.address = reinterpret_cast<uintptr_t>(ptr);
+    event.size = size;
+    event.callSiteIndex = callSiteIndex;
+    event.heapIndex = static_cast<u16>(mCallSites[callSiteIndex].heapIndex);
+    event.type = type;
+
+    mEventHead = (mEventHead + 1) % mEventNumMax;
+    if (mEventNum < mEventNumMax)
+        mEventNum++;
+}
+
+} // namespace sead
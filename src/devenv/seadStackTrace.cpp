@@ -0,0 +1,51 @@
+#include <devenv/seadStackTrace.h>
+
+#include <basis/seadRawPrint.h>
+
+namespace sead {
+
+u32 StackTrace::calcHash() const
+{
+    // FNV-1a over the addresses
+    u32 hash = 0x811C9DC5;
+
+    for (s32 i = 0; i < mDepth; i++)
+    {
+        u64 address = mAddresses[i];
+        for (s32 j = 0; j < 8; j++)
+        {
+            hash ^= static_cast<u32>(address & 0xFF);
+            hash *= 0x01000193;
+            address >>= 8;
+        }
+    }
+
+    return hash;
+}
+
+bool StackTrace::isEqual(const StackTrace& other) const
+{
+    if (mDepth != other.mDepth)
+        return false;
+
+    for (s32 i = 0; i < mDepth; i++)
+    {
+        if (mAddresses[i] != other.mAddresses[i])
+            return false;
+    }
+
+    return true;
+}
+
+void StackTrace::print() const
+{
+    FixedSafeString<256> name;
+
+    for (s32 i = 0; i < mDepth; i++)
+    {
+        getSymbolName(&name, i);
+        SEAD_PRINT("  #%d %s\n", i, name.cstr());
+    }
+}
+
+} // namespace sead
@@ -0,0 +1,87 @@
+#include <devenv/seadStackTrace.h>
+
+#include <basis/win/seadWindows.h>
+
+#include <DbgHelp.h>
+
+namespace sead {
+
+namespace {
+
+// DbgHelp is single threaded, every call into it goes through this lock
+SRWLOCK sDbgHelpLock = SRWLOCK_INIT;
+bool sIsDbgHelpInitialized = false;
+bool sIsDbgHelpAvailable = false;
+
+bool InitializeDbgHelp()
+{
+    if (!sIsDbgHelpInitialized)
+    {
+        // Symbols of a module are only loaded when an address in it is first looked up
+        SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+        sIsDbgHelpAvailable = SymInitialize(GetCurrentProcess(), nullptr, TRUE) != FALSE;
+        sIsDbgHelpInitialized = true;
+    }
+
+    return sIsDbgHelpAvailable;
+}
+
+} // namespace
+
+s32 StackTrace::capture(s32 skipNum)
+{
+    SEAD_ASSERT(0 <= skipNum && skipNum <= cSkipNumMax);
+
+    void* frames[cDepthMax];
+    // One more for capture() itself
+    s32 frameNum = CaptureStackBackTrace(static_cast<DWORD>(skipNum + 1), cDepthMax, frames, nullptr);
+
+    for (s32 i = 0; i < frameNum; i++)
+        mAddresses[i] = reinterpret_cast<uintptr_t>(frames[i]);
+
+    mDepth = frameNum;
+    return mDepth;
+}
+
+void StackTrace::getSymbolName(BufferedSafeString* name, s32 idx) const
+{
+    SEAD_ASSERT(name);
+
+    uintptr_t address = getAddress(idx);
+
+    {
+        const u32 cNameLengthMax = 256;
+
+        alignas(SYMBOL_INFO) u8 buffer[sizeof(SYMBOL_INFO) + cNameLengthMax];
+        SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen = cNameLengthMax;
+
+        DWORD64 displacement = 0;
+
+        AcquireSRWLockExclusive(&sDbgHelpLock);
+        bool found = InitializeDbgHelp() && SymFromAddr(GetCurrentProcess(), address, &displacement, symbol);
+        ReleaseSRWLockExclusive(&sDbgHelpLock);
+
+        if (found)
+        {
+            name->format("%s+0x%llx", symbol->Name, static_cast<unsigned long long>(displacement));
+            return;
+        }
+    }
+
+    // No symbols for the module, fall back to its file name
+    HMODULE module = nullptr;
+    char moduleName[MAX_PATH];
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           reinterpret_cast<LPCSTR>(address), &module) &&
+        GetModuleFileNameA(module, moduleName, MAX_PATH) != 0)
+    {
+        name->format("%s+0x%zx", moduleName, static_cast<size_t>(address - reinterpret_cast<uintptr_t>(module)));
+        return;
+    }
+
+    name->format("0x%p", reinterpret_cast<void*>(address));
+}
+
+} // namespace sead
@@ -1,9 +1,90 @@
 #include <filedevice/posix/seadPosixFileDevicePosix.h>
 
+#include <math/seadMathCalcCommon.h>
+
 #include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace sead {
 
+u8* PosixFileDevice::doLoad_(LoadArg& arg)
+{
+    if (!arg.use_map || arg.buffer)
+        return FileDevice::doLoad_(arg);
+
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (Mathi::abs(arg.alignment) > pageSize)
+        return FileDevice::doLoad_(arg);
+
+    FixedSafeString<512> filepath;
+    doResolvePath_(&filepath, arg.path);
+
+    s32 fd = ::open(filepath.cstr(), O_RDONLY);
+    if (fd == -1)
+    {
+        mLastRawError = errno;
+        return nullptr;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        mLastRawError = errno;
+        ::close(fd);
+        return nullptr;
+    }
+
+    if (st.st_size == 0)
+    {
+        SEAD_WARNING("fileSize is zero.[%s]", arg.path.cstr());
+        ::close(fd);
+        return nullptr;
+    }
+
+    if (st.st_size > static_cast<off_t>(0xFFFFFFFF))
+    {
+        SEAD_WARNING("file is too large to map.[%s]", arg.path.cstr());
+        ::close(fd);
+        return nullptr;
+    }
+
+    u32 fileSize = static_cast<u32>(st.st_size);
+
+    // The mapping stays valid after the descriptor is closed
+    void* map = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    mLastRawError = errno;
+    ::close(fd);
+
+    if (map == MAP_FAILED)
+    {
+        if (arg.enable_alloc_assert)
+            SEAD_ASSERT_MSG(false, "map size[%u] failed for file[%s]", fileSize, arg.path.cstr());
+
+        return nullptr;
+    }
+
+    ::madvise(map, fileSize, MADV_WILLNEED);
+
+    arg.read_size = fileSize;
+    arg.roundup_size = Mathi::roundUpN(fileSize, static_cast<s32>(pageSize));
+    arg.need_unload = false;
+    arg.map_device = this;
+
+    return static_cast<u8*>(map);
+}
+
+void PosixFileDevice::doUnmap_(u8* data, u32 size)
+{
+    if (::munmap(data, size) != 0)
+    {
+        mLastRawError = errno;
+        SEAD_WARNING("munmap failed[%d]", mLastRawError);
+    }
+}
+
 FileDevice* PosixFileDevice::doOpen_(FileHandle* handle, const SafeString& filename, FileOpenFlag flag)
 {
     FixedSafeString<512> filepath;
@@ -79,6 +160,45 @@ bool PosixFileDevice::doRead_(u32* readSize, FileHandle* handle, u8* buf, u32 si
     return bytesRead == size;
 }
 
+bool PosixFileDevice::doReadAt_(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset)
+{
+    std::FILE* file = *getHANDLE_(handle);
+
+    // pread() bypasses the stream buffer, so pending writes have to reach the file first
+    if (std::fflush(file) != 0)
+    {
+        mLastRawError = errno;
+        return false;
+    }
+
+    s32 fd = ::fileno(file);
+    u32 totalReadSize = 0;
+
+    while (totalReadSize < size)
+    {
+        off_t readPos = static_cast<off_t>(offset + totalReadSize);
+        ssize_t bytesRead = ::pread(fd, buf + totalReadSize, size - totalReadSize, readPos);
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            mLastRawError = errno;
+            break;
+        }
+
+        if (bytesRead == 0)
+            break;
+
+        totalReadSize += static_cast<u32>(bytesRead);
+    }
+
+    if (readSize)
+        *readSize = totalReadSize;
+
+    return totalReadSize == size;
+}
+
 bool PosixFileDevice::doWrite_(u32* writeSize, FileHandle* handle, const u8* buf, u32 size)
 {
     size_t bytesWritten = std::fwrite(buf, sizeof(u8), size, *getHANDLE_(handle));
@@ -91,7 +211,7 @@ bool PosixFileDevice::doWrite_(u32* writeSize, FileHandle* handle, const u8* buf
     return bytesWritten == size;
 }
 
-bool PosixFileDevice::doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin)
+bool PosixFileDevice::doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin)
 {
     s32 moveMethod = SEEK_SET;
     switch (origin)
@@ -112,16 +232,16 @@ bool PosixFileDevice::doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin)
             return false;
     }
 
-    s32 res = std::fseek(*getHANDLE_(handle), offset, moveMethod);
+    s32 res = ::fseeko(*getHANDLE_(handle), static_cast<off_t>(offset), moveMethod);
 
     mLastRawError = errno;
 
     return res == 0;
 }
 
-bool PosixFileDevice::doGetCurrentSeekPos_(u32* pos, FileHandle* handle)
+bool PosixFileDevice::doGetCurrentSeekPos_(u64* pos, FileHandle* handle)
 {
-    s32 currentPos = std::ftell(*getHANDLE_(handle));
+    off_t currentPos = ::ftello(*getHANDLE_(handle));
 
     mLastRawError = errno;
 
@@ -131,11 +251,11 @@ bool PosixFileDevice::doGetCurrentSeekPos_(u32* pos, FileHandle* handle)
         return false;
     }
 
-    *pos = static_cast<u32>(currentPos);
+    *pos = static_cast<u64>(currentPos);
     return true;
 }
 
-bool PosixFileDevice::doGetFileSize_(u32* size, const SafeString& path)
+bool PosixFileDevice::doGetFileSize_(u64* size, const SafeString& path)
 {
     // TODO
     SEAD_UNUSED(size);
@@ -144,9 +264,9 @@ bool PosixFileDevice::doGetFileSize_(u32* size, const SafeString& path)
     return false;
 }
 
-bool PosixFileDevice::doGetFileSize_(u32* size, FileHandle* handle)
+bool PosixFileDevice::doGetFileSize_(u64* size, FileHandle* handle)
 {
-    u32 prevPos = 0;
+    u64 prevPos = 0;
     if (!doGetCurrentSeekPos_(&prevPos, handle))
     {
         *size = 0;
@@ -159,14 +279,14 @@ bool PosixFileDevice::doGetFileSize_(u32* size, FileHandle* handle)
         return false;
     }
 
-    u32 fileSize = 0;
+    u64 fileSize = 0;
     if (!doGetCurrentSeekPos_(&fileSize, handle))
     {
         *size = 0;
         return false;
     }
 
-    if (!doSeek_(handle, prevPos, SeekOrigin::eBegin))
+    if (!doSeek_(handle, static_cast<s64>(prevPos), SeekOrigin::eBegin))
     {
         *size = 0;
         return false;
@@ -0,0 +1,239 @@
+#include <filedevice/seadArchiveFileDevice.h>
+
+#include <math/seadMathCalcCommon.h>
+#include <prim/seadPtrUtil.h>
+#include <resource/seadArchiveRes.h>
+
+#include <cstring>
+
+namespace sead {
+
+namespace {
+
+struct FileHandleInner
+{
+    const u8* data;
+    u32 size;
+    u32 pos;
+};
+
+static_assert(sizeof(FileHandleInner) <= sizeof(HandleBuffer), "FileHandleInner does not fit in HandleBuffer");
+
+} // namespace
+
+ArchiveFileDevice::ArchiveFileDevice(ArchiveRes* archive)
+    : FileDevice("arc")
+    , mArchive(archive)
+{
+}
+
+ArchiveFileDevice::~ArchiveFileDevice()
+{
+}
+
+bool ArchiveFileDevice::doIsAvailable_() const
+{
+    return mArchive && mArchive->isEnable();
+}
+
+u8* ArchiveFileDevice::doLoad_(LoadArg& arg)
+{
+    if (arg.buffer)
+        return FileDevice::doLoad_(arg);
+
+    ArchiveRes::FileInfo info;
+    u8* data = static_cast<u8*>(mArchive->getFile(arg.path, &info));
+    if (!data)
+        return nullptr;
+
+    if (info.length == 0)
+    {
+        SEAD_WARNING("fileSize is zero.[%s]", arg.path.cstr());
+        return nullptr;
+    }
+
+    // Files packed with a smaller alignment than requested are copied out like on any other device
+    if (arg.alignment != 0 && !PtrUtil::isAligned(data, Mathi::abs(arg.alignment)))
+        return FileDevice::doLoad_(arg);
+
+    arg.read_size = info.length;
+    arg.roundup_size = info.length;
+    arg.need_unload = false;
+    arg.map_device = nullptr;
+
+    return data;
+}
+
+FileDevice* ArchiveFileDevice::doOpen_(FileHandle* handle, const SafeString& filename, FileOpenFlag flag)
+{
+    if (flag != FileOpenFlag::eReadOnly)
+    {
+        SEAD_WARNING("archive is read only.[%s]", filename.cstr());
+        return nullptr;
+    }
+
+    ArchiveRes::FileInfo info;
+    const u8* data = static_cast<const u8*>(mArchive->getFile(filename, &info));
+    if (!data)
+        return nullptr;
+
+    FileHandleInner* inner = reinterpret_cast<FileHandleInner*>(&getHandleBaseHandleBuffer_(handle)[0]);
+    inner->data = data;
+    inner->size = info.length;
+    inner->pos = 0;
+
+    return this;
+}
+
+bool ArchiveFileDevice::doClose_(FileHandle* handle)
+{
+    SEAD_UNUSED(handle);
+    return true;
+}
+
+bool ArchiveFileDevice::doFlush_(FileHandle* handle)
+{
+    SEAD_UNUSED(handle);
+    return true;
+}
+
+bool ArchiveFileDevice::doRemove_(const SafeString& path)
+{
+    SEAD_UNUSED(path);
+    return false;
+}
+
+bool ArchiveFileDevice::doRead_(u32* readSize, FileHandle* handle, u8* buf, u32 size)
+{
+    FileHandleInner* inner = reinterpret_cast<FileHandleInner*>(&getHandleBaseHandleBuffer_(handle)[0]);
+
+    u32 bytesRead = Mathu::min(size, inner->size - inner->pos);
+    std::memcpy(buf, inner->data + inner->pos, bytesRead);
+    inner->pos += bytesRead;
+
+    if (readSize)
+        *readSize = bytesRead;
+
+    return bytesRead == size;
+}
+
+bool ArchiveFileDevice::doWrite_(u32* writeSize, FileHandle* handle, const u8* buf, u32 size)
+{
+    SEAD_UNUSED(handle);
+    SEAD_UNUSED(buf);
+    SEAD_UNUSED(size);
+
+    if (writeSize)
+        *writeSize = 0;
+
+    return false;
+}
+
+bool ArchiveFileDevice::doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin)
+{
+    FileHandleInner* inner = reinterpret_cast<FileHandleInner*>(&getHandleBaseHandleBuffer_(handle)[0]);
+
+    s64 base = 0;
+    switch (origin)
+    {
+        case SeekOrigin::eBegin:
+            base = 0;
+            break;
+
+        case SeekOrigin::eCurrent:
+            base = inner->pos;
+            break;
+
+        case SeekOrigin::eEnd:
+            base = inner->size;
+            break;
+
+        default:
+            return false;
+    }
+
+    // Compared against the remaining range so huge offsets can not overflow
+    if (offset < -base || offset > inner->size - base)
+        return false;
+
+    inner->pos = static_cast<u32>(base + offset);
+    return true;
+}
+
+bool ArchiveFileDevice::doGetCurrentSeekPos_(u64* pos, FileHandle* handle)
+{
+    FileHandleInner* inner = reinterpret_cast<FileHandleInner*>(&getHandleBaseHandleBuffer_(handle)[0]);
+
+    *pos = inner->pos;
+    return true;
+}
+
+bool ArchiveFileDevice::doGetFileSize_(u64* size, const SafeString& path)
+{
+    ArchiveRes::FileInfo info;
+    if (!mArchive->getFile(path, &info))
+    {
+        *size = 0;
+        return false;
+    }
+
+    *size = info.length;
+    return true;
+}
+
+bool ArchiveFileDevice::doGetFileSize_(u64* size, FileHandle* handle)
+{
+    FileHandleInner* inner = reinterpret_cast<FileHandleInner*>(&getHandleBaseHandleBuffer_(handle)[0]);
+
+    *size = inner->size;
+    return true;
+}
+
+bool ArchiveFileDevice::doIsExistFile_(bool* isExist, const SafeString& path)
+{
+    *isExist = mArchive->convertPathToEntryID(path) != -1;
+    return true;
+}
+
+bool ArchiveFileDevice::doIsExistDirectory_(bool* isExist, const SafeString& path)
+{
+    *isExist = mArchive->isExistDirectory(path);
+    return true;
+}
+
+FileDevice* ArchiveFileDevice::doOpenDirectory_(DirectoryHandle* handle, const SafeString& dirname)
+{
+    if (!mArchive->openDirectory(&getHandleBaseHandleBuffer_(handle), dirname))
+        return nullptr;
+
+    return this;
+}
+
+bool ArchiveFileDevice::doCloseDirectory_(DirectoryHandle* handle)
+{
+    return mArchive->closeDirectory(&getHandleBaseHandleBuffer_(handle));
+}
+
+bool ArchiveFileDevice::doReadDirectory_(u32* readNum, DirectoryHandle* handle, DirectoryEntry* entry, u32 num)
+{
+    u32 count = mArchive->readDirectory(&getHandleBaseHandleBuffer_(handle), entry, num);
+
+    if (readNum)
+        *readNum = count;
+
+    return true;
+}
+
+bool ArchiveFileDevice::doMakeDirectory_(const SafeString& path, u32 permission)
+{
+    SEAD_UNUSED(path);
+    SEAD_UNUSED(permission);
+    return false;
+}
+
+RawErrorCode ArchiveFileDevice::doGetLastRawError_() const
+{
+    return 0;
+}
+
+} // namespace sead
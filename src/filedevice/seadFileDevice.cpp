@@ -32,6 +32,13 @@ u8* FileDevice::tryLoad(LoadArg& arg)
     return doLoad_(arg);
 }
 
+void FileDevice::unmap(u8* data, u32 size)
+{
+    SEAD_ASSERT(data);
+    if (data)
+        doUnmap_(data, size);
+}
+
 bool FileDevice::trySave(SaveArg& arg)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
@@ -182,6 +189,35 @@ bool FileDevice::tryRead(u32* readSize, FileHandle* handle, u8* buf, u32 size)
     return true;
 }
 
+bool FileDevice::tryReadAt(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset)
+{
+    SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
+    if (!hasPermission())
+        return false;
+
+    if (!handle)
+    {
+        SEAD_ASSERT_MSG(false, "handle is null");
+        return false;
+    }
+
+    if (!isMatchDevice_(handle))
+    {
+        SEAD_ASSERT_MSG(false, "handle device miss match");
+        return false;
+    }
+
+    if (!buf)
+    {
+        SEAD_ASSERT_MSG(false, "buf is null");
+        return false;
+    }
+
+    bool success = doReadAt_(readSize, handle, buf, size, offset);
+    SEAD_ASSERT_MSG(!readSize || *readSize <= size, "buffer overflow");
+    return success;
+}
+
 bool FileDevice::tryWrite(u32* writeSize, FileHandle* handle, const u8* buf, u32 size)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
@@ -209,7 +245,7 @@ bool FileDevice::tryWrite(u32* writeSize, FileHandle* handle, const u8* buf, u32
     return doWrite_(writeSize, handle, buf, size);
 }
 
-bool FileDevice::trySeek(FileHandle* handle, s32 offset, SeekOrigin origin)
+bool FileDevice::trySeek(FileHandle* handle, s64 offset, SeekOrigin origin)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
     if (!hasPermission())
@@ -230,7 +266,7 @@ bool FileDevice::trySeek(FileHandle* handle, s32 offset, SeekOrigin origin)
     return doSeek_(handle, offset, origin);
 }
 
-bool FileDevice::tryGetCurrentSeekPos(u32* pos, FileHandle* handle)
+bool FileDevice::tryGetCurrentSeekPos(u64* pos, FileHandle* handle)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
     if (!hasPermission())
@@ -257,7 +293,28 @@ bool FileDevice::tryGetCurrentSeekPos(u32* pos, FileHandle* handle)
     return doGetCurrentSeekPos_(pos, handle);
 }
 
-bool FileDevice::tryGetFileSize(u32* size, const SafeString& path)
+bool FileDevice::tryGetCurrentSeekPos(u32* pos, FileHandle* handle)
+{
+    if (!pos)
+    {
+        SEAD_ASSERT_MSG(false, "pos is null");
+        return false;
+    }
+
+    u64 pos64 = 0;
+    bool success = tryGetCurrentSeekPos(&pos64, handle);
+
+    if (success && pos64 > Mathu::maxNumber())
+    {
+        SEAD_WARNING("seek pos[%llu] does not fit in u32", static_cast<unsigned long long>(pos64));
+        success = false;
+    }
+
+    *pos = success ? static_cast<u32>(pos64) : 0;
+    return success;
+}
+
+bool FileDevice::tryGetFileSize(u64* size, const SafeString& path)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
     if (!hasPermission())
@@ -272,7 +329,28 @@ bool FileDevice::tryGetFileSize(u32* size, const SafeString& path)
     return doGetFileSize_(size, path);
 }
 
-bool FileDevice::tryGetFileSize(u32* size, FileHandle* handle)
+bool FileDevice::tryGetFileSize(u32* size, const SafeString& path)
+{
+    if (!size)
+    {
+        SEAD_ASSERT_MSG(false, "size is null");
+        return false;
+    }
+
+    u64 size64 = 0;
+    bool success = tryGetFileSize(&size64, path);
+
+    if (success && size64 > Mathu::maxNumber())
+    {
+        SEAD_WARNING("file size[%llu] does not fit in u32.[%s]", static_cast<unsigned long long>(size64), path.cstr());
+        success = false;
+    }
+
+    *size = success ? static_cast<u32>(size64) : 0;
+    return success;
+}
+
+bool FileDevice::tryGetFileSize(u64* size, FileHandle* handle)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
     if (!hasPermission())
@@ -293,6 +371,27 @@ bool FileDevice::tryGetFileSize(u32* size, FileHandle* handle)
     return doGetFileSize_(size, handle);
 }
 
+bool FileDevice::tryGetFileSize(u32* size, FileHandle* handle)
+{
+    if (!size)
+    {
+        SEAD_ASSERT_MSG(false, "size is null");
+        return false;
+    }
+
+    u64 size64 = 0;
+    bool success = tryGetFileSize(&size64, handle);
+
+    if (success && size64 > Mathu::maxNumber())
+    {
+        SEAD_WARNING("file size[%llu] does not fit in u32", static_cast<unsigned long long>(size64));
+        success = false;
+    }
+
+    *size = success ? static_cast<u32>(size64) : 0;
+    return success;
+}
+
 bool FileDevice::tryIsExistFile(bool* isExist, const SafeString& path)
 {
     SEAD_ASSERT_MSG(hasPermission(), "Device permission error.");
@@ -460,10 +559,19 @@ u8* FileDevice::doLoad_(LoadArg& arg)
     u32 unalignBufferSize = arg.buffer_size;
     if (!arg.buffer || arg.check_read_whole)
     {
-        u32 fileSize = 0;
-        if (!tryGetFileSize(&fileSize, &handle))
+        u64 fileSize64 = 0;
+        if (!tryGetFileSize(&fileSize64, &handle))
             return nullptr;
 
+        // Whole file loads go through u32 buffers, larger files have to be streamed through a FileHandle
+        if (fileSize64 > Mathu::maxNumber())
+        {
+            SEAD_WARNING("file size[%llu] is too large to load.[%s]",
+                         static_cast<unsigned long long>(fileSize64), arg.path.cstr());
+            return nullptr;
+        }
+
+        u32 fileSize = static_cast<u32>(fileSize64);
         unalignBufferSize = fileSize;
 
         if (fileSize == 0)
@@ -538,10 +646,38 @@ u8* FileDevice::doLoad_(LoadArg& arg)
     arg.read_size = readSize;
     arg.roundup_size = bufferSize;
     arg.need_unload = needUnload;
+    arg.map_device = nullptr;
 
     return buffer;
 }
 
+void FileDevice::doUnmap_(u8* data, u32 size)
+{
+    SEAD_UNUSED(data);
+    SEAD_UNUSED(size);
+    SEAD_ASSERT_MSG(false, "device[%s] does not support mapping", mDriveName.cstr());
+}
+
+bool FileDevice::doReadAt_(u32* readSize, FileHandle* handle, u8* buf, u32 size, u64 offset)
+{
+    u64 pos = 0;
+    if (!doGetCurrentSeekPos_(&pos, handle))
+        return false;
+
+    if (offset > static_cast<u64>(MathCalcCommon<s64>::maxNumber()))
+        return false;
+
+    if (!doSeek_(handle, static_cast<s64>(offset), SeekOrigin::eBegin))
+        return false;
+
+    bool success = doRead_(readSize, handle, buf, size);
+
+    if (!doSeek_(handle, static_cast<s64>(pos), SeekOrigin::eBegin))
+        return false;
+
+    return success;
+}
+
 bool FileDevice::doSave_(SaveArg& arg)
 {
     if (!arg.buffer)
@@ -665,6 +801,28 @@ bool FileHandle::tryRead(u32* readSize, u8* buf, u32 size)
     return mDevice->tryRead(readSize, this, buf, size);
 }
 
+u32 FileHandle::readAt(u8* buf, u32 size, u64 offset)
+{
+    if (!mDevice)
+    {
+        SEAD_ASSERT_MSG(false, "handle not opened");
+        return 0;
+    }
+
+    return mDevice->readAt(this, buf, size, offset);
+}
+
+bool FileHandle::tryReadAt(u32* readSize, u8* buf, u32 size, u64 offset)
+{
+    if (!mDevice)
+    {
+        SEAD_ASSERT_MSG(false, "handle not opened");
+        return false;
+    }
+
+    return mDevice->tryReadAt(readSize, this, buf, size, offset);
+}
+
 u32 FileHandle::write(const u8* buf, u32 size)
 {
     if (!mDevice)
@@ -687,7 +845,7 @@ bool FileHandle::tryWrite(u32* writeSize, const u8* buf, u32 size)
     return mDevice->tryWrite(writeSize, this, buf, size);
 }
 
-bool FileHandle::seek(s32 offset, FileDevice::SeekOrigin origin)
+bool FileHandle::seek(s64 offset, FileDevice::SeekOrigin origin)
 {
     if (!mDevice)
     {
@@ -698,7 +856,7 @@ bool FileHandle::seek(s32 offset, FileDevice::SeekOrigin origin)
     return mDevice->seek(this, offset, origin);
 }
 
-bool FileHandle::trySeek(s32 offset, FileDevice::SeekOrigin origin)
+bool FileHandle::trySeek(s64 offset, FileDevice::SeekOrigin origin)
 {
     if (!mDevice)
     {
@@ -709,7 +867,7 @@ bool FileHandle::trySeek(s32 offset, FileDevice::SeekOrigin origin)
     return mDevice->trySeek(this, offset, origin);
 }
 
-u32 FileHandle::getCurrentSeekPos()
+u64 FileHandle::getCurrentSeekPos()
 {
     if (!mDevice)
     {
@@ -720,6 +878,17 @@ u32 FileHandle::getCurrentSeekPos()
     return mDevice->getCurrentSeekPos(this);
 }
 
+bool FileHandle::tryGetCurrentSeekPos(u64* pos)
+{
+    if (!mDevice)
+    {
+        SEAD_ASSERT_MSG(false, "handle not opened");
+        return false;
+    }
+
+    return mDevice->tryGetCurrentSeekPos(pos, this);
+}
+
 bool FileHandle::tryGetCurrentSeekPos(u32* pos)
 {
     if (!mDevice)
@@ -731,7 +900,7 @@ bool FileHandle::tryGetCurrentSeekPos(u32* pos)
     return mDevice->tryGetCurrentSeekPos(pos, this);
 }
 
-u32 FileHandle::getFileSize()
+u64 FileHandle::getFileSize()
 {
     if (!mDevice)
     {
@@ -742,6 +911,17 @@ u32 FileHandle::getFileSize()
     return mDevice->getFileSize(this);
 }
 
+bool FileHandle::tryGetFileSize(u64* size)
+{
+    if (!mDevice)
+    {
+        SEAD_ASSERT_MSG(false, "handle not opened");
+        return false;
+    }
+
+    return mDevice->tryGetFileSize(size, this);
+}
+
 bool FileHandle::tryGetFileSize(u32* size)
 {
     if (!mDevice)
@@ -114,6 +114,7 @@ u8* FileDeviceMgr::tryLoad(FileDevice::LoadArg& arg)
     arg.read_size = arg_.read_size;
     arg.roundup_size = arg_.roundup_size;
     arg.need_unload = arg_.need_unload;
+    arg.map_device = arg_.map_device;
 
     return ret;
 }
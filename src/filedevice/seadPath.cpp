@@ -110,4 +110,54 @@ bool Path::getDirectoryName(BufferedSafeString* dst, const SafeString& src)
     return false;
 }
 
+void Path::normalize(BufferedSafeString* dst, const SafeString& src)
+{
+    SEAD_ASSERT_MSG(dst, "destination buffer is null");
+    SEAD_ASSERT_MSG(dst->cstr() != src.cstr(), "destination buffer must not be the source");
+
+    dst->trim(0);
+
+    const char* str = src.cstr();
+
+    s32 idx = src.findIndex("://");
+    if (idx != -1)
+    {
+        dst->copy(src, idx + 3);
+        str += idx + 3;
+    }
+
+    if (*str == '/' || *str == '\\')
+        dst->append('/');
+
+    // Parts before root are never removed by ".."
+    const s32 root = dst->calcLength();
+
+    while (*str != '\0')
+    {
+        const char* end = str;
+        while (*end != '\0' && *end != '/' && *end != '\\')
+            end++;
+
+        s32 partLength = static_cast<s32>(end - str);
+        str = *end != '\0' ? end + 1 : end;
+
+        if (partLength == 0 || (partLength == 1 && end[-1] == '.'))
+            continue;
+
+        s32 length = dst->calcLength();
+        s32 lastPart = Mathi::max(rfindCharIndex(*dst, '/') + 1, root);
+
+        if (partLength == 2 && end[-2] == '.' && end[-1] == '.' && length > root && SafeString(dst->cstr() + lastPart) != "..")
+        {
+            dst->trim(Mathi::max(lastPart - 1, root));
+            continue;
+        }
+
+        if (length > root)
+            dst->append('/');
+
+        dst->append(SafeString(end - partLength), partLength);
+    }
+}
+
 } // namespace sead
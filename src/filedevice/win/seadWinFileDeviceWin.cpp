@@ -96,7 +96,7 @@ bool WinFileDevice::doWrite_(u32* writeSize, FileHandle* handle, const u8* buf,
     return success;
 }
 
-bool WinFileDevice::doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin)
+bool WinFileDevice::doSeek_(FileHandle* handle, s64 offset, SeekOrigin origin)
 {
     DWORD moveMethod = FILE_BEGIN;
     switch (origin)
@@ -117,30 +117,37 @@ bool WinFileDevice::doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin)
             return false;
     }
 
-    DWORD currentPos = SetFilePointer(*getHANDLE_(handle), offset, nullptr, moveMethod);
+    LARGE_INTEGER distance;
+    distance.QuadPart = offset;
+
+    BOOL success = SetFilePointerEx(*getHANDLE_(handle), distance, nullptr, moveMethod);
 
     mLastRawError = GetLastError();
 
-    return currentPos != INVALID_SET_FILE_POINTER;
+    return success != FALSE;
 }
 
-bool WinFileDevice::doGetCurrentSeekPos_(u32* pos, FileHandle* handle)
+bool WinFileDevice::doGetCurrentSeekPos_(u64* pos, FileHandle* handle)
 {
-    DWORD currentPos = SetFilePointer(*getHANDLE_(handle), 0, nullptr, FILE_CURRENT);
+    LARGE_INTEGER distance;
+    distance.QuadPart = 0;
+
+    LARGE_INTEGER currentPos;
+    BOOL success = SetFilePointerEx(*getHANDLE_(handle), distance, &currentPos, FILE_CURRENT);
 
     mLastRawError = GetLastError();
 
-    if (currentPos == INVALID_SET_FILE_POINTER)
+    if (!success)
     {
         *pos = 0;
         return false;
     }
 
-    *pos = currentPos;
+    *pos = static_cast<u64>(currentPos.QuadPart);
     return true;
 }
 
-bool WinFileDevice::doGetFileSize_(u32* size, const SafeString& path)
+bool WinFileDevice::doGetFileSize_(u64* size, const SafeString& path)
 {
     FixedSafeString<512> filepath;
     doResolvePath_(&filepath, path);
@@ -158,9 +165,7 @@ bool WinFileDevice::doGetFileSize_(u32* size, const SafeString& path)
 
         if (success)
         {
-            SEAD_ASSERT(findData.nFileSizeHigh == 0);
-
-            *size = findData.nFileSizeLow;
+            *size = (static_cast<u64>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow;
             return true;
         }
     }
@@ -169,22 +174,20 @@ bool WinFileDevice::doGetFileSize_(u32* size, const SafeString& path)
     return false;
 }
 
-bool WinFileDevice::doGetFileSize_(u32* size, FileHandle* handle)
+bool WinFileDevice::doGetFileSize_(u64* size, FileHandle* handle)
 {
-    DWORD fileSizeHigh = 0;
-    DWORD fileSize = GetFileSize(*getHANDLE_(handle), &fileSizeHigh);
+    LARGE_INTEGER fileSize;
+    BOOL success = GetFileSizeEx(*getHANDLE_(handle), &fileSize);
 
     mLastRawError = GetLastError();
 
-    if (fileSize == INVALID_FILE_SIZE)
+    if (!success)
     {
         *size = 0;
         return false;
     }
 
-    SEAD_ASSERT(fileSizeHigh == 0);
-
-    *size = fileSize;
+    *size = static_cast<u64>(fileSize.QuadPart);
     return true;
 }
 
@@ -1,5 +1,6 @@
 #include <framework/glfw/seadConsoleFrameworkGlfw.h>
 
+#include <framework/seadProcessMeterTracer.h>
 #include <framework/seadSingleScreenMethodTreeMgr.h>
 #include <framework/seadTaskMgr.h>
 #include <thread/seadThread.h>
@@ -8,6 +9,7 @@ namespace sead {
 
 ConsoleFrameworkGlfw::ConsoleFrameworkGlfw()
     : Framework()
+    , mFramePacer()
 {
 }
 
@@ -60,8 +62,14 @@ void ConsoleFrameworkGlfw::runImpl_()
 
     methodTreeMgr->pauseAll(false);
 
+    mFramePacer.reset();
+
     while (true)
     {
+        ProcessMeterTracer* tracer = ProcessMeterTracer::instance();
+        if (tracer)
+            tracer->markFrame();
+
         methodTreeMgr->draw();
 
         mTaskMgr->beforeCalc();
@@ -70,7 +78,15 @@ void ConsoleFrameworkGlfw::runImpl_()
 
         procReset_();
 
-        Thread::sleep(TickSpan::makeFromMilliSeconds(16));
+        s32 stepNum = mFramePacer.wait();
+
+        // Catch up on the calc steps of the frames the loop fell behind on
+        for (s32 i = 1; i < stepNum; i++)
+        {
+            mTaskMgr->beforeCalc();
+            methodTreeMgr->calc();
+            mTaskMgr->afterCalc();
+        }
     }
 }
 
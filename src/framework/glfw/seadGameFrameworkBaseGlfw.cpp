@@ -2,6 +2,7 @@
 
 #include <controller/seadControllerMgr.h>
 // #include <controller/win/seadKeyboardMouseDeviceWin.h>
+#include <framework/seadProcessMeterTracer.h>
 #include <framework/seadSingleScreenMethodTreeMgr.h>
 #include <framework/seadTaskMgr.h>
 #include <heap/seadExpHeap.h>
@@ -17,6 +18,7 @@ GameFrameworkBaseGlfw::GameFrameworkBaseGlfw(const CreateArg& arg)
     , mLastUpdateTime()
     , mFrameTime()
     , mLastDiffTime()
+    , mFramePacer()
     , mExit(false)
     // , mMsgProcCallback(nullptr)
     , mDefaultFrameBuffer(nullptr)
@@ -207,6 +209,7 @@ void GameFrameworkBaseGlfw::createWindow_()
     }
 
     setFps(mArg.fps);
+    mFramePacer.setMaxBacklogNum(mArg.max_frame_backlog);
     mLastUpdateTime.setNow();
     mLastUpdateTime -= mFrameTime;
 }
@@ -221,36 +224,41 @@ void GameFrameworkBaseGlfw::mainLoop_()
     }
     Graphics::instance()->unlockDrawContext();
 
+    mFramePacer.reset();
+
     while (!mExit)
     {
+        // Presenting paces the loop when waiting for vblank
+        s32 stepNum = 1;
+        if (mArg.wait_vblank == 0)
+            stepNum = mFramePacer.wait();
+
+        ProcessMeterTracer* tracer = ProcessMeterTracer::instance();
+        if (tracer)
+            tracer->markFrame();
+
         {
             CurrentHeapSetter chs(mGlfwHeap);
 
             glfwPollEvents();
         }
 
+        // Catch up on the calc steps of the frames the loop fell behind on
+        for (s32 i = 1; i < stepNum; i++)
         {
-            TickSpan dt = mLastUpdateTime.diffToNow();
-            if (mArg.wait_vblank > 0 || dt > mFrameTime)
+            Graphics::instance()->lockDrawContext();
             {
-                mLastDiffTime = dt;
-                mLastUpdateTime.setNow();
+                procCalc_();
+            }
+            Graphics::instance()->unlockDrawContext();
+        }
 
-                procFrame_();
+        mLastDiffTime = mLastUpdateTime.diffToNow();
+        mLastUpdateTime.setNow();
 
-                mMouseWheel = 0;
+        procFrame_();
 
-                Thread::sleep(TickSpan::makeFromMilliSeconds(0));
-            }
-            else if (dt + TickSpan::makeFromMilliSeconds(10) > mFrameTime)
-            {
-                Thread::sleep(TickSpan::makeFromMilliSeconds(0));
-            }
-            else
-            {
-                Thread::sleep(TickSpan::makeFromMilliSeconds(1));
-            }
-        }
+        mMouseWheel = 0;
     }
 }
 
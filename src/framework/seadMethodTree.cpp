@@ -1,13 +1,20 @@
 #include <framework/seadMethodTree.h>
 
+#include <framework/seadProcessMeterBar.h>
+#include <mc/seadJobQueue.h>
 #include <thread/seadCriticalSection.h>
 
 namespace sead {
 
 void MethodTreeNode::call()
+{
+    call(nullptr);
+}
+
+void MethodTreeNode::call(JobQueue* queue)
 {
     lock_();
-    callRec_();
+    callRec_(queue);
     unlock_();
 }
 
@@ -60,8 +67,11 @@ void MethodTreeNode::pushFrontChild(MethodTreeNode* o)
     unlock_();
 }
 
-void MethodTreeNode::callRec_()
+void MethodTreeNode::callRec_(JobQueue* queue)
 {
+    if (mProcessMeterBar)
+        mProcessMeterBar->measureBegin();
+
     if (mPauseFlag.isOff(PauseFlag::eSelf))
         mDelegate.invoke();
 
@@ -69,12 +79,32 @@ void MethodTreeNode::callRec_()
 
     if (mPauseFlag.isOff(PauseFlag::eChild))
     {
+        JobCounter counter;
+
         while (childNode)
         {
-            childNode->val()->callRec_();
-            childNode = childNode->val()->next();
+            MethodTreeNode* childMethod = childNode->val();
+
+            // Serial siblings run here in the meantime
+            if (queue && childMethod->mIsParallel)
+            {
+                childMethod->mCallJob.mQueue = queue;
+                queue->enqueue(&childMethod->mCallJob, &counter);
+            }
+            else
+            {
+                childMethod->callRec_(queue);
+            }
+
+            childNode = childMethod->next();
         }
+
+        if (queue)
+            queue->wait(&counter);
     }
+
+    if (mProcessMeterBar)
+        mProcessMeterBar->measureEnd();
 }
 
 void MethodTreeNode::attachMutexRec_(CriticalSection* m) const
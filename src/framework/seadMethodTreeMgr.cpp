@@ -4,6 +4,7 @@ namespace sead {
 
 MethodTreeMgr::MethodTreeMgr()
     : mCS()
+    , mJobQueue(nullptr)
 {
 }
 
@@ -1,6 +1,7 @@
 #include <framework/seadProcessMeterBar.h>
 
 #include <framework/seadProcessMeter.h>
+#include <framework/seadProcessMeterTracer.h>
 
 namespace sead {
 
@@ -33,7 +34,7 @@ ProcessMeterBarBase::~ProcessMeterBarBase()
 
 void ProcessMeterBarBase::measureBegin()
 {
-    if (mMesureEnable)
+    if (isMeasuring_())
     {
         TickTime t;
         measureBeginImpl_(t, mColor);
@@ -42,13 +43,13 @@ void ProcessMeterBarBase::measureBegin()
 
 void ProcessMeterBarBase::measureBegin(const TickTime& t)
 {
-    if (mMesureEnable)
+    if (isMeasuring_())
         measureBeginImpl_(t, mColor);
 }
 
 void ProcessMeterBarBase::measureBegin(const Color4f& c)
 {
-    if (mMesureEnable)
+    if (isMeasuring_())
     {
         TickTime t;
         measureBeginImpl_(t, c);
@@ -57,13 +58,13 @@ void ProcessMeterBarBase::measureBegin(const Color4f& c)
 
 void ProcessMeterBarBase::measureBegin(const TickTime& t, const Color4f& c)
 {
-    if (mMesureEnable)
+    if (isMeasuring_())
         measureBeginImpl_(t, c);
 }
 
 void ProcessMeterBarBase::measureEnd()
 {
-    if (mMesureEnable)
+    if (isMeasuring_())
     {
         TickTime t;
         measureEndImpl_(t);
@@ -72,7 +73,7 @@ void ProcessMeterBarBase::measureEnd()
 
 void ProcessMeterBarBase::measureEnd(const TickTime& arg)
 {
-    if (mMesureEnable)
+    if (isMeasuring_())
         measureEndImpl_(arg);
 }
 
@@ -113,13 +114,31 @@ void ProcessMeterBarBase::setParentProcessMeter(ProcessMeter* parent)
     mParent = parent;
 }
 
+bool ProcessMeterBarBase::isMeasuring_() const
+{
+    ProcessMeterTracer* tracer = ProcessMeterTracer::instance();
+    return mMesureEnable || (tracer && tracer->isRecording());
+}
+
 void ProcessMeterBarBase::measureBeginImpl_(const TickTime& t, Color4f color)
 {
-    addSection_(t, color, mTopSection);
+    ProcessMeterTracer* tracer = ProcessMeterTracer::instance();
+    if (tracer)
+        tracer->recordBegin(getName().cstr(), t);
+
+    if (mMesureEnable)
+        addSection_(t, color, mTopSection);
 }
 
 void ProcessMeterBarBase::measureEndImpl_(const TickTime& arg)
 {
+    ProcessMeterTracer* tracer = ProcessMeterTracer::instance();
+    if (tracer)
+        tracer->recordEnd(arg);
+
+    if (!mMesureEnable)
+        return;
+
     TickTime t = arg;
     mFinalEnd[mCurBuffer] = t;
 
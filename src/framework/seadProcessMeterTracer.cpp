@@ -0,0 +1,348 @@
+#include <framework/seadProcessMeterTracer.h>
+
+#include <basis/seadAssert.h>
+#include <basis/seadWarning.h>
+#include <stream/seadStream.h>
+#include <thread/seadThread.h>
+
+#include <bit>
+
+namespace sead {
+
+namespace {
+
+// TLS value of the threads that found every buffer taken
+const uintptr_t cNoBuffer = ~static_cast<uintptr_t>(0);
+
+// Chrome expects microseconds, the fraction keeps the nanoseconds
+void AppendTimestamp(BufferedSafeString* buf, u64 tick, u64 beginTick)
+{
+    s64 nsec = tick > beginTick ? TickSpan(static_cast<s64>(tick - beginTick)).toNanoSeconds() : 0;
+    buf->appendWithFormat("%lld.%03lld", static_cast<long long>(nsec / 1000), static_cast<long long>(nsec % 1000));
+}
+
+void AppendEscaped(BufferedSafeString* buf, const char* str)
+{
+    for (; *str != '\0'; str++)
+    {
+        char c = *str;
+        if (static_cast<u8>(c) < 0x20)
+            continue;
+
+        if (c == '"' || c == '\\')
+            buf->append('\\');
+
+        buf->append(c);
+    }
+}
+
+} // namespace
+
+SEAD_SINGLETON_DISPOSER_IMPL(ProcessMeterTracer);
+
+ProcessMeterTracer::ProcessMeterTracer()
+    : mBufferTLS()
+    , mThreadBuffers(nullptr)
+    , mThreadNumMax(0)
+    , mThreadNum(0)
+    , mEventMask(0)
+    , mIsRecording(0)
+    , mStream(nullptr)
+    , mBeginTick(0)
+    , mCaptureNum(0)
+    , mFrameNum(0)
+    , mIsFirstEntry(true)
+{
+}
+
+ProcessMeterTracer::~ProcessMeterTracer()
+{
+    end();
+
+    if (mThreadBuffers)
+    {
+        for (s32 i = 0; i < mThreadNumMax; i++)
+            delete[] mThreadBuffers[i].events;
+
+        delete[] mThreadBuffers;
+    }
+}
+
+void ProcessMeterTracer::initialize(s32 threadNumMax, s32 eventNumMax, Heap* heap)
+{
+    SEAD_ASSERT_MSG(!mThreadBuffers, "initialize twice");
+    SEAD_ASSERT(threadNumMax > 0 && eventNumMax > 0);
+
+    u32 eventNum = std::bit_ceil(static_cast<u32>(eventNumMax));
+
+    mThreadBuffers = new(heap) ThreadBuffer[threadNumMax];
+
+    for (s32 i = 0; i < threadNumMax; i++)
+    {
+        ThreadBuffer& buffer = mThreadBuffers[i];
+        buffer.events = new(heap) Event[eventNum];
+        buffer.head.setValue(0);
+        buffer.tail.setValue(0);
+        buffer.droppedNum.setValue(0);
+        buffer.isReady.setValue(0);
+        buffer.openDepth = 0;
+        buffer.droppedDepth = 0;
+        buffer.captureNum = 0;
+        buffer.isNameWritten = false;
+    }
+
+    mThreadNumMax = threadNumMax;
+    mEventMask = eventNum - 1;
+}
+
+void ProcessMeterTracer::begin(WriteStream* stream)
+{
+    SEAD_ASSERT_MSG(mThreadBuffers, "not initialized");
+    SEAD_ASSERT(stream);
+
+    if (isRecording())
+        end();
+
+    // Leftovers of a previous capture are dropped
+    s32 threadNum = static_cast<s32>(mThreadNum.getValue());
+    for (s32 i = 0; i < threadNum && i < mThreadNumMax; i++)
+    {
+        ThreadBuffer& buffer = mThreadBuffers[i];
+        buffer.tail.setValue(buffer.head.getValue());
+        buffer.droppedNum.setValue(0);
+        buffer.isNameWritten = false;
+    }
+
+    mStream = stream;
+    mBeginTick = TickTime().toU64();
+    // The threads reset their depths on their first event of the capture
+    mCaptureNum++;
+    mFrameNum = 0;
+    mIsFirstEntry = true;
+
+    FixedSafeString<64> header;
+    header.format("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    mStream->writeMemBlock(header.cstr(), static_cast<u32>(header.calcLength()));
+
+    mIsRecording.setValue(1);
+}
+
+void ProcessMeterTracer::end()
+{
+    if (!isRecording())
+        return;
+
+    mIsRecording.setValue(0);
+
+    flush_();
+
+    FixedSafeString<16> footer;
+    footer.format("\n]}\n");
+    mStream->writeMemBlock(footer.cstr(), static_cast<u32>(footer.calcLength()));
+    mStream->flush();
+
+    u32 droppedNum = getDroppedNum();
+    if (droppedNum > 0)
+        SEAD_WARNING("%u trace events were dropped, make the rings larger or drain them more often", droppedNum);
+
+    mStream = nullptr;
+}
+
+void ProcessMeterTracer::recordBegin(const char* name, const TickTime& t)
+{
+    if (isRecording())
+        push_(EventType::eBegin, name, t);
+}
+
+void ProcessMeterTracer::recordEnd(const TickTime& t)
+{
+    if (isRecording())
+        push_(EventType::eEnd, nullptr, t);
+}
+
+void ProcessMeterTracer::markFrame()
+{
+    if (!isRecording())
+        return;
+
+    push_(EventType::eFrame, nullptr, TickTime());
+    mFrameNum++;
+
+    flush_();
+}
+
+u32 ProcessMeterTracer::getDroppedNum() const
+{
+    u32 droppedNum = 0;
+
+    s32 threadNum = static_cast<s32>(mThreadNum.getValue());
+    for (s32 i = 0; i < threadNum && i < mThreadNumMax; i++)
+        droppedNum += mThreadBuffers[i].droppedNum.getValue();
+
+    return droppedNum;
+}
+
+ProcessMeterTracer::ThreadBuffer* ProcessMeterTracer::getThreadBuffer_()
+{
+    uintptr_t value = mBufferTLS.getValue();
+    if (value == cNoBuffer)
+        return nullptr;
+
+    if (value != 0)
+        return &mThreadBuffers[value - 1];
+
+    s32 idx = static_cast<s32>(mThreadNum.increment());
+    if (idx >= mThreadNumMax)
+    {
+        SEAD_WARNING("no trace buffer left for this thread, threadNumMax: %d", mThreadNumMax);
+        mBufferTLS.setValue(cNoBuffer);
+        return nullptr;
+    }
+
+    ThreadBuffer& buffer = mThreadBuffers[idx];
+
+    Thread* thread = ThreadMgr::instance() ? ThreadMgr::instance()->getCurrentThread() : nullptr;
+    if (thread)
+        buffer.name.copy(thread->getName());
+    else
+        buffer.name.format("Thread %d", idx);
+
+    buffer.isReady.setValue(1);
+    mBufferTLS.setValue(static_cast<uintptr_t>(idx) + 1);
+
+    return &buffer;
+}
+
+void ProcessMeterTracer::push_(EventType type, const char* name, const TickTime& t)
+{
+    ThreadBuffer* buffer = getThreadBuffer_();
+    if (!buffer)
+        return;
+
+    if (buffer->captureNum != mCaptureNum)
+    {
+        buffer->openDepth = 0;
+        buffer->droppedDepth = 0;
+        buffer->captureNum = mCaptureNum;
+    }
+
+    u32 head = buffer->head.getValue();
+    u32 usedNum = head - buffer->tail.getValue();
+
+    switch (type)
+    {
+        case EventType::eBegin:
+            // Room for this begin, its end and the ends of the sections still open
+            if (buffer->droppedDepth > 0 || usedNum + buffer->openDepth + 2 > mEventMask + 1)
+            {
+                buffer->droppedDepth++;
+                buffer->droppedNum.increment();
+                return;
+            }
+
+            buffer->openDepth++;
+            break;
+
+        case EventType::eEnd:
+            // Sections nested in a dropped one are dropped too, so this end belongs to the innermost dropped begin
+            if (buffer->droppedDepth > 0)
+            {
+                buffer->droppedDepth--;
+                buffer->droppedNum.increment();
+                return;
+            }
+
+            // The section began before the capture
+            if (buffer->openDepth == 0)
+                return;
+
+            buffer->openDepth--;
+            break;
+
+        case EventType::eFrame:
+            if (usedNum + buffer->openDepth + 1 > mEventMask + 1)
+            {
+                buffer->droppedNum.increment();
+                return;
+            }
+            break;
+    }
+
+    SEAD_ASSERT(usedNum <= mEventMask);
+
+    Event& event = buffer->events[head & mEventMask];
+    event.tick = t.toU64();
+    event.name = name;
+    event.type = type;
+
+    buffer->head.setValue(head + 1);
+}
+
+void ProcessMeterTracer::flush_()
+{
+    s32 threadNum = static_cast<s32>(mThreadNum.getValue());
+
+    for (s32 i = 0; i < threadNum && i < mThreadNumMax; i++)
+    {
+        ThreadBuffer& buffer = mThreadBuffers[i];
+        if (buffer.isReady.getValue() == 0)
+            continue;
+
+        if (!buffer.isNameWritten)
+        {
+            FixedSafeString<128> entry;
+            entry.format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"", i);
+            AppendEscaped(&entry, buffer.name.cstr());
+            entry.append("\"}}");
+            writeEntry_(entry);
+
+            buffer.isNameWritten = true;
+        }
+
+        u32 head = buffer.head.getValue();
+        u32 tail = buffer.tail.getValue();
+
+        for (; tail != head; tail++)
+            writeEvent_(i, buffer.events[tail & mEventMask]);
+
+        buffer.tail.setValue(tail);
+    }
+}
+
+void ProcessMeterTracer::writeEvent_(s32 tid, const Event& event)
+{
+    FixedSafeString<256> entry;
+
+    switch (event.type)
+    {
+        case EventType::eBegin:
+            entry.copy("{\"name\":\"");
+            AppendEscaped(&entry, event.name ? event.name : "");
+            entry.appendWithFormat("\",\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":", tid);
+            break;
+
+        case EventType::eEnd:
+            entry.format("{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":", tid);
+            break;
+
+        case EventType::eFrame:
+            entry.format("{\"name\":\"Frame %u\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%d,\"ts\":", mFrameNum, tid);
+            break;
+    }
+
+    AppendTimestamp(&entry, event.tick, mBeginTick);
+    entry.append('}');
+
+    writeEntry_(entry);
+}
+
+void ProcessMeterTracer::writeEntry_(const SafeString& entry)
+{
+    if (!mIsFirstEntry)
+        mStream->writeMemBlock(",\n", 2);
+
+    mStream->writeMemBlock(entry.cstr(), static_cast<u32>(entry.calcLength()));
+    mIsFirstEntry = false;
+}
+
+} // namespace sead
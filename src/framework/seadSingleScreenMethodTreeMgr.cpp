@@ -121,11 +121,12 @@ void SingleScreenMethodTreeMgr::pauseAppCalc(bool p)
 
 void SingleScreenMethodTreeMgr::calc()
 {
-    mRootCalcNode.call();
+    mRootCalcNode.call(mJobQueue);
 }
 
 void SingleScreenMethodTreeMgr::draw()
 {
+    // Drawing stays on the thread owning the graphics context
     mRootDrawNode.call();
 }
 
@@ -1,14 +1,48 @@
 #include <heap/seadArena.h>
 
 #include <basis/seadAssert.h>
+#include <basis/seadWarning.h>
 
 #include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(SEAD_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#endif // SEAD_PLATFORM_LINUX
 
 namespace sead {
 
+namespace {
+
+#if defined(SEAD_PLATFORM_LINUX)
+const size_t cHugePageSize = 2 * 1024 * 1024;
+
+// From <numaif.h>, which needs libnuma
+const int cMPolBind = 2;
+
+bool BindToNumaNode(void* start, size_t size, s32 node)
+{
+    const size_t cBitsPerWord = sizeof(unsigned long) * 8;
+
+    unsigned long nodeMask[4] = {};
+    if (node < 0 || static_cast<size_t>(node) >= sizeof(nodeMask) * 8)
+        return false;
+
+    nodeMask[node / cBitsPerWord] = 1ul << (node % cBitsPerWord);
+
+    return syscall(SYS_mbind, start, size, cMPolBind, nodeMask, sizeof(nodeMask) * 8, 0) == 0;
+}
+#endif // SEAD_PLATFORM_LINUX
+
+} // namespace
+
 Arena::Arena()
     : mStart(nullptr)
     , mSize(0)
+    , mReservedSize(0)
+    , mPageType(PageType::eNormal)
+    , mNumaNode(cNumaNodeAny)
     , mInitWithStartAddress(false)
 {
 }
@@ -18,11 +52,80 @@ Arena::~Arena()
 }
 
 void Arena::initialize(size_t size)
+{
+    initialize(size, PageType::eNormal, cNumaNodeAny);
+}
+
+void Arena::initialize(size_t size, PageType pageType, s32 numaNode)
 {
     SEAD_ASSERT_MSG(!mStart, "initialize twice");
 
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t reservedSize = (size + pageSize - 1) & ~(pageSize - 1);
+
+    // Private anonymous mappings are committed page by page on first touch
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif // MAP_NORESERVE
+
+    void* start = MAP_FAILED;
+
+#if defined(SEAD_PLATFORM_LINUX) && defined(MAP_HUGETLB)
+    if (pageType == PageType::eHuge)
+    {
+        size_t hugeSize = (size + cHugePageSize - 1) & ~(cHugePageSize - 1);
+
+        // Without a reservation a fault on an exhausted pool raises SIGBUS, so the pool is checked here instead
+        start = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (start != MAP_FAILED)
+        {
+            reservedSize = hugeSize;
+        }
+        else
+        {
+            SEAD_WARNING("no huge pages left for %zu bytes, using transparent huge pages", hugeSize);
+            pageType = PageType::eTransparentHuge;
+        }
+    }
+#else
+    if (pageType == PageType::eHuge)
+        pageType = PageType::eTransparentHuge;
+#endif // SEAD_PLATFORM_LINUX && MAP_HUGETLB
+
+    if (start == MAP_FAILED)
+    {
+        start = mmap(nullptr, reservedSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        SEAD_ASSERT_MSG(start != MAP_FAILED, "Arena mmap failed. size: %zu", reservedSize);
+    }
+
+#if defined(SEAD_PLATFORM_LINUX) && defined(MADV_HUGEPAGE)
+    if (pageType == PageType::eTransparentHuge && madvise(start, reservedSize, MADV_HUGEPAGE) != 0)
+        SEAD_WARNING("transparent huge pages are not available");
+#else
+    if (pageType == PageType::eTransparentHuge)
+        pageType = PageType::eNormal;
+#endif // SEAD_PLATFORM_LINUX && MADV_HUGEPAGE
+
+    if (numaNode != cNumaNodeAny)
+    {
+#if defined(SEAD_PLATFORM_LINUX)
+        if (!BindToNumaNode(start, reservedSize, numaNode))
+        {
+            SEAD_WARNING("failed to bind the arena to numa node %d", numaNode);
+            numaNode = cNumaNodeAny;
+        }
+#else
+        SEAD_WARNING("numa binding is not supported on this platform");
+        numaNode = cNumaNodeAny;
+#endif // SEAD_PLATFORM_LINUX
+    }
+
+    mStart = static_cast<u8*>(start);
     mSize = size;
-    mStart = static_cast<u8*>(std::malloc(mSize));
+    mReservedSize = reservedSize;
+    mPageType = pageType;
+    mNumaNode = numaNode;
     mInitWithStartAddress = false;
 }
 
@@ -32,6 +135,9 @@ void Arena::initialize(u8* start, size_t size)
 
     mSize = size;
     mStart = start;
+    mReservedSize = size;
+    mPageType = PageType::eNormal;
+    mNumaNode = cNumaNodeAny;
     mInitWithStartAddress = true;
 }
 
@@ -40,11 +146,51 @@ void Arena::destroy()
     SEAD_ASSERT_MSG(mStart, "not intialized");
 
     if (!mInitWithStartAddress)
-        std::free(mStart);
+        munmap(mStart, mReservedSize);
 
     mStart = nullptr;
     mSize = 0;
+    mReservedSize = 0;
+    mPageType = PageType::eNormal;
+    mNumaNode = cNumaNodeAny;
     mInitWithStartAddress = false;
 }
 
+size_t Arena::getResidentSize() const
+{
+    if (!mStart)
+        return 0;
+
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    u8* begin = static_cast<u8*>(PtrUtil::roundDownPow2(mStart, static_cast<u32>(pageSize)));
+    u8* end = mStart + mReservedSize;
+
+#if defined(SEAD_PLATFORM_MACOSX)
+    char residency[1024];
+#else
+    unsigned char residency[1024];
+#endif // SEAD_PLATFORM_MACOSX
+
+    const size_t cChunkSize = sizeof(residency) * pageSize;
+
+    size_t residentSize = 0;
+
+    for (u8* chunk = begin; chunk < end; chunk += cChunkSize)
+    {
+        size_t chunkSize = static_cast<size_t>(end - chunk) < cChunkSize ? static_cast<size_t>(end - chunk) : cChunkSize;
+        if (mincore(chunk, chunkSize, residency) != 0)
+            return 0;
+
+        size_t pageNum = (chunkSize + pageSize - 1) / pageSize;
+        for (size_t i = 0; i < pageNum; i++)
+        {
+            if (residency[i] & 1)
+                residentSize += pageSize;
+        }
+    }
+
+    return residentSize;
+}
+
 } // namespace sead
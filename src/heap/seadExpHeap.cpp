@@ -1,18 +1,108 @@
 #include <heap/seadExpHeap.h>
 
 #include <heap/seadHeapMgr.h>
+#include <heap/seadThreadHeapCache.h>
+#include <hostio/seadHostIOContext.h>
 #include <math/seadMathCalcCommon.h>
 #include <prim/seadFormatPrint.h>
 #include <prim/seadScopedLock.h>
 #include <stream/seadStream.h>
 #include <thread/seadThreadUtil.h>
+#include <time/seadTickTime.h>
 
+#include <bit>
 #include <climits>
 
 namespace sead {
 
 static const uintptr_t cOffsetMax = UINT16_MAX;
 
+// Segregated fit bins free blocks with a two level index: the first level splits sizes by powers
+// of two and the second level splits each power of two range linearly. Sizes below one second
+// level range are kept in the first level 0 with cMinAlignment granularity.
+static const s32 cFreeBinSLIndexLog2 = 3;
+static const s32 cFreeBinSLIndexNum = 1 << cFreeBinSLIndexLog2;
+static const s32 cFreeBinAlignLog2 = std::countr_zero(static_cast<u32>(Heap::cMinAlignment));
+static const s32 cFreeBinFLShift = cFreeBinSLIndexLog2 + cFreeBinAlignLog2;
+static const s32 cFreeBinFLIndexMax = 64;
+
+struct ExpHeap::FreeBinTable
+{
+    MemBlockList& getBin(s32 fl, s32 sl) { return bins[fl * cFreeBinSLIndexNum + sl]; }
+    const MemBlockList& getBin(s32 fl, s32 sl) const { return bins[fl * cFreeBinSLIndexNum + sl]; }
+
+    MemBlock* memBlock;
+    MemBlockList* bins;
+    u64 flBitmap;
+    s32 flNum;
+    u8 slBitmap[cFreeBinFLIndexMax];
+};
+
+static void CalcFreeBinIndex(size_t size, s32* fl, s32* sl)
+{
+    if (size < (static_cast<size_t>(1) << cFreeBinFLShift))
+    {
+        *fl = 0;
+        *sl = static_cast<s32>(size >> cFreeBinAlignLog2);
+    }
+    else
+    {
+        s32 msb = std::bit_width(size) - 1;
+        *fl = msb - cFreeBinFLShift + 1;
+        *sl = static_cast<s32>(size >> (msb - cFreeBinSLIndexLog2)) ^ cFreeBinSLIndexNum;
+    }
+}
+
+// Rounds up to the next bin boundary so that any block of the resulting bin is large enough
+static size_t RoundUpFreeBinSize(size_t size)
+{
+    if (size >= (static_cast<size_t>(1) << cFreeBinFLShift))
+    {
+        s32 msb = std::bit_width(size) - 1;
+        size += (static_cast<size_t>(1) << (msb - cFreeBinSLIndexLog2)) - 1;
+    }
+
+    return size;
+}
+
+// Relocatable memory starts with the index of its handle entry, the address handed out follows it
+static const size_t cHandleHeaderSize = Heap::cMinAlignment;
+
+struct ExpHeap::HandleEntry
+{
+    // Null while the entry is unused
+    void* ptr;
+    s32 nextFree;
+    u16 generation;
+    u16 lockNum;
+};
+
+struct ExpHeap::HandleTable
+{
+    MemBlock* memBlock;
+    HandleEntry* entries;
+    s32 entryNum;
+    s32 usedNum;
+    s32 freeEntry;
+    // Where compact() resumes, as an offset from the area start
+    size_t compactCursor;
+};
+
+static void AddFreeBlock(ExpHeap::FragmentationInfo* info, size_t size)
+{
+    info->freeSize += size;
+    info->freeBlockNum++;
+
+    if (size > info->maxFreeBlockSize)
+        info->maxFreeBlockSize = size;
+
+    s32 bucket = size < 32 ? 0 : std::bit_width(size) - 5;
+    if (bucket >= ExpHeap::cFreeBlockHistogramNum)
+        bucket = ExpHeap::cFreeBlockHistogramNum - 1;
+
+    info->freeBlockHistogram[bucket]++;
+}
+
 ExpHeap* ExpHeap::create(size_t size, const SafeString& name, Heap* parent, HeapDirection direction, bool enableLock)
 {
     ExpHeap* heap = ExpHeap::tryCreate(size, name, parent, direction, enableLock);
@@ -125,6 +215,9 @@ ExpHeap::ExpHeap(const SafeString& name, Heap* parent, void* start, size_t size,
     , mAllocMode(AllocMode::eFirstFit)
     , mFreeList()
     , mUseList()
+    , mFreeBinTable(nullptr)
+    , mThreadHeapCache()
+    , mHandleTable(nullptr)
 {
     ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
 
@@ -149,6 +242,10 @@ void ExpHeap::destroy()
         HeapMgr::instance()->callDestroyCallback_(this);
 #endif // SEAD_TARGET_DEBUG
 
+    ThreadHeapCache* threadHeapCache = mThreadHeapCache.getValueAcquire();
+    if (threadHeapCache)
+        threadHeapCache->detachHeap_();
+
     Heap* parent = mParent;
     void* start = mStart;
 
@@ -208,19 +305,27 @@ size_t ExpHeap::adjust()
     if (!mParent)
         return mSize;
 
-    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
-
     size_t newSize = 0;
 
+    void* prevAreaStart = nullptr;
+    void* prevAreaEnd = nullptr;
+
     {
+        ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
         ScopedLock<Heap> parentLock(mParent);
 
+        prevAreaStart = getAreaStart_();
+        prevAreaEnd = getAreaEnd_();
+
         if (mDirection == HeapDirection::eForward)
             newSize = adjustBack_();
         else
             newSize = adjustFront_();
     }
 
+    // The tree lock is taken before heap locks elsewhere
+    HeapMgr::updateAddressIndex_(this, prevAreaStart, prevAreaEnd);
+
     //mFreeSize = getFreeSize();
 
     return newSize;
@@ -284,31 +389,29 @@ void* ExpHeap::tryAlloc(size_t size, s32 alignment)
 
     allocSize = MathSizeT::roundUpPow2(allocSize, cMinAlignment);
 
-    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
-
-    allocAlignment *= static_cast<s32>(mDirection);
-
     MemBlock* block = nullptr;
-    if (allocAlignment < 0)
+    ThreadHeapCache* threadHeapCache = mThreadHeapCache.getValueAcquire();
+    if (threadHeapCache)
     {
-        allocAlignment = -allocAlignment;
-        if (allocAlignment <= cMinAlignment)
-            block = allocFromTail_(allocSize);
-        else
-            block = allocFromTail_(allocSize, allocAlignment);
+        void* ptr = threadHeapCache->tryAlloc_(allocSize, allocAlignment);
+        if (ptr)
+            block = MemBlock::FindManageArea(ptr);
     }
-    else
+
+    allocAlignment *= static_cast<s32>(mDirection);
+
+    if (!block)
     {
-        if (allocAlignment <= cMinAlignment)
-            block = allocFromHead_(allocSize);
-        else
-            block = allocFromHead_(allocSize, allocAlignment);
+        ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+        block = allocMemBlock_(allocSize, allocAlignment);
     }
 
+    if (allocAlignment < 0)
+        allocAlignment = -allocAlignment;
+
     void* ret = nullptr;
     if (block)
     {
-        block->setHeapCheckTag(mHeapCheckTag);
         ret = block->memory();
 
 #if defined(SEAD_TARGET_DEBUG)
@@ -393,8 +496,6 @@ void ExpHeap::free(void* ptr)
     if (mFlag.isOnBit(Flag::eDisposing))
         return;
 
-    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
-
     MemBlock* block = MemBlock::FindManageArea(ptr);
     if (!block)
     {
@@ -438,12 +539,13 @@ void ExpHeap::free(void* ptr)
     }
 #endif // SEAD_TARGET_DEBUG
 
-    mUseList.erase(block);
+    ThreadHeapCache* threadHeapCache = mThreadHeapCache.getValueAcquire();
+    if (threadHeapCache && threadHeapCache->tryFree_(ptr, block->getSize()))
+        return;
 
-    block->setSize(block->getSize() + block->getOffset());
-    block->setOffset(0);
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
 
-    pushToFreeList_(block);
+    freeMemBlock_(block);
 
     //mFreeSize = getFreeSize();
 }
@@ -476,7 +578,7 @@ void* ExpHeap::resizeFront(void* ptr, size_t newSize)
         return block->memory();
 
     size_t remainSize = block->getSizeWithManage() - newSize - sizeof(MemBlock);
-    if (remainSize < sizeof(MemBlock))
+    if (remainSize < sizeof(MemBlock) + 1)
     {
         size_t offset = block->getOffset() + block->getSize() - newSize;
         SEAD_ASSERT_MSG(offset <= cOffsetMax, "Offset is too large.");
@@ -487,6 +589,7 @@ void* ExpHeap::resizeFront(void* ptr, size_t newSize)
     {
         MemBlock* newBlock = new(PtrUtil::addOffset(block, remainSize)) MemBlock();
         newBlock->setHeapCheckTag(mHeapCheckTag);
+        newBlock->setHeapId(mHeapId);
         newBlock->setSize(newSize);
         pushToUseList_(newBlock);
 
@@ -529,7 +632,7 @@ void* ExpHeap::resizeBack(void* ptr, size_t newSize)
         return block->memory();
 
     size_t remainSize = block->getSize() - newSize;
-    if (remainSize < sizeof(MemBlock))
+    if (remainSize < sizeof(MemBlock) + 1)
     {
         return block->memory();
     }
@@ -600,7 +703,7 @@ void* ExpHeap::tryRealloc(void* ptr, size_t newSize, s32 alignment)
         return realloc_(ptr, block->memory(), newSize, newSize, alignment);
 
     size_t remainSize = block->getSize() - newSize;
-    if (remainSize < sizeof(MemBlock))
+    if (remainSize < sizeof(MemBlock) + 1)
     {
         return block->memory();
     }
@@ -629,10 +732,31 @@ void ExpHeap::freeAll()
 
     dispose_(nullptr, nullptr);
 
+    ThreadHeapCache* threadHeapCache = mThreadHeapCache.getValueAcquire();
+    if (threadHeapCache)
+        threadHeapCache->purge_();
+
     mUseList.clear();
     mFreeList.clear();
 
+    // The bin table lives inside the heap, so it is carved again from the fresh free block
+    bool isSegregated = mFreeBinTable != nullptr;
+    mFreeBinTable = nullptr;
+
+    // As is the handle table, every handle is gone with the memory
+    s32 handleNumMax = mHandleTable ? mHandleTable->entryNum : 0;
+    mHandleTable = nullptr;
+
     ExpHeap::createMaxSizeFreeMemBlock_(this);
+
+    if (isSegregated && !createFreeBinTable_())
+    {
+        SEAD_ASSERT_MSG(false, "Failed to recreate free bin table.");
+        mAllocMode = AllocMode::eFirstFit;
+    }
+
+    if (handleNumMax > 0 && !createHandleTable(handleNumMax))
+        SEAD_ASSERT_MSG(false, "Failed to recreate handle table.");
 }
 
 const void* ExpHeap::getStartAddress() const
@@ -660,6 +784,20 @@ size_t ExpHeap::getFreeSize() const
     ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
 
     size_t freeSize = 0;
+
+    if (mFreeBinTable)
+    {
+        for (s32 i = 0; i < mFreeBinTable->flNum * cFreeBinSLIndexNum; i++)
+        {
+            for (MemBlock& block : mFreeBinTable->bins[i])
+            {
+                freeSize += block.getSize();
+            }
+        }
+
+        return freeSize;
+    }
+
     for (MemBlock& block : mFreeList)
     {
         freeSize += block.getSize();
@@ -804,10 +942,25 @@ void ExpHeap::dumpFreeList() const
     else if constexpr (sizeof(void*) == 8)
         SEAD_PRINT("[ %-18s ] %-18s | size       | offset   | %-18s | %-18s\n", "HeaderAddr", "memory()", "prev", "next");
 
-    for (MemBlock& block : mFreeList)
+    if (mFreeBinTable)
     {
-        SEAD_PRINT("[ 0x%p ] 0x%p | %10zu | %8d | 0x%p | 0x%p\n",
-                   &block, block.memory(), block.getSize(), block.getOffset(), mFreeList.prev(&block), mFreeList.next(&block));
+        for (s32 i = 0; i < mFreeBinTable->flNum * cFreeBinSLIndexNum; i++)
+        {
+            const MemBlockList& bin = mFreeBinTable->bins[i];
+            for (MemBlock& block : bin)
+            {
+                SEAD_PRINT("[ 0x%p ] 0x%p | %10zu | %8d | 0x%p | 0x%p | bin %d\n",
+                           &block, block.memory(), block.getSize(), block.getOffset(), bin.prev(&block), bin.next(&block), i);
+            }
+        }
+    }
+    else
+    {
+        for (MemBlock& block : mFreeList)
+        {
+            SEAD_PRINT("[ 0x%p ] 0x%p | %10zu | %8d | 0x%p | 0x%p\n",
+                       &block, block.memory(), block.getSize(), block.getOffset(), mFreeList.prev(&block), mFreeList.next(&block));
+        }
     }
 
     SEAD_PRINT("--------- dumpFreeList done ---------\n");
@@ -847,6 +1000,9 @@ bool ExpHeap::tryCheckFreeList() const
 
     ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
 
+    if (mFreeBinTable)
+        return tryCheckFreeBin_();
+
     for (MemBlock& block : mFreeList)
     {
         if (block.getOffset() != 0)
@@ -885,6 +1041,22 @@ bool ExpHeap::tryCheckUseList() const
     return mUseList.checkLinks();
 }
 
+size_t ExpHeap::getFreeListSize() const
+{
+    if (!mFreeBinTable)
+        return mFreeList.size();
+
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    size_t size = 0;
+    for (s32 i = 0; i < mFreeBinTable->flNum * cFreeBinSLIndexNum; i++)
+    {
+        size += mFreeBinTable->bins[i].size();
+    }
+
+    return size;
+}
+
 size_t ExpHeap::getAllocatedSize(void* ptr)
 {
     if (!isInclude(ptr))
@@ -912,8 +1084,10 @@ void ExpHeap::dumpYAML(WriteStream& stream, s32 indent) const
 
     if (getAllocMode() == AllocMode::eFirstFit)
         allocMode = "First Fit";
-    else
+    else if (getAllocMode() == AllocMode::eBestFit)
         allocMode = "Best Fit";
+    else
+        allocMode = "Segregated Fit";
 
     buf.appendWithFormat("  alloc_mode: %s\n", allocMode);
     stream.writeDecorationText(buf);
@@ -925,178 +1099,568 @@ void ExpHeap::dumpYAML(WriteStream& stream, s32 indent) const
 
     buf.clear();
     buf.append(' ', indent);
-    buf.appendWithFormat("  free_list_size: %d\n", mFreeList.size());
+    buf.appendWithFormat("  free_list_size: %zu\n", getFreeListSize());
     stream.writeDecorationText(buf);
-}
 
-void ExpHeap::doCreate(ExpHeap* heap, Heap* parent)
-{
-    SEAD_ASSERT_MSG(heap, "heap is null");
+    FragmentationInfo info;
+    calcFragmentationInfo(&info);
 
-    ExpHeap::createMaxSizeFreeMemBlock_(heap);
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("  max_free_block_size: %zu\n", info.maxFreeBlockSize);
+    stream.writeDecorationText(buf);
 
-    if (parent)
-        parent->pushBackChild_(heap);
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("  external_fragmentation: %.3f\n", info.externalFragmentation);
+    stream.writeDecorationText(buf);
 
-#if defined(SEAD_TARGET_DEBUG)
-    HeapMgr* heapMgr = HeapMgr::instance();
-    if (heapMgr)
-        heapMgr->callCreateCallback_(heap);
-#endif // SEAD_TARGET_DEBUG
-}
+    FixedSafeString<256> histogram("");
+    histogram.append(' ', indent);
+    histogram.appendWithFormat("  free_block_histogram: [");
 
-void ExpHeap::createMaxSizeFreeMemBlock_(ExpHeap* heap)
-{
-    ConditionalScopedLock<CriticalSection> lock(&heap->mCS, heap->isEnableLock());
+    for (s32 i = 0; i < cFreeBlockHistogramNum; i++)
+        histogram.appendWithFormat(i == 0 ? "%u" : ", %u", info.freeBlockHistogram[i]);
 
-    MemBlock* block = nullptr;
-    if (heap->mDirection == HeapDirection::eForward)
-        block = new(PtrUtil::addOffset(heap, sizeof(ExpHeap))) MemBlock();
-    else
-        block = new(heap->mStart) MemBlock();
+    histogram.appendWithFormat("]\n");
+    stream.writeDecorationText(histogram);
 
-    block->setSize(heap->mSize - sizeof(ExpHeap) - sizeof(MemBlock));
-    heap->pushToFreeList_(block);
+    if (mHandleTable)
+    {
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("  handle_num: %d\n", mHandleTable->usedNum);
+        stream.writeDecorationText(buf);
 
-#if defined(SEAD_TARGET_DEBUG)
-    HeapMgr* heapMgr = HeapMgr::instance();
-    if (heapMgr && heapMgr->isEnableDebugFillHeapCreate())
-        block->fill(heapMgr->getDebugFillHeapCreate());
-#endif // SEAD_TARGET_DEBUG
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("  handle_num_max: %d\n", mHandleTable->entryNum);
+        stream.writeDecorationText(buf);
+    }
 }
 
-MemBlock* ExpHeap::findFreeMemBlockFromHead_(size_t size, FindMode mode) const
+void ExpHeap::calcFragmentationInfo(FragmentationInfo* info) const
 {
-    MemBlock* ret = nullptr;
+    SEAD_ASSERT(info);
 
-    for (MemBlock& block : mFreeList)
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    info->freeSize = 0;
+    info->maxFreeBlockSize = 0;
+    info->freeBlockNum = 0;
+
+    for (s32 i = 0; i < cFreeBlockHistogramNum; i++)
+        info->freeBlockHistogram[i] = 0;
+
+    if (mFreeBinTable)
     {
-        size_t blockSize = block.getSize();
-        if (blockSize >= size)
+        for (s32 i = 0; i < mFreeBinTable->flNum * cFreeBinSLIndexNum; i++)
         {
-            if (mode == FindMode::eFirstFit)
-                return &block;
-
-            if (!ret
-                || mode == FindMode::eBestFit && blockSize < ret->getSize()
-                || mode == FindMode::eMaxSize && blockSize > ret->getSize())
+            for (MemBlock& block : mFreeBinTable->bins[i])
             {
-                ret = &block;
+                AddFreeBlock(info, block.getSize());
             }
         }
     }
-
-    return ret;
-}
-
-MemBlock* ExpHeap::findFreeMemBlockFromHead_(size_t size, s32 alignment, FindMode mode) const
-{
-    MemBlock* ret = nullptr;
-
-    for (MemBlock& block : mFreeList)
+    else
     {
-        size_t blockSize = block.getSize();
-        if (blockSize >= size)
+        for (MemBlock& block : mFreeList)
         {
-            void* memory = block.memory();
-            if (blockSize >= size + PtrUtil::diff(PtrUtil::roundUpPow2(memory, alignment), memory))
-            {
-                if (mode == FindMode::eFirstFit)
-                    return &block;
-
-                if (!ret
-                    || mode == FindMode::eBestFit && blockSize < ret->getSize()
-                    || mode == FindMode::eMaxSize && blockSize > ret->getSize())
-                {
-                    ret = &block;
-                }
-            }
+            AddFreeBlock(info, block.getSize());
         }
     }
 
-    return ret;
+    if (info->freeSize != 0)
+        info->externalFragmentation = 1.0f - static_cast<f32>(info->maxFreeBlockSize) / static_cast<f32>(info->freeSize);
+    else
+        info->externalFragmentation = 0.0f;
 }
 
-MemBlock* ExpHeap::findFreeMemBlockFromTail_(size_t size, FindMode mode) const
+bool ExpHeap::createHandleTable(s32 handleNumMax)
 {
-    MemBlock* ret = nullptr;
+    SEAD_ASSERT_MSG(0 < handleNumMax && handleNumMax <= cHandleNumMax, "handleNumMax[%d] is out of range", handleNumMax);
 
-    for (MemBlock* block = mFreeList.back(); block != nullptr; block = mFreeList.prev(block))
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    if (mHandleTable)
     {
-        size_t blockSize = block->getSize();
-        if (blockSize >= size)
-        {
-            if (mode == FindMode::eFirstFit)
-                return block;
+        SEAD_ASSERT_MSG(false, "handle table is already created. heap: %s", getName().cstr());
+        return false;
+    }
 
-            if (!ret
-                || mode == FindMode::eBestFit && blockSize < ret->getSize()
-                || mode == FindMode::eMaxSize && blockSize > ret->getSize())
-            {
-                ret = block;
-            }
-        }
+    size_t tableSize = MathSizeT::roundUpPow2(sizeof(HandleTable) + sizeof(HandleEntry) * handleNumMax, cMinAlignment);
+
+    // Same side as the free bin table, compact() slides memory toward it
+    MemBlock* tableBlock;
+    if (mDirection == HeapDirection::eForward)
+        tableBlock = allocFromHead_(tableSize);
+    else
+        tableBlock = allocFromTail_(tableSize);
+
+    if (!tableBlock)
+        return false;
+
+    mUseList.erase(tableBlock);
+    tableBlock->setHeapCheckTag(mHeapCheckTag);
+    tableBlock->setHeapId(mHeapId);
+
+    HandleTable* table = new(tableBlock->memory()) HandleTable();
+    table->memBlock = tableBlock;
+    table->entries = static_cast<HandleEntry*>(PtrUtil::addOffset(table, sizeof(HandleTable)));
+    table->entryNum = handleNumMax;
+    table->usedNum = 0;
+    table->freeEntry = 0;
+    table->compactCursor = 0;
+
+    for (s32 i = 0; i < handleNumMax; i++)
+    {
+        HandleEntry* entry = new(&table->entries[i]) HandleEntry();
+        entry->ptr = nullptr;
+        entry->nextFree = i + 1 < handleNumMax ? i + 1 : -1;
+        entry->generation = 1;
+        entry->lockNum = 0;
     }
 
-    return ret;
+    mHandleTable = table;
+    return true;
 }
 
-MemBlock* ExpHeap::findFreeMemBlockFromTail_(size_t size, s32 alignment, FindMode mode) const
+void ExpHeap::destroyHandleTable()
 {
-    MemBlock* ret = nullptr;
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
 
-    for (MemBlock* block = mFreeList.back(); block != nullptr; block = mFreeList.prev(block))
-    {
-        size_t blockSize = block->getSize();
-        if (blockSize >= size)
-        {
-            void* memory = PtrUtil::addOffset(block->memory(), block->getSize() - size);
-            if (blockSize >= size + PtrUtil::diff(memory, PtrUtil::roundDownPow2(memory, alignment)))
-            {
-                if (mode == FindMode::eFirstFit)
-                    return block;
+    if (!mHandleTable)
+        return;
 
-                if (!ret
-                    || mode == FindMode::eBestFit && blockSize < ret->getSize()
-                    || mode == FindMode::eMaxSize && blockSize > ret->getSize())
-                {
-                    ret = block;
-                }
-            }
-        }
+    if (mHandleTable->usedNum != 0)
+    {
+        SEAD_ASSERT_MSG(false, "%d handles are still allocated. heap: %s", mHandleTable->usedNum, getName().cstr());
+        return;
     }
 
-    return ret;
+    MemBlock* tableBlock = mHandleTable->memBlock;
+    mHandleTable = nullptr;
+
+    tableBlock->setSize(tableBlock->getSize() + tableBlock->getOffset());
+    tableBlock->setOffset(0);
+    pushToFreeList_(tableBlock);
 }
 
-MemBlock* ExpHeap::findLastMemBlockIfFree_()
+ExpHeap::Handle ExpHeap::tryAllocHandle(size_t size)
 {
-    mUseList.sort(&ExpHeap::compareMemBlockAddr_);
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
 
-    MemBlock* backFreeBlock = mFreeList.back();
-    MemBlock* backUseBlock = mUseList.back();
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
 
-    if (backFreeBlock <= backUseBlock)
-        return nullptr;
+    if (!mHandleTable)
+    {
+        SEAD_ASSERT_MSG(false, "handle table is not created. heap: %s", getName().cstr());
+        return cInvalidHandle;
+    }
 
-    return backFreeBlock;
-}
+    s32 idx = mHandleTable->freeEntry;
+    if (idx < 0)
+        return cInvalidHandle;
 
-MemBlock* ExpHeap::findFirstMemBlockIfFree_()
-{
-    mUseList.sort(&ExpHeap::compareMemBlockAddr_);
+    if (size < cMinAllocSize)
+        size = cMinAllocSize;
 
-    MemBlock* frontFreeBlock = mFreeList.front();
-    MemBlock* frontUseBlock = mUseList.front();
+    size_t allocSize = MathSizeT::roundUpPow2(size, cMinAlignment) + cHandleHeaderSize;
 
-    if (frontUseBlock && frontUseBlock <= frontFreeBlock)
-        return nullptr;
+    MemBlock* block = allocMemBlock_(allocSize, cMinAlignment * static_cast<s32>(mDirection));
+    if (!block)
+        return cInvalidHandle;
 
-    return frontFreeBlock;
-}
+    SEAD_ASSERT(block->getOffset() == 0);
+    block->setRelocatable(true);
+    *reinterpret_cast<s32*>(block->memory()) = idx;
 
-void ExpHeap::pushToUseList_(MemBlock* memBlock)
-{
+    HandleEntry& entry = mHandleTable->entries[idx];
+    mHandleTable->freeEntry = entry.nextFree;
+    mHandleTable->usedNum++;
+
+    entry.ptr = block->memory() + cHandleHeaderSize;
+    entry.nextFree = -1;
+    entry.lockNum = 0;
+
+#if defined(SEAD_TARGET_DEBUG)
+    if (isEnableDebugFillAlloc_())
+        MemUtil::fill(entry.ptr, HeapMgr::instance()->getDebugFillAlloc(), block->getSize() - cHandleHeaderSize);
+#endif // SEAD_TARGET_DEBUG
+
+    return (static_cast<u32>(entry.generation) << 16) | static_cast<u32>(idx);
+}
+
+void ExpHeap::freeHandle(Handle handle)
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    if (handle == cInvalidHandle)
+        return;
+
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    HandleEntry* entry = findHandleEntry_(handle);
+    if (!entry)
+    {
+        SEAD_ASSERT_MSG(false, "invalid handle 0x%08x. heap: %s", handle, getName().cstr());
+        return;
+    }
+
+    SEAD_ASSERT_MSG(entry->lockNum == 0, "handle 0x%08x is freed while locked", handle);
+
+    freeMemBlock_(getHandleMemBlock_(entry));
+
+    s32 idx = static_cast<s32>(entry - mHandleTable->entries);
+
+    entry->ptr = nullptr;
+    entry->nextFree = mHandleTable->freeEntry;
+    entry->lockNum = 0;
+
+    // Stale handles must not match a reused entry
+    entry->generation++;
+    if (entry->generation == 0)
+        entry->generation = 1;
+
+    mHandleTable->freeEntry = idx;
+    mHandleTable->usedNum--;
+}
+
+bool ExpHeap::isValidHandle(Handle handle) const
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+    return findHandleEntry_(handle) != nullptr;
+}
+
+void* ExpHeap::getHandleAddress(Handle handle) const
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    HandleEntry* entry = findHandleEntry_(handle);
+    SEAD_ASSERT_MSG(entry, "invalid handle 0x%08x. heap: %s", handle, getName().cstr());
+
+    return entry ? entry->ptr : nullptr;
+}
+
+void* ExpHeap::lockHandle(Handle handle)
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    HandleEntry* entry = findHandleEntry_(handle);
+    if (!entry)
+    {
+        SEAD_ASSERT_MSG(false, "invalid handle 0x%08x. heap: %s", handle, getName().cstr());
+        return nullptr;
+    }
+
+    SEAD_ASSERT_MSG(entry->lockNum != 0xFFFF, "too many locks on handle 0x%08x", handle);
+    entry->lockNum++;
+
+    return entry->ptr;
+}
+
+void ExpHeap::unlockHandle(Handle handle)
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    HandleEntry* entry = findHandleEntry_(handle);
+    if (!entry || entry->lockNum == 0)
+    {
+        SEAD_ASSERT_MSG(false, "handle 0x%08x is not locked. heap: %s", handle, getName().cstr());
+        return;
+    }
+
+    entry->lockNum--;
+}
+
+bool ExpHeap::compact(TickSpan budget)
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    if (!mHandleTable)
+    {
+        SEAD_ASSERT_MSG(false, "handle table is not created. heap: %s", getName().cstr());
+        return true;
+    }
+
+    TickTime startTime;
+
+    void* areaStart = getAreaStart_();
+    void* areaEnd = getAreaEnd_();
+    void* cursor = PtrUtil::addOffset(areaStart, mHandleTable->compactCursor);
+    bool isFromStart = mHandleTable->compactCursor == 0;
+    bool isMoved = false;
+
+    // With free bins every block tells whether it is free, otherwise the address ordered free list is followed along
+    MemBlock* nextFreeBlock = mFreeBinTable ? nullptr : mFreeList.front();
+    MemBlock* prevFreeBlock = nullptr;
+
+    for (void* addr = areaStart; addr < areaEnd; )
+    {
+        MemBlock* block = static_cast<MemBlock*>(addr);
+
+        bool isFree;
+        if (mFreeBinTable)
+        {
+            isFree = block->isFree();
+        }
+        else
+        {
+            isFree = block == nextFreeBlock;
+            if (isFree)
+                nextFreeBlock = mFreeList.next(nextFreeBlock);
+        }
+
+        if (!isFree && addr >= cursor && block->isRelocatable())
+        {
+            MemBlock* freeBlock;
+            if (compactMemBlock_(block, prevFreeBlock, &freeBlock))
+            {
+                isMoved = true;
+
+                // Go on from the free block left behind
+                if (!mFreeBinTable)
+                    nextFreeBlock = freeBlock;
+
+                prevFreeBlock = nullptr;
+                addr = freeBlock;
+
+                if (startTime.diffToNow().toS64() >= budget.toS64())
+                {
+                    mHandleTable->compactCursor = PtrUtil::diff(addr, areaStart);
+                    return false;
+                }
+
+                continue;
+            }
+        }
+
+        prevFreeBlock = isFree ? block : nullptr;
+        addr = PtrUtil::addOffset(block, block->getSizeWithManage());
+    }
+
+    mHandleTable->compactCursor = 0;
+    return isFromStart && !isMoved;
+}
+
+void ExpHeap::doCreate(ExpHeap* heap, Heap* parent)
+{
+    SEAD_ASSERT_MSG(heap, "heap is null");
+
+    ExpHeap::createMaxSizeFreeMemBlock_(heap);
+
+    if (parent)
+        parent->pushBackChild_(heap);
+
+    HeapMgr::addToAddressIndex_(heap);
+
+#if defined(SEAD_TARGET_DEBUG)
+    HeapMgr* heapMgr = HeapMgr::instance();
+    if (heapMgr)
+        heapMgr->callCreateCallback_(heap);
+#endif // SEAD_TARGET_DEBUG
+}
+
+void ExpHeap::createMaxSizeFreeMemBlock_(ExpHeap* heap)
+{
+    ConditionalScopedLock<CriticalSection> lock(&heap->mCS, heap->isEnableLock());
+
+    MemBlock* block = nullptr;
+    if (heap->mDirection == HeapDirection::eForward)
+        block = new(PtrUtil::addOffset(heap, sizeof(ExpHeap))) MemBlock();
+    else
+        block = new(heap->mStart) MemBlock();
+
+    block->setSize(heap->mSize - sizeof(ExpHeap) - sizeof(MemBlock));
+    heap->pushToFreeList_(block);
+
+#if defined(SEAD_TARGET_DEBUG)
+    HeapMgr* heapMgr = HeapMgr::instance();
+    if (heapMgr && heapMgr->isEnableDebugFillHeapCreate())
+        block->fill(heapMgr->getDebugFillHeapCreate());
+#endif // SEAD_TARGET_DEBUG
+}
+
+MemBlock* ExpHeap::findFreeMemBlockFromHead_(size_t size, FindMode mode) const
+{
+    if (mFreeBinTable)
+        return findFreeBinMemBlock_(size, cMinAlignment, false, mode);
+
+    MemBlock* ret = nullptr;
+
+    for (MemBlock& block : mFreeList)
+    {
+        size_t blockSize = block.getSize();
+        if (blockSize >= size)
+        {
+            if (mode == FindMode::eFirstFit)
+                return &block;
+
+            if (!ret
+                || mode == FindMode::eBestFit && blockSize < ret->getSize()
+                || mode == FindMode::eMaxSize && blockSize > ret->getSize())
+            {
+                ret = &block;
+            }
+        }
+    }
+
+    return ret;
+}
+
+MemBlock* ExpHeap::findFreeMemBlockFromHead_(size_t size, s32 alignment, FindMode mode) const
+{
+    if (mFreeBinTable)
+        return findFreeBinMemBlock_(size, alignment, false, mode);
+
+    MemBlock* ret = nullptr;
+
+    for (MemBlock& block : mFreeList)
+    {
+        size_t blockSize = block.getSize();
+        if (blockSize >= size)
+        {
+            void* memory = block.memory();
+            if (blockSize >= size + PtrUtil::diff(PtrUtil::roundUpPow2(memory, alignment), memory))
+            {
+                if (mode == FindMode::eFirstFit)
+                    return &block;
+
+                if (!ret
+                    || mode == FindMode::eBestFit && blockSize < ret->getSize()
+                    || mode == FindMode::eMaxSize && blockSize > ret->getSize())
+                {
+                    ret = &block;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+MemBlock* ExpHeap::findFreeMemBlockFromTail_(size_t size, FindMode mode) const
+{
+    if (mFreeBinTable)
+        return findFreeBinMemBlock_(size, cMinAlignment, true, mode);
+
+    MemBlock* ret = nullptr;
+
+    for (MemBlock* block = mFreeList.back(); block != nullptr; block = mFreeList.prev(block))
+    {
+        size_t blockSize = block->getSize();
+        if (blockSize >= size)
+        {
+            if (mode == FindMode::eFirstFit)
+                return block;
+
+            if (!ret
+                || mode == FindMode::eBestFit && blockSize < ret->getSize()
+                || mode == FindMode::eMaxSize && blockSize > ret->getSize())
+            {
+                ret = block;
+            }
+        }
+    }
+
+    return ret;
+}
+
+MemBlock* ExpHeap::findFreeMemBlockFromTail_(size_t size, s32 alignment, FindMode mode) const
+{
+    if (mFreeBinTable)
+        return findFreeBinMemBlock_(size, alignment, true, mode);
+
+    MemBlock* ret = nullptr;
+
+    for (MemBlock* block = mFreeList.back(); block != nullptr; block = mFreeList.prev(block))
+    {
+        size_t blockSize = block->getSize();
+        if (blockSize >= size)
+        {
+            void* memory = PtrUtil::addOffset(block->memory(), block->getSize() - size);
+            if (blockSize >= size + PtrUtil::diff(memory, PtrUtil::roundDownPow2(memory, alignment)))
+            {
+                if (mode == FindMode::eFirstFit)
+                    return block;
+
+                if (!ret
+                    || mode == FindMode::eBestFit && blockSize < ret->getSize()
+                    || mode == FindMode::eMaxSize && blockSize > ret->getSize())
+                {
+                    ret = block;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+MemBlock* ExpHeap::findLastMemBlockIfFree_()
+{
+    if (mFreeBinTable)
+    {
+        // Bins are not address ordered, look for the free block that touches the end of the area
+        void* areaEnd = getAreaEnd_();
+        for (s32 i = 0; i < mFreeBinTable->flNum * cFreeBinSLIndexNum; i++)
+        {
+            for (MemBlock& block : mFreeBinTable->bins[i])
+            {
+                if (PtrUtil::addOffset(&block, block.getSizeWithManage()) == areaEnd)
+                    return &block;
+            }
+        }
+
+        return nullptr;
+    }
+
+    mUseList.sort(&ExpHeap::compareMemBlockAddr_);
+
+    MemBlock* backFreeBlock = mFreeList.back();
+    MemBlock* backUseBlock = mUseList.back();
+
+    if (backFreeBlock <= backUseBlock)
+        return nullptr;
+
+    return backFreeBlock;
+}
+
+MemBlock* ExpHeap::findFirstMemBlockIfFree_()
+{
+    if (mFreeBinTable)
+    {
+        MemBlock* frontBlock = static_cast<MemBlock*>(getAreaStart_());
+        if (frontBlock == getAreaEnd_() || !frontBlock->isFree())
+            return nullptr;
+
+        return frontBlock;
+    }
+
+    mUseList.sort(&ExpHeap::compareMemBlockAddr_);
+
+    MemBlock* frontFreeBlock = mFreeList.front();
+    MemBlock* frontUseBlock = mUseList.front();
+
+    if (frontUseBlock && frontUseBlock <= frontFreeBlock)
+        return nullptr;
+
+    return frontFreeBlock;
+}
+
+void ExpHeap::pushToUseList_(MemBlock* memBlock)
+{
     if (mDirection == HeapDirection::eForward)
         mUseList.pushBack(memBlock);
     else
@@ -1105,6 +1669,12 @@ void ExpHeap::pushToUseList_(MemBlock* memBlock)
 
 void ExpHeap::pushToFreeList_(MemBlock* memBlock)
 {
+    if (mFreeBinTable)
+    {
+        pushToFreeBin_(memBlock);
+        return;
+    }
+
     bool blockInserted = false;
     MemBlock* prevBlock = nullptr;
 
@@ -1174,6 +1744,93 @@ void ExpHeap::pushToFreeList_(MemBlock* memBlock)
     }
 }
 
+ExpHeap::HandleEntry* ExpHeap::findHandleEntry_(Handle handle) const
+{
+    if (!mHandleTable)
+        return nullptr;
+
+    s32 idx = static_cast<s32>(handle & 0xFFFF);
+    if (idx >= mHandleTable->entryNum)
+        return nullptr;
+
+    HandleEntry* entry = &mHandleTable->entries[idx];
+    if (!entry->ptr || entry->generation != (handle >> 16))
+        return nullptr;
+
+    return entry;
+}
+
+MemBlock* ExpHeap::getHandleMemBlock_(const HandleEntry* entry) const
+{
+    return static_cast<MemBlock*>(PtrUtil::addOffset(entry->ptr, -static_cast<intptr_t>(cHandleHeaderSize + sizeof(MemBlock))));
+}
+
+bool ExpHeap::compactMemBlock_(MemBlock* memBlock, MemBlock* prevFreeBlock, MemBlock** freeBlock)
+{
+    SEAD_ASSERT(memBlock->getOffset() == 0);
+
+    HandleEntry& entry = mHandleTable->entries[*reinterpret_cast<s32*>(memBlock->memory())];
+    SEAD_ASSERT(getHandleMemBlock_(&entry) == memBlock);
+
+    if (entry.lockNum != 0)
+        return false;
+
+    size_t size = memBlock->getSize();
+
+    if (prevFreeBlock)
+    {
+        // Slide down over the free block right before, which then ends up right behind
+        size_t freeSize = prevFreeBlock->getSize();
+
+        eraseFromFreeList_(prevFreeBlock);
+        mUseList.erase(memBlock);
+
+        MemUtil::copyOverlap(prevFreeBlock->memory(), memBlock->memory(), size);
+
+        MemBlock* movedBlock = new(prevFreeBlock) MemBlock();
+        movedBlock->setHeapCheckTag(mHeapCheckTag);
+        movedBlock->setHeapId(mHeapId);
+        movedBlock->setSize(size);
+        movedBlock->setRelocatable(true);
+        pushToUseList_(movedBlock);
+
+        MemBlock* newFreeBlock = new(PtrUtil::addOffset(movedBlock, movedBlock->getSizeWithManage())) MemBlock();
+        newFreeBlock->setSize(freeSize);
+
+        markMemBlockUsed_(movedBlock, false);
+        pushToFreeList_(newFreeBlock);
+
+        entry.ptr = movedBlock->memory() + cHandleHeaderSize;
+        *freeBlock = newFreeBlock;
+        return true;
+    }
+
+    // Pinned in place by its neighbors, move it into a hole further down like realloc_ does
+    MemBlock* lowerBlock = findFreeMemBlockFromHead_(size, FindMode::eFirstFit);
+    if (!lowerBlock || lowerBlock > memBlock)
+        return false;
+
+    MemBlock* newBlock = allocMemBlock_(size, cMinAlignment);
+    if (!newBlock)
+        return false;
+
+    if (newBlock > memBlock)
+    {
+        freeMemBlock_(newBlock);
+        return false;
+    }
+
+    MemUtil::copy(newBlock->memory(), memBlock->memory(), size);
+    newBlock->setRelocatable(true);
+
+    entry.ptr = newBlock->memory() + cHandleHeaderSize;
+
+    // The block before is not free, so the header stays where it is
+    freeMemBlock_(memBlock);
+    *freeBlock = memBlock;
+    return true;
+}
+
 #if defined(SEAD_TARGET_DEBUG)
 void ExpHeap::fillMemBlockDebugFillFree_(void* addr)
 {
@@ -1186,16 +1843,87 @@ void ExpHeap::fillMemBlockDebugFillFree_(void* addr)
     else
         MemUtil::fill(addr, HeapMgr::cDefaultDebugFillFree, sizeof(MemBlock));
 }
+
+void ExpHeap::genInformation_(hostio::Context* context)
+{
+    Heap::genInformation_(context);
+
+    FragmentationInfo info;
+    calcFragmentationInfo(&info);
+
+    hostio::Context::ContextBufferAccessor* ctxBuf = context->beginHTMLLabel("");
+    if (ctxBuf)
+    {
+        BufferedSafeString buf(static_cast<char*>(ctxBuf->getBuffer()), ctxBuf->getMaxSize());
+        buf.format(
+            "<font face=\"ＭＳ ゴシック\"><table><tr><th>FreeBlockNum</th><td>%u</td></tr><tr><th>MaxFreeBlockSize</th><td>%zu</td></tr><tr><th>ExternalFragmentation</th><td>%.1f%%</td></tr><tr><th>FreeBlockHistogram</th><td>",
+            info.freeBlockNum, info.maxFreeBlockSize, info.externalFragmentation * 100.0f
+        );
+
+        for (s32 i = 0; i < cFreeBlockHistogramNum; i++)
+            buf.appendWithFormat(i == 0 ? "%u" : " %u", info.freeBlockHistogram[i]);
+
+        buf.append("</td></tr></table></font>");
+        context->endHTMLLabel(buf.calcLength());
+    }
+}
 #endif // SEAD_TARGET_DEBUG
 
 s32 ExpHeap::compareMemBlockAddr_(const MemBlock* a, const MemBlock* b)
 {
-    return Mathi::sign(static_cast<s32>(PtrUtil::diff(a, b)));
+    // Compare directly, a truncated address difference flips sign on heaps larger than 2GB
+    if (a < b)
+        return -1;
+
+    if (a > b)
+        return 1;
+
+    return 0;
+}
+
+MemBlock* ExpHeap::allocMemBlock_(size_t size, s32 alignment)
+{
+    MemBlock* block;
+    if (alignment < 0)
+    {
+        alignment = -alignment;
+        if (alignment <= cMinAlignment)
+            block = allocFromTail_(size);
+        else
+            block = allocFromTail_(size, alignment);
+    }
+    else
+    {
+        if (alignment <= cMinAlignment)
+            block = allocFromHead_(size);
+        else
+            block = allocFromHead_(size, alignment);
+    }
+
+    if (block)
+    {
+        block->setHeapCheckTag(mHeapCheckTag);
+        block->setHeapId(mHeapId);
+    }
+
+    return block;
+}
+
+void ExpHeap::freeMemBlock_(MemBlock* memBlock)
+{
+    mUseList.erase(memBlock);
+
+    memBlock->setRelocatable(false);
+
+    memBlock->setSize(memBlock->getSize() + memBlock->getOffset());
+    memBlock->setOffset(0);
+
+    pushToFreeList_(memBlock);
 }
 
 MemBlock* ExpHeap::allocFromHead_(size_t size)
 {
-    MemBlock* memBlock = findFreeMemBlockFromHead_(size, static_cast<FindMode>(mAllocMode));
+    MemBlock* memBlock = findFreeMemBlockFromHead_(size, getAllocFindMode_());
     if (!memBlock)
         return nullptr;
 
@@ -1205,11 +1933,11 @@ MemBlock* ExpHeap::allocFromHead_(size_t size)
     void* memory = memBlock->memory();
     size_t remainSize = memBlock->getSize() - size;
 
+    eraseFromFreeList_(memBlock);
     memBlock->setSize(size);
-
-    mFreeList.erase(memBlock);
     pushToUseList_(memBlock);
 
+    MemBlock* newBlock = nullptr;
     if (remainSize < sizeof(MemBlock) + 1)
     {
         if (remainSize != 0)
@@ -1217,17 +1945,21 @@ MemBlock* ExpHeap::allocFromHead_(size_t size)
     }
     else
     {
-        MemBlock* newBlock = new(PtrUtil::addOffset(memory, size)) MemBlock();
+        newBlock = new(PtrUtil::addOffset(memory, size)) MemBlock();
         newBlock->setSize(remainSize - sizeof(MemBlock));
-        pushToFreeList_(newBlock);
     }
 
+    markMemBlockUsed_(memBlock, false);
+
+    if (newBlock)
+        pushToFreeList_(newBlock);
+
     return memBlock;
 }
 
 MemBlock* ExpHeap::allocFromHead_(size_t size, s32 alignment)
 {
-    MemBlock* memBlock = findFreeMemBlockFromHead_(size, alignment, static_cast<FindMode>(mAllocMode));
+    MemBlock* memBlock = findFreeMemBlockFromHead_(size, alignment, getAllocFindMode_());
     if (!memBlock)
         return nullptr;
 
@@ -1235,24 +1967,27 @@ MemBlock* ExpHeap::allocFromHead_(size_t size, s32 alignment)
     size_t offset = PtrUtil::diff(PtrUtil::roundUpPow2(memory, alignment), memory);
     size_t remainSize = memBlock->getSize() - (size + offset);
 
+    bool prevFree = false;
     if (offset <= cOffsetMax)
     {
+        eraseFromFreeList_(memBlock);
         memBlock->setOffset(static_cast<u16>(offset));
         memBlock->setSize(size);
-        mFreeList.erase(memBlock);
     }
     else
     {
         memBlock->setOffset(0);
-        memBlock->setSize(offset - sizeof(MemBlock));
+        resizeFreeMemBlock_(memBlock, offset - sizeof(MemBlock));
 
         memBlock = new(PtrUtil::addOffset(memBlock, memBlock->getSizeWithManage())) MemBlock();
         memBlock->setOffset(0);
         memBlock->setSize(size);
+        prevFree = true;
     }
 
     pushToUseList_(memBlock);
 
+    MemBlock* newBlock = nullptr;
     if (remainSize < sizeof(MemBlock) + 1)
     {
         if (remainSize != 0)
@@ -1260,17 +1995,21 @@ MemBlock* ExpHeap::allocFromHead_(size_t size, s32 alignment)
     }
     else
     {
-        MemBlock* newBlock = new(PtrUtil::addOffset(memBlock->memory(), size)) MemBlock();
+        newBlock = new(PtrUtil::addOffset(memBlock->memory(), size)) MemBlock();
         newBlock->setSize(remainSize - sizeof(MemBlock));
-        pushToFreeList_(newBlock);
     }
 
+    markMemBlockUsed_(memBlock, prevFree);
+
+    if (newBlock)
+        pushToFreeList_(newBlock);
+
     return memBlock;
 }
 
 MemBlock* ExpHeap::allocFromTail_(size_t size)
 {
-    MemBlock* memBlock = findFreeMemBlockFromTail_(size, static_cast<FindMode>(mAllocMode));
+    MemBlock* memBlock = findFreeMemBlockFromTail_(size, getAllocFindMode_());
     if (!memBlock)
         return nullptr;
 
@@ -1280,17 +2019,19 @@ MemBlock* ExpHeap::allocFromTail_(size_t size)
     size_t remainSize = memBlock->getSize() - size;
     if (remainSize < sizeof(MemBlock) + 1)
     {
-        mFreeList.erase(memBlock);
+        eraseFromFreeList_(memBlock);
         pushToUseList_(memBlock);
+        markMemBlockUsed_(memBlock, false);
     }
     else
     {
         remainSize -= sizeof(MemBlock);
-        memBlock->setSize(remainSize);
+        resizeFreeMemBlock_(memBlock, remainSize);
 
         memBlock = new(PtrUtil::addOffset(memBlock->memory(), remainSize)) MemBlock();
         memBlock->setSize(size);
         pushToUseList_(memBlock);
+        markMemBlockUsed_(memBlock, true);
     }
 
     return memBlock;
@@ -1298,7 +2039,7 @@ MemBlock* ExpHeap::allocFromTail_(size_t size)
 
 MemBlock* ExpHeap::allocFromTail_(size_t size, s32 alignment)
 {
-    MemBlock* memBlock = findFreeMemBlockFromTail_(size, alignment, static_cast<FindMode>(mAllocMode));
+    MemBlock* memBlock = findFreeMemBlockFromTail_(size, alignment, getAllocFindMode_());
     if (!memBlock)
         return nullptr;
 
@@ -1312,11 +2053,13 @@ MemBlock* ExpHeap::allocFromTail_(size_t size, s32 alignment)
     {
         size_t offset = memBlock->getSize() - newBlockSize;
         SEAD_ASSERT_MSG(offset <= cOffsetMax, "Offset is too large.");
+
+        eraseFromFreeList_(memBlock);
         memBlock->setOffset(static_cast<u16>(offset));
         memBlock->setSize(newBlockSize);
 
-        mFreeList.erase(memBlock);
         pushToUseList_(memBlock);
+        markMemBlockUsed_(memBlock, false);
 
         SEAD_ASSERT(memBlock->memory() == alignedAddr);
 
@@ -1325,7 +2068,7 @@ MemBlock* ExpHeap::allocFromTail_(size_t size, s32 alignment)
     else
     {
         remainSize -= sizeof(MemBlock);
-        memBlock->setSize(remainSize);
+        resizeFreeMemBlock_(memBlock, remainSize);
 
         MemBlock* newBlock = new(PtrUtil::addOffset(memBlock->memory(), remainSize)) MemBlock();
         newBlock->setSize(newBlockSize);
@@ -1333,6 +2076,7 @@ MemBlock* ExpHeap::allocFromTail_(size_t size, s32 alignment)
         SEAD_ASSERT(newBlock->memory() == alignedAddr);
 
         pushToUseList_(newBlock);
+        markMemBlockUsed_(newBlock, true);
 
         return newBlock;
     }
@@ -1348,7 +2092,7 @@ size_t ExpHeap::adjustBack_()
 
     size_t newSize = PtrUtil::diff(memBlock, mStart);
 
-    mFreeList.erase(memBlock);
+    eraseFromFreeList_(memBlock);
 
     void* addr = mParent->resizeBack(mStart, newSize);
     if (addr)
@@ -1367,7 +2111,11 @@ size_t ExpHeap::adjustFront_()
 
     size_t newSize = mSize - memBlock->getSizeWithManage();
 
-    mFreeList.erase(memBlock);
+    MemBlock* nextBlock = getNextMemBlock_(memBlock);
+    eraseFromFreeList_(memBlock);
+
+    if (nextBlock)
+        nextBlock->setPrevFree(false);
 
     void* addr = mParent->resizeFront(mStart, newSize);
     if (addr)
@@ -1396,6 +2144,402 @@ void* ExpHeap::realloc_(void* ptr, u8* oldMem, size_t copySize, size_t newSize,
     return ret;
 }
 
+void ExpHeap::setAllocMode(AllocMode mode)
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    if (mode == mAllocMode)
+        return;
+
+    if (mode == AllocMode::eSegregatedFit)
+    {
+        if (!createFreeBinTable_())
+        {
+            SEAD_ASSERT_MSG(false, "Failed to create free bin table. heap: %s, max allocatable size: %zu",
+                            getName().cstr(), getMaxAllocatableSize());
+            return;
+        }
+    }
+    else if (mFreeBinTable)
+    {
+        destroyFreeBinTable_();
+    }
+
+    mAllocMode = mode;
+}
+
+void ExpHeap::eraseFromFreeList_(MemBlock* memBlock)
+{
+    if (mFreeBinTable)
+        eraseFromFreeBin_(memBlock);
+    else
+        mFreeList.erase(memBlock);
+}
+
+void ExpHeap::resizeFreeMemBlock_(MemBlock* memBlock, size_t newSize)
+{
+    if (!mFreeBinTable)
+    {
+        memBlock->setSize(newSize);
+        return;
+    }
+
+    eraseFromFreeBin_(memBlock);
+    memBlock->setSize(newSize);
+    insertToFreeBin_(memBlock);
+}
+
+void ExpHeap::markMemBlockUsed_(MemBlock* memBlock, bool prevFree)
+{
+    if (!mFreeBinTable)
+        return;
+
+    memBlock->setFree(false);
+    memBlock->setPrevFree(prevFree);
+
+    MemBlock* nextBlock = getNextMemBlock_(memBlock);
+    if (nextBlock)
+        nextBlock->setPrevFree(false);
+}
+
+void* ExpHeap::getAreaStart_() const
+{
+    if (mDirection == HeapDirection::eForward)
+        return PtrUtil::addOffset(mStart, sizeof(ExpHeap));
+    else
+        return mStart;
+}
+
+void* ExpHeap::getAreaEnd_() const
+{
+    if (mDirection == HeapDirection::eForward)
+        return PtrUtil::addOffset(mStart, mSize);
+    else
+        return PtrUtil::addOffset(mStart, mSize - sizeof(ExpHeap));
+}
+
+MemBlock* ExpHeap::getNextMemBlock_(const MemBlock* memBlock) const
+{
+    void* next = PtrUtil::addOffset(memBlock, memBlock->getSizeWithManage());
+    if (next >= getAreaEnd_())
+        return nullptr;
+
+    return static_cast<MemBlock*>(next);
+}
+
+bool ExpHeap::createFreeBinTable_()
+{
+    SEAD_ASSERT(!mFreeBinTable);
+
+    s32 flNum;
+    s32 slIndex;
+    CalcFreeBinIndex(PtrUtil::diff(getAreaEnd_(), getAreaStart_()), &flNum, &slIndex);
+    flNum += 1;
+    SEAD_ASSERT(flNum <= cFreeBinFLIndexMax);
+
+    size_t tableSize = MathSizeT::roundUpPow2(sizeof(FreeBinTable) + sizeof(MemBlockList) * flNum * cFreeBinSLIndexNum, cMinAlignment);
+
+    // Keep the table on the side adjust() never trims
+    MemBlock* tableBlock;
+    if (mDirection == HeapDirection::eForward)
+        tableBlock = allocFromHead_(tableSize);
+    else
+        tableBlock = allocFromTail_(tableSize);
+
+    if (!tableBlock)
+        return false;
+
+    mUseList.erase(tableBlock);
+    tableBlock->setHeapCheckTag(mHeapCheckTag);
+    tableBlock->setHeapId(mHeapId);
+
+    FreeBinTable* table = new(tableBlock->memory()) FreeBinTable();
+    table->memBlock = tableBlock;
+    table->bins = static_cast<MemBlockList*>(PtrUtil::addOffset(table, sizeof(FreeBinTable)));
+    table->flBitmap = 0;
+    table->flNum = flNum;
+
+    for (s32 i = 0; i < flNum * cFreeBinSLIndexNum; i++)
+    {
+        MemBlockList* bin = new(&table->bins[i]) MemBlockList();
+        bin->initOffset(offsetof(MemBlock, mListNode));
+    }
+
+    // The free list is address ordered, so the boundary tags can be set up in a single walk over the area
+    MemBlock* freeBlock = mFreeList.front();
+    bool prevFree = false;
+
+    for (void* addr = getAreaStart_(); addr < getAreaEnd_(); )
+    {
+        MemBlock* block = static_cast<MemBlock*>(addr);
+        bool isFree = block == freeBlock;
+
+        block->setFree(isFree);
+        block->setPrevFree(prevFree);
+
+        if (isFree)
+            freeBlock = mFreeList.next(freeBlock);
+
+        prevFree = isFree;
+        addr = PtrUtil::addOffset(block, block->getSizeWithManage());
+    }
+
+    SEAD_ASSERT(!freeBlock);
+
+    mFreeBinTable = table;
+
+    for (MemBlock* block = mFreeList.popFront(); block; block = mFreeList.popFront())
+    {
+        insertToFreeBin_(block);
+    }
+
+    return true;
+}
+
+void ExpHeap::destroyFreeBinTable_()
+{
+    FreeBinTable* table = mFreeBinTable;
+    mFreeBinTable = nullptr;
+
+    for (s32 i = 0; i < table->flNum * cFreeBinSLIndexNum; i++)
+    {
+        MemBlockList& bin = table->bins[i];
+        for (MemBlock* block = bin.popFront(); block; block = bin.popFront())
+        {
+            mFreeList.pushBack(block);
+        }
+    }
+
+    mFreeList.mergeSort(&ExpHeap::compareMemBlockAddr_);
+
+    MemBlock* tableBlock = table->memBlock;
+    tableBlock->setSize(tableBlock->getSize() + tableBlock->getOffset());
+    tableBlock->setOffset(0);
+    pushToFreeList_(tableBlock);
+}
+
+MemBlock* ExpHeap::findFreeBinMemBlock_(size_t size, s32 alignment, bool fromTail, FindMode mode) const
+{
+    const FreeBinTable* table = mFreeBinTable;
+
+    if (mode == FindMode::eMaxSize)
+    {
+        u64 flBitmap = table->flBitmap;
+        while (flBitmap != 0)
+        {
+            s32 fl = std::bit_width(flBitmap) - 1;
+            u32 slBitmap = table->slBitmap[fl];
+
+            while (slBitmap != 0)
+            {
+                s32 sl = std::bit_width(slBitmap) - 1;
+
+                MemBlock* ret = nullptr;
+                for (MemBlock& block : table->getBin(fl, sl))
+                {
+                    if (isMemBlockFit_(&block, size, alignment, fromTail) && (!ret || block.getSize() > ret->getSize()))
+                        ret = &block;
+                }
+
+                if (ret)
+                    return ret;
+
+                slBitmap &= ~(1u << sl);
+            }
+
+            flBitmap &= ~(1ull << fl);
+        }
+
+        return nullptr;
+    }
+
+    // Every block in a bin at or above the rounded up request fits, alignment padding included
+    size_t requestSize = size;
+    if (alignment > cMinAlignment)
+        requestSize += alignment - cMinAlignment;
+
+    s32 fl;
+    s32 sl;
+    CalcFreeBinIndex(RoundUpFreeBinSize(requestSize), &fl, &sl);
+
+    if (fl < table->flNum)
+    {
+        u32 slBitmap = table->slBitmap[fl] & (~0u << sl);
+        if (slBitmap == 0)
+        {
+            u64 flBitmap = fl + 1 < cFreeBinFLIndexMax ? table->flBitmap & (~0ull << (fl + 1)) : 0;
+            if (flBitmap != 0)
+            {
+                fl = std::countr_zero(flBitmap);
+                slBitmap = table->slBitmap[fl];
+            }
+        }
+
+        if (slBitmap != 0)
+            return table->getBin(fl, std::countr_zero(slBitmap)).front();
+    }
+
+    // Nothing is guaranteed to fit, so check each block of the bins the request itself falls into.
+    // Only reached near exhaustion, the bins above the rounded request are all empty at this point.
+    CalcFreeBinIndex(size, &fl, &sl);
+
+    u32 slMask = ~0u << sl;
+    for (; fl < table->flNum; fl++)
+    {
+        u32 slBitmap = table->slBitmap[fl] & slMask;
+        slMask = ~0u;
+
+        while (slBitmap != 0)
+        {
+            for (MemBlock& block : table->getBin(fl, std::countr_zero(slBitmap)))
+            {
+                if (isMemBlockFit_(&block, size, alignment, fromTail))
+                    return &block;
+            }
+
+            slBitmap &= slBitmap - 1;
+        }
+    }
+
+    return nullptr;
+}
+
+void ExpHeap::pushToFreeBin_(MemBlock* memBlock)
+{
+    SEAD_ASSERT(memBlock->getOffset() == 0);
+
+    if (memBlock->isPrevFree())
+    {
+        MemBlock* prevBlock = *static_cast<MemBlock**>(PtrUtil::addOffset(memBlock, -cPtrSize));
+        SEAD_ASSERT(prevBlock->isFree() && PtrUtil::addOffset(prevBlock, prevBlock->getSizeWithManage()) == memBlock);
+
+        eraseFromFreeBin_(prevBlock);
+        prevBlock->setSize(prevBlock->getSize() + memBlock->getSizeWithManage());
+#if defined(SEAD_TARGET_DEBUG)
+        fillMemBlockDebugFillFree_(memBlock);
+#endif // SEAD_TARGET_DEBUG
+        memBlock = prevBlock;
+    }
+
+    MemBlock* nextBlock = getNextMemBlock_(memBlock);
+    if (nextBlock && nextBlock->isFree())
+    {
+        eraseFromFreeBin_(nextBlock);
+        memBlock->setSize(memBlock->getSize() + nextBlock->getSizeWithManage());
+#if defined(SEAD_TARGET_DEBUG)
+        fillMemBlockDebugFillFree_(nextBlock);
+#endif // SEAD_TARGET_DEBUG
+        nextBlock = getNextMemBlock_(memBlock);
+    }
+
+    insertToFreeBin_(memBlock);
+
+    if (nextBlock)
+        nextBlock->setPrevFree(true);
+}
+
+void ExpHeap::insertToFreeBin_(MemBlock* memBlock)
+{
+    memBlock->setFree(true);
+
+    // Footer for the next block to find this one when coalescing
+    *static_cast<MemBlock**>(PtrUtil::addOffset(memBlock->memory(), memBlock->getSize() - cPtrSize)) = memBlock;
+
+    s32 fl;
+    s32 sl;
+    CalcFreeBinIndex(memBlock->getSize(), &fl, &sl);
+
+    mFreeBinTable->getBin(fl, sl).pushFront(memBlock);
+    mFreeBinTable->slBitmap[fl] |= 1 << sl;
+    mFreeBinTable->flBitmap |= 1ull << fl;
+}
+
+void ExpHeap::eraseFromFreeBin_(MemBlock* memBlock)
+{
+    s32 fl;
+    s32 sl;
+    CalcFreeBinIndex(memBlock->getSize(), &fl, &sl);
+
+    MemBlockList& bin = mFreeBinTable->getBin(fl, sl);
+    bin.erase(memBlock);
+
+    if (bin.isEmpty())
+    {
+        mFreeBinTable->slBitmap[fl] &= ~(1 << sl);
+        if (mFreeBinTable->slBitmap[fl] == 0)
+            mFreeBinTable->flBitmap &= ~(1ull << fl);
+    }
+}
+
+bool ExpHeap::tryCheckFreeBin_() const
+{
+    u64 flBitmap = 0;
+
+    for (s32 fl = 0; fl < mFreeBinTable->flNum; fl++)
+    {
+        u32 slBitmap = 0;
+
+        for (s32 sl = 0; sl < cFreeBinSLIndexNum; sl++)
+        {
+            const MemBlockList& bin = mFreeBinTable->getBin(fl, sl);
+            if (!bin.checkLinks())
+                return false;
+
+            if (!bin.isEmpty())
+                slBitmap |= 1 << sl;
+
+            for (MemBlock& block : bin)
+            {
+                if (block.getOffset() != 0 || block.getSize() == 0 || !block.isFree())
+                    return false;
+
+                if (reinterpret_cast<uintptr_t>(block.memory()) % cMinAlignment != 0)
+                    return false;
+
+                s32 blockFl;
+                s32 blockSl;
+                CalcFreeBinIndex(block.getSize(), &blockFl, &blockSl);
+                if (blockFl != fl || blockSl != sl)
+                    return false;
+
+                if (*reinterpret_cast<MemBlock**>(block.memory() + block.getSize() - cPtrSize) != &block)
+                    return false;
+
+                MemBlock* nextBlock = getNextMemBlock_(&block);
+                if (nextBlock && (nextBlock->isFree() || !nextBlock->isPrevFree()))
+                    return false;
+            }
+        }
+
+        if (slBitmap != mFreeBinTable->slBitmap[fl])
+            return false;
+
+        if (slBitmap != 0)
+            flBitmap |= 1ull << fl;
+    }
+
+    return flBitmap == mFreeBinTable->flBitmap;
+}
+
+bool ExpHeap::isMemBlockFit_(const MemBlock* memBlock, size_t size, s32 alignment, bool fromTail)
+{
+    size_t blockSize = memBlock->getSize();
+    if (blockSize < size)
+        return false;
+
+    if (alignment <= cMinAlignment)
+        return true;
+
+    if (fromTail)
+    {
+        void* memory = PtrUtil::addOffset(memBlock->memory(), blockSize - size);
+        return blockSize >= size + PtrUtil::diff(memory, PtrUtil::roundDownPow2(memory, alignment));
+    }
+
+    void* memory = memBlock->memory();
+    return blockSize >= size + PtrUtil::diff(PtrUtil::roundUpPow2(memory, alignment), memory);
+}
+
 template <>
 void PrintFormatter::out<ExpHeap>(const ExpHeap& obj, const char*, PrintOutput* output)
 {
@@ -1409,8 +2553,10 @@ void PrintFormatter::out<ExpHeap>(const ExpHeap& obj, const char*, PrintOutput*
 
     if (obj.getAllocMode() == ExpHeap::AllocMode::eFirstFit)
         allocMode = "First Fit";
-    else
+    else if (obj.getAllocMode() == ExpHeap::AllocMode::eBestFit)
         allocMode = "Best Fit";
+    else
+        allocMode = "Segregated Fit";
 
     buf.format("         AllocMode: %s\n", allocMode);
     PrintFormatter::out(SafeString(buf.cstr()), nullptr, output);
@@ -1418,7 +2564,7 @@ void PrintFormatter::out<ExpHeap>(const ExpHeap& obj, const char*, PrintOutput*
     buf.format("      UseList size: %d\n", obj.mUseList.size());
     PrintFormatter::out(SafeString(buf.cstr()), nullptr, output);
 
-    buf.format("     FreeList size: %d\n", obj.mFreeList.size());
+    buf.format("     FreeList size: %zu\n", obj.getFreeListSize());
     PrintFormatter::out(SafeString(buf.cstr()), nullptr, output);
 
     PrintFormatter::out(SafeString("==================================================\n"), nullptr, output);
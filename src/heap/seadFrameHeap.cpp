@@ -68,6 +68,8 @@ FrameHeap* FrameHeap::tryCreate(size_t size_, const SafeString& name, Heap* pare
 
     parent->pushBackChild_(result);
 
+    HeapMgr::addToAddressIndex_(result);
+
 #if defined(SEAD_TARGET_DEBUG)
     {
         HeapMgr* mgr = HeapMgr::instance();
@@ -154,25 +156,36 @@ size_t FrameHeap::adjust()
     if (!mParent)
         return mSize;
 
-    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
-    ScopedLock<Heap> parentLock(mParent);
-
     size_t ret;
-    if (mDirection == HeapDirection::eForward)
-    {
-        if (getAreaEnd_() == mState.mTailPtr)
-            ret = adjustBack_();
-        else
-            ret = mSize;
-    }
-    else
+
+    void* prevAreaStart = nullptr;
+    void* prevAreaEnd = nullptr;
+
     {
-        if (getAreaStart_() == mState.mHeadPtr)
-            ret = adjustFront_();
+        ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+        ScopedLock<Heap> parentLock(mParent);
+
+        prevAreaStart = getAreaStart_();
+        prevAreaEnd = getAreaEnd_();
+
+        if (mDirection == HeapDirection::eForward)
+        {
+            if (getAreaEnd_() == mState.mTailPtr)
+                ret = adjustBack_();
+            else
+                ret = mSize;
+        }
         else
-            ret = mSize;
+        {
+            if (getAreaStart_() == mState.mHeadPtr)
+                ret = adjustFront_();
+            else
+                ret = mSize;
+        }
     }
 
+    HeapMgr::updateAddressIndex_(this, prevAreaStart, prevAreaEnd);
+
     return ret;
 }
 
@@ -27,6 +27,7 @@ Heap::Heap(const SafeString& name, Heap* parent, void* start, size_t size, HeapD
     , mFlag(1 << Flag::eEnableWarning)
 #endif // SEAD_TARGET_DEBUG
     , mHeapCheckTag(static_cast<u16>(HeapMgr::getHeapCheckTag()))
+    , mHeapId(0)
 #if defined(SEAD_TARGET_DEBUG)
     , mAccessThread(nullptr)
 #endif // SEAD_TARGET_DEBUG
@@ -212,6 +213,7 @@ void Heap::destruct_()
     dispose_(nullptr, nullptr);
 
     HeapMgr::removeFromFindContainHeapCache_(this);
+    HeapMgr::removeFromAddressIndex_(this);
 
     if (mParent)
         mParent->eraseChild_(this);
@@ -0,0 +1,362 @@
+#include <heap/seadHeapAddressIndex.h>
+
+#include <basis/seadAssert.h>
+#include <basis/seadWarning.h>
+
+#include <cstdlib>
+#include <new>
+
+namespace sead {
+
+namespace {
+
+const u32 cSplitBits = 12;
+const u64 cSequenceMask = 0xFFFF;
+
+u32 GetSequence(u64 layout)
+{
+    return static_cast<u32>(layout & cSequenceMask);
+}
+
+u32 GetSegmentNum(u64 layout)
+{
+    return static_cast<u32>(layout >> 16) & 0xF;
+}
+
+u32 GetSplit(u64 layout, s32 index)
+{
+    return static_cast<u32>(layout >> (20 + index * cSplitBits)) & ((1u << cSplitBits) - 1);
+}
+
+u16 GetId(u64 ids, s32 index)
+{
+    return static_cast<u16>(ids >> (index * 16));
+}
+
+} // namespace
+
+HeapAddressIndex::HeapAddressIndex()
+    : mHeapIdEnd(1)
+{
+    static_assert(HeapAddressIndex::cPageShift == cSplitBits, "split offsets must hold a page offset");
+}
+
+HeapAddressIndex::~HeapAddressIndex()
+{
+    clear();
+}
+
+bool HeapAddressIndex::find(Heap** heap, const void* addr) const
+{
+    uintptr_t page = reinterpret_cast<uintptr_t>(addr) >> cPageShift;
+    if ((page >> cIndexBits) != 0)
+        return false;
+
+    *heap = nullptr;
+
+    Node* node = mRoot[page >> (cLeafBits + cNodeBits)].getValue();
+    if (!node)
+        return true;
+
+    Leaf* leaf = node->leaves[(page >> cLeafBits) & ((1 << cNodeBits) - 1)].getValue();
+    if (!leaf)
+        return true;
+
+    const Entry& entry = leaf->entries[page & ((1 << cLeafBits) - 1)];
+
+    u64 layout;
+    u64 ids;
+
+    for (;;)
+    {
+        layout = entry.layout.getValue();
+        if ((GetSequence(layout) & 1) == 0)
+        {
+            ids = entry.ids.getValue();
+            if (entry.layout.getValue() == layout)
+                break;
+        }
+    }
+
+    u32 num = GetSegmentNum(layout);
+    if (num == cComplexNum)
+        return false;
+
+    if (num == 0)
+        return true;
+
+    u32 offset = static_cast<u32>(reinterpret_cast<uintptr_t>(addr) & (cPageSize - 1));
+
+    s32 segment = 0;
+    while (segment < static_cast<s32>(num) - 1 && offset >= GetSplit(layout, segment))
+        segment++;
+
+    u16 id = GetId(ids, segment);
+    if (id != 0)
+        *heap = mHeaps[id].getValue();
+
+    return true;
+}
+
+void HeapAddressIndex::assign(const void* start, const void* end, Heap* heap)
+{
+    uintptr_t startAddr = reinterpret_cast<uintptr_t>(start);
+    uintptr_t endAddr = reinterpret_cast<uintptr_t>(end);
+    if (startAddr >= endAddr)
+        return;
+
+    u16 id = heap ? getId_(heap) : 0;
+
+    uintptr_t startPage = startAddr >> cPageShift;
+    uintptr_t endPage = (endAddr - 1) >> cPageShift;
+
+    for (uintptr_t page = startPage; page <= endPage; page++)
+    {
+        if ((page >> cIndexBits) != 0)
+            break;
+
+        // A page never written to is not owned by any heap
+        Entry* entry = getEntry_(page, id != 0);
+        if (!entry)
+            continue;
+
+        u32 begin = page == startPage ? static_cast<u32>(startAddr & (cPageSize - 1)) : 0;
+        u32 finish = page == endPage ? static_cast<u32>(((endAddr - 1) & (cPageSize - 1)) + 1) : static_cast<u32>(cPageSize);
+
+        assignPage_(entry, begin, finish, id);
+    }
+}
+
+void HeapAddressIndex::release(Heap* heap)
+{
+    for (s32 i = 1; i < mHeapIdEnd; i++)
+    {
+        if (mHeaps[i].getValue() == heap)
+        {
+            mHeaps[i].setValue(nullptr);
+
+            if (i == mHeapIdEnd - 1)
+            {
+                while (mHeapIdEnd > 1 && !mHeaps[mHeapIdEnd - 1].getValue())
+                    mHeapIdEnd--;
+            }
+
+            return;
+        }
+    }
+}
+
+u16 HeapAddressIndex::registerHeap(Heap* heap)
+{
+    u16 id = getId_(heap);
+    return id != cComplexId ? id : 0;
+}
+
+void HeapAddressIndex::clear()
+{
+    for (s32 i = 0; i < (1 << cRootBits); i++)
+    {
+        Node* node = mRoot[i].swap(nullptr);
+        if (!node)
+            continue;
+
+        for (s32 j = 0; j < (1 << cNodeBits); j++)
+        {
+            Leaf* leaf = node->leaves[j].getValue();
+            if (leaf)
+            {
+                leaf->~Leaf();
+                std::free(leaf);
+            }
+        }
+
+        node->~Node();
+        std::free(node);
+    }
+
+    for (s32 i = 0; i < mHeapIdEnd; i++)
+        mHeaps[i].setValue(nullptr);
+
+    mHeapIdEnd = 1;
+}
+
+HeapAddressIndex::Entry* HeapAddressIndex::getEntry_(uintptr_t page, bool create)
+{
+    AtomicPtr<Node*>& nodePtr = mRoot[page >> (cLeafBits + cNodeBits)];
+
+    Node* node = nodePtr.getValue();
+    if (!node)
+    {
+        if (!create)
+            return nullptr;
+
+        // The tables live outside of the heaps they describe
+        void* ptr = std::malloc(sizeof(Node));
+        SEAD_ASSERT_MSG(ptr, "HeapAddressIndex node malloc failed");
+
+        node = new(ptr) Node();
+        nodePtr.setValue(node);
+    }
+
+    AtomicPtr<Leaf*>& leafPtr = node->leaves[(page >> cLeafBits) & ((1 << cNodeBits) - 1)];
+
+    Leaf* leaf = leafPtr.getValue();
+    if (!leaf)
+    {
+        if (!create)
+            return nullptr;
+
+        void* ptr = std::malloc(sizeof(Leaf));
+        SEAD_ASSERT_MSG(ptr, "HeapAddressIndex leaf malloc failed");
+
+        leaf = new(ptr) Leaf();
+        leafPtr.setValue(leaf);
+    }
+
+    return &leaf->entries[page & ((1 << cLeafBits) - 1)];
+}
+
+void HeapAddressIndex::assignPage_(Entry* entry, u32 begin, u32 end, u16 id)
+{
+    u64 layout = entry->layout.getValue();
+    u64 ids = entry->ids.getValue();
+
+    u32 num = GetSegmentNum(layout);
+
+    u32 splits[cSegmentMax];
+    u16 owners[cSegmentMax];
+    s32 newNum = 0;
+
+    if (id == cComplexId)
+    {
+        newNum = cComplexNum;
+    }
+    else if (begin == 0 && end == cPageSize)
+    {
+        owners[0] = id;
+        newNum = id != 0 ? 1 : 0;
+    }
+    else if (num == cComplexNum)
+    {
+        // What the rest of the page belongs to is unknown
+        newNum = cComplexNum;
+    }
+    else
+    {
+        // Sample the new step function at every old and new boundary
+        u32 points[cSegmentMax + 2];
+        s32 pointNum = 0;
+
+        points[pointNum++] = 0;
+        for (s32 i = 0; i < static_cast<s32>(num) - 1; i++)
+            points[pointNum++] = GetSplit(layout, i);
+
+        points[pointNum++] = begin;
+        if (end < cPageSize)
+            points[pointNum++] = end;
+
+        // Insertion sort, there are at most six points
+        for (s32 i = 1; i < pointNum; i++)
+        {
+            u32 p = points[i];
+            s32 j = i - 1;
+            while (j >= 0 && points[j] > p)
+            {
+                points[j + 1] = points[j];
+                j--;
+            }
+
+            points[j + 1] = p;
+        }
+
+        for (s32 i = 0; i < pointNum; i++)
+        {
+            u32 p = points[i];
+
+            u16 owner;
+            if (begin <= p && p < end)
+            {
+                owner = id;
+            }
+            else if (num == 0)
+            {
+                owner = 0;
+            }
+            else
+            {
+                s32 segment = 0;
+                while (segment < static_cast<s32>(num) - 1 && p >= GetSplit(layout, segment))
+                    segment++;
+
+                owner = GetId(ids, segment);
+            }
+
+            if (newNum > 0 && owners[newNum - 1] == owner)
+                continue;
+
+            if (newNum == cSegmentMax)
+            {
+                newNum = cComplexNum;
+                break;
+            }
+
+            splits[newNum] = p;
+            owners[newNum] = owner;
+            newNum++;
+        }
+
+        if (newNum == 1 && owners[0] == 0)
+            newNum = 0;
+    }
+
+    u64 newLayout = static_cast<u64>(newNum) << 16;
+    u64 newIds = 0;
+
+    if (newNum != static_cast<s32>(cComplexNum))
+    {
+        for (s32 i = 0; i < newNum; i++)
+        {
+            newIds |= static_cast<u64>(owners[i]) << (i * 16);
+            if (i > 0)
+                newLayout |= static_cast<u64>(splits[i]) << (20 + (i - 1) * cSplitBits);
+        }
+    }
+
+    u32 seq = GetSequence(layout);
+
+    entry->layout.setValue((layout & ~cSequenceMask) | ((seq + 1) & cSequenceMask));
+    entry->ids.setValue(newIds);
+    entry->layout.setValue(newLayout | ((seq + 2) & cSequenceMask));
+}
+
+u16 HeapAddressIndex::getId_(Heap* heap)
+{
+    s32 freeId = 0;
+
+    for (s32 i = 1; i < mHeapIdEnd; i++)
+    {
+        Heap* registered = mHeaps[i].getValue();
+        if (registered == heap)
+            return static_cast<u16>(i);
+
+        if (!registered && freeId == 0)
+            freeId = i;
+    }
+
+    if (freeId == 0)
+    {
+        if (mHeapIdEnd == cHeapNumMax)
+        {
+            // The pages of this heap fall back to the heap tree
+            SEAD_WARNING("HeapAddressIndex is full");
+            return cComplexId;
+        }
+
+        freeId = mHeapIdEnd++;
+    }
+
+    mHeaps[freeId].setValue(heap);
+    return static_cast<u16>(freeId);
+}
+
+} // namespace sead
@@ -28,6 +28,7 @@ CriticalSection HeapMgr::sHeapTreeLockCS;
 
 HeapMgr::RootHeaps HeapMgr::sRootHeaps;
 HeapMgr::IndependentHeaps HeapMgr::sIndependentHeaps;
+HeapAddressIndex HeapMgr::sAddressIndex;
 
 #if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
 Heap* HeapMgr::sUnboundHeap = nullptr;
@@ -105,6 +106,8 @@ void HeapMgr::destroy()
 
     sInstancePtr = nullptr;
 
+    sAddressIndex.clear();
+
     sArena->destroy();
     sArena = nullptr;
 }
@@ -166,6 +169,26 @@ void HeapMgr::genMessage(hostio::Context* context)
 
 Heap* HeapMgr::findContainHeap(const void* memBlock) const
 {
+    Heap* indexedHeap = nullptr;
+    if (sAddressIndex.find(&indexedHeap, memBlock))
+    {
+        if (indexedHeap)
+            return indexedHeap;
+
+#if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
+        // The blocks of the unbound heap are scattered and not indexed
+        if (sUnboundHeap && static_cast<UnboundHeap*>(sUnboundHeap)->isIncludeMemBlock_(memBlock))
+            return sUnboundHeap;
+#endif // SEAD_PLATFORM_WINDOWS
+
+        return nullptr;
+    }
+
+    // Pages with too many heap boundaries are resolved through the block header, then through the heap tree
+    Heap* taggedHeap = findHeapFromMemBlockTag_(memBlock, false);
+    if (taggedHeap)
+        return taggedHeap;
+
     FindContainHeapCache* heapCache = nullptr;
 
     ThreadMgr* threadMgr = ThreadMgr::instance();
@@ -192,6 +215,10 @@ Heap* HeapMgr::findContainHeap(const void* memBlock) const
 
     ScopedLock<CriticalSection> lock(&sHeapTreeLockCS);
 
+    taggedHeap = findHeapFromMemBlockTag_(memBlock, true);
+    if (taggedHeap)
+        return taggedHeap;
+
     if (heapCache)
     {
 #if defined(SEAD_TARGET_DEBUG)
@@ -328,6 +355,10 @@ void HeapMgr::removeRootHeap(Heap* heap)
 
 bool HeapMgr::isContainedInAnyHeap(const void* addr)
 {
+    Heap* indexedHeap = nullptr;
+    if (sAddressIndex.find(&indexedHeap, addr))
+        return indexedHeap != nullptr;
+
     // TODO: Sead does not lock sHeapTreeLockCS here, should we ?
 
     for (Heap& heap : sRootHeaps)
@@ -349,6 +380,41 @@ void HeapMgr::dumpTreeYAML(WriteStream& stream)
 {
     ScopedLock<CriticalSection> lock(&sHeapTreeLockCS);
 
+    if (sArena)
+    {
+        const char* pageType;
+
+        if (sArena->getPageType() == Arena::PageType::eHuge)
+            pageType = "Huge";
+        else if (sArena->getPageType() == Arena::PageType::eTransparentHuge)
+            pageType = "Transparent Huge";
+        else
+            pageType = "Normal";
+
+        FixedSafeString<128> buf;
+
+        buf.format("- arena:\n");
+        stream.writeDecorationText(buf);
+
+        buf.format("    start_address: 0x%p\n", sArena->getStartAddr());
+        stream.writeDecorationText(buf);
+
+        buf.format("    size: %zu\n", sArena->getSize());
+        stream.writeDecorationText(buf);
+
+        buf.format("    reserved_size: %zu\n", sArena->getReservedSize());
+        stream.writeDecorationText(buf);
+
+        buf.format("    resident_size: %zu\n", sArena->getResidentSize());
+        stream.writeDecorationText(buf);
+
+        buf.format("    page_type: %s\n", pageType);
+        stream.writeDecorationText(buf);
+
+        buf.format("    numa_node: %d\n", sArena->getNumaNode());
+        stream.writeDecorationText(buf);
+    }
+
     for (Heap& heap : sRootHeaps)
     {
         heap.dumpTreeYAML(stream, 0);
@@ -459,6 +525,79 @@ void HeapMgr::removeFromFindContainHeapCache_(Heap* heap)
     }
 }
 
+void HeapMgr::addToAddressIndex_(Heap* heap)
+{
+    ScopedLock<CriticalSection> lock(&sHeapTreeLockCS);
+
+    heap->mHeapId = sAddressIndex.registerHeap(heap);
+    sAddressIndex.assign(heap->getAreaStart_(), heap->getAreaEnd_(), heap);
+}
+
+void HeapMgr::removeFromAddressIndex_(Heap* heap)
+{
+    ScopedLock<CriticalSection> lock(&sHeapTreeLockCS);
+
+    // The area goes back to the parent, whose allocated block it still is
+    Heap* owner = heap->getParent();
+#if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
+    if (owner == sUnboundHeap)
+        owner = nullptr;
+#endif // SEAD_PLATFORM_WINDOWS
+
+    sAddressIndex.assign(heap->getAreaStart_(), heap->getAreaEnd_(), owner);
+    sAddressIndex.release(heap);
+    heap->mHeapId = 0;
+}
+
+void HeapMgr::updateAddressIndex_(Heap* heap, const void* prevAreaStart, const void* prevAreaEnd)
+{
+    ScopedLock<CriticalSection> lock(&sHeapTreeLockCS);
+
+    Heap* owner = heap->getParent();
+#if defined(SEAD_PLATFORM_WINDOWS) || defined(SEAD_PLATFORM_POSIX)
+    if (owner == sUnboundHeap)
+        owner = nullptr;
+#endif // SEAD_PLATFORM_WINDOWS
+
+    const void* areaStart = heap->getAreaStart_();
+    const void* areaEnd = heap->getAreaEnd_();
+
+    // Adjusting only ever shrinks the area
+    if (prevAreaStart < areaStart)
+        sAddressIndex.assign(prevAreaStart, areaStart, owner);
+
+    if (areaEnd < prevAreaEnd)
+        sAddressIndex.assign(areaEnd, prevAreaEnd, owner);
+}
+
+Heap* HeapMgr::findHeapFromMemBlockTag_(const void* ptr, bool isTreeLocked)
+{
+    const MemBlock* block = MemBlock::TryFindManageArea(ptr);
+    if (!block || block->memory() != ptr)
+        return nullptr;
+
+    Heap* heap = sAddressIndex.getHeap(block->mHeapId);
+    if (!heap || heap->mHeapCheckTag != block->mHeapCheckTag || !heap->isInclude(ptr))
+        return nullptr;
+
+    // A heap without children is the innermost one containing ptr. This holds without the heap tree lock, the same as
+    // for the FindContainHeapCache, since a heap's children can only come and go while it is in use.
+    if (heap->hasNoChild_())
+        return heap;
+
+    if (!isTreeLocked)
+        return nullptr;
+
+    // The header may be a stale one in memory now handed out by a child heap
+    for (Heap& child : heap->mChildren)
+    {
+        if (child.isInclude(ptr))
+            return nullptr;
+    }
+
+    return heap;
+}
+
 #if defined(SEAD_TARGET_DEBUG)
 void HeapMgr::dumpFindContainHeapCacheStatistics()
 {
@@ -517,6 +656,10 @@ void HeapMgr::createUnboundHeap()
     SEAD_ASSERT(!sUnboundHeap);
 
     sUnboundHeap = UnboundHeap::create("UnboundHeap");
+
+    // Its blocks are scattered, so it only gets an id for the tag of its blocks
+    ScopedLock<CriticalSection> lock(&sHeapTreeLockCS);
+    sUnboundHeap->mHeapId = sAddressIndex.registerHeap(sUnboundHeap);
 }
 #endif // SEAD_PLATFORM_WINDOWS
 
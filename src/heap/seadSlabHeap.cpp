@@ -0,0 +1,817 @@
+#include <heap/seadSlabHeap.h>
+
+#include <basis/seadWarning.h>
+#include <heap/seadHeapMgr.h>
+#include <math/seadMathCalcCommon.h>
+#include <prim/seadFormatPrint.h>
+#include <prim/seadScopedLock.h>
+#include <stream/seadStream.h>
+
+#include <bit>
+
+namespace sead {
+
+namespace {
+
+const u32 cDefaultElemSizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+
+u64 MakeHead(u64 prevHead, u32 index)
+{
+    return ((prevHead >> 32) + 1) << 32 | index;
+}
+
+} // namespace
+
+SlabHeap* SlabHeap::create(size_t size, const SafeString& name, Heap* parent, const u32* elemSizes, s32 sizeClassNum, size_t slabSize,
+                           bool enableLock)
+{
+    SlabHeap* heap = SlabHeap::tryCreate(size, name, parent, elemSizes, sizeClassNum, slabSize, enableLock);
+    SEAD_ASSERT_MSG(heap, "heap create failed. [%s] size: %zu, parent: %s(0x%p), parent allocatable size: %zu",
+                    name.cstr(), size, parent ? parent->getName().cstr() : "null", parent,
+                    parent ? parent->getMaxAllocatableSize(cSlabAlignment) : 0);
+    return heap;
+}
+
+SlabHeap* SlabHeap::tryCreate(size_t size_, const SafeString& name, Heap* parent, const u32* elemSizes, s32 sizeClassNum, size_t slabSize,
+                              bool enableLock)
+{
+    if (!elemSizes)
+    {
+        elemSizes = cDefaultElemSizes;
+        sizeClassNum = sizeof(cDefaultElemSizes) / sizeof(cDefaultElemSizes[0]);
+    }
+
+    if (sizeClassNum <= 0 || sizeClassNum > cSizeClassNumMax)
+    {
+        SEAD_ASSERT_MSG(false, "bad size class num %d", sizeClassNum);
+        return nullptr;
+    }
+
+    if ((slabSize & (slabSize - 1)) != 0 || slabSize < static_cast<size_t>(cSlabAlignment))
+    {
+        SEAD_ASSERT_MSG(false, "slab size must be a power of 2 not smaller than %d: %zu", cSlabAlignment, slabSize);
+        return nullptr;
+    }
+
+    for (s32 i = 0; i < sizeClassNum; i++)
+    {
+        if (elemSizes[i] == 0 || elemSizes[i] % (1 << cIndexShift) != 0 || elemSizes[i] > slabSize ||
+            (i > 0 && elemSizes[i] <= elemSizes[i - 1]))
+        {
+            SEAD_ASSERT_MSG(false, "bad element size %u", elemSizes[i]);
+            return nullptr;
+        }
+    }
+
+    if (!parent)
+    {
+        parent = HeapMgr::instance()->getCurrentHeap();
+        if (!parent)
+        {
+            SEAD_ASSERT_MSG(false, "current heap is null");
+            return nullptr;
+        }
+    }
+
+    size_t size;
+    if (size_ == 0)
+    {
+        size = parent->getMaxAllocatableSize(cSlabAlignment);
+        size = MathSizeT::roundDownPow2(size, cMinAlignment);
+    }
+    else
+    {
+        size = MathSizeT::roundUpPow2(size_, cMinAlignment);
+    }
+
+    if (size < getManagementAreaSize(1) + slabSize)
+    {
+        SEAD_ASSERT_MSG(size_ == 0, "size must be able to include manage area and a slab: size=%zu", size);
+        return nullptr;
+    }
+
+    if ((size >> cIndexShift) >= cNullIndex)
+    {
+        SEAD_ASSERT_MSG(false, "size is too large: size=%zu", size);
+        return nullptr;
+    }
+
+    void* heapStart;
+
+    {
+#if defined(SEAD_TARGET_DEBUG)
+        ScopedDebugFillSystemDisabler disabler(parent);
+#endif // SEAD_TARGET_DEBUG
+        heapStart = parent->tryAlloc(size, cSlabAlignment);
+    }
+
+    if (!heapStart)
+        return nullptr;
+
+    SlabHeap* result = new(heapStart) SlabHeap(name, parent, heapStart, size, slabSize, enableLock);
+    result->initialize_(elemSizes, sizeClassNum);
+
+    parent->pushBackChild_(result);
+
+    HeapMgr::addToAddressIndex_(result);
+
+#if defined(SEAD_TARGET_DEBUG)
+    {
+        HeapMgr* mgr = HeapMgr::instance();
+        if (mgr)
+            mgr->callCreateCallback_(result);
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    return result;
+}
+
+size_t SlabHeap::getManagementAreaSize(s32 slabNum)
+{
+    return sizeof(SlabHeap) + slabNum + cSlabAlignment;
+}
+
+SlabHeap::SlabHeap(const SafeString& name, Heap* parent, void* start, size_t size, size_t slabSize, bool enableLock)
+    : Heap(name, parent, start, size, HeapDirection::eForward, enableLock)
+    , mSizeClassNum(0)
+    , mSlabSize(slabSize)
+    , mSlabShift(std::countr_zero(slabSize))
+    , mSlabStart(nullptr)
+    , mSlabNum(0)
+    , mSlabUsedNum(0)
+    , mSlabSizeClasses(nullptr)
+{
+}
+
+SlabHeap::~SlabHeap()
+{
+    destruct_();
+}
+
+void SlabHeap::destroy()
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+
+    HeapMgr* mgr = HeapMgr::instance();
+    if (mgr)
+        mgr->callDestroyCallback_(this);
+#endif // SEAD_TARGET_DEBUG
+
+    Heap* parent = mParent;
+    void* start = mStart;
+
+#if defined(SEAD_TARGET_DEBUG)
+    size_t size = mSize;
+    bool isEnableFill = isEnableDebugFillHeapDestroy_();
+#endif // SEAD_TARGET_DEBUG
+
+    this->~SlabHeap();
+
+#if defined(SEAD_TARGET_DEBUG)
+    if (isEnableFill)
+    {
+        u8 fillValue = HeapMgr::cDefaultDebugFillHeapDestroy;
+        if (HeapMgr::instance())
+            fillValue = HeapMgr::instance()->getDebugFillHeapDestroy();
+
+        MemUtil::fill(start, fillValue, size);
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    if (parent && parent->isFreeable())
+    {
+#if defined(SEAD_TARGET_DEBUG)
+        ScopedDebugFillSystemDisabler disabler(parent);
+#endif // SEAD_TARGET_DEBUG
+        parent->free(start);
+    }
+}
+
+size_t SlabHeap::adjust()
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    if (!mParent)
+        return mSize;
+
+    size_t ret = mSize;
+
+    void* prevAreaStart = nullptr;
+    void* prevAreaEnd = nullptr;
+
+    {
+        ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+        ScopedLock<Heap> parentLock(mParent);
+
+        prevAreaStart = getAreaStart_();
+        prevAreaEnd = getAreaEnd_();
+
+        s32 slabUsedNum = getSlabUsedNum();
+
+        size_t newSize = PtrUtil::diff(PtrUtil::addOffset(mSlabStart, slabUsedNum * mSlabSize), mStart);
+        if (newSize < mSize)
+        {
+            if (mParent->resizeBack(mStart, newSize))
+            {
+                mSlabNum = slabUsedNum;
+                mSize = newSize;
+                ret = newSize;
+            }
+            else
+            {
+                SEAD_ASSERT_MSG(false, "Resize failed.(Parent heap is not support resize.)");
+            }
+        }
+    }
+
+    HeapMgr::updateAddressIndex_(this, prevAreaStart, prevAreaEnd);
+
+    return ret;
+}
+
+void* SlabHeap::tryAlloc(size_t size, s32 alignment)
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    HeapMgr* mgr = HeapMgr::instance();
+
+#if defined(SEAD_TARGET_DEBUG)
+    HeapMgr::AllocCallbackArg allocCallbackArg;
+
+    HeapMgr::IAllocCallback* allocCallback = nullptr;
+    if (mgr)
+        allocCallback = mgr->getAllocCallback();
+
+    if (allocCallback)
+    {
+        allocCallbackArg.heap = this;
+        allocCallbackArg.request_size = size;
+        allocCallbackArg.request_alignment = alignment;
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    if (size < cMinAllocSize)
+        size = cMinAllocSize;
+
+    if (alignment < 0)
+        alignment = -alignment;
+
+    s32 index = findSizeClass(size, alignment);
+    if (index < 0)
+    {
+        HeapMgr::IAllocFailedCallback* allocFailedCallback = nullptr;
+        if (mgr)
+            allocFailedCallback = mgr->getAllocFailedCallback();
+
+        if (allocFailedCallback)
+        {
+            HeapMgr::AllocFailedCallbackArg allocFailedCallbackArg;
+            allocFailedCallbackArg.heap = this;
+            allocFailedCallbackArg.request_size = size;
+            allocFailedCallbackArg.request_alignment = alignment;
+            allocFailedCallbackArg.alloc_size = size;
+            allocFailedCallbackArg.alloc_alignment = alignment;
+
+            allocFailedCallback->invoke(&allocFailedCallbackArg);
+        }
+
+        if (!Mathi::isPow2(alignment))
+            SEAD_ASSERT_MSG(false, "bad alignment %d", alignment);
+
+        return nullptr;
+    }
+
+    SizeClass* sizeClass = &mSizeClasses[index];
+
+    void* ptr = popElem_(sizeClass);
+    while (!ptr)
+    {
+        if (!refill_(index))
+        {
+            HeapMgr::IAllocFailedCallback* allocFailedCallback = nullptr;
+            if (mgr)
+                allocFailedCallback = mgr->getAllocFailedCallback();
+
+            if (allocFailedCallback)
+            {
+                HeapMgr::AllocFailedCallbackArg allocFailedCallbackArg;
+                allocFailedCallbackArg.heap = this;
+                allocFailedCallbackArg.request_size = size;
+                allocFailedCallbackArg.request_alignment = alignment;
+                allocFailedCallbackArg.alloc_size = sizeClass->elemSize;
+                allocFailedCallbackArg.alloc_alignment = alignment;
+
+                allocFailedCallback->invoke(&allocFailedCallbackArg);
+            }
+
+            return nullptr;
+        }
+
+        ptr = popElem_(sizeClass);
+    }
+
+    // The peak is only a statistic, a lost race under-reports it slightly
+    u32 usedNum = sizeClass->usedNum.increment() + 1;
+    if (usedNum > sizeClass->peakNum.getValue())
+        sizeClass->peakNum.setValue(usedNum);
+
+#if defined(SEAD_TARGET_DEBUG)
+    if (isEnableDebugFillAlloc_())
+    {
+        if (mgr)
+            MemUtil::fill(ptr, mgr->getDebugFillAlloc(), sizeClass->elemSize);
+        else
+            MemUtil::fill(ptr, HeapMgr::cDefaultDebugFillAlloc, sizeClass->elemSize);
+    }
+
+    if (allocCallback)
+    {
+        allocCallbackArg.alloc_size = sizeClass->elemSize;
+        allocCallbackArg.alloc_alignment = alignment;
+        allocCallbackArg.ptr = ptr;
+
+        allocCallback->invoke(&allocCallbackArg);
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    return ptr;
+}
+
+void SlabHeap::free(void* ptr)
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    if (!ptr)
+        return;
+
+    HeapMgr* mgr = HeapMgr::instance();
+#if defined(SEAD_TARGET_DEBUG)
+    if (mgr)
+    {
+        HeapMgr::FreeCallbackArg arg;
+        arg.heap = this;
+        arg.ptr = ptr;
+
+        mgr->callFreeCallback_(arg);
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    if (!isInclude(ptr))
+    {
+        SEAD_ASSERT_MSG(false, "free error. This heap(%s) is not including 0x%p.", getName().cstr(), ptr);
+        return;
+    }
+
+    if (mFlag.isOnBit(Flag::eDisposing))
+        return;
+
+    s32 slab = getSlabIndex_(ptr);
+    u8 index = slab < getSlabUsedNum() ? mSlabSizeClasses[slab] : cNullSizeClass;
+    if (index == cNullSizeClass)
+    {
+        SEAD_ASSERT_MSG(false, "Name:(%s) Invalid pointer: 0x%p, slab %d is not used", getName().cstr(), ptr, slab);
+        return;
+    }
+
+    SizeClass* sizeClass = &mSizeClasses[index];
+
+    if (PtrUtil::diff(ptr, PtrUtil::addOffset(mSlabStart, slab * mSlabSize)) % sizeClass->elemSize != 0)
+    {
+        SEAD_ASSERT_MSG(false, "Name:(%s) Invalid pointer: 0x%p, not an element of size %u", getName().cstr(), ptr,
+                        sizeClass->elemSize);
+        return;
+    }
+
+#if defined(SEAD_TARGET_DEBUG)
+    if (isEnableDebugFillFree_())
+    {
+        if (mgr)
+            MemUtil::fill(ptr, mgr->getDebugFillFree(), sizeClass->elemSize);
+        else
+            MemUtil::fill(ptr, HeapMgr::cDefaultDebugFillFree, sizeClass->elemSize);
+    }
+#else
+    SEAD_UNUSED(mgr);
+#endif // SEAD_TARGET_DEBUG
+
+    sizeClass->usedNum.decrement();
+    pushElems_(sizeClass, getElemIndex_(ptr), static_cast<u32*>(ptr));
+}
+
+void* SlabHeap::resizeFront(void* ptr, size_t)
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+
+    if (isEnableWarning())
+        SEAD_WARNING("Cannot resizeFront from SlabHeap [%s] 0x%p\n", getName().cstr(), ptr);
+#else
+    SEAD_UNUSED(ptr);
+#endif // SEAD_TARGET_DEBUG
+
+    return nullptr;
+}
+
+void* SlabHeap::resizeBack(void* ptr, size_t newSize)
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    if (!isInclude(ptr))
+    {
+        SEAD_ASSERT_MSG(false, "resize error. This heap(%s) is not including 0x%p.", getName().cstr(), ptr);
+        return nullptr;
+    }
+
+    // Elements never move, shrinking or growing within the element always succeeds
+    s32 slab = getSlabIndex_(ptr);
+    if (slab < getSlabUsedNum() && mSlabSizeClasses[slab] != cNullSizeClass &&
+        newSize <= mSizeClasses[mSlabSizeClasses[slab]].elemSize)
+        return ptr;
+
+    return nullptr;
+}
+
+void SlabHeap::freeAll()
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+#endif // SEAD_TARGET_DEBUG
+
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    dispose_(nullptr, nullptr);
+
+#if defined(SEAD_TARGET_DEBUG)
+    if (isEnableDebugFillFree_())
+    {
+        HeapMgr* mgr = HeapMgr::instance();
+        u8 fillValue = mgr ? mgr->getDebugFillFree() : HeapMgr::cDefaultDebugFillFree;
+
+        MemUtil::fill(mSlabStart, fillValue, getSlabUsedNum() * mSlabSize);
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    for (s32 i = 0; i < mSizeClassNum; i++)
+    {
+        SizeClass& sizeClass = mSizeClasses[i];
+        sizeClass.head.setValue(MakeHead(sizeClass.head.getValue(), cNullIndex));
+        sizeClass.usedNum.setValue(0);
+        sizeClass.slabNum = 0;
+    }
+
+    MemUtil::fill(mSlabSizeClasses, cNullSizeClass, mSlabNum);
+    mSlabUsedNum.setValue(0);
+}
+
+const void* SlabHeap::getStartAddress() const
+{
+    return mStart;
+}
+
+const void* SlabHeap::getEndAddress() const
+{
+    return PtrUtil::addOffset(mStart, mSize);
+}
+
+size_t SlabHeap::getSize() const
+{
+    return mSize;
+}
+
+size_t SlabHeap::getFreeSize() const
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    size_t freeSize = (mSlabNum - getSlabUsedNum()) * mSlabSize;
+
+    for (s32 i = 0; i < mSizeClassNum; i++)
+    {
+        const SizeClass& sizeClass = mSizeClasses[i];
+
+        u32 elemNum = sizeClass.slabNum * sizeClass.elemNumPerSlab;
+        u32 usedNum = sizeClass.usedNum.getValue();
+        if (usedNum < elemNum)
+            freeSize += (elemNum - usedNum) * static_cast<size_t>(sizeClass.elemSize);
+    }
+
+    return freeSize;
+}
+
+size_t SlabHeap::getMaxAllocatableSize(s32 alignment) const
+{
+    if (alignment < 0)
+        alignment = -alignment;
+
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    bool hasFreeSlab = getSlabUsedNum() < mSlabNum;
+
+    for (s32 i = mSizeClassNum - 1; i >= 0; i--)
+    {
+        const SizeClass& sizeClass = mSizeClasses[i];
+
+        if (findSizeClass(sizeClass.elemSize, alignment) != i)
+            continue;
+
+        if (hasFreeSlab || sizeClass.usedNum.getValue() < sizeClass.slabNum * sizeClass.elemNumPerSlab)
+            return sizeClass.elemSize;
+    }
+
+    return 0;
+}
+
+bool SlabHeap::isInclude(const void* ptr) const
+{
+    return getAreaStart_() <= ptr && ptr < getAreaEnd_();
+}
+
+bool SlabHeap::isEmpty() const
+{
+    for (s32 i = 0; i < mSizeClassNum; i++)
+    {
+        if (mSizeClasses[i].usedNum.getValue() != 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool SlabHeap::isFreeable() const
+{
+    return true;
+}
+
+bool SlabHeap::isResizable() const
+{
+    return false;
+}
+
+bool SlabHeap::isAdjustable() const
+{
+    return true;
+}
+
+void SlabHeap::dump() const
+{
+#if defined(SEAD_TARGET_DEBUG)
+    if (mAccessThread)
+        checkAccessThread_();
+
+    {
+        BufferingPrintFormatter formatter;
+
+        formatter << "%@", *this;
+        formatter.flush();
+    }
+#endif // SEAD_TARGET_DEBUG
+
+    for (s32 i = 0; i < mSizeClassNum; i++)
+    {
+        const SizeClass& sizeClass = mSizeClasses[i];
+        SEAD_PRINT("[%2d] size: %5u, slabs: %4d, used: %7u, peak: %7u\n", i, sizeClass.elemSize, sizeClass.slabNum,
+                   sizeClass.usedNum.getValue(), sizeClass.peakNum.getValue());
+    }
+}
+
+void SlabHeap::dumpYAML(WriteStream& stream, s32 indent) const
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    Heap::dumpYAML(stream, indent);
+
+    FixedSafeString<128> buf("");
+    buf.append(' ', indent);
+    buf.appendWithFormat("  heap_type: SlabHeap\n");
+    stream.writeDecorationText(buf);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("  slab_size: %zu\n", mSlabSize);
+    stream.writeDecorationText(buf);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("  slab_num: %d\n", mSlabNum);
+    stream.writeDecorationText(buf);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("  slab_used_num: %d\n", getSlabUsedNum());
+    stream.writeDecorationText(buf);
+
+    buf.clear();
+    buf.append(' ', indent);
+    buf.appendWithFormat("  size_classes:\n");
+    stream.writeDecorationText(buf);
+
+    for (s32 i = 0; i < mSizeClassNum; i++)
+    {
+        const SizeClass& sizeClass = mSizeClasses[i];
+
+        buf.clear();
+        buf.append(' ', indent);
+        buf.appendWithFormat("    - { elem_size: %u, slab_num: %d, used_num: %u, peak_num: %u }\n", sizeClass.elemSize,
+                             sizeClass.slabNum, sizeClass.usedNum.getValue(), sizeClass.peakNum.getValue());
+        stream.writeDecorationText(buf);
+    }
+}
+
+s32 SlabHeap::findSizeClass(size_t size, s32 alignment) const
+{
+    if (alignment < 0)
+        alignment = -alignment;
+
+    if (!Mathi::isPow2(alignment) || alignment > cSlabAlignment)
+        return -1;
+
+    for (s32 i = 0; i < mSizeClassNum; i++)
+    {
+        u32 elemSize = mSizeClasses[i].elemSize;
+
+        // Slabs are aligned to cSlabAlignment, so elements are aligned to the lowest bit of their size
+        if (elemSize >= size && (elemSize & (alignment - 1)) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+size_t SlabHeap::getElemSize(s32 sizeClass) const
+{
+    SEAD_ASSERT(0 <= sizeClass && sizeClass < mSizeClassNum);
+    return mSizeClasses[sizeClass].elemSize;
+}
+
+s32 SlabHeap::getElemSlabNum(s32 sizeClass) const
+{
+    SEAD_ASSERT(0 <= sizeClass && sizeClass < mSizeClassNum);
+    return mSizeClasses[sizeClass].slabNum;
+}
+
+u32 SlabHeap::getElemUsedNum(s32 sizeClass) const
+{
+    SEAD_ASSERT(0 <= sizeClass && sizeClass < mSizeClassNum);
+    return mSizeClasses[sizeClass].usedNum.getValue();
+}
+
+u32 SlabHeap::getElemPeakNum(s32 sizeClass) const
+{
+    SEAD_ASSERT(0 <= sizeClass && sizeClass < mSizeClassNum);
+    return mSizeClasses[sizeClass].peakNum.getValue();
+}
+
+void SlabHeap::initialize_(const u32* elemSizes, s32 sizeClassNum)
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    mSizeClassNum = sizeClassNum;
+
+    for (s32 i = 0; i < sizeClassNum; i++)
+    {
+        SizeClass& sizeClass = mSizeClasses[i];
+        sizeClass.head.setValue(cNullIndex);
+        sizeClass.usedNum.setValue(0);
+        sizeClass.peakNum.setValue(0);
+        sizeClass.elemSize = elemSizes[i];
+        sizeClass.elemNumPerSlab = static_cast<u32>(mSlabSize / elemSizes[i]);
+        sizeClass.slabNum = 0;
+    }
+
+    // One size class byte per slab follows the heap, then the slabs
+    u8* tableStart = static_cast<u8*>(PtrUtil::addOffset(mStart, sizeof(SlabHeap)));
+    size_t areaSize = mSize - sizeof(SlabHeap) - cSlabAlignment;
+
+    mSlabNum = static_cast<s32>(areaSize / (mSlabSize + 1));
+    mSlabSizeClasses = tableStart;
+    mSlabStart = PtrUtil::roundUpPow2(tableStart + mSlabNum, cSlabAlignment);
+
+    SEAD_ASSERT(PtrUtil::addOffset(mSlabStart, mSlabNum * mSlabSize) <= getEndAddress());
+
+    MemUtil::fill(mSlabSizeClasses, cNullSizeClass, mSlabNum);
+    mSlabUsedNum.setValue(0);
+
+#if defined(SEAD_TARGET_DEBUG)
+    HeapMgr* mgr = HeapMgr::instance();
+    if (mgr && mgr->isEnableDebugFillHeapCreate())
+        MemUtil::fill(mSlabStart, mgr->getDebugFillHeapCreate(), mSlabNum * mSlabSize);
+#endif // SEAD_TARGET_DEBUG
+}
+
+void* SlabHeap::getAreaStart_() const
+{
+    return mSlabStart;
+}
+
+void* SlabHeap::getAreaEnd_() const
+{
+    return PtrUtil::addOffset(mSlabStart, mSlabNum * mSlabSize);
+}
+
+void* SlabHeap::popElem_(SizeClass* sizeClass)
+{
+    u64 head = sizeClass->head.getValue();
+
+    for (;;)
+    {
+        u32 index = static_cast<u32>(head);
+        if (index == cNullIndex)
+            return nullptr;
+
+        // The element may be popped and written by another thread meanwhile, the tag then makes the swap fail
+        void* elem = getElem_(index);
+        u32 next = *static_cast<volatile u32*>(elem);
+
+        if (sizeClass->head.compareAndSwap(head, MakeHead(head, next)))
+            return elem;
+
+        head = sizeClass->head.getValue();
+    }
+}
+
+void SlabHeap::pushElems_(SizeClass* sizeClass, u32 headIndex, u32* tailNext)
+{
+    u64 head = sizeClass->head.getValue();
+
+    for (;;)
+    {
+        *tailNext = static_cast<u32>(head);
+
+        if (sizeClass->head.compareAndSwap(head, MakeHead(head, headIndex)))
+            return;
+
+        head = sizeClass->head.getValue();
+    }
+}
+
+bool SlabHeap::refill_(s32 index)
+{
+    ConditionalScopedLock<CriticalSection> lock(&mCS, isEnableLock());
+
+    SizeClass* sizeClass = &mSizeClasses[index];
+
+    // Another thread may have refilled it while this one was waiting for the lock
+    if (static_cast<u32>(sizeClass->head.getValue()) != cNullIndex)
+        return true;
+
+    s32 slab = getSlabUsedNum();
+    if (slab >= mSlabNum)
+        return false;
+
+    mSlabSizeClasses[slab] = static_cast<u8>(index);
+    sizeClass->slabNum++;
+
+    void* slabStart = PtrUtil::addOffset(mSlabStart, slab * mSlabSize);
+    u32 elemSize = sizeClass->elemSize;
+    u32 elemNum = sizeClass->elemNumPerSlab;
+
+    u32 firstIndex = getElemIndex_(slabStart);
+    u32 indexStride = elemSize >> cIndexShift;
+
+    for (u32 i = 0; i < elemNum - 1; i++)
+        *static_cast<u32*>(PtrUtil::addOffset(slabStart, i * elemSize)) = firstIndex + (i + 1) * indexStride;
+
+    mSlabUsedNum.setValue(slab + 1);
+
+    pushElems_(sizeClass, firstIndex, static_cast<u32*>(PtrUtil::addOffset(slabStart, (elemNum - 1) * elemSize)));
+
+    return true;
+}
+
+template <>
+void PrintFormatter::out<SlabHeap>(const SlabHeap& obj, const char*, PrintOutput* output)
+{
+    ConditionalScopedLock<CriticalSection> lock(&obj.mCS, obj.isEnableLock());
+
+    PrintFormatter::out<Heap>(obj, nullptr, output);
+
+    FixedSafeString<128> buf;
+
+    buf.format("          SlabSize: %zu\n", obj.getSlabSize());
+    PrintFormatter::out(SafeString(buf.cstr()), nullptr, output);
+
+    buf.format("             Slabs: %d / %d\n", obj.getSlabUsedNum(), obj.getSlabNum());
+    PrintFormatter::out(SafeString(buf.cstr()), nullptr, output);
+
+    buf.format("     SizeClass num: %d\n", obj.getSizeClassNum());
+    PrintFormatter::out(SafeString(buf.cstr()), nullptr, output);
+
+    PrintFormatter::out(SafeString("==================================================\n"), nullptr, output);
+}
+
+} // namespace sead
@@ -0,0 +1,241 @@
+#include <heap/seadThreadHeapCache.h>
+
+#include <heap/seadExpHeap.h>
+#include <heap/seadHeapMgr.h>
+#include <prim/seadPtrUtil.h>
+#include <prim/seadScopedLock.h>
+
+namespace sead {
+
+ThreadHeapCache* ThreadHeapCache::create(ExpHeap* heap, s32 threadNumMax, Heap* workHeap)
+{
+    SEAD_ASSERT(heap);
+    SEAD_ASSERT(threadNumMax > 0);
+
+    if (!workHeap)
+        workHeap = HeapMgr::instance()->getCurrentHeap();
+
+    // Magazines are dropped when the heap is cleared, so their bookkeeping must live elsewhere
+    if (workHeap == heap)
+    {
+        SEAD_ASSERT_MSG(false, "ThreadHeapCache can not be allocated from its own heap(%s).", heap->getName().cstr());
+        return nullptr;
+    }
+
+    ThreadCache* threadCaches = new(workHeap) ThreadCache[threadNumMax];
+    ThreadHeapCache* cache = new(workHeap) ThreadHeapCache(heap, threadCaches, threadNumMax);
+
+    {
+        ConditionalScopedLock<CriticalSection> lock(&heap->mCS, heap->isEnableLock());
+
+        SEAD_ASSERT_MSG(!heap->mThreadHeapCache.getValue(), "heap(%s) already has a ThreadHeapCache.", heap->getName().cstr());
+        // Publishes the magazines set up by the constructor to threads reading it without the heap lock
+        heap->mThreadHeapCache.setValueRelease(cache);
+    }
+
+    return cache;
+}
+
+void ThreadHeapCache::destroy()
+{
+    if (mHeap)
+    {
+        ConditionalScopedLock<CriticalSection> lock(&mHeap->mCS, mHeap->isEnableLock());
+
+        for (s32 i = 0; i < mThreadNumMax; i++)
+        {
+            flushThreadCache_(&mThreadCaches[i]);
+        }
+
+        mHeap->mThreadHeapCache.setValueRelease(nullptr);
+        mHeap = nullptr;
+    }
+
+    // The slots must stay valid while the thread local storage is torn down
+    ThreadCache* threadCaches = mThreadCaches;
+    delete this;
+    delete[] threadCaches;
+}
+
+void ThreadHeapCache::flush()
+{
+    ThreadCache* threadCache = reinterpret_cast<ThreadCache*>(mThreadCacheTLS.getValue());
+    if (!threadCache)
+        return;
+
+    mThreadCacheTLS.setValue(0);
+    releaseThreadCache_(threadCache);
+}
+
+ThreadHeapCache::ThreadHeapCache(ExpHeap* heap, ThreadCache* threadCaches, s32 threadNumMax)
+    : mHeap(heap)
+    , mThreadCaches(threadCaches)
+    , mThreadNumMax(threadNumMax)
+    , mCS()
+    , mThreadCacheTLS(&ThreadHeapCache::onThreadExit_)
+{
+    for (s32 i = 0; i < mThreadNumMax; i++)
+    {
+        ThreadCache& threadCache = mThreadCaches[i];
+        for (Magazine& magazine : threadCache.magazines)
+        {
+            magazine.num = 0;
+        }
+
+        threadCache.owner = this;
+        threadCache.isUsed = false;
+    }
+}
+
+ThreadHeapCache::~ThreadHeapCache()
+{
+}
+
+void* ThreadHeapCache::tryAlloc_(size_t size, s32 alignment)
+{
+    if (size > cMaxCacheSize || alignment <= 0 || alignment > cAlignment)
+        return nullptr;
+
+    ThreadCache* threadCache = getThreadCache_();
+    if (!threadCache)
+        return nullptr;
+
+    s32 index = calcSizeClass_(size);
+    Magazine* magazine = &threadCache->magazines[index];
+
+    if (magazine->list.isEmpty())
+        refill_(magazine, index);
+
+    void* ptr = magazine->list.get();
+    if (ptr)
+        magazine->num--;
+
+    return ptr;
+}
+
+bool ThreadHeapCache::tryFree_(void* ptr, size_t size)
+{
+    // Any block of exactly a class size is interchangeable, whether it came from a magazine or not
+    if (size > cMaxCacheSize || size % cSizeClassUnit != 0 || !PtrUtil::isAlignedPow2(ptr, cAlignment))
+        return false;
+
+    ThreadCache* threadCache = getThreadCache_();
+    if (!threadCache)
+        return false;
+
+    Magazine* magazine = &threadCache->magazines[calcSizeClass_(size)];
+    magazine->list.put(ptr);
+    magazine->num++;
+
+    if (magazine->num >= cMagazineNumMax)
+    {
+        ConditionalScopedLock<CriticalSection> lock(&mHeap->mCS, mHeap->isEnableLock());
+        flush_(magazine, cMagazineNumMax - cRefillNum);
+    }
+
+    return true;
+}
+
+ThreadHeapCache::ThreadCache* ThreadHeapCache::getThreadCache_()
+{
+    ThreadCache* threadCache = reinterpret_cast<ThreadCache*>(mThreadCacheTLS.getValue());
+    if (threadCache)
+        return threadCache;
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    for (s32 i = 0; i < mThreadNumMax; i++)
+    {
+        if (!mThreadCaches[i].isUsed)
+        {
+            threadCache = &mThreadCaches[i];
+            threadCache->isUsed = true;
+
+            mThreadCacheTLS.setValue(reinterpret_cast<uintptr_t>(threadCache));
+            return threadCache;
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadHeapCache::releaseThreadCache_(ThreadCache* threadCache)
+{
+    if (mHeap)
+    {
+        ConditionalScopedLock<CriticalSection> lock(&mHeap->mCS, mHeap->isEnableLock());
+        flushThreadCache_(threadCache);
+    }
+
+    ScopedLock<CriticalSection> lock(&mCS);
+    threadCache->isUsed = false;
+}
+
+#if defined(SEAD_PLATFORM_WINDOWS)
+void __stdcall ThreadHeapCache::onThreadExit_(void* threadCache)
+#elif defined(SEAD_PLATFORM_POSIX)
+void ThreadHeapCache::onThreadExit_(void* threadCache)
+#endif // SEAD_PLATFORM_WINDOWS
+{
+    ThreadCache* exitedThreadCache = static_cast<ThreadCache*>(threadCache);
+    exitedThreadCache->owner->releaseThreadCache_(exitedThreadCache);
+}
+
+void ThreadHeapCache::refill_(Magazine* magazine, s32 index)
+{
+    size_t size = getSizeClassSize_(index);
+    s32 alignment = cAlignment * static_cast<s32>(mHeap->getDirection());
+
+    ConditionalScopedLock<CriticalSection> lock(&mHeap->mCS, mHeap->isEnableLock());
+
+    for (s32 i = 0; i < cRefillNum; i++)
+    {
+        MemBlock* block = mHeap->allocMemBlock_(size, alignment);
+        if (!block)
+            break;
+
+        magazine->list.put(block->memory());
+        magazine->num++;
+    }
+}
+
+void ThreadHeapCache::flush_(Magazine* magazine, s32 num)
+{
+    for (s32 i = 0; i < num; i++)
+    {
+        void* ptr = magazine->list.get();
+        if (!ptr)
+            break;
+
+        mHeap->freeMemBlock_(MemBlock::FindManageArea(ptr));
+        magazine->num--;
+    }
+}
+
+void ThreadHeapCache::flushThreadCache_(ThreadCache* threadCache)
+{
+    for (Magazine& magazine : threadCache->magazines)
+    {
+        flush_(&magazine, magazine.num);
+    }
+}
+
+void ThreadHeapCache::purge_()
+{
+    for (s32 i = 0; i < mThreadNumMax; i++)
+    {
+        for (Magazine& magazine : mThreadCaches[i].magazines)
+        {
+            magazine.list.cleanup();
+            magazine.num = 0;
+        }
+    }
+}
+
+void ThreadHeapCache::detachHeap_()
+{
+    purge_();
+    mHeap = nullptr;
+}
+
+} // namespace sead
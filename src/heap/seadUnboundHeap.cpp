@@ -142,6 +142,7 @@ void* UnboundHeap::tryAlloc(size_t size, s32 alignment)
     memBlock = new(memBlock) MemBlock();
 
     memBlock->setHeapCheckTag(mHeapCheckTag);
+    memBlock->setHeapId(mHeapId);
     memBlock->setSize(size);
 
     mMemBlockList.pushBack(memBlock);
@@ -324,30 +325,14 @@ bool UnboundHeap::isInclude(const void* ptr) const
             return true;
     }
 
-    // Inline FindManageArea logic so we can do a structural sanity check
-    // before touching any MemBlock field. Reading ptr - cPtrSize is safe:
-    // the caller handed us this address, so the word just before it is
-    // within a valid allocation (or the check below will reject it).
-    //
-    // Layout written by tryAlloc / setOffset:
-    //    [MemBlock][optional padding, last word = this|1][user data]
-    //                                                     ^ ptr
-    // When mOffset == 0: ptr - cPtrSize overlaps the tail of MemBlock (mSize).
-    //    mSize is always pointer-aligned, so bit 0 == 0 → block = ptr - sizeof(MemBlock).
-    // When mOffset > 0:  ptr - cPtrSize holds (MemBlock* this)|1, bit 0 == 1.
-
-    uintptr_t word = *reinterpret_cast<uintptr_t*>(PtrUtil::addOffset(ptr, -static_cast<intptr_t>(cPtrSize)));
-
-    const MemBlock* memBlock;
-    if ((word & 1) == 0)
-        memBlock = reinterpret_cast<const MemBlock*>(PtrUtil::addOffset(ptr, -static_cast<intptr_t>(sizeof(MemBlock))));
-    else
-        memBlock = reinterpret_cast<const MemBlock*>(word - 1);
-
-    // Structural pre-screen: for any legitimately malloc'd block,
-    // the MemBlock header must end at or before ptr. A garbage decoded
-    // address that violates this is an immediate false-negative
-    if (PtrUtil::addOffset(memBlock, sizeof(MemBlock)) > ptr)
+    return isIncludeMemBlock_(ptr);
+}
+
+bool UnboundHeap::isIncludeMemBlock_(const void* ptr) const
+{
+    // Structural sanity check before touching any MemBlock field
+    const MemBlock* memBlock = MemBlock::TryFindManageArea(ptr);
+    if (!memBlock)
         return false;
 
     if (memBlock->mHeapCheckTag != mHeapCheckTag)
@@ -1,14 +1,50 @@
 #include <heap/seadArena.h>
 
 #include <basis/seadAssert.h>
+#include <basis/seadWarning.h>
+#include <basis/win/seadWindows.h>
 
-#include <cstdlib>
+#include <Psapi.h>
 
 namespace sead {
 
+namespace {
+
+// Large pages need SeLockMemoryPrivilege, which has to be held by the user and enabled in the process token
+bool EnableLockMemoryPrivilege()
+{
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+        return false;
+
+    TOKEN_PRIVILEGES privileges = {};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+    bool success = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+                   AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+                   GetLastError() == ERROR_SUCCESS;
+
+    CloseHandle(token);
+    return success;
+}
+
+void* AllocPages(size_t size, DWORD type, s32 numaNode)
+{
+    if (numaNode != Arena::cNumaNodeAny)
+        return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, type, PAGE_READWRITE, static_cast<DWORD>(numaNode));
+
+    return VirtualAlloc(nullptr, size, type, PAGE_READWRITE);
+}
+
+} // namespace
+
 Arena::Arena()
     : mStart(nullptr)
     , mSize(0)
+    , mReservedSize(0)
+    , mPageType(PageType::eNormal)
+    , mNumaNode(cNumaNodeAny)
     , mInitWithStartAddress(false)
 {
 }
@@ -18,11 +54,69 @@ Arena::~Arena()
 }
 
 void Arena::initialize(size_t size)
+{
+    initialize(size, PageType::eNormal, cNumaNodeAny);
+}
+
+void Arena::initialize(size_t size, PageType pageType, s32 numaNode)
 {
     SEAD_ASSERT_MSG(!mStart, "initialize twice");
 
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    size_t pageSize = info.dwPageSize;
+    size_t reservedSize = (size + pageSize - 1) & ~(pageSize - 1);
+
+    if (numaNode != cNumaNodeAny)
+    {
+        ULONG highestNode = 0;
+        if (numaNode < 0 || !GetNumaHighestNodeNumber(&highestNode) || static_cast<ULONG>(numaNode) > highestNode)
+        {
+            SEAD_WARNING("numa node %d does not exist", numaNode);
+            numaNode = cNumaNodeAny;
+        }
+    }
+
+    void* start = nullptr;
+
+    if (pageType == PageType::eHuge)
+    {
+        size_t largePageSize = GetLargePageMinimum();
+        if (largePageSize != 0 && EnableLockMemoryPrivilege())
+        {
+            size_t hugeSize = (size + largePageSize - 1) & ~(largePageSize - 1);
+
+            // Large pages can not be paged out, so they are committed up front
+            start = AllocPages(hugeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, numaNode);
+            if (start)
+                reservedSize = hugeSize;
+        }
+
+        if (!start)
+        {
+            SEAD_WARNING("no large pages for %zu bytes, using normal pages", size);
+            pageType = PageType::eNormal;
+        }
+    }
+    else if (pageType == PageType::eTransparentHuge)
+    {
+        // Windows does not promote normal pages to large ones
+        pageType = PageType::eNormal;
+    }
+
+    if (!start)
+    {
+        // Committed pages only get physical memory when first touched
+        start = AllocPages(reservedSize, MEM_RESERVE | MEM_COMMIT, numaNode);
+        SEAD_ASSERT_MSG(start, "Arena VirtualAlloc failed. size: %zu", reservedSize);
+    }
+
+    mStart = static_cast<u8*>(start);
     mSize = size;
-    mStart = static_cast<u8*>(std::malloc(mSize));
+    mReservedSize = reservedSize;
+    mPageType = pageType;
+    mNumaNode = numaNode;
     mInitWithStartAddress = false;
 }
 
@@ -32,6 +126,9 @@ void Arena::initialize(u8* start, size_t size)
 
     mSize = size;
     mStart = start;
+    mReservedSize = size;
+    mPageType = PageType::eNormal;
+    mNumaNode = cNumaNodeAny;
     mInitWithStartAddress = true;
 }
 
@@ -40,11 +137,58 @@ void Arena::destroy()
     SEAD_ASSERT_MSG(mStart, "not intialized");
 
     if (!mInitWithStartAddress)
-        std::free(mStart);
+        VirtualFree(mStart, 0, MEM_RELEASE);
 
     mStart = nullptr;
     mSize = 0;
+    mReservedSize = 0;
+    mPageType = PageType::eNormal;
+    mNumaNode = cNumaNodeAny;
     mInitWithStartAddress = false;
 }
 
+size_t Arena::getResidentSize() const
+{
+    if (!mStart)
+        return 0;
+
+    // Large pages are locked in memory
+    if (mPageType == PageType::eHuge)
+        return mReservedSize;
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    size_t pageSize = info.dwPageSize;
+
+    u8* begin = static_cast<u8*>(PtrUtil::roundDownPow2(mStart, static_cast<u32>(pageSize)));
+    u8* end = mStart + mReservedSize;
+
+    PSAPI_WORKING_SET_EX_INFORMATION residency[512];
+
+    const size_t cChunkSize = (sizeof(residency) / sizeof(residency[0])) * pageSize;
+
+    size_t residentSize = 0;
+
+    for (u8* chunk = begin; chunk < end; chunk += cChunkSize)
+    {
+        size_t chunkSize = static_cast<size_t>(end - chunk) < cChunkSize ? static_cast<size_t>(end - chunk) : cChunkSize;
+        size_t pageNum = (chunkSize + pageSize - 1) / pageSize;
+
+        for (size_t i = 0; i < pageNum; i++)
+            residency[i].VirtualAddress = chunk + i * pageSize;
+
+        if (!QueryWorkingSetEx(GetCurrentProcess(), residency, static_cast<DWORD>(pageNum * sizeof(residency[0]))))
+            return 0;
+
+        for (size_t i = 0; i < pageNum; i++)
+        {
+            if (residency[i].VirtualAttributes.Valid)
+                residentSize += pageSize;
+        }
+    }
+
+    return residentSize;
+}
+
 } // namespace sead
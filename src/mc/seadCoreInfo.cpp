@@ -2,11 +2,22 @@
 
 #include <basis/seadRawPrint.h>
 
+#include <bit>
+
+#if defined(SEAD_PLATFORM_POSIX)
+#include <unistd.h>
+#endif // SEAD_PLATFORM_POSIX
+
 namespace sead {
 
+u32 CoreIdMask::countOnBits() const
+{
+    return static_cast<u32>(std::popcount(mMask));
+}
+
 u32 CoreInfo::sNumCores = 1;
 u32 CoreInfo::sPlatformCoreId[32];
-CoreId CoreInfo::sCoreIdFromPlatformCoreIdTable[32];
+CoreId CoreInfo::sCoreIdFromPlatformCoreIdTable[cPlatformCoreIdMax];
 
 struct CoreInfoInitializer
 {
@@ -31,11 +42,49 @@ void CoreInfo::configure()
         sPlatformCoreId[i] = i;
     }
 #elif defined(SEAD_PLATFORM_POSIX)
-    return; // TODO
+    sNumCores = 0;
+
+#if !defined(SEAD_PLATFORM_MACOSX)
+    // Only the cores the process is allowed to run on, it may be restricted to a cpuset
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+    {
+        // CoreIdMask can not hold more than 32
+        for (u32 i = 0; i < cPlatformCoreIdMax && sNumCores < 32; i++)
+        {
+            if (CPU_ISSET(i, &cpuSet))
+            {
+                sPlatformCoreId[sNumCores] = i;
+                sNumCores++;
+            }
+        }
+    }
+#endif // SEAD_PLATFORM_MACOSX
+
+    if (sNumCores == 0)
+    {
+        long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+        sNumCores = numCores > 0 ? static_cast<u32>(numCores) : 1;
+
+        if (sNumCores > 32)
+            sNumCores = 32;
+
+        for (u32 i = 0; i < sNumCores; i++)
+        {
+            sPlatformCoreId[i] = i;
+        }
+    }
 #else
     #error "Unsupported platform"
 #endif // SEAD_PLATFORM_WINDOWS
 
+    for (u32 i = 0; i < cPlatformCoreIdMax; i++)
+    {
+        sCoreIdFromPlatformCoreIdTable[i] = cUndef;
+    }
+
     for (u32 i = 0; i < sNumCores; i++)
     {
         u32 id = sPlatformCoreId[i];
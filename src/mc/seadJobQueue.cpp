@@ -0,0 +1,359 @@
+#include <mc/seadJobQueue.h>
+
+#include <basis/seadAssert.h>
+#include <heap/seadHeap.h>
+#include <mc/seadWorker.h>
+#include <prim/seadScopedLock.h>
+#include <thread/seadEvent.h>
+
+#include <bit>
+
+namespace sead {
+
+struct JobCounter::Waiter
+{
+    Waiter()
+        : event(false)
+        , next(nullptr)
+    {
+    }
+
+    Event event;
+    Waiter* next;
+};
+
+JobQueue::JobQueue()
+    : mWorkers(nullptr)
+    , mWorkerNum(0)
+    , mInjectQueue()
+    , mSleepingMask(0)
+    , mIsFinalizing(0)
+    , mWorkerTLS()
+    , mDependencyCS()
+{
+}
+
+JobQueue::~JobQueue()
+{
+    finalize();
+}
+
+void JobQueue::initialize(const CoreIdMask& coreMask, Heap* heap, s32 platformPriority, s32 stackSize, s32 dequeSize, s32 injectQueueSize)
+{
+    SEAD_ASSERT_MSG(!mWorkers, "JobQueue is already initialized.");
+
+    mWorkerNum = static_cast<s32>(coreMask.countOnBits());
+    if (mWorkerNum == 0)
+    {
+        SEAD_ASSERT_MSG(false, "coreMask is empty.");
+        return;
+    }
+
+    mInjectQueue.allocateLockFree(injectQueueSize, heap);
+    mSleepingMask.setValue(0);
+    mIsFinalizing.setValue(0);
+
+    mWorkers = new(heap) Worker*[mWorkerNum];
+
+    s32 index = 0;
+    for (s32 id = 0; id < 32; id++)
+    {
+        CoreId coreId = static_cast<CoreId>(id);
+        if (!coreMask.isOn(coreId))
+            continue;
+
+        mWorkers[index] = new(heap) Worker(this, index, coreId, dequeSize, heap, platformPriority, stackSize);
+        mWorkers[index]->setAffinity(CoreIdMask(coreId));
+        index++;
+    }
+
+    for (s32 i = 0; i < mWorkerNum; i++)
+    {
+        mWorkers[i]->start();
+    }
+}
+
+void JobQueue::finalize()
+{
+    if (!mWorkers)
+        return;
+
+    mIsFinalizing.setValue(1);
+
+    for (s32 i = 0; i < mWorkerNum; i++)
+    {
+        mWorkers[i]->wakeup_();
+    }
+
+    for (s32 i = 0; i < mWorkerNum; i++)
+    {
+        mWorkers[i]->waitDone();
+        delete mWorkers[i];
+    }
+
+    delete[] mWorkers;
+    mWorkers = nullptr;
+    mWorkerNum = 0;
+
+    mInjectQueue.free();
+}
+
+void JobQueue::enqueue(Job* job, JobCounter* counter, JobCounter* dependency)
+{
+    SEAD_ASSERT(job);
+
+    job->mCounter = counter;
+    job->mNext = nullptr;
+
+    if (counter)
+        counter->mCount.increment();
+
+    if (dependency)
+    {
+        // Checked under the lock so that the last job of dependency can not miss this one
+        ScopedLock<CriticalSection> lock(&mDependencyCS);
+
+        if (dependency->mCount.getValue() != 0)
+        {
+            job->mNext = dependency->mWaitingJobs;
+            dependency->mWaitingJobs = job;
+            return;
+        }
+    }
+
+    push_(job);
+}
+
+void JobQueue::enqueue(Job** jobs, s32 num, JobCounter* counter)
+{
+    if (counter)
+        counter->mCount.add(num);
+
+    for (s32 i = 0; i < num; i++)
+    {
+        jobs[i]->mCounter = counter;
+        jobs[i]->mNext = nullptr;
+        push_(jobs[i]);
+    }
+}
+
+void JobQueue::wait(JobCounter* counter)
+{
+    SEAD_ASSERT(counter);
+
+    Worker* worker = getCurrentWorker();
+
+    s32 spinNum = 0;
+    while (!counter->isDone())
+    {
+        Job* job = acquireJob_(worker);
+        if (job)
+        {
+            execute_(job);
+            spinNum = 0;
+        }
+        else if (spinNum < cWaitSpinNum)
+        {
+            spinNum++;
+            Thread::yield();
+        }
+        else
+        {
+            block_(counter, worker);
+            return;
+        }
+    }
+}
+
+Worker* JobQueue::getWorker(s32 index) const
+{
+    SEAD_ASSERT(0 <= index && index < mWorkerNum);
+    return mWorkers[index];
+}
+
+void JobQueue::push_(Job* job)
+{
+    Worker* worker = getCurrentWorker();
+
+    if (!(worker && worker->pushJob_(job)) &&
+        !mInjectQueue.push(reinterpret_cast<MessageQueue::Element>(job), MessageQueue::BlockType::eNoBlock))
+    {
+        // Every queue is full, the caller has to do the work itself
+        execute_(job);
+        return;
+    }
+
+    wakeupWorker_();
+}
+
+Job* JobQueue::acquireJob_(Worker* worker)
+{
+    Job* job = nullptr;
+
+    if (worker)
+    {
+        job = worker->popJob_();
+        if (job)
+            return job;
+    }
+
+    MessageQueue::Element msg = mInjectQueue.pop(MessageQueue::BlockType::eNoBlock);
+    if (msg != MessageQueue::cNullElement)
+        return reinterpret_cast<Job*>(msg);
+
+    // Start next to ourselves so that thieves spread over the victims
+    s32 start = worker ? worker->getIndex() + 1 : 0;
+    for (s32 i = 0; i < mWorkerNum; i++)
+    {
+        Worker* victim = mWorkers[(start + i) % mWorkerNum];
+        if (victim == worker)
+            continue;
+
+        job = victim->stealJob_();
+        if (job)
+            return job;
+    }
+
+    return nullptr;
+}
+
+void JobQueue::execute_(Job* job)
+{
+    // The job may be reused as soon as its counter is done
+    JobCounter* counter = job->mCounter;
+
+    job->invoke();
+
+    if (counter)
+        finish_(counter);
+}
+
+void JobQueue::finish_(JobCounter* counter)
+{
+    counter->mFinishingNum.increment();
+
+    if (counter->mCount.decrement() != 1)
+    {
+        counter->mFinishingNum.decrement();
+        return;
+    }
+
+    Job* waitingJobs = nullptr;
+    JobCounter::Waiter* waiters = nullptr;
+    {
+        ScopedLock<CriticalSection> lock(&mDependencyCS);
+        waitingJobs = counter->mWaitingJobs;
+        counter->mWaitingJobs = nullptr;
+        waiters = counter->mWaiters;
+        counter->mWaiters = nullptr;
+    }
+
+    // Waiters only return once mFinishingNum is zero, so their events are still alive here
+    while (waiters)
+    {
+        JobCounter::Waiter* next = waiters->next;
+        waiters->event.setSignal();
+        waiters = next;
+    }
+
+    counter->mFinishingNum.decrement();
+
+    while (waitingJobs)
+    {
+        Job* next = waitingJobs->mNext;
+        waitingJobs->mNext = nullptr;
+        push_(waitingJobs);
+        waitingJobs = next;
+    }
+}
+
+void JobQueue::block_(JobCounter* counter, Worker* worker)
+{
+    JobCounter::Waiter waiter;
+
+    while (!counter->isDone())
+    {
+        Job* job = acquireJob_(worker);
+        if (job)
+        {
+            execute_(job);
+            continue;
+        }
+
+        bool isListed = false;
+        {
+            ScopedLock<CriticalSection> lock(&mDependencyCS);
+
+            // Still listed after a timeout, unlink first so that the waiter is never listed twice
+            for (JobCounter::Waiter** it = &counter->mWaiters; *it; it = &(*it)->next)
+            {
+                if (*it == &waiter)
+                {
+                    *it = waiter.next;
+                    break;
+                }
+            }
+
+            // Otherwise the last job already took the list and only has to leave the counter
+            if (counter->mCount.getValue() != 0)
+            {
+                waiter.next = counter->mWaiters;
+                counter->mWaiters = &waiter;
+                isListed = true;
+            }
+        }
+
+        if (!isListed)
+            Thread::yield();
+        else if (worker)
+            waiter.event.wait(TickSpan::makeFromMilliSeconds(cWorkerWaitMilliSeconds));
+        else
+            waiter.event.wait();
+    }
+}
+
+bool JobQueue::hasJob_() const
+{
+    if (mInjectQueue.peek(MessageQueue::BlockType::eNoBlock) != MessageQueue::cNullElement)
+        return true;
+
+    for (s32 i = 0; i < mWorkerNum; i++)
+    {
+        if (mWorkers[i]->hasJob_())
+            return true;
+    }
+
+    return false;
+}
+
+void JobQueue::wakeupWorker_()
+{
+    u32 mask = mSleepingMask.getValue();
+
+    while (mask != 0)
+    {
+        u32 index = static_cast<u32>(std::countr_zero(mask));
+        if (mSleepingMask.setBitOff(index))
+        {
+            mWorkers[index]->wakeup_();
+            return;
+        }
+
+        mask = mSleepingMask.getValue();
+    }
+}
+
+void JobQueue::sleepWorker_(Worker* worker)
+{
+    u32 bit = static_cast<u32>(worker->getIndex());
+    mSleepingMask.setBitOn(bit);
+
+    // Check again once the bit is visible, a job pushed in between would otherwise wait for the next wakeup.
+    // When someone else already cleared the bit the event is signaled and the wait below returns at once.
+    if ((hasJob_() || mIsFinalizing.getValue() != 0) && mSleepingMask.setBitOff(bit))
+        return;
+
+    worker->mWakeEvent.wait();
+}
+
+} // namespace sead
@@ -0,0 +1,102 @@
+#include <mc/seadWorker.h>
+
+#include <mc/seadJobQueue.h>
+
+#include <bit>
+
+namespace sead {
+
+Worker::Worker(JobQueue* jobQueue, s32 index, CoreId coreId, s32 dequeSize, Heap* heap, s32 platformPriority, s32 stackSize)
+    : Thread("sead::Worker", heap, platformPriority, MessageQueue::BlockType::eNoBlock, cDefaultQuitMsg, stackSize, 1)
+    , mJobQueue(jobQueue)
+    , mIndex(index)
+    , mCoreId(coreId)
+    , mWakeEvent(false)
+    , mDeque(nullptr)
+    , mDequeMask(0)
+    , mTop(0)
+    , mBottom(0)
+{
+    SEAD_ASSERT(dequeSize > 0);
+
+    s32 size = static_cast<s32>(std::bit_ceil(static_cast<u32>(dequeSize)));
+    mDeque = new(heap) AtomicPtr<Job*>[size];
+    mDequeMask = size - 1;
+}
+
+Worker::~Worker()
+{
+    delete[] mDeque;
+}
+
+void Worker::run_()
+{
+    mJobQueue->mWorkerTLS.setValue(reinterpret_cast<uintptr_t>(this));
+
+    while (mJobQueue->mIsFinalizing.getValue() == 0)
+    {
+        Job* job = mJobQueue->acquireJob_(this);
+        if (job)
+            mJobQueue->execute_(job);
+        else
+            mJobQueue->sleepWorker_(this);
+    }
+}
+
+bool Worker::pushJob_(Job* job)
+{
+    s64 bottom = mBottom.getValue();
+    s64 top = mTop.getValue();
+
+    if (bottom - top > mDequeMask)
+        return false;
+
+    mDeque[bottom & mDequeMask].setValue(job);
+    mBottom.setValue(bottom + 1);
+
+    return true;
+}
+
+Job* Worker::popJob_()
+{
+    s64 bottom = mBottom.getValue() - 1;
+    mBottom.setValue(bottom);
+
+    s64 top = mTop.getValue();
+    if (top > bottom)
+    {
+        mBottom.setValue(bottom + 1);
+        return nullptr;
+    }
+
+    Job* job = mDeque[bottom & mDequeMask].getValue();
+
+    // Thieves may be after the last job as well
+    if (top == bottom)
+    {
+        if (!mTop.compareAndSwap(top, top + 1))
+            job = nullptr;
+
+        mBottom.setValue(bottom + 1);
+    }
+
+    return job;
+}
+
+Job* Worker::stealJob_()
+{
+    s64 top = mTop.getValue();
+    s64 bottom = mBottom.getValue();
+
+    if (top >= bottom)
+        return nullptr;
+
+    Job* job = mDeque[top & mDequeMask].getValue();
+
+    if (!mTop.compareAndSwap(top, top + 1))
+        return nullptr;
+
+    return job;
+}
+
+} // namespace sead
@@ -1,64 +1,260 @@
 #include <prim/seadEndian.h>
 
-static u8 Swap8(u8 x)
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SEAD_ENDIAN_SWAP_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif // _MSC_VER
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SEAD_ENDIAN_SWAP_NEON
+#include <arm_neon.h>
+#endif
+
+namespace sead {
+
+namespace {
+
+u16 SwapBytes(u16 x)
 {
-    return x;
+    return Endian::swapU16(x);
 }
 
-static u8 Null8(u8 x)
+u32 SwapBytes(u32 x)
 {
-    return x;
+    return Endian::swapU32(x);
 }
 
-static u16 Swap16(u16 x)
+u64 SwapBytes(u64 x)
 {
-    return (x << 8 | x >> 8) & 0xFFFF;
+    return Endian::swapU64(x);
 }
 
-static u16 Null16(u16 x)
+// Swaps the elements the vector loops left over
+template <typename T>
+void SwapArrayScalar(u8* dst, const u8* src, size_t num)
 {
-    return x;
+    for (size_t i = 0; i < num; i++)
+    {
+        T value;
+        std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+        value = SwapBytes(value);
+        std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+    }
 }
 
-static u32 Swap32(u32 x)
+#if defined(SEAD_ENDIAN_SWAP_X86)
+
+#if defined(__GNUC__)
+#define SEAD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define SEAD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SEAD_TARGET_SSSE3
+#define SEAD_TARGET_AVX2
+#endif // __GNUC__
+
+// pshufb controls reversing each 2, 4 and 8 byte element of a 128 bit lane
+alignas(16) const u8 cShuffle16[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+alignas(16) const u8 cShuffle32[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+alignas(16) const u8 cShuffle64[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+template <typename T>
+const u8* GetShuffle()
+{
+    if constexpr (sizeof(T) == 2)
+        return cShuffle16;
+    else if constexpr (sizeof(T) == 4)
+        return cShuffle32;
+    else
+        return cShuffle64;
+}
+
+struct CpuFeatures
 {
-    return x << 24 |
-          (x & 0xFF00) << 8 |
-           x >> 24 |
-           x >> 8 & 0xFF00;
+    bool ssse3;
+    bool avx2;
+};
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures cFeatures = []()
+    {
+        CpuFeatures features = { false, false };
+
+        u32 ecx1 = 0;
+        u32 ebx7 = 0;
+        u32 maxLeaf = 0;
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        maxLeaf = static_cast<u32>(info[0]);
+        __cpuid(info, 1);
+        ecx1 = static_cast<u32>(info[2]);
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            ebx7 = static_cast<u32>(info[1]);
+        }
+#else
+        u32 eax, ebx, edx;
+        maxLeaf = __get_cpuid_max(0, nullptr);
+        if (!__get_cpuid(1, &eax, &ebx, &ecx1, &edx))
+            return features;
+
+        if (maxLeaf >= 7)
+        {
+            u32 ecx7;
+            __cpuid_count(7, 0, eax, ebx7, ecx7, edx);
+        }
+#endif // _MSC_VER
+
+        features.ssse3 = (ecx1 & (1u << 9)) != 0;
+
+        // AVX2 also needs the OS to save the ymm registers, OSXSAVE and then XCR0 bits 1 and 2
+        if ((ebx7 & (1u << 5)) != 0 && (ecx1 & (1u << 27)) != 0)
+        {
+#if defined(_MSC_VER)
+            u64 xcr0 = _xgetbv(0);
+#else
+            u32 xcr0Lo, xcr0Hi;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+            u64 xcr0 = static_cast<u64>(xcr0Hi) << 32 | xcr0Lo;
+#endif // _MSC_VER
+            features.avx2 = (xcr0 & 6) == 6;
+        }
+
+        return features;
+    }();
+
+    return cFeatures;
+}
+
+// Returns the number of bytes swapped, a multiple of 16
+SEAD_TARGET_SSSE3 size_t SwapArraySsse3(u8* dst, const u8* src, size_t size, const u8* shuffle)
+{
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle));
+
+    size_t offset = 0;
+
+    for (; offset + 64 <= size; offset += 64)
+    {
+        __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset + 0x00));
+        __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset + 0x10));
+        __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset + 0x20));
+        __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset + 0x30));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + 0x00), _mm_shuffle_epi8(x0, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + 0x10), _mm_shuffle_epi8(x1, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + 0x20), _mm_shuffle_epi8(x2, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + 0x30), _mm_shuffle_epi8(x3, mask));
+    }
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), _mm_shuffle_epi8(x, mask));
+    }
+
+    return offset;
 }
 
-static u32 Null32(u32 x)
+// vpshufb shuffles within each 128 bit lane, so the same control is used for both
+SEAD_TARGET_AVX2 size_t SwapArrayAvx2(u8* dst, const u8* src, size_t size, const u8* shuffle)
 {
-    return x;
+    const __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(shuffle)));
+
+    size_t offset = 0;
+
+    for (; offset + 128 <= size; offset += 128)
+    {
+        __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset + 0x00));
+        __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset + 0x20));
+        __m256i x2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset + 0x40));
+        __m256i x3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset + 0x60));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset + 0x00), _mm256_shuffle_epi8(x0, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset + 0x20), _mm256_shuffle_epi8(x1, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset + 0x40), _mm256_shuffle_epi8(x2, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset + 0x60), _mm256_shuffle_epi8(x3, mask));
+    }
+
+    for (; offset + 32 <= size; offset += 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + offset), _mm256_shuffle_epi8(x, mask));
+    }
+
+    return offset;
 }
 
-static u64 Swap64(u64 x)
+#endif // SEAD_ENDIAN_SWAP_X86
+
+#if defined(SEAD_ENDIAN_SWAP_NEON)
+
+// NEON is part of every ARMv8 CPU, so unlike x86 there is nothing to detect
+template <typename T>
+size_t SwapArrayNeon(u8* dst, const u8* src, size_t size)
 {
-    return x << 56 |
-          (x & 0xFF00) << 40 |
-          (x & 0xFF0000) << 24 |
-          (x & 0xFF000000) << 8 |
-           x >> 56 |
-           x >> 40 & 0xFF00 |
-           x >> 24 & 0xFF0000 |
-           x >> 8 & 0xFF000000;
+    size_t offset = 0;
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        uint8x16_t x = vld1q_u8(src + offset);
+
+        if constexpr (sizeof(T) == 2)
+            x = vrev16q_u8(x);
+        else if constexpr (sizeof(T) == 4)
+            x = vrev32q_u8(x);
+        else
+            x = vrev64q_u8(x);
+
+        vst1q_u8(dst + offset, x);
+    }
+
+    return offset;
 }
 
-static u64 Null64(u64 x)
+#endif // SEAD_ENDIAN_SWAP_NEON
+
+template <typename T>
+void SwapArray(void* dst, const void* src, size_t num)
 {
-    return x;
+    u8* dstU8 = static_cast<u8*>(dst);
+    const u8* srcU8 = static_cast<const u8*>(src);
+
+    size_t size = num * sizeof(T);
+    size_t swappedSize = 0;
+
+#if defined(SEAD_ENDIAN_SWAP_X86)
+    const CpuFeatures& features = GetCpuFeatures();
+    if (features.avx2)
+        swappedSize = SwapArrayAvx2(dstU8, srcU8, size, GetShuffle<T>());
+    else if (features.ssse3)
+        swappedSize = SwapArraySsse3(dstU8, srcU8, size, GetShuffle<T>());
+#elif defined(SEAD_ENDIAN_SWAP_NEON)
+    swappedSize = SwapArrayNeon<T>(dstU8, srcU8, size);
+#endif // SEAD_ENDIAN_SWAP_X86
+
+    SwapArrayScalar<T>(dstU8 + swappedSize, srcU8 + swappedSize, (size - swappedSize) / sizeof(T));
 }
 
-namespace sead {
+} // namespace
+
+void Endian::swapArrayU16(void* dst, const void* src, size_t num)
+{
+    SwapArray<u16>(dst, src, num);
+}
 
-const Endian::Types Endian::cHostEndian = Endian::markToEndian(0xFEFF);
+void Endian::swapArrayU32(void* dst, const void* src, size_t num)
+{
+    SwapArray<u32>(dst, src, num);
+}
 
-const Endian::ConvFuncTable Endian::cConvFuncTable = {
-    { &Null8,  &Swap8 },
-    { &Null16, &Swap16 },
-    { &Null32, &Swap32 },
-    { &Null64, &Swap64 }
-};
+void Endian::swapArrayU64(void* dst, const void* src, size_t num)
+{
+    SwapArray<u64>(dst, src, num);
+}
 
 } // namespace sead
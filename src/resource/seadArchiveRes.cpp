@@ -0,0 +1,101 @@
+#include <resource/seadArchiveRes.h>
+
+namespace sead {
+
+ArchiveRes::ArchiveRes()
+    : DirectResource()
+    , mEnable(false)
+{
+}
+
+ArchiveRes::~ArchiveRes()
+{
+}
+
+void* ArchiveRes::getFile(const SafeString& path, FileInfo* info)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return nullptr;
+
+    return getFileImpl_(trimPath_(path), info);
+}
+
+void* ArchiveRes::getFileFast(s32 entryID, FileInfo* info)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return nullptr;
+
+    return getFileFastImpl_(entryID, info);
+}
+
+s32 ArchiveRes::convertPathToEntryID(const SafeString& path)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return -1;
+
+    return convertPathToEntryIDImpl_(trimPath_(path));
+}
+
+s32 ArchiveRes::getFileNum() const
+{
+    if (!mEnable)
+        return 0;
+
+    return getFileNumImpl_();
+}
+
+bool ArchiveRes::isExistDirectory(const SafeString& path)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return false;
+
+    return isExistDirectoryImpl_(trimPath_(path));
+}
+
+bool ArchiveRes::openDirectory(HandleBuffer* handle, const SafeString& path)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return false;
+
+    return openDirectoryImpl_(handle, trimPath_(path));
+}
+
+bool ArchiveRes::closeDirectory(HandleBuffer* handle)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return false;
+
+    return closeDirectoryImpl_(handle);
+}
+
+u32 ArchiveRes::readDirectory(HandleBuffer* handle, DirectoryEntry* entries, u32 num)
+{
+    SEAD_ASSERT_MSG(mEnable, "archive is not ready");
+    if (!mEnable)
+        return 0;
+
+    return readDirectoryImpl_(handle, entries, num);
+}
+
+void ArchiveRes::doCreate_(u8* data, u32 size, Heap* instanceHeap)
+{
+    mEnable = prepareArchive_(data, size, instanceHeap);
+    SEAD_ASSERT_MSG(mEnable, "failed to prepare archive");
+}
+
+SafeString ArchiveRes::trimPath_(const SafeString& path)
+{
+    const char* str = path.cstr();
+    while (*str == '/')
+        str++;
+
+    return SafeString(str);
+}
+
+} // namespace sead
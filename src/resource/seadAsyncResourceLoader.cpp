@@ -0,0 +1,301 @@
+#include <resource/seadAsyncResourceLoader.h>
+
+#include <basis/seadWarning.h>
+#include <resource/seadResource.h>
+
+namespace sead {
+
+AsyncLoadHandle::AsyncLoadHandle()
+    : mPath()
+    , mConvertExt()
+    , mArg()
+    , mDecomp(nullptr)
+    , mIsUseDecomp(false)
+    , mPriority(Priority::eNormal)
+    , mCallback(nullptr)
+    , mResource(nullptr)
+    , mState(static_cast<u32>(State::eIdle))
+    , mIsCancelRequested(0)
+{
+}
+
+AsyncLoadHandle::~AsyncLoadHandle()
+{
+    SEAD_ASSERT_MSG(!isBusy(), "handle destroyed while loading [%s]", mPath.cstr());
+}
+
+bool AsyncLoadHandle::isBusy() const
+{
+    State state = getState();
+    return state == State::eQueued || state == State::eLoading;
+}
+
+bool AsyncLoadHandle::isDone() const
+{
+    State state = getState();
+    return state == State::eLoaded || state == State::eFailed || state == State::eCancelled;
+}
+
+void AsyncLoadHandle::load_()
+{
+    mState.setValue(static_cast<u32>(State::eLoading));
+
+    if (isCancelRequested())
+        return;
+
+    ResourceMgr* mgr = ResourceMgr::instance();
+    if (!mgr)
+    {
+        SEAD_ASSERT_MSG(false, "AsyncLoadHandle need ResourceMgr");
+        return;
+    }
+
+    if (mIsUseDecomp)
+        mResource = mgr->tryLoad(mArg, mConvertExt, mDecomp);
+    else
+        mResource = mgr->tryLoadWithoutDecomp(mArg);
+}
+
+AsyncResourceLoader::LoaderThread::LoaderThread(AsyncResourceLoader* loader, Heap* heap, s32 platformPriority, s32 stackSize)
+    : Thread("sead::AsyncResourceLoader", heap, platformPriority, MessageQueue::BlockType::eNoBlock, cDefaultQuitMsg, stackSize, 1)
+    , mLoader(loader)
+    , mHeap(heap)
+{
+}
+
+void AsyncResourceLoader::LoaderThread::run_()
+{
+    // Load arguments without a heap allocate from the loader heap
+    CurrentHeapSetter setter(mHeap);
+
+    // One wake message is pushed per request, so every request message is backed by a queued handle
+    while (mLoader->mWakeQueue.pop(MessageQueue::BlockType::eBlock) == cRequestMsg)
+    {
+        AsyncLoadHandle* handle = mLoader->popRequest_();
+        handle->load_();
+        mLoader->finish_(handle);
+    }
+}
+
+AsyncResourceLoader::AsyncResourceLoader()
+    : mThreads(nullptr)
+    , mThreadNum(0)
+    , mRequestQueue()
+    , mWakeQueue()
+    , mDoneQueue()
+    , mRequestNum(0)
+    , mRequestNumMax(0)
+{
+}
+
+AsyncResourceLoader::~AsyncResourceLoader()
+{
+    if (isInitialized())
+        finalize();
+}
+
+void AsyncResourceLoader::initialize(Heap* heap, s32 threadNum, s32 queueSize, s32 platformPriority, s32 stackSize)
+{
+    SEAD_ASSERT_MSG(!isInitialized(), "already initialized");
+    SEAD_ASSERT(threadNum > 0);
+    SEAD_ASSERT(queueSize > 0);
+
+    for (s32 i = 0; i < AsyncLoadHandle::cPriorityNum; i++)
+        mRequestQueue[i].allocateLockFree(queueSize, heap);
+
+    // Large enough to never block on push, whatever the requests and quit messages
+    mWakeQueue.allocate(queueSize * AsyncLoadHandle::cPriorityNum + threadNum, heap);
+    mDoneQueue.allocateLockFree(queueSize * AsyncLoadHandle::cPriorityNum, heap);
+
+    mRequestNumMax = queueSize * AsyncLoadHandle::cPriorityNum;
+    mThreadNum = threadNum;
+    mThreads = new(heap) LoaderThread*[threadNum];
+
+    for (s32 i = 0; i < threadNum; i++)
+    {
+        mThreads[i] = new(heap) LoaderThread(this, heap, platformPriority, stackSize);
+        mThreads[i]->start();
+    }
+}
+
+void AsyncResourceLoader::finalize()
+{
+    if (!isInitialized())
+        return;
+
+    // Jammed ahead of the pending requests so the threads stop after their current one
+    for (s32 i = 0; i < mThreadNum; i++)
+        mWakeQueue.jam(cQuitMsg, MessageQueue::BlockType::eBlock);
+
+    for (s32 i = 0; i < mThreadNum; i++)
+    {
+        mThreads[i]->waitDone();
+        delete mThreads[i];
+    }
+
+    delete[] mThreads;
+    mThreads = nullptr;
+    mThreadNum = 0;
+
+    for (s32 i = 0; i < AsyncLoadHandle::cPriorityNum; i++)
+    {
+        MessageQueue::Element msg;
+        while ((msg = mRequestQueue[i].pop(MessageQueue::BlockType::eNoBlock)) != MessageQueue::cNullElement)
+        {
+            AsyncLoadHandle* handle = reinterpret_cast<AsyncLoadHandle*>(msg);
+            handle->cancel();
+            finish_(handle);
+        }
+    }
+
+    calc();
+
+    for (s32 i = 0; i < AsyncLoadHandle::cPriorityNum; i++)
+        mRequestQueue[i].free();
+
+    mWakeQueue.free();
+    mDoneQueue.free();
+}
+
+bool AsyncResourceLoader::requestLoad(AsyncLoadHandle* handle, const ResourceMgr::LoadArg& arg, AsyncLoadHandle::Priority priority,
+                                      AsyncLoadCallback* callback)
+{
+    if (!handle)
+    {
+        SEAD_ASSERT_MSG(false, "handle is null");
+        return false;
+    }
+
+    handle->mIsUseDecomp = false;
+    handle->mDecomp = nullptr;
+    handle->mConvertExt.clear();
+
+    return request_(handle, arg, priority, callback);
+}
+
+bool AsyncResourceLoader::requestLoadWithDecomp(AsyncLoadHandle* handle, const ResourceMgr::LoadArg& arg, const SafeString& convertExt,
+                                                Decompressor* decomp, AsyncLoadHandle::Priority priority, AsyncLoadCallback* callback)
+{
+    if (!handle)
+    {
+        SEAD_ASSERT_MSG(false, "handle is null");
+        return false;
+    }
+
+    handle->mIsUseDecomp = true;
+    handle->mDecomp = decomp;
+    handle->mConvertExt.copy(convertExt);
+
+    return request_(handle, arg, priority, callback);
+}
+
+s32 AsyncResourceLoader::calc(s32 maxNum)
+{
+    s32 num = 0;
+
+    while (maxNum < 0 || num < maxNum)
+    {
+        MessageQueue::Element msg = mDoneQueue.pop(MessageQueue::BlockType::eNoBlock);
+        if (msg == MessageQueue::cNullElement)
+            break;
+
+        AsyncLoadHandle* handle = reinterpret_cast<AsyncLoadHandle*>(msg);
+
+        AsyncLoadHandle::State state;
+        if (handle->isCancelRequested())
+        {
+            if (handle->mResource)
+            {
+                ResourceMgr::instance()->unload(handle->mResource);
+                handle->mResource = nullptr;
+            }
+
+            state = AsyncLoadHandle::State::eCancelled;
+        }
+        else
+        {
+            state = handle->mResource ? AsyncLoadHandle::State::eLoaded : AsyncLoadHandle::State::eFailed;
+        }
+
+        AsyncLoadCallback* callback = handle->mCallback;
+        handle->mCallback = nullptr;
+        handle->mState.setValue(static_cast<u32>(state));
+        mRequestNum.decrement();
+        num++;
+
+        if (callback)
+            callback->invoke(handle);
+    }
+
+    return num;
+}
+
+bool AsyncResourceLoader::request_(AsyncLoadHandle* handle, const ResourceMgr::LoadArg& arg, AsyncLoadHandle::Priority priority,
+                                   AsyncLoadCallback* callback)
+{
+    if (!isInitialized())
+    {
+        SEAD_ASSERT_MSG(false, "not initialized");
+        return false;
+    }
+
+    if (handle->isBusy())
+    {
+        SEAD_ASSERT_MSG(false, "handle is busy [%s]", handle->mPath.cstr());
+        return false;
+    }
+
+    // Finished requests wait in mDoneQueue until calc(), so it bounds the requests in flight
+    if (static_cast<s32>(mRequestNum.increment()) >= mRequestNumMax)
+    {
+        mRequestNum.decrement();
+        SEAD_WARNING("too many requests in flight [%s]", arg.path.cstr());
+        return false;
+    }
+
+    handle->mPath.copy(arg.path);
+    handle->mArg = arg;
+    handle->mArg.path = handle->mPath;
+    handle->mPriority = priority;
+    handle->mCallback = callback;
+    handle->mResource = nullptr;
+    handle->mIsCancelRequested.setValue(0);
+    handle->mState.setValue(static_cast<u32>(AsyncLoadHandle::State::eQueued));
+
+    if (!mRequestQueue[static_cast<s32>(priority)].push(reinterpret_cast<MessageQueue::Element>(handle), MessageQueue::BlockType::eNoBlock))
+    {
+        SEAD_WARNING("request queue is full [%s]", handle->mPath.cstr());
+        handle->mCallback = nullptr;
+        handle->mState.setValue(static_cast<u32>(AsyncLoadHandle::State::eIdle));
+        mRequestNum.decrement();
+        return false;
+    }
+
+    mWakeQueue.push(cRequestMsg, MessageQueue::BlockType::eBlock);
+
+    return true;
+}
+
+AsyncLoadHandle* AsyncResourceLoader::popRequest_()
+{
+    for (;;)
+    {
+        for (s32 i = 0; i < AsyncLoadHandle::cPriorityNum; i++)
+        {
+            MessageQueue::Element msg = mRequestQueue[i].pop(MessageQueue::BlockType::eNoBlock);
+            if (msg != MessageQueue::cNullElement)
+                return reinterpret_cast<AsyncLoadHandle*>(msg);
+        }
+
+        // A concurrent push may not be visible yet
+        Thread::yield();
+    }
+}
+
+void AsyncResourceLoader::finish_(AsyncLoadHandle* handle)
+{
+    while (!mDoneQueue.push(reinterpret_cast<MessageQueue::Element>(handle), MessageQueue::BlockType::eNoBlock))
+        Thread::yield();
+}
+
+} // namespace sead
@@ -0,0 +1,95 @@
+#include <resource/seadDecompressor.h>
+
+#include <filedevice/seadFileDevice.h>
+#include <filedevice/seadFileDeviceMgr.h>
+#include <heap/seadHeap.h>
+#include <heap/seadHeapMgr.h>
+#include <math/seadMathCalcCommon.h>
+#include <resource/seadResource.h>
+
+namespace sead {
+
+FileDevice* Decompressor::tryOpen_(FileHandle* handle, const ResourceMgr::LoadArg& arg) const
+{
+    if (arg.device)
+        return arg.device->tryOpen(handle, arg.path, FileDevice::FileOpenFlag::eReadOnly, arg.div_size);
+    else
+        return FileDeviceMgr::instance()->tryOpen(handle, arg.path, FileDevice::FileOpenFlag::eReadOnly, arg.div_size);
+}
+
+u8* Decompressor::tryAllocLoadData_(u32* outBufferSize, bool* outNeedDelete, const ResourceMgr::LoadArg& arg, Resource* res, u32 decompSize,
+                                    u32 dataAlignment) const
+{
+    if (arg.load_data_buffer)
+    {
+        if (arg.load_data_buffer_size < decompSize)
+        {
+            SEAD_WARNING("arg.load_data_buffer_size[%u] is smaller than decompressed size[%u]", arg.load_data_buffer_size, decompSize);
+            return nullptr;
+        }
+
+        *outBufferSize = arg.load_data_buffer_size;
+        *outNeedDelete = false;
+        return arg.load_data_buffer;
+    }
+
+    if (arg.load_data_buffer_size_alignment % FileDevice::cBufferMinAlignment != 0)
+    {
+        SEAD_WARNING("arg.load_data_buffer_size_alignment[%u] is not multipe of FileDevice::cBufferMinAlignment[%u]",
+                     arg.load_data_buffer_size_alignment, FileDevice::cBufferMinAlignment);
+        return nullptr;
+    }
+
+    u32 bufferSize;
+    if (arg.load_data_buffer_size_alignment != 0)
+        bufferSize = Mathi::roundUpN(decompSize, arg.load_data_buffer_size_alignment);
+    else
+        bufferSize = Mathi::roundUpPow2(decompSize, FileDevice::cBufferMinAlignment);
+
+    s32 alignment = arg.load_data_alignment;
+    if (alignment == 0)
+    {
+        DirectResource* directRes = DynamicCast<DirectResource>(res);
+
+        if (dataAlignment != 0)
+            alignment = static_cast<s32>(dataAlignment);
+        else if (directRes)
+            alignment = directRes->getLoadDataAlignment();
+
+        alignment *= Mathi::sign(arg.instance_alignment);
+    }
+
+    alignment = Mathi::sign(alignment) * Mathi::max(Mathi::abs(alignment), FileDevice::cBufferMinAlignment);
+
+    Heap* heap = arg.load_data_heap;
+    if (!heap)
+        heap = HeapMgr::instance()->getCurrentHeap();
+
+    u8* buffer = static_cast<u8*>(heap->tryAlloc(bufferSize, alignment));
+    if (!buffer)
+    {
+        if (arg.enable_alloc_assert)
+            SEAD_ASSERT_MSG(false, "alloc size[%u] failed in heap[%s] for file[%s]", bufferSize, heap->getName().cstr(), arg.path.cstr());
+
+        return nullptr;
+    }
+
+    *outBufferSize = bufferSize;
+    *outNeedDelete = true;
+    return buffer;
+}
+
+u8* Decompressor::tryAllocWork_(const ResourceMgr::LoadArg& arg, u32 size) const
+{
+    Heap* heap = arg.load_data_heap;
+    if (!heap)
+        heap = HeapMgr::instance()->getCurrentHeap();
+
+    u8* work = static_cast<u8*>(heap->tryAlloc(size, -FileDevice::cBufferMinAlignment));
+    if (!work && arg.enable_alloc_assert)
+        SEAD_ASSERT_MSG(false, "alloc work size[%u] failed in heap[%s] for file[%s]", size, heap->getName().cstr(), arg.path.cstr());
+
+    return work;
+}
+
+} // namespace sead
@@ -0,0 +1,508 @@
+#include <resource/seadLZ4Decompressor.h>
+
+#include <filedevice/seadFileDevice.h>
+#include <heap/seadHeapMgr.h>
+#include <math/seadMathCalcCommon.h>
+#include <mc/seadJobQueue.h>
+#include <prim/seadEndian.h>
+#include <time/seadTickTime.h>
+
+#include <cstring>
+
+namespace sead {
+
+namespace {
+
+const u32 cBlockSizeMask = 0x7FFFFFFF;
+const u32 cBlockRawFlag = 0x80000000;
+const u32 cChecksumSize = 4;
+const u32 cMinMatch = 4;
+
+u32 ReadU32LE(const u8* src)
+{
+    u32 value;
+    std::memcpy(&value, src, sizeof(u32));
+    return Endian::toHostU32(Endian::eLittle, value);
+}
+
+u64 ReadU64LE(const u8* src)
+{
+    u64 value;
+    std::memcpy(&value, src, sizeof(u64));
+    return Endian::toHostU64(Endian::eLittle, value);
+}
+
+u32 CalcFrameHeaderSize(u8 flg)
+{
+    u32 size = LZ4Decompressor::cFrameHeaderSizeMin;
+
+    if ((flg & 0x08) != 0)
+        size += 8;
+
+    if ((flg & 0x01) != 0)
+        size += 4;
+
+    return size;
+}
+
+// Reads the variable length extension of a literal or match length
+bool ReadLength(u32* length, const u8** ip, const u8* ipEnd)
+{
+    u8 b;
+    do
+    {
+        if (*ip >= ipEnd)
+            return false;
+
+        b = *(*ip)++;
+        *length += b;
+    } while (b == 0xFF);
+
+    return true;
+}
+
+// Matches may reach back to history, the start of the output of the frame for linked blocks and of the block otherwise
+s32 DecodeBlock(u8* dst, u32 dstSize, const u8* history, const u8* src, u32 srcSize)
+{
+    const u8* ip = src;
+    const u8* ipEnd = src + srcSize;
+    u8* op = dst;
+    u8* opEnd = dst + dstSize;
+
+    while (true)
+    {
+        if (ip >= ipEnd)
+            return LZ4Decompressor::cErrorInvalidData;
+
+        u32 token = *ip++;
+
+        u32 literalLength = token >> 4;
+        if (literalLength == 0xF && !ReadLength(&literalLength, &ip, ipEnd))
+            return LZ4Decompressor::cErrorInvalidData;
+
+        if (literalLength > static_cast<u32>(ipEnd - ip) || literalLength > static_cast<u32>(opEnd - op))
+            return LZ4Decompressor::cErrorInvalidData;
+
+        std::memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+
+        // The last sequence is made of literals only
+        if (ip == ipEnd)
+            break;
+
+        if (ipEnd - ip < 2)
+            return LZ4Decompressor::cErrorInvalidData;
+
+        u32 offset = static_cast<u32>(ip[0]) | static_cast<u32>(ip[1]) << 8;
+        ip += 2;
+
+        if (offset == 0 || offset > static_cast<u32>(op - history))
+            return LZ4Decompressor::cErrorInvalidData;
+
+        u32 matchLength = token & 0xF;
+        if (matchLength == 0xF && !ReadLength(&matchLength, &ip, ipEnd))
+            return LZ4Decompressor::cErrorInvalidData;
+
+        matchLength += cMinMatch;
+        if (matchLength > static_cast<u32>(opEnd - op))
+            return LZ4Decompressor::cErrorInvalidData;
+
+        const u8* match = op - offset;
+
+        // A match closer than its length repeats the bytes it is writing, it is copied in steps no longer than the offset
+        if (offset >= matchLength)
+        {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else if (offset >= 8)
+        {
+            u8* copyEnd = op + matchLength;
+            for (; op + 8 <= copyEnd; op += 8, match += 8)
+                std::memcpy(op, match, 8);
+
+            while (op < copyEnd)
+                *op++ = *match++;
+        }
+        else
+        {
+            for (u32 i = 0; i < matchLength; i++)
+                op[i] = match[i];
+
+            op += matchLength;
+        }
+    }
+
+    return static_cast<s32>(op - dst);
+}
+
+class BlockJob : public Job
+{
+public:
+    BlockJob()
+        : Job()
+        , mDst(nullptr)
+        , mDstSize(0)
+        , mHistory(nullptr)
+        , mSrc(nullptr)
+        , mSrcSize(0)
+        , mIsRaw(false)
+        , mResult(0)
+    {
+    }
+
+    void setSrc(const u8* src, u32 srcSize, bool isRaw)
+    {
+        mSrc = src;
+        mSrcSize = srcSize;
+        mIsRaw = isRaw;
+    }
+
+    void setDst(u8* dst, u32 dstSize, const u8* history)
+    {
+        mDst = dst;
+        mDstSize = dstSize;
+        mHistory = history;
+    }
+
+    void invoke() override
+    {
+        if (!mIsRaw)
+        {
+            mResult = DecodeBlock(mDst, mDstSize, mHistory, mSrc, mSrcSize);
+        }
+        else if (mSrcSize <= mDstSize)
+        {
+            std::memcpy(mDst, mSrc, mSrcSize);
+            mResult = static_cast<s32>(mSrcSize);
+        }
+        else
+        {
+            mResult = LZ4Decompressor::cErrorInvalidData;
+        }
+    }
+
+    u8* getDst() const { return mDst; }
+    s32 getResult() const { return mResult; }
+
+private:
+    u8* mDst;
+    u32 mDstSize;
+    const u8* mHistory;
+    const u8* mSrc;
+    u32 mSrcSize;
+    bool mIsRaw;
+    s32 mResult;
+};
+
+bool ReadExact(FileHandle* handle, u8* buf, u32 size, u32* restSize)
+{
+    if (size > *restSize)
+        return false;
+
+    u32 readSize = 0;
+    if (!handle->tryRead(&readSize, buf, size) || readSize != size)
+        return false;
+
+    *restSize -= size;
+    return true;
+}
+
+} // namespace
+
+LZ4Decompressor::LZ4Decompressor(u32 workSize, u8* workBuffer)
+    : Decompressor("lz4")
+    , mWorkSize(workSize)
+    , mWorkBuffer(workBuffer)
+    , mWorkBufferCS()
+    , mJobQueue(nullptr)
+    , mBatchNumMax(cDefaultBatchNumMax)
+    , mTotalDecompSize()
+    , mTotalDecompTick()
+{
+}
+
+u8* LZ4Decompressor::tryDecompFromDevice(const ResourceMgr::LoadArg& arg, Resource* res, u32* outSize, u32* outBufferSize, bool* outNeedDelete)
+{
+    TickTime startTime;
+
+    FileHandle handle;
+    if (!tryOpen_(&handle, arg))
+        return nullptr;
+
+    u32 restSize = 0;
+    if (!handle.tryGetFileSize(&restSize))
+        return nullptr;
+
+    u8 header[cFrameHeaderSizeMax];
+    FrameInfo info;
+    if (!ReadExact(&handle, header, cFrameHeaderSizeMin, &restSize) ||
+        !ReadExact(&handle, header + cFrameHeaderSizeMin, CalcFrameHeaderSize(header[4]) - cFrameHeaderSizeMin, &restSize) ||
+        !parseFrameHeader(&info, header, cFrameHeaderSizeMax))
+    {
+        SEAD_WARNING("not a supported LZ4 frame.[%s]", arg.path.cstr());
+        return nullptr;
+    }
+
+    if (!info.hasContentSize || info.contentSize == 0 || info.contentSize > cBlockSizeMask)
+    {
+        SEAD_WARNING("LZ4 frame has no usable content size, compress with --content-size.[%s]", arg.path.cstr());
+        return nullptr;
+    }
+
+    u32 decompSize = static_cast<u32>(info.contentSize);
+
+    u32 bufferSize = 0;
+    bool needDelete = false;
+    u8* dst = tryAllocLoadData_(&bufferSize, &needDelete, arg, res, decompSize, 0);
+    if (!dst)
+        return nullptr;
+
+    // Room for a batch of blocks with their checksums, a single block unless they are independent and a queue is set
+    s32 batchNum = 1;
+    if (mJobQueue && info.isBlockIndependent)
+    {
+        s32 blockNum = static_cast<s32>((decompSize + info.blockMaxSize - 1) / info.blockMaxSize);
+        batchNum = Mathi::min(Mathi::min(mJobQueue->getWorkerNum() + 1, mBatchNumMax), blockNum);
+        batchNum = Mathi::max(batchNum, 1);
+    }
+
+    // A batch never reads more than what is left of the file, small files do not take a buffer of whole blocks
+    u32 slotSize = info.blockMaxSize + cChecksumSize;
+    u32 workSize = Mathu::max(Mathu::min(slotSize * batchNum, restSize), cChecksumSize);
+
+    u8* work = nullptr;
+    bool isWorkBufferLocked = false;
+
+    // Loads on other threads may be using the work buffer, a load allocates its own when it is busy
+    if (mWorkBuffer && mWorkSize >= workSize && mWorkBufferCS.tryLock())
+    {
+        work = mWorkBuffer;
+        isWorkBufferLocked = true;
+    }
+    else
+    {
+        work = tryAllocWork_(arg, workSize);
+    }
+
+    Heap* heap = arg.load_data_heap ? arg.load_data_heap : HeapMgr::instance()->getCurrentHeap();
+    BlockJob* jobs = work ? new(heap, -static_cast<s32>(alignof(BlockJob)), std::nothrow) BlockJob[batchNum] : nullptr;
+
+    s32 result = jobs ? 0 : cErrorInvalidData;
+    u32 dstPos = 0;
+    bool isEnd = false;
+
+    while (result >= 0 && !isEnd)
+    {
+        s32 jobNum = 0;
+        u32 workPos = 0;
+
+        for (; jobNum < batchNum; jobNum++)
+        {
+            u8 sizeBuf[4];
+            if (!ReadExact(&handle, sizeBuf, sizeof(sizeBuf), &restSize))
+            {
+                result = cErrorInvalidData;
+                break;
+            }
+
+            u32 blockSize = ReadU32LE(sizeBuf);
+            if (blockSize == 0)
+            {
+                isEnd = true;
+                break;
+            }
+
+            u32 srcSize = blockSize & cBlockSizeMask;
+            u32 readSize = srcSize + (info.hasBlockChecksum ? cChecksumSize : 0);
+            if (srcSize > info.blockMaxSize || !ReadExact(&handle, work + workPos, readSize, &restSize))
+            {
+                result = cErrorInvalidData;
+                break;
+            }
+
+            // Placed as if every block before it in the batch is full, which is how encoders write them
+            u32 blockPos = Mathu::min(dstPos + info.blockMaxSize * jobNum, decompSize);
+            u8* blockDst = dst + blockPos;
+
+            jobs[jobNum].setSrc(work + workPos, srcSize, (blockSize & cBlockRawFlag) != 0);
+            jobs[jobNum].setDst(blockDst, Mathu::min(info.blockMaxSize, decompSize - blockPos), info.isBlockIndependent ? blockDst : dst);
+            workPos += readSize;
+        }
+
+        if (result < 0)
+            break;
+
+        if (jobNum > 1)
+        {
+            JobCounter counter;
+            for (s32 i = 1; i < jobNum; i++)
+                mJobQueue->enqueue(&jobs[i], &counter);
+
+            jobs[0].invoke();
+            mJobQueue->wait(&counter);
+        }
+        else if (jobNum == 1)
+        {
+            jobs[0].invoke();
+        }
+
+        // A block after a shorter one was decoded at the wrong place, it is decoded again where it belongs
+        for (s32 i = 0; i < jobNum; i++)
+        {
+            if (jobs[i].getDst() != dst + dstPos)
+            {
+                jobs[i].setDst(dst + dstPos, decompSize - dstPos, dst + dstPos);
+                jobs[i].invoke();
+            }
+
+            result = jobs[i].getResult();
+            if (result < 0)
+                break;
+
+            dstPos += static_cast<u32>(result);
+        }
+    }
+
+    if (result >= 0 && dstPos != decompSize)
+    {
+        SEAD_WARNING("LZ4 frame decoded to %u bytes instead of %u.[%s]", dstPos, decompSize, arg.path.cstr());
+        result = cErrorInvalidData;
+    }
+
+    delete[] jobs;
+
+    if (isWorkBufferLocked)
+        mWorkBufferCS.unlock();
+    else
+        delete[] work;
+
+    if (result < 0 || !handle.tryClose())
+    {
+        if (result < 0)
+            SEAD_WARNING("broken LZ4 data, error %d.[%s]", result, arg.path.cstr());
+
+        if (needDelete)
+            delete[] dst;
+
+        return nullptr;
+    }
+
+    mTotalDecompSize.add(static_cast<s64>(decompSize));
+    mTotalDecompTick.add(startTime.diffToNow().toS64());
+
+    if (outSize)
+        *outSize = decompSize;
+
+    if (outBufferSize)
+        *outBufferSize = bufferSize;
+
+    if (outNeedDelete)
+        *outNeedDelete = needDelete;
+
+    return dst;
+}
+
+f64 LZ4Decompressor::calcThroughput() const
+{
+    s64 nsec = getTotalDecompTime().toNanoSeconds();
+    if (nsec <= 0)
+        return 0.0;
+
+    return static_cast<f64>(getTotalDecompSize()) * 1000000000.0 / static_cast<f64>(nsec);
+}
+
+void LZ4Decompressor::resetStats()
+{
+    mTotalDecompSize.setValue(0);
+    mTotalDecompTick.setValue(0);
+}
+
+bool LZ4Decompressor::parseFrameHeader(FrameInfo* info, const void* src, u32 srcSize)
+{
+    SEAD_ASSERT(info);
+
+    const u8* header = static_cast<const u8*>(src);
+    if (srcSize < cFrameHeaderSizeMin || ReadU32LE(header) != cMagic)
+        return false;
+
+    u8 flg = header[4];
+    u8 bd = header[5];
+
+    // Version 01, no reserved bits and no dictionary
+    if ((flg & 0xC0) != 0x40 || (flg & 0x03) != 0 || (bd & 0x8F) != 0)
+        return false;
+
+    u32 headerSize = CalcFrameHeaderSize(flg);
+    if (srcSize < headerSize)
+        return false;
+
+    u32 blockMaxId = bd >> 4 & 0x7;
+    if (blockMaxId < 4)
+        return false;
+
+    // 64 KB, 256 KB, 1 MB and 4 MB
+    info->blockMaxSize = 1u << (2 * blockMaxId + 8);
+    info->headerSize = headerSize;
+    info->isBlockIndependent = (flg & 0x20) != 0;
+    info->hasBlockChecksum = (flg & 0x10) != 0;
+    info->hasContentSize = (flg & 0x08) != 0;
+    info->hasContentChecksum = (flg & 0x04) != 0;
+    info->contentSize = info->hasContentSize ? ReadU64LE(header + 6) : 0;
+
+    return true;
+}
+
+s32 LZ4Decompressor::decompBlock(void* dst, u32 dstSize, const void* src, u32 srcSize)
+{
+    u8* dstU8 = static_cast<u8*>(dst);
+    return DecodeBlock(dstU8, dstSize, dstU8, static_cast<const u8*>(src), srcSize);
+}
+
+s32 LZ4Decompressor::decomp(void* dst, u32 dstSize, const void* src, u32 srcSize)
+{
+    FrameInfo info;
+    if (!parseFrameHeader(&info, src, srcSize))
+        return cErrorInvalidHeader;
+
+    const u8* ip = static_cast<const u8*>(src) + info.headerSize;
+    const u8* ipEnd = static_cast<const u8*>(src) + srcSize;
+    u8* dstU8 = static_cast<u8*>(dst);
+    u32 dstPos = 0;
+
+    while (true)
+    {
+        if (ipEnd - ip < 4)
+            return cErrorInvalidData;
+
+        u32 blockSize = ReadU32LE(ip);
+        ip += 4;
+
+        if (blockSize == 0)
+            break;
+
+        u32 size = blockSize & cBlockSizeMask;
+        u32 checksumSize = info.hasBlockChecksum ? cChecksumSize : 0;
+        if (size > info.blockMaxSize || size + checksumSize > static_cast<u32>(ipEnd - ip))
+            return cErrorInvalidData;
+
+        BlockJob job;
+        job.setSrc(ip, size, (blockSize & cBlockRawFlag) != 0);
+        job.setDst(dstU8 + dstPos, dstSize - dstPos, info.isBlockIndependent ? dstU8 + dstPos : dstU8);
+        job.invoke();
+
+        if (job.getResult() < 0)
+            return job.getResult();
+
+        dstPos += static_cast<u32>(job.getResult());
+        ip += size + checksumSize;
+    }
+
+    if (info.hasContentSize && info.contentSize != dstPos)
+        return cErrorInvalidData;
+
+    return static_cast<s32>(dstPos);
+}
+
+} // namespace sead
@@ -22,6 +22,7 @@ DirectResource::DirectResource()
     , mRawSize(0)
     , mBufferSize(0)
     , mSettingFlag()
+    , mMapDevice(nullptr)
 {
 }
 
@@ -31,6 +32,10 @@ DirectResource::~DirectResource()
     {
         delete[] mRawData;
     }
+    else if (mMapDevice)
+    {
+        mMapDevice->unmap(mRawData, mRawSize);
+    }
 }
 
 void DirectResource::create(u8* data, u32 size, u32 bufferSize, bool needDelete, Heap* instanceHeap)
@@ -48,6 +53,22 @@ void DirectResource::create(u8* data, u32 size, u32 bufferSize, bool needDelete,
     doCreate_(data, size, instanceHeap);
 }
 
+void DirectResource::createOnMap(u8* data, u32 size, u32 bufferSize, FileDevice* mapDevice, Heap* instanceHeap)
+{
+    if (mRawData)
+    {
+        SEAD_ASSERT_MSG(false, "read twice");
+        return;
+    }
+
+    mRawData = data;
+    mRawSize = size;
+    mBufferSize = bufferSize;
+    mSettingFlag.resetBit(SettingFlag::eNeedDelete);
+    mMapDevice = mapDevice;
+    doCreate_(data, size, instanceHeap);
+}
+
 IndirectResource::IndirectResource()
     : Resource()
 {
@@ -91,6 +112,7 @@ Resource* DirectResourceFactoryBase::tryCreate(const ResourceMgr::LoadArg& arg)
     fdArg.div_size = arg.div_size;
     fdArg.enable_alloc_assert = arg.enable_alloc_assert;
     fdArg.buffer_size_alignment = arg.load_data_buffer_size_alignment;
+    fdArg.use_map = arg.use_map;
 
     if (arg.load_data_alignment != 0)
     {
@@ -117,7 +139,11 @@ Resource* DirectResourceFactoryBase::tryCreate(const ResourceMgr::LoadArg& arg)
         return nullptr;
     }
 
-    res->create(data, fdArg.read_size, fdArg.roundup_size, fdArg.need_unload, arg.instance_heap);
+    if (fdArg.map_device)
+        res->createOnMap(data, fdArg.read_size, fdArg.roundup_size, fdArg.map_device, arg.instance_heap);
+    else
+        res->create(data, fdArg.read_size, fdArg.roundup_size, fdArg.need_unload, arg.instance_heap);
+
     return res;
 }
 
@@ -190,8 +216,15 @@ Resource* IndirectResourceFactoryBase::tryCreate(const ResourceMgr::LoadArg& arg
         return nullptr;
     }
 
+    u32 fileSize = 0;
+    if (!handle.tryGetFileSize(&fileSize))
+    {
+        delete res;
+        return nullptr;
+    }
+
     FileDeviceReadStream stream(&handle, Stream::Modes::eBinary);
-    res->create(&stream, handle.getFileSize(), arg.instance_heap);
+    res->create(&stream, fileSize, arg.instance_heap);
 
     bool success = handle.tryClose();
     if (!success)
@@ -225,7 +258,9 @@ Resource* IndirectResourceFactoryBase::tryCreateWithDecomp(const ResourceMgr::Lo
 
     RamReadStream stream(data, size, Stream::Modes::eBinary);
     res->create(&stream, size, arg.instance_heap);
-    delete[] data;
+
+    if (needDelete)
+        delete[] data;
 
     return res;
 }
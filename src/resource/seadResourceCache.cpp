@@ -0,0 +1,543 @@
+#include <resource/seadResourceCache.h>
+
+#include <basis/seadWarning.h>
+#include <codec/seadHashCRC32.h>
+#include <filedevice/seadPath.h>
+#include <heap/seadHeap.h>
+#include <heap/seadHeapMgr.h>
+#include <hostio/seadHostIOContext.h>
+#include <hostio/seadHostIOEvent.h>
+#include <hostio/seadHostIOFramework.h>
+#include <hostio/seadHostIOMgr.h>
+#include <hostio/seadHostIORoot.h>
+#include <prim/seadScopedLock.h>
+#include <resource/seadResource.h>
+
+#include <cstring>
+
+namespace sead {
+
+namespace {
+
+Heap* GetInstanceHeap(const ResourceMgr::LoadArg& arg)
+{
+    if (arg.instance_heap)
+        return arg.instance_heap;
+
+    return HeapMgr::instance()->getCurrentHeap();
+}
+
+size_t CalcResourceSize(Resource* resource)
+{
+    // Mapped files do not take up heap memory
+    DirectResource* direct = DynamicCast<DirectResource>(resource);
+    if (direct && !direct->isMapped())
+        return direct->getBufferSize();
+
+    return 0;
+}
+
+} // namespace
+
+u32 ResourceCache::KeyTraits::calcHash(const Key& key)
+{
+    HashCRC32::Context context;
+    HashCRC32::calcHashWithContext(&context, &key.factory, sizeof(key.factory));
+    HashCRC32::calcHashWithContext(&context, &key.device, sizeof(key.device));
+    HashCRC32::calcHashWithContext(&context, &key.decomp, sizeof(key.decomp));
+    HashCRC32::calcHashWithContext(&context, &key.instanceHeap, sizeof(key.instanceHeap));
+    HashCRC32::calcHashWithContext(&context, &key.loadDataHeap, sizeof(key.loadDataHeap));
+    HashCRC32::calcHashWithContext(&context, &key.loadDataAlignment, sizeof(key.loadDataAlignment));
+    return HashCRC32::calcStringHashWithContext(&context, key.path);
+}
+
+bool ResourceCache::KeyTraits::isEqual(const Key& key, const Key& arg)
+{
+    return key.factory == arg.factory && key.device == arg.device && key.decomp == arg.decomp &&
+           key.instanceHeap == arg.instanceHeap && key.loadDataHeap == arg.loadDataHeap &&
+           key.loadDataAlignment == arg.loadDataAlignment && std::strcmp(key.path, arg.path) == 0;
+}
+
+ResourceCache::Key ResourceCache::Entry::getKey() const
+{
+    Key key;
+    key.path = path.cstr();
+    key.factory = factory;
+    key.device = device;
+    key.decomp = decomp;
+    key.instanceHeap = budget->heap;
+    key.loadDataHeap = loadDataHeap;
+    key.loadDataAlignment = loadDataAlignment;
+    return key;
+}
+
+ResourceCache::HeapDisposer::HeapDisposer(ResourceCache* cache, Heap* heap)
+    : IDisposer(heap, HeapNullOption::eNotAllow)
+    , mCache(cache)
+    , mHeap(heap)
+{
+}
+
+ResourceCache::HeapDisposer::~HeapDisposer()
+{
+    // Null when the budget was removed before the heap got destroyed
+    if (!mCache)
+        return;
+
+    ScopedLock<CriticalSection> lock(&mCache->mCS);
+
+    HeapBudget* budget = mCache->findBudget_(mHeap);
+    if (budget)
+    {
+        budget->disposer = nullptr;
+        mCache->removeBudget_(budget);
+    }
+}
+
+ResourceCache::ResourceCache()
+    : mEntries(nullptr)
+    , mEntryMax(0)
+    , mFreeEntryList()
+    , mEntryMap()
+    , mResourceMap()
+    , mCS()
+    , mHitNum(0)
+    , mMissNum(0)
+    , mEvictNum(0)
+    , mSavedSize(0)
+{
+}
+
+ResourceCache::~ResourceCache()
+{
+    finalize();
+}
+
+void ResourceCache::initialize(Heap* heap, s32 entryMax)
+{
+    if (mEntries)
+    {
+        SEAD_ASSERT_MSG(false, "resource cache already initialized");
+        return;
+    }
+
+    SEAD_ASSERT_MSG(entryMax > 0, "entryMax[%d] must be larger than zero", entryMax);
+
+    mEntries = new(heap) Entry[entryMax];
+    mEntryMax = entryMax;
+
+    for (s32 i = 0; i < entryMax; i++)
+        mFreeEntryList.pushBack(&mEntries[i].listNode);
+
+    mEntryMap.allocBuffer(entryMax, heap);
+    mResourceMap.allocBuffer(entryMax, heap);
+}
+
+void ResourceCache::finalize()
+{
+    if (!mEntries)
+        return;
+
+    {
+        ScopedLock<CriticalSection> lock(&mCS);
+
+        for (s32 i = 0; i < cHeapBudgetMax; i++)
+        {
+            HeapBudget* budget = &mBudgets[i];
+            if (!budget->heap)
+                continue;
+
+            if (budget->disposer)
+            {
+                budget->disposer->mCache = nullptr;
+                delete budget->disposer;
+                budget->disposer = nullptr;
+            }
+
+            removeBudget_(budget);
+        }
+
+        mFreeEntryList.clear();
+        mEntryMap.freeBuffer();
+        mResourceMap.freeBuffer();
+    }
+
+    delete[] mEntries;
+    mEntries = nullptr;
+    mEntryMax = 0;
+}
+
+bool ResourceCache::setBudget(Heap* heap, size_t budget)
+{
+    SEAD_ASSERT_MSG(heap, "heap is null");
+
+    if (!mEntries)
+    {
+        SEAD_ASSERT_MSG(false, "resource cache is not initialized");
+        return false;
+    }
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    HeapBudget* heapBudget = findBudget_(heap);
+
+    if (budget == 0)
+    {
+        if (heapBudget)
+        {
+            if (heapBudget->disposer)
+            {
+                heapBudget->disposer->mCache = nullptr;
+                delete heapBudget->disposer;
+                heapBudget->disposer = nullptr;
+            }
+
+            removeBudget_(heapBudget);
+        }
+
+        return true;
+    }
+
+    if (!heapBudget)
+    {
+        heapBudget = findBudget_(nullptr);
+        if (!heapBudget)
+        {
+            SEAD_WARNING("budgets of more than %d heaps are not supported", cHeapBudgetMax);
+            return false;
+        }
+
+        HeapDisposer* disposer = new(heap, std::nothrow) HeapDisposer(this, heap);
+        if (!disposer)
+            return false;
+
+        heapBudget->heap = heap;
+        heapBudget->disposer = disposer;
+        heapBudget->usedSize = 0;
+    }
+
+    heapBudget->budget = budget;
+    evict_(heapBudget, budget);
+
+    return true;
+}
+
+size_t ResourceCache::getBudget(const Heap* heap) const
+{
+    const HeapBudget* budget = findBudget_(heap);
+    return budget ? budget->budget : 0;
+}
+
+size_t ResourceCache::getUsedSize(const Heap* heap) const
+{
+    const HeapBudget* budget = findBudget_(heap);
+    return budget ? budget->usedSize : 0;
+}
+
+void ResourceCache::purge()
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    for (s32 i = 0; i < cHeapBudgetMax; i++)
+    {
+        if (mBudgets[i].heap)
+            evict_(&mBudgets[i], 0);
+    }
+}
+
+f32 ResourceCache::calcHitRate() const
+{
+    u64 total = mHitNum + mMissNum;
+    if (total == 0)
+        return 0.0f;
+
+    return static_cast<f32>(mHitNum) / static_cast<f32>(total);
+}
+
+void ResourceCache::resetStats()
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    mHitNum = 0;
+    mMissNum = 0;
+    mEvictNum = 0;
+    mSavedSize = 0;
+}
+
+void ResourceCache::initHostIO()
+{
+#if defined(SEAD_TARGET_DEBUG)
+    hostio::AddNode(HostIOMgr::instance()->getSeadRoot(), "ResourceCache", this, "");
+#endif // SEAD_TARGET_DEBUG
+}
+
+#if defined(SEAD_TARGET_DEBUG)
+void ResourceCache::listenPropertyEvent(const hostio::PropertyEvent* ev)
+{
+    switch (ev->id)
+    {
+        case 'rsst':
+            resetStats();
+            break;
+
+        case 'prge':
+            purge();
+            break;
+    }
+}
+
+void ResourceCache::genMessage(hostio::Context* context)
+{
+    context->genButton("Reset statistics", 'rsst', "", nullptr);
+    context->genButton("Purge unused resources", 'prge', "", nullptr);
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    context->genLabel(FormatFixedSafeString<64>("Entries: %d / %d", mEntryMap.size(), mEntryMax), 0, "");
+    context->genLabel(FormatFixedSafeString<64>("Hit: %llu", mHitNum), 0, "");
+    context->genLabel(FormatFixedSafeString<64>("Miss: %llu", mMissNum), 0, "");
+    context->genLabel(FormatFixedSafeString<64>("Hit rate: %.1f%%", calcHitRate() * 100.0f), 0, "");
+    context->genLabel(FormatFixedSafeString<64>("Saved: %llu bytes", mSavedSize), 0, "");
+    context->genLabel(FormatFixedSafeString<64>("Evicted: %llu", mEvictNum), 0, "");
+
+    for (s32 i = 0; i < cHeapBudgetMax; i++)
+    {
+        const HeapBudget& budget = mBudgets[i];
+        if (!budget.heap)
+            continue;
+
+        context->genLabel(FormatFixedSafeString<128>("%s: %zu / %zu bytes, %d unused", budget.heap->getName().cstr(), budget.usedSize,
+                                                     budget.budget, budget.lruList.size()),
+                          0, "");
+    }
+}
+#endif // SEAD_TARGET_DEBUG
+
+Resource* ResourceCache::tryObtain_(const ResourceMgr::LoadArg& arg, ResourceFactory* factory, Decompressor* decomp)
+{
+    FixedSafeString<cPathBufferSize> path;
+    Key key;
+    if (!makeKey_(&key, &path, arg, factory, decomp))
+        return nullptr;
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    if (!findBudget_(key.instanceHeap))
+        return nullptr;
+
+    Entry** found = mEntryMap.find(key);
+    if (!found)
+    {
+        mMissNum++;
+        return nullptr;
+    }
+
+    Entry* entry = *found;
+    if (entry->refCount == 0)
+        entry->budget->lruList.erase(&entry->listNode);
+
+    entry->refCount++;
+
+    mHitNum++;
+    mSavedSize += entry->size;
+
+    return entry->resource;
+}
+
+Resource* ResourceCache::add_(const ResourceMgr::LoadArg& arg, ResourceFactory* factory, Decompressor* decomp,
+                             Resource* resource)
+{
+    FixedSafeString<cPathBufferSize> path;
+    Key key;
+    if (!makeKey_(&key, &path, arg, factory, decomp))
+        return resource;
+
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    HeapBudget* budget = findBudget_(key.instanceHeap);
+    if (!budget)
+        return resource;
+
+    // Another load of the same file finished first, its resource is shared instead
+    Entry** found = mEntryMap.find(key);
+    if (found)
+    {
+        Entry* entry = *found;
+        if (entry->refCount == 0)
+            entry->budget->lruList.erase(&entry->listNode);
+
+        entry->refCount++;
+
+        delete resource;
+        return entry->resource;
+    }
+
+    if (mFreeEntryList.isEmpty())
+    {
+        TListNode<Entry*>* oldest = budget->lruList.front();
+        if (!oldest)
+            return resource;
+
+        Resource* evicted = oldest->val()->resource;
+        removeEntry_(oldest->val());
+        delete evicted;
+        mEvictNum++;
+    }
+
+    Entry* entry = mFreeEntryList.popFront()->val();
+    entry->path.copy(path);
+    entry->factory = factory;
+    entry->device = arg.device;
+    entry->decomp = decomp;
+    entry->loadDataHeap = arg.load_data_heap;
+    entry->loadDataAlignment = arg.load_data_alignment;
+    entry->resource = resource;
+    entry->budget = budget;
+    entry->refCount = 1;
+    entry->size = CalcResourceSize(resource);
+
+    mEntryMap.insert(entry->getKey(), entry);
+    mResourceMap.insert(resource, entry);
+
+    budget->usedSize += entry->size;
+    evict_(budget, budget->budget);
+
+    return resource;
+}
+
+bool ResourceCache::release_(Resource* resource)
+{
+    ScopedLock<CriticalSection> lock(&mCS);
+
+    if (!mResourceMap.isBufferReady())
+        return false;
+
+    Entry** found = mResourceMap.find(resource);
+    if (!found)
+        return false;
+
+    Entry* entry = *found;
+    SEAD_ASSERT_MSG(entry->refCount > 0, "resource[%s] released too many times", entry->path.cstr());
+
+    entry->refCount--;
+    if (entry->refCount == 0)
+    {
+        entry->budget->lruList.pushBack(&entry->listNode);
+        evict_(entry->budget, entry->budget->budget);
+    }
+
+    return true;
+}
+
+bool ResourceCache::makeKey_(Key* key, BufferedSafeString* path, const ResourceMgr::LoadArg& arg, ResourceFactory* factory,
+                             Decompressor* decomp) const
+{
+    if (!mEntries)
+        return false;
+
+    // Data loaded into a buffer of the caller is not shared
+    if (arg.load_data_buffer)
+        return false;
+
+    Path::normalize(path, arg.path);
+
+    // Longer paths may have been cut off and could collide
+    if (path->calcLength() >= path->getBufferSize() - 1)
+        return false;
+
+    key->path = path->cstr();
+    key->factory = factory;
+    key->device = arg.device;
+    // Resources live in their instance heap, so loads into another heap never share them
+    key->decomp = decomp;
+    key->instanceHeap = GetInstanceHeap(arg);
+    key->loadDataHeap = arg.load_data_heap;
+    key->loadDataAlignment = arg.load_data_alignment;
+    return true;
+}
+
+ResourceCache::HeapBudget* ResourceCache::findBudget_(const Heap* heap)
+{
+    for (s32 i = 0; i < cHeapBudgetMax; i++)
+    {
+        if (mBudgets[i].heap == heap)
+            return &mBudgets[i];
+    }
+
+    return nullptr;
+}
+
+const ResourceCache::HeapBudget* ResourceCache::findBudget_(const Heap* heap) const
+{
+    for (s32 i = 0; i < cHeapBudgetMax; i++)
+    {
+        if (mBudgets[i].heap == heap)
+            return &mBudgets[i];
+    }
+
+    return nullptr;
+}
+
+void ResourceCache::evict_(HeapBudget* budget, size_t limit)
+{
+    while (budget->usedSize > limit && !budget->lruList.isEmpty())
+    {
+        Entry* entry = budget->lruList.front()->val();
+        Resource* resource = entry->resource;
+
+        removeEntry_(entry);
+        delete resource;
+
+        mEvictNum++;
+    }
+}
+
+void ResourceCache::removeBudget_(HeapBudget* budget)
+{
+    for (s32 i = 0; i < mEntryMax; i++)
+    {
+        Entry* entry = &mEntries[i];
+        if (entry->budget != budget)
+            continue;
+
+        // Referenced resources are unloaded by their owners with ResourceMgr::unload() as if never cached
+        Resource* resource = entry->resource;
+        bool isUnused = entry->refCount == 0;
+
+        removeEntry_(entry);
+
+        if (isUnused)
+            delete resource;
+    }
+
+    budget->heap = nullptr;
+    budget->budget = 0;
+    budget->usedSize = 0;
+}
+
+void ResourceCache::removeEntry_(Entry* entry)
+{
+    mEntryMap.erase(entry->getKey());
+    mResourceMap.erase(entry->resource);
+
+    // Unreferenced entries wait in the lru list on the same node that goes back to the free list
+    if (entry->refCount == 0)
+        entry->budget->lruList.erase(&entry->listNode);
+
+    entry->budget->usedSize -= entry->size;
+
+    entry->path.clear();
+    entry->factory = nullptr;
+    entry->device = nullptr;
+    entry->decomp = nullptr;
+    entry->loadDataHeap = nullptr;
+    entry->loadDataAlignment = 0;
+    entry->resource = nullptr;
+    entry->budget = nullptr;
+    entry->refCount = 0;
+    entry->size = 0;
+
+    mFreeEntryList.pushBack(&entry->listNode);
+}
+
+} // namespace sead
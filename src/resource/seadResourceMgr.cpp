@@ -2,18 +2,51 @@
 
 #include <filedevice/seadPath.h>
 #include <heap/seadHeapMgr.h>
+#include <resource/seadAsyncResourceLoader.h>
 #include <resource/seadDecompressor.h>
 #include <resource/seadResource.h>
+#include <resource/seadResourceCache.h>
 
 namespace sead {
 
 SEAD_SINGLETON_DISPOSER_IMPL(ResourceMgr);
 
+ResourceMgr::LoadArg::LoadArg()
+    : path()
+    , instance_heap(nullptr)
+    , load_data_heap(nullptr)
+    , instance_alignment(0)
+    , load_data_alignment(0)
+    , load_data_buffer(nullptr)
+    , load_data_buffer_size(0)
+    , load_data_buffer_size_alignment(0)
+    , factory(nullptr)
+    , device(nullptr)
+    , div_size(0)
+    , enable_alloc_assert(true)
+    , use_map(false)
+{
+}
+
+ResourceMgr::CreateArg::CreateArg()
+    : buffer(nullptr)
+    , file_size(0)
+    , buffer_size(0)
+    , need_unload(false)
+    , factory(nullptr)
+    , ext()
+    , heap(nullptr)
+    , alignment(0)
+{
+}
+
 ResourceMgr::ResourceMgr()
     : mFactoryList()
     , mDecompList()
     , mNullResourceFactory(nullptr)
     , mDefaultResourceFactory(nullptr)
+    , mAsyncLoader(nullptr)
+    , mCache(nullptr)
 {
     HeapMgr* heapMgr = HeapMgr::instance();
     if (!heapMgr)
@@ -30,6 +63,9 @@ ResourceMgr::ResourceMgr()
 
 ResourceMgr::~ResourceMgr()
 {
+    finalizeAsyncLoader();
+    finalizeCache();
+
     if (mNullResourceFactory)
     {
         delete mNullResourceFactory;
@@ -59,7 +95,7 @@ ResourcePtr ResourceMgr::tryLoadWithoutDecomp(const LoadArg& arg)
         }
     }
 
-    return factory->tryCreate(arg);
+    return tryCreate_(arg, factory, nullptr);
 }
 
 ResourcePtr ResourceMgr::tryLoad(const LoadArg& arg, const SafeString& convertExt, Decompressor* decomp)
@@ -99,18 +135,14 @@ ResourcePtr ResourceMgr::tryLoad(const LoadArg& arg, const SafeString& convertEx
         SEAD_ASSERT(factory);
     }
 
-    if (decomp)
-    {
-        return factory->tryCreateWithDecomp(arg, decomp);
-    }
-    else
-    {
-        return factory->tryCreate(arg);
-    }
+    return tryCreate_(arg, factory, decomp);
 }
 
 void ResourceMgr::unload(Resource* resource)
 {
+    if (mCache && mCache->release_(resource))
+        return;
+
     delete resource;
 }
 
@@ -214,4 +246,71 @@ ResourcePtr ResourceMgr::create(const CreateArg& arg)
     return nullptr;
 }
 
+void ResourceMgr::initializeAsyncLoader(Heap* heap, s32 threadNum)
+{
+    if (mAsyncLoader)
+    {
+        SEAD_ASSERT_MSG(false, "async loader already initialized");
+        return;
+    }
+
+    mAsyncLoader = new(heap) AsyncResourceLoader();
+    mAsyncLoader->initialize(heap, threadNum);
+}
+
+void ResourceMgr::finalizeAsyncLoader()
+{
+    if (mAsyncLoader)
+    {
+        delete mAsyncLoader;
+        mAsyncLoader = nullptr;
+    }
+}
+
+void ResourceMgr::initializeCache(Heap* heap, s32 entryMax)
+{
+    if (mCache)
+    {
+        SEAD_ASSERT_MSG(false, "resource cache already initialized");
+        return;
+    }
+
+    mCache = new(heap) ResourceCache();
+    mCache->initialize(heap, entryMax);
+}
+
+void ResourceMgr::finalizeCache()
+{
+    if (mCache)
+    {
+        delete mCache;
+        mCache = nullptr;
+    }
+}
+
+Resource* ResourceMgr::tryCreate_(const LoadArg& arg, ResourceFactory* factory, Decompressor* decomp)
+{
+    if (mCache)
+    {
+        Resource* cached = mCache->tryObtain_(arg, factory, decomp);
+        if (cached)
+            return cached;
+    }
+
+    Resource* resource;
+    if (decomp)
+    {
+        resource = factory->tryCreateWithDecomp(arg, decomp);
+    }
+    else
+    {
+        resource = factory->tryCreate(arg);
+    }
+
+    if (resource && mCache)
+        resource = mCache->add_(arg, factory, decomp, resource);
+
+    return resource;
+}
+
 } // namespace sead
@@ -0,0 +1,322 @@
+#include <resource/seadSZSDecompressor.h>
+
+#include <filedevice/seadFileDevice.h>
+#include <math/seadMathCalcCommon.h>
+#include <prim/seadEndian.h>
+
+#include <cstring>
+
+namespace sead {
+
+namespace {
+
+bool IsYaz0(const u8* header)
+{
+    return header[0] == 'Y' && header[1] == 'a' && header[2] == 'z' && header[3] == '0';
+}
+
+u32 ReadU32BE(const u8* src)
+{
+    u32 value;
+    std::memcpy(&value, src, sizeof(u32));
+    return Endian::toHostU32(Endian::eBig, value);
+}
+
+} // namespace
+
+SZSDecompressor::DecompContext::DecompContext()
+{
+    initialize(nullptr);
+}
+
+SZSDecompressor::DecompContext::DecompContext(void* dst)
+{
+    initialize(dst);
+}
+
+void SZSDecompressor::DecompContext::initialize(void* dst_)
+{
+    dst = static_cast<u8*>(dst_);
+    destSize = 0;
+    destPos = 0;
+    headerSize = 0;
+    flags = 0;
+    flagMask = 0;
+    step = 0;
+    packHigh = 0;
+    packLow = 0;
+}
+
+SZSDecompressor::SZSDecompressor(u32 workSize, u8* workBuffer)
+    : Decompressor("szs")
+    , mWorkSize(workSize)
+    , mWorkBuffer(workBuffer)
+    , mWorkBufferCS()
+{
+    SEAD_ASSERT_MSG(workSize >= cHeaderSize, "workSize[%u] is smaller than the header", workSize);
+}
+
+u8* SZSDecompressor::tryDecompFromDevice(const ResourceMgr::LoadArg& arg, Resource* res, u32* outSize, u32* outBufferSize, bool* outNeedDelete)
+{
+    FileHandle handle;
+    if (!tryOpen_(&handle, arg))
+        return nullptr;
+
+    u32 fileSize = 0;
+    if (!handle.tryGetFileSize(&fileSize))
+        return nullptr;
+
+    u8 header[cHeaderSize];
+    u32 readSize = 0;
+    if (fileSize < cHeaderSize || !handle.tryRead(&readSize, header, cHeaderSize) || !IsYaz0(header))
+    {
+        SEAD_WARNING("not a Yaz0 file.[%s]", arg.path.cstr());
+        return nullptr;
+    }
+
+    u32 decompSize = getDecompSize(header);
+    if (decompSize == 0)
+    {
+        SEAD_WARNING("decompressed size is zero.[%s]", arg.path.cstr());
+        return nullptr;
+    }
+
+    u32 bufferSize = 0;
+    bool needDelete = false;
+    u8* dst = tryAllocLoadData_(&bufferSize, &needDelete, arg, res, decompSize, getDecompAlignment(header));
+    if (!dst)
+        return nullptr;
+
+    u8* work = nullptr;
+    bool isWorkBufferLocked = false;
+
+    // Loads on other threads may be using the work buffer, a load allocates its own when it is busy
+    if (mWorkBuffer && mWorkBufferCS.tryLock())
+    {
+        work = mWorkBuffer;
+        isWorkBufferLocked = true;
+    }
+    else
+    {
+        work = tryAllocWork_(arg, mWorkSize);
+        if (!work)
+        {
+            if (needDelete)
+                delete[] dst;
+
+            return nullptr;
+        }
+    }
+
+    u32 chunkSize = mWorkSize;
+    if (arg.div_size != 0)
+        chunkSize = Mathu::min(arg.div_size, mWorkSize);
+
+    DecompContext context(dst);
+    s32 result = streamDecomp(&context, header, cHeaderSize);
+    u32 restSize = fileSize - cHeaderSize;
+
+    while (result > 0)
+    {
+        if (restSize == 0)
+        {
+            SEAD_WARNING("file ended %d bytes before the end of the data.[%s]", result, arg.path.cstr());
+            result = cErrorInvalidData;
+            break;
+        }
+
+        u32 size = Mathu::min(chunkSize, restSize);
+        if (!handle.tryRead(&readSize, work, size))
+        {
+            result = cErrorInvalidData;
+            break;
+        }
+
+        restSize -= size;
+        result = streamDecomp(&context, work, readSize);
+    }
+
+    if (isWorkBufferLocked)
+        mWorkBufferCS.unlock();
+    else
+        delete[] work;
+
+    if (result < 0 || !handle.tryClose())
+    {
+        if (result < 0)
+            SEAD_WARNING("broken Yaz0 data, error %d.[%s]", result, arg.path.cstr());
+
+        if (needDelete)
+            delete[] dst;
+
+        return nullptr;
+    }
+
+    if (outSize)
+        *outSize = decompSize;
+
+    if (outBufferSize)
+        *outBufferSize = bufferSize;
+
+    if (outNeedDelete)
+        *outNeedDelete = needDelete;
+
+    return dst;
+}
+
+u32 SZSDecompressor::getDecompSize(const void* src)
+{
+    const u8* header = static_cast<const u8*>(src);
+    if (!IsYaz0(header))
+        return 0;
+
+    return ReadU32BE(header + 4);
+}
+
+u32 SZSDecompressor::getDecompAlignment(const void* src)
+{
+    const u8* header = static_cast<const u8*>(src);
+    if (!IsYaz0(header))
+        return 0;
+
+    return ReadU32BE(header + 8);
+}
+
+s32 SZSDecompressor::streamDecomp(DecompContext* context, const void* src, u32 srcSize)
+{
+    SEAD_ASSERT(context);
+
+    const u8* p = static_cast<const u8*>(src);
+    const u8* end = p + srcSize;
+
+    if (context->headerSize < cHeaderSize)
+    {
+        u32 copySize = Mathu::min(cHeaderSize - context->headerSize, srcSize);
+        std::memcpy(context->header + context->headerSize, p, copySize);
+        context->headerSize += copySize;
+        p += copySize;
+
+        // The size is not known yet, so the header bytes missing stand in for it
+        if (context->headerSize < cHeaderSize)
+            return static_cast<s32>(cHeaderSize - context->headerSize);
+
+        if (!IsYaz0(context->header))
+            return cErrorInvalidHeader;
+
+        context->destSize = getDecompSize(context->header);
+        SEAD_ASSERT_MSG(context->dst || context->destSize == 0, "context->dst is null");
+    }
+
+    u8* dst = context->dst;
+    const u32 destSize = context->destSize;
+    u32 destPos = context->destPos;
+    u8 flags = context->flags;
+    u8 flagMask = context->flagMask;
+    u8 step = context->step;
+    u8 packHigh = context->packHigh;
+    u8 packLow = context->packLow;
+
+    while (destPos < destSize && p < end)
+    {
+        if (flagMask == 0)
+        {
+            flags = *p++;
+            flagMask = 0x80;
+            continue;
+        }
+
+        if ((flags & flagMask) != 0)
+        {
+            dst[destPos++] = *p++;
+            flagMask >>= 1;
+            continue;
+        }
+
+        // Back reference of two bytes, or three when the length does not fit in the upper nibble.
+        // The chunk may end in the middle of one, step keeps how far it got.
+        if (step == 0)
+        {
+            packHigh = *p++;
+            step = 1;
+
+            if (p == end)
+                break;
+        }
+
+        if (step == 1)
+        {
+            packLow = *p++;
+            step = 2;
+        }
+
+        u32 length = packHigh >> 4;
+        if (length != 0)
+        {
+            length += 2;
+        }
+        else
+        {
+            if (p == end)
+                break;
+
+            length = *p++ + 0x12u;
+        }
+
+        step = 0;
+        flagMask >>= 1;
+
+        u32 distance = ((packHigh & 0xFu) << 8 | packLow) + 1;
+        if (distance > destPos)
+            return cErrorInvalidData;
+
+        length = Mathu::min(length, destSize - destPos);
+
+        const u8* ref = dst + destPos - distance;
+        u8* out = dst + destPos;
+
+        // A reference closer than its length repeats the bytes it is writing
+        if (distance >= length)
+        {
+            std::memcpy(out, ref, length);
+        }
+        else
+        {
+            for (u32 i = 0; i < length; i++)
+                out[i] = ref[i];
+        }
+
+        destPos += length;
+    }
+
+    context->destPos = destPos;
+    context->flags = flags;
+    context->flagMask = flagMask;
+    context->step = step;
+    context->packHigh = packHigh;
+    context->packLow = packLow;
+
+    return static_cast<s32>(destSize - destPos);
+}
+
+s32 SZSDecompressor::decomp(void* dst, u32 dstSize, const void* src, u32 srcSize)
+{
+    if (srcSize < cHeaderSize)
+        return cErrorInvalidHeader;
+
+    u32 decompSize = getDecompSize(src);
+    if (!IsYaz0(static_cast<const u8*>(src)) || dstSize < decompSize)
+        return cErrorInvalidHeader;
+
+    DecompContext context(dst);
+    s32 result = streamDecomp(&context, src, srcSize);
+    if (result < 0)
+        return result;
+
+    // Data ending before the decompressed size is reached
+    if (result > 0)
+        return cErrorInvalidData;
+
+    return static_cast<s32>(decompSize);
+}
+
+} // namespace sead
@@ -0,0 +1,383 @@
+#include <resource/seadSharcArchiveRes.h>
+
+#include <prim/seadPtrUtil.h>
+
+#include <cstring>
+
+namespace sead {
+
+namespace {
+
+struct DirectoryHandleInner
+{
+    s32 start;
+    s32 end;
+    s32 current;
+    s32 prefixLen;
+};
+
+static_assert(sizeof(DirectoryHandleInner) <= sizeof(HandleBuffer), "DirectoryHandleInner does not fit in HandleBuffer");
+
+DirectoryHandleInner* GetDirectoryHandleInner(HandleBuffer* handle)
+{
+    return reinterpret_cast<DirectoryHandleInner*>(&(*handle)[0]);
+}
+
+bool IsSignature(u32 signature, const char* str)
+{
+    return std::memcmp(&signature, str, sizeof(u32)) == 0;
+}
+
+s32 CompareName(const char* a, const char* b)
+{
+    return std::strcmp(a, b);
+}
+
+} // namespace
+
+SharcArchiveRes::SharcArchiveRes()
+    : ArchiveRes()
+    , mArchiveBlockHeader(nullptr)
+    , mFATBlockHeader(nullptr)
+    , mFATEntries(nullptr)
+    , mFNTBlock(nullptr)
+    , mFNTBlockSize(0)
+    , mDataBlock(nullptr)
+    , mEndianType(Endian::getHostEndian())
+    , mSortedNames()
+{
+}
+
+SharcArchiveRes::~SharcArchiveRes()
+{
+    mSortedNames.freeBuffer();
+}
+
+u32 SharcArchiveRes::calcHash(const SafeString& path, u32 key)
+{
+    u32 hash = 0;
+    for (const char* str = path.cstr(); *str != '\0'; str++)
+        hash = hash * key + static_cast<s8>(*str);
+
+    return hash;
+}
+
+bool SharcArchiveRes::prepareArchive_(const void* archive, u32 size, Heap* heap)
+{
+    SEAD_ASSERT_MSG(PtrUtil::isAligned(archive, 4), "archive must be 4 byte aligned: %p", archive);
+
+    const u8* archiveU8 = static_cast<const u8*>(archive);
+
+    if (size < sizeof(ArchiveBlockHeader))
+    {
+        SEAD_WARNING("archive is smaller than its header: %u", size);
+        return false;
+    }
+
+    mArchiveBlockHeader = static_cast<const ArchiveBlockHeader*>(archive);
+    if (!IsSignature(mArchiveBlockHeader->signature, "SARC"))
+    {
+        SEAD_WARNING("invalid SARC signature");
+        return false;
+    }
+
+    const u8* byteOrder = reinterpret_cast<const u8*>(&mArchiveBlockHeader->byte_order);
+    if (byteOrder[0] == 0xFE && byteOrder[1] == 0xFF)
+        mEndianType = Endian::eBig;
+    else if (byteOrder[0] == 0xFF && byteOrder[1] == 0xFE)
+        mEndianType = Endian::eLittle;
+    else
+    {
+        SEAD_WARNING("invalid byte order mark: 0x%02X 0x%02X", byteOrder[0], byteOrder[1]);
+        return false;
+    }
+
+    u32 headerSize = toHost_(mArchiveBlockHeader->header_size);
+    u32 fileSize = toHost_(mArchiveBlockHeader->file_size);
+    u32 dataBlockOffset = toHost_(mArchiveBlockHeader->data_block_offset);
+
+    if (toHost_(mArchiveBlockHeader->version) != cArchiveVersion)
+    {
+        SEAD_WARNING("unsupported SARC version: 0x%04X", toHost_(mArchiveBlockHeader->version));
+        return false;
+    }
+
+    if (fileSize > size || dataBlockOffset > fileSize || headerSize != sizeof(ArchiveBlockHeader) ||
+        headerSize + sizeof(FATBlockHeader) > dataBlockOffset)
+    {
+        SEAD_WARNING("broken SARC header, size: %u, file size: %u, data offset: %u", size, fileSize, dataBlockOffset);
+        return false;
+    }
+
+    mFATBlockHeader = reinterpret_cast<const FATBlockHeader*>(archiveU8 + headerSize);
+    u32 fileNum = toHost_(mFATBlockHeader->file_num);
+    u32 fatEnd = headerSize + toHost_(mFATBlockHeader->header_size) + fileNum * sizeof(FATEntry);
+
+    if (!IsSignature(mFATBlockHeader->signature, "SFAT") || toHost_(mFATBlockHeader->header_size) != sizeof(FATBlockHeader) ||
+        fatEnd + sizeof(FNTBlockHeader) > dataBlockOffset)
+    {
+        SEAD_WARNING("broken SFAT block");
+        return false;
+    }
+
+    mFATEntries = reinterpret_cast<const FATEntry*>(mFATBlockHeader + 1);
+
+    const FNTBlockHeader* fntBlockHeader = reinterpret_cast<const FNTBlockHeader*>(archiveU8 + fatEnd);
+    if (!IsSignature(fntBlockHeader->signature, "SFNT") || toHost_(fntBlockHeader->header_size) != sizeof(FNTBlockHeader))
+    {
+        SEAD_WARNING("broken SFNT block");
+        return false;
+    }
+
+    mFNTBlock = reinterpret_cast<const char*>(fntBlockHeader + 1);
+    mFNTBlockSize = dataBlockOffset - fatEnd - sizeof(FNTBlockHeader);
+    mDataBlock = archiveU8 + dataBlockOffset;
+
+    u32 dataBlockSize = fileSize - dataBlockOffset;
+    u32 namedNum = 0;
+
+    for (u32 i = 0; i < fileNum; i++)
+    {
+        const FATEntry& entry = mFATEntries[i];
+
+        if (i > 0 && toHost_(entry.hash) < toHost_(mFATEntries[i - 1].hash))
+        {
+            SEAD_WARNING("SFAT entries are not sorted by hash, entry: %u", i);
+            return false;
+        }
+
+        u32 dataStart = toHost_(entry.data_start_offset);
+        u32 dataEnd = toHost_(entry.data_end_offset);
+        if (dataStart > dataEnd || dataEnd > dataBlockSize)
+        {
+            SEAD_WARNING("data of entry %u is out of the archive", i);
+            return false;
+        }
+
+        u32 nameOffset = toHost_(entry.name_offset);
+        if ((nameOffset & 0xFF000000) == 0)
+            continue;
+
+        u32 nameStart = (nameOffset & 0x00FFFFFF) * 4;
+        if (nameStart >= mFNTBlockSize || !std::memchr(mFNTBlock + nameStart, '\0', mFNTBlockSize - nameStart))
+        {
+            SEAD_WARNING("name of entry %u is out of the name table", i);
+            return false;
+        }
+
+        namedNum++;
+    }
+
+    mSortedNames.freeBuffer();
+
+    if (namedNum > 0)
+    {
+        if (!mSortedNames.tryAllocBuffer(static_cast<s32>(namedNum), heap))
+        {
+            SEAD_WARNING("alloc failed for the names of %u files", namedNum);
+            return false;
+        }
+
+        for (u32 i = 0; i < fileNum; i++)
+        {
+            const char* name = getName_(mFATEntries[i]);
+            if (name)
+                mSortedNames.pushBack(const_cast<char*>(name));
+        }
+
+        mSortedNames.heapSort(&CompareName);
+    }
+
+    return true;
+}
+
+void* SharcArchiveRes::getFileImpl_(const SafeString& path, FileInfo* info)
+{
+    s32 entryID = convertPathToEntryIDImpl_(path);
+    if (entryID < 0)
+        return nullptr;
+
+    return getFileFastImpl_(entryID, info);
+}
+
+void* SharcArchiveRes::getFileFastImpl_(s32 entryID, FileInfo* info)
+{
+    if (entryID < 0 || entryID >= getFileNumImpl_())
+        return nullptr;
+
+    const FATEntry& entry = mFATEntries[entryID];
+    u32 dataStart = toHost_(entry.data_start_offset);
+    u32 dataEnd = toHost_(entry.data_end_offset);
+
+    if (info)
+    {
+        info->startOffset = toHost_(mArchiveBlockHeader->data_block_offset) + dataStart;
+        info->length = dataEnd - dataStart;
+    }
+
+    return const_cast<u8*>(mDataBlock + dataStart);
+}
+
+s32 SharcArchiveRes::convertPathToEntryIDImpl_(const SafeString& path)
+{
+    u32 hash = calcHash(path, toHost_(mFATBlockHeader->hash_key));
+
+    s32 low = 0;
+    s32 high = getFileNumImpl_();
+
+    while (low < high)
+    {
+        s32 mid = (low + high) / 2;
+        if (toHost_(mFATEntries[mid].hash) < hash)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    // Files colliding on the hash sit next to each other and are told apart by name
+    for (s32 i = low; i < getFileNumImpl_() && toHost_(mFATEntries[i].hash) == hash; i++)
+    {
+        const char* name = getName_(mFATEntries[i]);
+        if (!name || std::strcmp(name, path.cstr()) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+s32 SharcArchiveRes::getFileNumImpl_() const
+{
+    return toHost_(mFATBlockHeader->file_num);
+}
+
+bool SharcArchiveRes::isExistDirectoryImpl_(const SafeString& path)
+{
+    s32 start, end, prefixLen;
+    return findDirectory_(&start, &end, &prefixLen, path);
+}
+
+bool SharcArchiveRes::openDirectoryImpl_(HandleBuffer* handle, const SafeString& path)
+{
+    DirectoryHandleInner* inner = GetDirectoryHandleInner(handle);
+
+    if (!findDirectory_(&inner->start, &inner->end, &inner->prefixLen, path))
+        return false;
+
+    inner->current = inner->start;
+    return true;
+}
+
+bool SharcArchiveRes::closeDirectoryImpl_(HandleBuffer* handle)
+{
+    SEAD_UNUSED(handle);
+    return true;
+}
+
+u32 SharcArchiveRes::readDirectoryImpl_(HandleBuffer* handle, DirectoryEntry* entries, u32 num)
+{
+    DirectoryHandleInner* inner = GetDirectoryHandleInner(handle);
+
+    u32 readNum = 0;
+    while (readNum < num && inner->current < inner->end)
+    {
+        const char* fullName = mSortedNames.at(inner->current);
+        const char* name = fullName + inner->prefixLen;
+        const char* separator = std::strchr(name, '/');
+
+        DirectoryEntry& entry = entries[readNum];
+
+        if (separator)
+        {
+            // Every name in the subdirectory follows, they are skipped at once
+            s32 nameLen = static_cast<s32>(separator - name);
+            entry.name.copy(SafeString(name), nameLen);
+            entry.is_directory = true;
+            inner->current = findEndName_(fullName, inner->prefixLen + nameLen + 1);
+        }
+        else
+        {
+            entry.name.copy(SafeString(name));
+            entry.is_directory = false;
+            inner->current++;
+        }
+
+        readNum++;
+    }
+
+    return readNum;
+}
+
+const char* SharcArchiveRes::getName_(const FATEntry& entry) const
+{
+    u32 nameOffset = toHost_(entry.name_offset);
+    if ((nameOffset & 0xFF000000) == 0)
+        return nullptr;
+
+    return mFNTBlock + (nameOffset & 0x00FFFFFF) * 4;
+}
+
+s32 SharcArchiveRes::findFirstName_(const char* prefix, s32 prefixLen) const
+{
+    s32 low = 0;
+    s32 high = mSortedNames.size();
+
+    while (low < high)
+    {
+        s32 mid = (low + high) / 2;
+        if (std::strncmp(mSortedNames.at(mid), prefix, prefixLen) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+s32 SharcArchiveRes::findEndName_(const char* prefix, s32 prefixLen) const
+{
+    s32 low = 0;
+    s32 high = mSortedNames.size();
+
+    while (low < high)
+    {
+        s32 mid = (low + high) / 2;
+        if (std::strncmp(mSortedNames.at(mid), prefix, prefixLen) <= 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+bool SharcArchiveRes::findDirectory_(s32* start, s32* end, s32* prefixLen, const SafeString& path) const
+{
+    s32 pathLen = path.calcLength();
+    while (pathLen > 0 && path.cstr()[pathLen - 1] == '/')
+        pathLen--;
+
+    // The root always exists, even when empty
+    if (pathLen == 0)
+    {
+        *start = 0;
+        *end = mSortedNames.size();
+        *prefixLen = 0;
+        return true;
+    }
+
+    FixedSafeString<512> prefix;
+    prefix.copy(path, pathLen);
+    prefix.append('/');
+
+    s32 len = prefix.calcLength();
+    s32 first = findFirstName_(prefix.cstr(), len);
+    if (first >= mSortedNames.size() || std::strncmp(mSortedNames.at(first), prefix.cstr(), len) != 0)
+        return false;
+
+    *start = first;
+    *end = findEndName_(prefix.cstr(), len);
+    *prefixLen = len;
+    return true;
+}
+
+} // namespace sead
@@ -0,0 +1,379 @@
+#include <resource/seadZstdDecompressor.h>
+
+#include <filedevice/seadFileDevice.h>
+#include <heap/seadHeap.h>
+#include <heap/seadHeapMgr.h>
+#include <math/seadMathCalcCommon.h>
+#include <mc/seadJobQueue.h>
+#include <time/seadTickTime.h>
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include <zstd.h>
+
+namespace sead {
+
+namespace {
+
+struct Frame
+{
+    u32 srcSize;
+    u64 contentSize;
+    bool isSkippable;
+};
+
+bool ParseFrame(Frame* frame, const u8* src, u32 srcSize)
+{
+    size_t frameSize = ZSTD_findFrameCompressedSize(src, srcSize);
+    if (ZSTD_isError(frameSize))
+        return false;
+
+    frame->srcSize = static_cast<u32>(frameSize);
+    frame->isSkippable = ZSTD_isSkippableFrame(src, srcSize) != 0;
+    frame->contentSize = 0;
+
+    if (frame->isSkippable)
+        return true;
+
+    unsigned long long contentSize = ZSTD_getFrameContentSize(src, srcSize);
+    if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN || contentSize == ZSTD_CONTENTSIZE_ERROR)
+        return false;
+
+    frame->contentSize = contentSize;
+    return true;
+}
+
+// Counts the frames to decode and sums their content sizes
+bool ScanFrames(s32* frameNum, u64* decompSize, const u8* src, u32 srcSize)
+{
+    *frameNum = 0;
+    *decompSize = 0;
+
+    while (srcSize > 0)
+    {
+        Frame frame;
+        if (!ParseFrame(&frame, src, srcSize))
+            return false;
+
+        if (!frame.isSkippable)
+        {
+            (*frameNum)++;
+            *decompSize += frame.contentSize;
+        }
+
+        src += frame.srcSize;
+        srcSize -= frame.srcSize;
+    }
+
+    return *frameNum > 0;
+}
+
+bool IsFrameStart(const u8* src, u32 srcSize)
+{
+    return ZSTD_getFrameContentSize(src, srcSize) != ZSTD_CONTENTSIZE_ERROR;
+}
+
+// Every context gets a slot of the same size in one work buffer
+u32 CalcContextSize()
+{
+    return Mathu::roundUpPow2(static_cast<u32>(ZSTD_estimateDCtxSize()), FileDevice::cBufferMinAlignment);
+}
+
+class FrameJob : public Job
+{
+public:
+    FrameJob()
+        : Job()
+        , mContext(nullptr)
+        , mDst(nullptr)
+        , mDstSize(0)
+        , mSrc(nullptr)
+        , mSrcSize(0)
+        , mResult(0)
+    {
+    }
+
+    void setContext(ZSTD_DCtx* context)
+    {
+        mContext = context;
+    }
+
+    void setFrame(u8* dst, u32 dstSize, const u8* src, u32 srcSize)
+    {
+        mDst = dst;
+        mDstSize = dstSize;
+        mSrc = src;
+        mSrcSize = srcSize;
+    }
+
+    void invoke() override
+    {
+        size_t result = ZSTD_decompressDCtx(mContext, mDst, mDstSize, mSrc, mSrcSize);
+
+        // The frame has to fill exactly the size its header announced
+        if (ZSTD_isError(result) || result != mDstSize)
+            mResult = ZstdDecompressor::cErrorInvalidData;
+        else
+            mResult = static_cast<s32>(result);
+    }
+
+    s32 getResult() const { return mResult; }
+
+private:
+    ZSTD_DCtx* mContext;
+    u8* mDst;
+    u32 mDstSize;
+    const u8* mSrc;
+    u32 mSrcSize;
+    s32 mResult;
+};
+
+} // namespace
+
+ZstdDecompressor::ZstdDecompressor()
+    : Decompressor("zs")
+    , mJobQueue(nullptr)
+    , mBatchNumMax(cDefaultBatchNumMax)
+    , mTotalDecompSize()
+    , mTotalDecompTick()
+{
+}
+
+u8* ZstdDecompressor::tryDecompFromDevice(const ResourceMgr::LoadArg& arg, Resource* res, u32* outSize, u32* outBufferSize, bool* outNeedDelete)
+{
+    TickTime startTime;
+
+    FileHandle handle;
+    if (!tryOpen_(&handle, arg))
+        return nullptr;
+
+    u32 fileSize = 0;
+    if (!handle.tryGetFileSize(&fileSize))
+        return nullptr;
+
+    if (fileSize == 0)
+    {
+        SEAD_WARNING("fileSize is zero.[%s]", arg.path.cstr());
+        return nullptr;
+    }
+
+    u8* src = tryAllocWork_(arg, fileSize);
+    if (!src)
+        return nullptr;
+
+    // Read in chunks of the div size of the handle
+    u32 readSize = 0;
+    if (!handle.tryRead(&readSize, src, fileSize) || readSize != fileSize || !handle.tryClose())
+    {
+        delete[] src;
+        return nullptr;
+    }
+
+    s32 frameNum = 0;
+    u64 decompSize64 = 0;
+    if (!IsFrameStart(src, fileSize) || !ScanFrames(&frameNum, &decompSize64, src, fileSize) || decompSize64 == 0 ||
+        decompSize64 > Mathu::maxNumber())
+    {
+        SEAD_WARNING("not a supported Zstandard file, every frame needs its content size.[%s]", arg.path.cstr());
+        delete[] src;
+        return nullptr;
+    }
+
+    u32 decompSize = static_cast<u32>(decompSize64);
+
+    u32 bufferSize = 0;
+    bool needDelete = false;
+    u8* dst = tryAllocLoadData_(&bufferSize, &needDelete, arg, res, decompSize, 0);
+    if (!dst)
+    {
+        delete[] src;
+        return nullptr;
+    }
+
+    // A decoder context for each frame of a batch, a single one unless a queue is set
+    s32 batchNum = 1;
+    if (mJobQueue)
+    {
+        batchNum = Mathi::min(Mathi::min(mJobQueue->getWorkerNum() + 1, mBatchNumMax), frameNum);
+        batchNum = Mathi::max(batchNum, 1);
+    }
+
+    u32 contextSize = CalcContextSize();
+    u8* contextWork = tryAllocWork_(arg, contextSize * batchNum);
+
+    Heap* heap = arg.load_data_heap ? arg.load_data_heap : HeapMgr::instance()->getCurrentHeap();
+    FrameJob* jobs = contextWork ? new(heap, -static_cast<s32>(alignof(FrameJob)), std::nothrow) FrameJob[frameNum] : nullptr;
+
+    s32 result = jobs ? 0 : cErrorInvalidData;
+
+    // Static contexts live at the start of their slot
+    for (s32 i = 0; i < batchNum && result >= 0; i++)
+    {
+        if (!ZSTD_initStaticDCtx(contextWork + contextSize * i, contextSize))
+            result = cErrorInvalidData;
+    }
+
+    if (result >= 0)
+    {
+        const u8* ip = src;
+        u32 restSize = fileSize;
+        u32 dstPos = 0;
+
+        for (s32 i = 0; i < frameNum;)
+        {
+            Frame frame;
+            ParseFrame(&frame, ip, restSize);
+
+            if (!frame.isSkippable)
+            {
+                u32 contentSize = static_cast<u32>(frame.contentSize);
+                jobs[i].setFrame(dst + dstPos, contentSize, ip, frame.srcSize);
+                dstPos += contentSize;
+                i++;
+            }
+
+            ip += frame.srcSize;
+            restSize -= frame.srcSize;
+        }
+    }
+
+    for (s32 i = 0; i < frameNum && result >= 0; i += batchNum)
+    {
+        s32 jobNum = Mathi::min(batchNum, frameNum - i);
+
+        for (s32 j = 0; j < jobNum; j++)
+            jobs[i + j].setContext(reinterpret_cast<ZSTD_DCtx*>(contextWork + contextSize * j));
+
+        if (jobNum > 1)
+        {
+            JobCounter counter;
+            for (s32 j = 1; j < jobNum; j++)
+                mJobQueue->enqueue(&jobs[i + j], &counter);
+
+            jobs[i].invoke();
+            mJobQueue->wait(&counter);
+        }
+        else
+        {
+            jobs[i].invoke();
+        }
+
+        for (s32 j = 0; j < jobNum; j++)
+        {
+            if (jobs[i + j].getResult() < 0)
+            {
+                result = jobs[i + j].getResult();
+                break;
+            }
+        }
+    }
+
+    delete[] jobs;
+    delete[] contextWork;
+    delete[] src;
+
+    if (result < 0)
+    {
+        SEAD_WARNING("broken Zstandard data, error %d.[%s]", result, arg.path.cstr());
+
+        if (needDelete)
+            delete[] dst;
+
+        return nullptr;
+    }
+
+    mTotalDecompSize.add(static_cast<s64>(decompSize));
+    mTotalDecompTick.add(startTime.diffToNow().toS64());
+
+    if (outSize)
+        *outSize = decompSize;
+
+    if (outBufferSize)
+        *outBufferSize = bufferSize;
+
+    if (outNeedDelete)
+        *outNeedDelete = needDelete;
+
+    return dst;
+}
+
+f64 ZstdDecompressor::calcThroughput() const
+{
+    s64 nsec = getTotalDecompTime().toNanoSeconds();
+    if (nsec <= 0)
+        return 0.0;
+
+    return static_cast<f64>(getTotalDecompSize()) * 1000000000.0 / static_cast<f64>(nsec);
+}
+
+void ZstdDecompressor::resetStats()
+{
+    mTotalDecompSize.setValue(0);
+    mTotalDecompTick.setValue(0);
+}
+
+u32 ZstdDecompressor::getDecompSize(const void* src, u32 srcSize)
+{
+    const u8* srcU8 = static_cast<const u8*>(src);
+
+    s32 frameNum = 0;
+    u64 decompSize = 0;
+    if (!IsFrameStart(srcU8, srcSize) || !ScanFrames(&frameNum, &decompSize, srcU8, srcSize) || decompSize > Mathu::maxNumber())
+        return 0;
+
+    return static_cast<u32>(decompSize);
+}
+
+s32 ZstdDecompressor::decomp(void* dst, u32 dstSize, const void* src, u32 srcSize, Heap* heap)
+{
+    const u8* ip = static_cast<const u8*>(src);
+    if (!IsFrameStart(ip, srcSize))
+        return cErrorInvalidHeader;
+
+    s32 frameNum = 0;
+    u64 decompSize = 0;
+    if (!ScanFrames(&frameNum, &decompSize, ip, srcSize) || decompSize > dstSize)
+        return cErrorInvalidData;
+
+    if (!heap)
+        heap = HeapMgr::instance()->getCurrentHeap();
+
+    u32 contextSize = CalcContextSize();
+    u8* contextWork = static_cast<u8*>(heap->tryAlloc(contextSize, FileDevice::cBufferMinAlignment));
+    if (!contextWork)
+        return cErrorInvalidData;
+
+    s32 result = ZSTD_initStaticDCtx(contextWork, contextSize) ? 0 : cErrorInvalidData;
+
+    FrameJob job;
+    job.setContext(reinterpret_cast<ZSTD_DCtx*>(contextWork));
+
+    u8* dstU8 = static_cast<u8*>(dst);
+    u32 dstPos = 0;
+
+    while (srcSize > 0 && result >= 0)
+    {
+        Frame frame;
+        ParseFrame(&frame, ip, srcSize);
+
+        if (!frame.isSkippable)
+        {
+            job.setFrame(dstU8 + dstPos, static_cast<u32>(frame.contentSize), ip, frame.srcSize);
+            job.invoke();
+
+            result = job.getResult();
+            dstPos += static_cast<u32>(frame.contentSize);
+        }
+
+        ip += frame.srcSize;
+        srcSize -= frame.srcSize;
+    }
+
+    heap->free(contextWork);
+
+    if (result < 0)
+        return result;
+
+    return static_cast<s32>(dstPos);
+}
+
+} // namespace sead
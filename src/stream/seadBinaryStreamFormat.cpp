@@ -5,6 +5,93 @@
 
 namespace sead {
 
+namespace {
+
+// Elements swapped through the stack when the source has no direct access
+const u32 cSwapBufferSize = 256;
+
+// dst and src may be the same
+template <typename T>
+void SwapCopy(void* dst, const void* src, u32 num)
+{
+    if constexpr (sizeof(T) == 2)
+        Endian::swapArrayU16(dst, src, num);
+    else if constexpr (sizeof(T) == 4)
+        Endian::swapArrayU32(dst, src, num);
+    else
+        Endian::swapArrayU64(dst, src, num);
+}
+
+template <typename T>
+void ReadArray(StreamSrc* src, Endian::Types endian, void* dst, u32 num)
+{
+    u32 size = num * sizeof(T);
+
+    if constexpr (sizeof(T) > 1)
+    {
+        if (endian != Endian::getHostEndian())
+        {
+            // Swap while copying out of memory backed sources
+            const void* data = src->readDirect(size);
+            if (data)
+            {
+                SwapCopy<T>(dst, data, num);
+                return;
+            }
+
+            u32 rb = src->read(dst, size);
+            SEAD_ASSERT(rb == size);
+
+            SwapCopy<T>(dst, dst, rb / sizeof(T));
+            return;
+        }
+    }
+
+    u32 rb = src->read(dst, size);
+    SEAD_ASSERT(rb == size);
+}
+
+template <typename T>
+void WriteArray(StreamSrc* src, Endian::Types endian, const void* values, u32 num)
+{
+    u32 size = num * sizeof(T);
+
+    if constexpr (sizeof(T) > 1)
+    {
+        if (endian != Endian::getHostEndian())
+        {
+            void* data = src->writeDirect(size);
+            if (data)
+            {
+                SwapCopy<T>(data, values, num);
+                return;
+            }
+
+            const u8* valuesU8 = static_cast<const u8*>(values);
+            T buffer[cSwapBufferSize];
+
+            while (num > 0)
+            {
+                u32 stepNum = num < cSwapBufferSize ? num : cSwapBufferSize;
+                SwapCopy<T>(buffer, valuesU8, stepNum);
+
+                u32 wb = src->write(buffer, stepNum * sizeof(T));
+                SEAD_ASSERT(wb == stepNum * sizeof(T));
+
+                valuesU8 += stepNum * sizeof(T);
+                num -= stepNum;
+            }
+
+            return;
+        }
+    }
+
+    u32 wb = src->write(values, size);
+    SEAD_ASSERT(wb == size);
+}
+
+} // namespace
+
 u8 BinaryStreamFormat::readU8(StreamSrc* src, Endian::Types endian)
 {
     u8 ret = 0;
@@ -86,6 +173,51 @@ f32 BinaryStreamFormat::readF32(StreamSrc* src, Endian::Types endian)
     return Endian::toHostF32(endian, &ret);
 }
 
+void BinaryStreamFormat::readU8Array(StreamSrc* src, Endian::Types endian, u8* dst, u32 num)
+{
+    ReadArray<u8>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readU16Array(StreamSrc* src, Endian::Types endian, u16* dst, u32 num)
+{
+    ReadArray<u16>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readU32Array(StreamSrc* src, Endian::Types endian, u32* dst, u32 num)
+{
+    ReadArray<u32>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readU64Array(StreamSrc* src, Endian::Types endian, u64* dst, u32 num)
+{
+    ReadArray<u64>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readS8Array(StreamSrc* src, Endian::Types endian, s8* dst, u32 num)
+{
+    ReadArray<u8>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readS16Array(StreamSrc* src, Endian::Types endian, s16* dst, u32 num)
+{
+    ReadArray<u16>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readS32Array(StreamSrc* src, Endian::Types endian, s32* dst, u32 num)
+{
+    ReadArray<u32>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readS64Array(StreamSrc* src, Endian::Types endian, s64* dst, u32 num)
+{
+    ReadArray<u64>(src, endian, dst, num);
+}
+
+void BinaryStreamFormat::readF32Array(StreamSrc* src, Endian::Types endian, f32* dst, u32 num)
+{
+    ReadArray<u32>(src, endian, dst, num);
+}
+
 void BinaryStreamFormat::readBit(StreamSrc* src, void* data, u32 bitnum)
 {
     u8* dataU8 = static_cast<u8*>(data);
@@ -200,6 +332,51 @@ void BinaryStreamFormat::writeF32(StreamSrc* src, Endian::Types endian, f32 valu
     SEAD_ASSERT(wb == sizeof(u32));
 }
 
+void BinaryStreamFormat::writeU8Array(StreamSrc* src, Endian::Types endian, const u8* values, u32 num)
+{
+    WriteArray<u8>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeU16Array(StreamSrc* src, Endian::Types endian, const u16* values, u32 num)
+{
+    WriteArray<u16>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeU32Array(StreamSrc* src, Endian::Types endian, const u32* values, u32 num)
+{
+    WriteArray<u32>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeU64Array(StreamSrc* src, Endian::Types endian, const u64* values, u32 num)
+{
+    WriteArray<u64>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeS8Array(StreamSrc* src, Endian::Types endian, const s8* values, u32 num)
+{
+    WriteArray<u8>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeS16Array(StreamSrc* src, Endian::Types endian, const s16* values, u32 num)
+{
+    WriteArray<u16>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeS32Array(StreamSrc* src, Endian::Types endian, const s32* values, u32 num)
+{
+    WriteArray<u32>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeS64Array(StreamSrc* src, Endian::Types endian, const s64* values, u32 num)
+{
+    WriteArray<u64>(src, endian, values, num);
+}
+
+void BinaryStreamFormat::writeF32Array(StreamSrc* src, Endian::Types endian, const f32* values, u32 num)
+{
+    WriteArray<u32>(src, endian, values, num);
+}
+
 void BinaryStreamFormat::writeBit(StreamSrc* src, const void* data, u32 bitnum)
 {
     const u8* dataU8 = static_cast<const u8*>(data);
@@ -76,6 +76,19 @@ bool BufferWriteStreamSrc::flush()
     return full;
 }
 
+void* BufferWriteStreamSrc::writeDirect(u32 size)
+{
+    if (size > mBufferSize)
+        return nullptr;
+
+    if (mBufferSize - mCurrentPos < size && !flush())
+        return nullptr;
+
+    void* data = mBufferAddr + mCurrentPos;
+    mCurrentPos += size;
+    return data;
+}
+
 BufferMultiByteTextWriteStreamSrc::BufferMultiByteTextWriteStreamSrc(StreamSrc* src, void* start, u32 size)
     : BufferWriteStreamSrc(src, start, size)
 {
@@ -52,7 +52,7 @@ u32 FileDeviceStreamSrc::skip(s32 byte)
 void FileDeviceStreamSrc::rewind()
 {
     SEAD_ASSERT(mHandle);
-    mHandle->seek(mBeginPos, FileDevice::SeekOrigin::eBegin);
+    mHandle->seek(static_cast<s64>(mBeginPos), FileDevice::SeekOrigin::eBegin);
 }
 
 bool FileDeviceStreamSrc::isEOF()
@@ -53,6 +53,30 @@ u32 RamStreamSrc::skip(s32 byte)
     return byte;
 }
 
+const void* RamStreamSrc::readDirect(u32 size)
+{
+    if (mCurPos + size > mSize)
+    {
+        return nullptr;
+    }
+
+    const void* data = mStartAddr + mCurPos;
+    mCurPos += size;
+    return data;
+}
+
+void* RamStreamSrc::writeDirect(u32 size)
+{
+    if (mCurPos + size > mSize)
+    {
+        return nullptr;
+    }
+
+    void* data = mStartAddr + mCurPos;
+    mCurPos += size;
+    return data;
+}
+
 RamReadStream::RamReadStream(const void* start, u32 size, Modes mode)
     : ReadStream()
     , mRamStreamSrc(const_cast<void*>(start), size)
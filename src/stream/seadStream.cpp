@@ -215,6 +215,69 @@ void ReadStream::readF32(f32& dst)
     dst = readF32();
 }
 
+void ReadStream::readU8Array(u8* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readU8Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readU16Array(u16* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readU16Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readU32Array(u32* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readU32Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readU64Array(u64* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readU64Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readS8Array(s8* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readS8Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readS16Array(s16* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readS16Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readS32Array(s32* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readS32Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readS64Array(s64* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readS64Array(mSrcStream, mSrcEndian, dst, num);
+}
+
+void ReadStream::readF32Array(f32* dst, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->readF32Array(mSrcStream, mSrcEndian, dst, num);
+}
+
 void ReadStream::readBit(void* dst, u32 bitnum)
 {
     SEAD_ASSERT(mFormat);
@@ -320,6 +383,69 @@ void WriteStream::writeF32(f32 value)
     mFormat->writeF32(mSrcStream, mSrcEndian, value);
 }
 
+void WriteStream::writeU8Array(const u8* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeU8Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeU16Array(const u16* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeU16Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeU32Array(const u32* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeU32Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeU64Array(const u64* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeU64Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeS8Array(const s8* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeS8Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeS16Array(const s16* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeS16Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeS32Array(const s32* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeS32Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeS64Array(const s64* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeS64Array(mSrcStream, mSrcEndian, values, num);
+}
+
+void WriteStream::writeF32Array(const f32* values, u32 num)
+{
+    SEAD_ASSERT(mFormat);
+    SEAD_ASSERT(mSrcStream);
+    mFormat->writeF32Array(mSrcStream, mSrcEndian, values, num);
+}
+
 void WriteStream::writeBit(const void* src, u32 bitnum)
 {
     SEAD_ASSERT(mFormat);
@@ -0,0 +1,149 @@
+#include <stream/seadStreamFormat.h>
+
+namespace sead {
+
+void StreamFormat::readU8Array(StreamSrc* src, Endian::Types endian, u8* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readU8(src, endian);
+    }
+}
+
+void StreamFormat::readU16Array(StreamSrc* src, Endian::Types endian, u16* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readU16(src, endian);
+    }
+}
+
+void StreamFormat::readU32Array(StreamSrc* src, Endian::Types endian, u32* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readU32(src, endian);
+    }
+}
+
+void StreamFormat::readU64Array(StreamSrc* src, Endian::Types endian, u64* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readU64(src, endian);
+    }
+}
+
+void StreamFormat::readS8Array(StreamSrc* src, Endian::Types endian, s8* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readS8(src, endian);
+    }
+}
+
+void StreamFormat::readS16Array(StreamSrc* src, Endian::Types endian, s16* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readS16(src, endian);
+    }
+}
+
+void StreamFormat::readS32Array(StreamSrc* src, Endian::Types endian, s32* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readS32(src, endian);
+    }
+}
+
+void StreamFormat::readS64Array(StreamSrc* src, Endian::Types endian, s64* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readS64(src, endian);
+    }
+}
+
+void StreamFormat::readF32Array(StreamSrc* src, Endian::Types endian, f32* dst, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        dst[i] = readF32(src, endian);
+    }
+}
+
+void StreamFormat::writeU8Array(StreamSrc* src, Endian::Types endian, const u8* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeU8(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeU16Array(StreamSrc* src, Endian::Types endian, const u16* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeU16(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeU32Array(StreamSrc* src, Endian::Types endian, const u32* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeU32(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeU64Array(StreamSrc* src, Endian::Types endian, const u64* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeU64(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeS8Array(StreamSrc* src, Endian::Types endian, const s8* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeS8(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeS16Array(StreamSrc* src, Endian::Types endian, const s16* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeS16(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeS32Array(StreamSrc* src, Endian::Types endian, const s32* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeS32(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeS64Array(StreamSrc* src, Endian::Types endian, const s64* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeS64(src, endian, values[i]);
+    }
+}
+
+void StreamFormat::writeF32Array(StreamSrc* src, Endian::Types endian, const f32* values, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+    {
+        writeF32(src, endian, values[i]);
+    }
+}
+
+} // namespace sead
@@ -3,12 +3,23 @@
 #include <basis/seadAssert.h>
 #include <prim/seadScopedLock.h>
 
+#include <bit>
+
 namespace sead {
 
 MessageQueue::MessageQueue()
     : mCriticalSection()
-    , mEvent(false)
+    , mNotFullEvent(false)
+    , mNotEmptyEvent(false)
+    , mNotFullWaiterNum(0)
+    , mNotEmptyWaiterNum(0)
     , mBuffer()
+    , mCells(nullptr)
+    , mCellMask(0)
+    , mJamMessage(cNullElement)
+    , mPushPos(0)
+    , mPadding()
+    , mPopPos(0)
 {
 }
 
@@ -28,75 +39,153 @@ void MessageQueue::allocate(s32 size, Heap* heap)
     mBuffer.allocBuffer(size, heap);
 }
 
+void MessageQueue::allocateLockFree(s32 size, Heap* heap)
+{
+    if (size <= 0)
+    {
+        SEAD_ASSERT_MSG(false, "MessageQueue size must not zero");
+        return;
+    }
+
+    SEAD_ASSERT(!mCells && !mBuffer.isBufferReady());
+
+    u32 cellNum = std::bit_ceil(static_cast<u32>(size));
+
+    mCells = new(heap, cCacheLineSize) Cell[cellNum];
+    mCellMask = cellNum - 1;
+
+    for (u32 i = 0; i < cellNum; i++)
+    {
+        mCells[i].sequence.setValueNonAtomic(i);
+        mCells[i].message.setValueNonAtomic(cNullElement);
+    }
+
+    mJamMessage.setValue(cNullElement);
+    mPushPos.setValue(0);
+    mPopPos.setValue(0);
+}
+
 void MessageQueue::free()
 {
     mBuffer.freeBuffer();
-    mEvent.setSignal();
+
+    if (mCells)
+    {
+        delete[] mCells;
+        mCells = nullptr;
+        mCellMask = 0;
+    }
+
+    mNotFullEvent.setSignal();
+    mNotEmptyEvent.setSignal();
+}
+
+s32 MessageQueue::getSize() const
+{
+    if (isLockFree())
+        return static_cast<s32>(mCellMask + 1);
+
+    return mBuffer.maxSize();
 }
 
+// Waiters register themselves before retrying, so the other side only signals when someone actually waits.
+// An auto reset event folds several signals into one, so a waiter that got through passes the signal on.
+
 bool MessageQueue::push(Element message, BlockType blockType)
 {
+    if (push_(message))
+        return true;
+
     if (blockType != BlockType::eBlock)
-        return push_(message);
+        return false;
+
+    mNotFullWaiterNum.increment();
 
     while (!push_(message))
-        mEvent.wait();
+        mNotFullEvent.wait();
+
+    if (mNotFullWaiterNum.decrement() > 1)
+        mNotFullEvent.setSignal();
 
     return true;
 }
 
 bool MessageQueue::push_(Element message)
 {
-    ScopedLock<CriticalSection> lock(&mCriticalSection);
+    if (isLockFree())
+        return pushLockFree_(message);
+
+    bool success;
+    {
+        ScopedLock<CriticalSection> lock(&mCriticalSection);
+        success = mBuffer.pushBack(message);
+    }
 
-    bool success = mBuffer.pushBack(message);
     if (success)
-        mEvent.setSignal();
+        signalNotEmpty_();
 
     return success;
 }
 
 MessageQueue::Element MessageQueue::pop(BlockType blockType)
 {
-    if (blockType != BlockType::eBlock)
-        return pop_();
+    Element msg = pop_();
+    if (msg != cNullElement || blockType != BlockType::eBlock)
+        return msg;
+
+    mNotEmptyWaiterNum.increment();
 
-    Element msg;
     while ((msg = pop_()) == cNullElement)
-        mEvent.wait();
+        mNotEmptyEvent.wait();
+
+    if (mNotEmptyWaiterNum.decrement() > 1)
+        mNotEmptyEvent.setSignal();
 
     return msg;
 }
 
 MessageQueue::Element MessageQueue::pop_()
 {
-    ScopedLock<CriticalSection> lock(&mCriticalSection);
-
-    if (mBuffer.getNum() <= 0)
-        return cNullElement;
+    if (isLockFree())
+        return popLockFree_();
 
     Element msg;
-    mBuffer.popFront(&msg);
+    {
+        ScopedLock<CriticalSection> lock(&mCriticalSection);
+
+        if (mBuffer.getNum() <= 0)
+            return cNullElement;
+
+        mBuffer.popFront(&msg);
+    }
 
-    mEvent.setSignal();
+    signalNotFull_();
 
     return msg;
 }
 
 MessageQueue::Element MessageQueue::peek(BlockType blockType) const
 {
-    if (blockType != BlockType::eBlock)
-        return peek_();
+    Element msg = peek_();
+    if (msg != cNullElement || blockType != BlockType::eBlock)
+        return msg;
+
+    mNotEmptyWaiterNum.increment();
 
-    Element msg;
     while ((msg = peek_()) == cNullElement)
-        mEvent.wait();
+        mNotEmptyEvent.wait();
+
+    if (mNotEmptyWaiterNum.decrement() > 1)
+        mNotEmptyEvent.setSignal();
 
     return msg;
 }
 
 MessageQueue::Element MessageQueue::peek_() const
 {
+    if (isLockFree())
+        return peekLockFree_();
+
     ScopedLock<CriticalSection> lock(&mCriticalSection);
 
     if (mBuffer.getNum() <= 0)
@@ -110,24 +199,155 @@ MessageQueue::Element MessageQueue::peek_() const
 
 bool MessageQueue::jam(Element message, BlockType blockType)
 {
+    if (jam_(message))
+        return true;
+
     if (blockType != BlockType::eBlock)
-        return jam_(message);
+        return false;
+
+    mNotFullWaiterNum.increment();
 
     while (!jam_(message))
-        mEvent.wait();
+        mNotFullEvent.wait();
+
+    if (mNotFullWaiterNum.decrement() > 1)
+        mNotFullEvent.setSignal();
 
     return true;
 }
 
 bool MessageQueue::jam_(Element message)
 {
-    ScopedLock<CriticalSection> lock(&mCriticalSection);
+    if (isLockFree())
+        return jamLockFree_(message);
+
+    bool success;
+    {
+        ScopedLock<CriticalSection> lock(&mCriticalSection);
+        success = mBuffer.pushFront(message);
+    }
 
-    bool success = mBuffer.pushFront(message);
     if (success)
-        mEvent.setSignal();
+        signalNotEmpty_();
 
     return success;
 }
 
+bool MessageQueue::pushLockFree_(Element message)
+{
+    u32 pos = mPushPos.getValue();
+    Cell* cell;
+
+    while (true)
+    {
+        cell = &mCells[pos & mCellMask];
+
+        s32 diff = static_cast<s32>(cell->sequence.getValue() - pos);
+        if (diff == 0)
+        {
+            if (mPushPos.compareAndSwap(pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // The cell still holds a message from the previous lap
+            return false;
+        }
+
+        pos = mPushPos.getValue();
+    }
+
+    cell->message.setValue(message);
+    cell->sequence.setValue(pos + 1);
+
+    signalNotEmpty_();
+
+    return true;
+}
+
+MessageQueue::Element MessageQueue::popLockFree_()
+{
+    if (mJamMessage.getValue() != cNullElement)
+    {
+        Element msg = mJamMessage.swap(cNullElement);
+        if (msg != cNullElement)
+        {
+            signalNotFull_();
+            return msg;
+        }
+    }
+
+    u32 pos = mPopPos.getValue();
+    Cell* cell;
+
+    while (true)
+    {
+        cell = &mCells[pos & mCellMask];
+
+        s32 diff = static_cast<s32>(cell->sequence.getValue() - (pos + 1));
+        if (diff == 0)
+        {
+            if (mPopPos.compareAndSwap(pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return cNullElement;
+        }
+
+        pos = mPopPos.getValue();
+    }
+
+    Element msg = cell->message.getValue();
+    cell->sequence.setValue(pos + mCellMask + 1);
+
+    signalNotFull_();
+
+    return msg;
+}
+
+MessageQueue::Element MessageQueue::peekLockFree_() const
+{
+    Element msg = mJamMessage.getValue();
+    if (msg != cNullElement)
+        return msg;
+
+    while (true)
+    {
+        u32 pos = mPopPos.getValue();
+        const Cell& cell = mCells[pos & mCellMask];
+
+        if (cell.sequence.getValue() != pos + 1)
+            return cNullElement;
+
+        msg = cell.message.getValue();
+
+        // Only valid if nobody popped the cell in the meantime
+        if (mPopPos.getValue() == pos)
+            return msg;
+    }
+}
+
+bool MessageQueue::jamLockFree_(Element message)
+{
+    if (!mJamMessage.compareAndSwap(cNullElement, message))
+        return false;
+
+    signalNotEmpty_();
+
+    return true;
+}
+
+void MessageQueue::signalNotFull_()
+{
+    if (mNotFullWaiterNum.getValue() != 0)
+        mNotFullEvent.setSignal();
+}
+
+void MessageQueue::signalNotEmpty_()
+{
+    if (mNotEmptyWaiterNum.getValue() != 0)
+        mNotEmptyEvent.setSignal();
+}
+
 } // namespace sead
@@ -16,6 +16,28 @@ const s32 cGuardSize = 0x1000;
 
 const s32 Thread::cDefaultPriority = 0;
 
+static void SetPosixThreadAffinity(pthread_t handle, const CoreIdMask& affinity)
+{
+#if !defined(SEAD_PLATFORM_MACOSX)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    for (u32 i = 0; i < CoreInfo::getNumCores(); i++)
+    {
+        CoreId id = static_cast<CoreId>(i);
+        if (affinity.isOn(id))
+            CPU_SET(CoreInfo::getPlatformCoreId(id), &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(handle, sizeof(cpuSet), &cpuSet) != 0)
+        SEAD_WARNING("Failed to set thread affinity.\n");
+#else
+    // Threads can not be bound to cores on this platform
+    SEAD_UNUSED(handle);
+    SEAD_UNUSED(affinity);
+#endif // SEAD_PLATFORM_MACOSX
+}
+
 SEAD_SINGLETON_DISPOSER_IMPL(ThreadMgr);
 
 Thread::Thread(const SafeString& name, Heap* heap, s32 platformPriority, MessageQueue::BlockType blockType,
@@ -31,6 +53,7 @@ Thread::Thread(const SafeString& name, Heap* heap, s32 platformPriority, Message
     , mQuitMsg(quitMsg)
     , mID(0)
     , mState(State::eInitialized)
+    , mAffinity(CoreInfo::getMaskAll())
     , mHandle(0)
     , mAttr()
     , mStackBase(0)
@@ -67,6 +90,7 @@ Thread::Thread(Heap* heap, pthread_t handle)
     , mQuitMsg(cDefaultQuitMsg)
     , mID(static_cast<u32>(reinterpret_cast<uintptr_t>(handle)))
     , mState(State::eRunning)
+    , mAffinity(CoreInfo::getMaskAll())
     , mHandle(handle)
     , mAttr()
     , mStackBase(0)
@@ -177,6 +201,17 @@ s32 Thread::getPriority() const
     return mPriority;
 }
 
+void Thread::setAffinity(const CoreIdMask& affinity)
+{
+    mAffinity = affinity;
+
+    // Applied by posixThreadFunc_ once started
+    if (mState == State::eInitialized)
+        return;
+
+    SetPosixThreadAffinity(mHandle, mAffinity);
+}
+
 u32* Thread::getStackCheckStartAddress_() const
 {
     return nullptr;
@@ -194,6 +229,9 @@ void* Thread::posixThreadFunc_(void* param)
     pthread_setname_np(thread->mNameBuffer.cstr());
 #endif // SEAD_PLATFORM
 
+    if (static_cast<u32>(thread->mAffinity) != static_cast<u32>(CoreInfo::getMaskAll()))
+        SetPosixThreadAffinity(pthread_self(), thread->mAffinity);
+
     thread->mState = State::eRunning;
     thread->run_();
     thread->mState = State::eTerminated;
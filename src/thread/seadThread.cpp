@@ -41,6 +41,25 @@ MessageQueue::Element Thread::recvMessage(MessageQueue::BlockType blockType)
     return mMessageQueue.pop(blockType);
 }
 
+bool Thread::changeToLockFreeMessageQueue(Heap* heap)
+{
+    if (mState != State::eInitialized)
+    {
+        SEAD_WARNING("Thread is running or done. Can not change message queue.\n");
+        return false;
+    }
+
+    if (mMessageQueue.isLockFree())
+        return true;
+
+    s32 size = mMessageQueue.getSize();
+
+    mMessageQueue.free();
+    mMessageQueue.allocateLockFree(size, heap);
+
+    return true;
+}
+
 void Thread::quit(bool isJam)
 {
     if (isDone())
@@ -113,9 +132,9 @@ void Thread::genMessage(hostio::Context* context)
     {
         BufferedSafeString buf(static_cast<char*>(ctxBuf->getBuffer()), ctxBuf->getMaxSize());
         buf.format(
-            "<font face=\"ＭＳ ゴシック\"><table><tr><th>Name</th><td>%s</td></tr><tr><th>ID</th><td>%d</td></tr><tr><th>Priority</th><td>%d</td></tr><tr><th>BlockType</th><td>%s</td></tr><tr><th>QuitMessage</th><td>%d</td></tr><tr><th>StackSize</th><td>%d</td></tr><tr><th>StackUsedSizePeak</th><td>%d (%d%%)</td></tr><tr><th>State</th><td>%s</td></tr></table></font>",
+            "<font face=\"ＭＳ ゴシック\"><table><tr><th>Name</th><td>%s</td></tr><tr><th>ID</th><td>%d</td></tr><tr><th>Priority</th><td>%d</td></tr><tr><th>BlockType</th><td>%s</td></tr><tr><th>QuitMessage</th><td>%d</td></tr><tr><th>StackSize</th><td>%d</td></tr><tr><th>StackUsedSizePeak</th><td>%d (%d%%)</td></tr><tr><th>State</th><td>%s</td></tr><tr><th>Affinity</th><td>0x%08x</td></tr></table></font>",
             getName().cstr(), mID, getPriority(), getBlockType() == MessageQueue::BlockType::eBlock ? "Block" : "NoBlock", mQuitMsg, getStackSize(),
-            calcStackUsedSizePeak(), 0, ""//mState.text()
+            calcStackUsedSizePeak(), 0, ""/*mState.text()*/, static_cast<u32>(getAffinity())
         );
 
         context->endHTMLLabel(buf.calcLength());
@@ -24,6 +24,7 @@ Thread::Thread(const SafeString& name, Heap* heap, s32 platformPriority, Message
     , mQuitMsg(quitMsg)
     , mID(0)
     , mState(State::eInitialized)
+    , mAffinity(CoreInfo::getMaskAll())
     , mHandle(0)
 {
     mMessageQueue.allocate(msgQueueSize, heap);
@@ -66,6 +67,7 @@ Thread::Thread(Heap* heap, HANDLE thread, u32 id)
     , mQuitMsg(cDefaultQuitMsg)
     , mID(id)
     , mState(State::eRunning)
+    , mAffinity(CoreInfo::getMaskAll())
     , mHandle(thread)
 {
     mMessageQueue.allocate(cDefaultMsgQueueSize, heap);
@@ -154,6 +156,22 @@ s32 Thread::getPriority() const
     return GetThreadPriority(mHandle);
 }
 
+void Thread::setAffinity(const CoreIdMask& affinity)
+{
+    mAffinity = affinity;
+
+    DWORD_PTR mask = 0;
+    for (u32 i = 0; i < CoreInfo::getNumCores(); i++)
+    {
+        CoreId id = static_cast<CoreId>(i);
+        if (affinity.isOn(id))
+            mask |= CoreInfo::getPlatformMask(id);
+    }
+
+    if (SetThreadAffinityMask(mHandle, mask) == 0)
+        SEAD_WARNING("SetThreadAffinityMask failed. %d\n", GetLastError());
+}
+
 u32* Thread::getStackCheckStartAddress_() const
 {
     return nullptr;
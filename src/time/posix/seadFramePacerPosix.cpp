@@ -0,0 +1,33 @@
+#include <time/seadFramePacer.h>
+
+#include <cerrno>
+#include <ctime>
+
+#if !defined(SEAD_PLATFORM_LINUX)
+#include <thread/seadThread.h>
+#endif // SEAD_PLATFORM_LINUX
+
+namespace sead {
+
+TickSpan FramePacer::sleepUntil_(const TickTime& deadline)
+{
+#if defined(SEAD_PLATFORM_LINUX)
+    // TickTime counts nanoseconds of CLOCK_MONOTONIC here, so the deadline can be handed over as it is
+    struct ::timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadline.toU64() / 1'000'000'000ULL);
+    ts.tv_nsec = static_cast<long>(deadline.toU64() % 1'000'000'000ULL);
+
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    }
+#else
+    // No clock_nanosleep on macOS
+    TickSpan remain = deadline.diff(TickTime());
+    if (remain.toS64() > 0)
+        Thread::sleep(remain);
+#endif // SEAD_PLATFORM_LINUX
+
+    return TickTime().diff(deadline);
+}
+
+} // namespace sead
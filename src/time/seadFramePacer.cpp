@@ -0,0 +1,112 @@
+#include <time/seadFramePacer.h>
+
+#include <basis/seadAssert.h>
+
+namespace sead {
+
+namespace {
+
+// The lower bound leaves a margin for the scheduler, the upper one caps the time burnt spinning every frame
+const s64 cSpinTimeMinMicroSeconds = 50;
+const s64 cSpinTimeMaxMicroSeconds = 2000;
+const s64 cSpinTimeInitMicroSeconds = 500;
+
+} // namespace
+
+FramePacer::FramePacer()
+    : mFrameTime(TickSpan::makeFromMicroSeconds(1000000 / 60))
+    , mMaxBacklogNum(cDefaultMaxBacklogNum)
+    , mDeadline()
+    , mLastFrameTime()
+    , mLastFrameSpan()
+    , mSpinTime(TickSpan::makeFromMicroSeconds(cSpinTimeInitMicroSeconds))
+    , mDroppedFrameNum(0)
+{
+    reset();
+}
+
+void FramePacer::setFrameTime(TickSpan frameTime)
+{
+    SEAD_ASSERT(frameTime.toS64() > 0);
+    mFrameTime = frameTime;
+}
+
+void FramePacer::setFps(f32 fps)
+{
+    SEAD_ASSERT(fps > 0.0f);
+    setFrameTime(TickSpan::makeFromMicroSeconds(static_cast<s64>(1000000 / fps)));
+}
+
+void FramePacer::setMaxBacklogNum(s32 num)
+{
+    SEAD_ASSERT(num >= 0);
+    mMaxBacklogNum = num;
+}
+
+void FramePacer::reset()
+{
+    mLastFrameTime.setNow();
+    mDeadline = mLastFrameTime + mFrameTime;
+    mLastFrameSpan = 0;
+}
+
+s32 FramePacer::wait()
+{
+    TickTime now;
+
+    if (mDeadline.diff(now) > mSpinTime)
+    {
+        calibrate_(sleepUntil_(mDeadline - mSpinTime));
+        now.setNow();
+    }
+
+    while (mDeadline.diff(now).toS64() > 0)
+        now.setNow();
+
+    s64 lateFrameNum = now.diff(mDeadline).toS64() / mFrameTime.toS64();
+    s32 stepNum = 1;
+
+    if (lateFrameNum > mMaxBacklogNum)
+    {
+        // Too far behind to catch up, the schedule starts over from now
+        mDroppedFrameNum += static_cast<u32>(lateFrameNum - mMaxBacklogNum);
+        stepNum += mMaxBacklogNum;
+        mDeadline = now;
+    }
+    else
+    {
+        stepNum += static_cast<s32>(lateFrameNum);
+        mDeadline += TickSpan(mFrameTime.toS64() * lateFrameNum);
+    }
+
+    mDeadline += mFrameTime;
+
+    mLastFrameSpan = now.diff(mLastFrameTime);
+    mLastFrameTime = now;
+
+    return stepNum;
+}
+
+void FramePacer::calibrate_(TickSpan oversleep)
+{
+    // Follows a later wake up at once and an earlier one slowly, with a quarter on top as a margin
+    s64 sample = oversleep.toS64() + oversleep.toS64() / 4;
+    s64 spin = mSpinTime.toS64();
+
+    if (sample > spin)
+        spin = sample;
+    else
+        spin -= (spin - sample) / 16;
+
+    s64 spinMin = TickSpan::makeFromMicroSeconds(cSpinTimeMinMicroSeconds).toS64();
+    s64 spinMax = TickSpan::makeFromMicroSeconds(cSpinTimeMaxMicroSeconds).toS64();
+
+    if (spin < spinMin)
+        spin = spinMin;
+    else if (spin > spinMax)
+        spin = spinMax;
+
+    mSpinTime = spin;
+}
+
+} // namespace sead
@@ -0,0 +1,36 @@
+#include <time/seadFramePacer.h>
+
+#include <basis/win/seadWindows.h>
+#include <thread/seadThread.h>
+
+namespace sead {
+
+TickSpan FramePacer::sleepUntil_(const TickTime& deadline)
+{
+    TickSpan remain = deadline.diff(TickTime());
+    if (remain.toS64() <= 0)
+        return TickTime().diff(deadline);
+
+#if defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+    // Kept for the lifetime of the thread, high resolution timers are not bound to the 1ms timer period
+    static thread_local HANDLE sTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (sTimer)
+    {
+        // Relative due time in units of 100 nanoseconds
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -(remain.toNanoSeconds() / 100);
+
+        if (SetWaitableTimer(sTimer, &dueTime, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForSingleObject(sTimer, INFINITE);
+            return TickTime().diff(deadline);
+        }
+    }
+#endif // CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+
+    Thread::sleep(remain);
+
+    return TickTime().diff(deadline);
+}
+
+} // namespace sead
@@ -0,0 +1,93 @@
+#include "seadBenchmark.h"
+
+#include <heap/seadExpHeap.h>
+#include <heap/seadHeapMgr.h>
+#include <thread/seadThread.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct Benchmark
+{
+    const char* name;
+    void (*run)(sead::Heap* heap);
+};
+
+const Benchmark cBenchmarks[] = {
+    { "heap", &sead::benchmark::RunHeap },
+    { "hashmap", &sead::benchmark::RunHashMap },
+    { "crc", &sead::benchmark::RunHashCRC },
+    { "szs", &sead::benchmark::RunSZS },
+    { "stream", &sead::benchmark::RunStream },
+};
+
+const u32 cRootHeapSize = 512 * 1024 * 1024;
+
+bool IsSelected(const char* name, int argc, char** argv)
+{
+    if (argc < 2)
+        return true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace
+
+namespace sead::benchmark {
+
+void Report(const char* name, f64 nsecPerCall)
+{
+    std::printf("  %-48s %12.1f ns\n", name, nsecPerCall);
+}
+
+void ReportThroughput(const char* name, u64 size, f64 nsec)
+{
+    std::printf("  %-48s %12.1f MB/s\n", name, nsec > 0.0 ? static_cast<f64>(size) * 1000.0 / nsec : 0.0);
+}
+
+void ReportNote(const char* text)
+{
+    std::printf("  %s\n", text);
+}
+
+} // namespace sead::benchmark
+
+// Usage: benchmark [name...], runs every benchmark when no name is given
+int main(int argc, char** argv)
+{
+    sead::HeapMgr::initialize(cRootHeapSize);
+    sead::Heap* rootHeap = sead::HeapMgr::getRootHeap(0);
+
+    {
+        sead::Heap* threadHeap = sead::ExpHeap::create(0, "sead::ThreadMgr", rootHeap);
+
+        sead::ThreadMgr::createInstance(threadHeap);
+        sead::ThreadMgr::instance()->initialize(threadHeap);
+
+        threadHeap->adjust();
+    }
+
+    sead::CurrentHeapSetter setter(rootHeap);
+
+    for (const Benchmark& benchmark : cBenchmarks)
+    {
+        if (!IsSelected(benchmark.name, argc, argv))
+            continue;
+
+        std::printf("%s\n", benchmark.name);
+
+        sead::Heap* heap = sead::ExpHeap::create(0, benchmark.name, rootHeap);
+        benchmark.run(heap);
+        heap->destroy();
+    }
+
+    return 0;
+}
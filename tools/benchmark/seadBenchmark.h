@@ -0,0 +1,37 @@
+#pragma once
+
+#include <basis/seadTypes.h>
+#include <time/seadTickTime.h>
+
+namespace sead {
+
+class Heap;
+
+namespace benchmark {
+
+// Average nanoseconds per call of func, which is given the iteration index, over num calls
+template <typename Func>
+f64 Measure(s32 num, Func func)
+{
+    TickTime start;
+
+    for (s32 i = 0; i < num; i++)
+        func(i);
+
+    return static_cast<f64>(start.diffToNow().toNanoSeconds()) / num;
+}
+
+void Report(const char* name, f64 nsecPerCall);
+void ReportThroughput(const char* name, u64 size, f64 nsec);
+void ReportNote(const char* text);
+
+// Every benchmark gets a heap of its own, freed as a whole afterwards
+void RunHeap(Heap* heap);
+void RunHashMap(Heap* heap);
+void RunHashCRC(Heap* heap);
+void RunSZS(Heap* heap);
+void RunStream(Heap* heap);
+
+} // namespace benchmark
+
+} // namespace sead
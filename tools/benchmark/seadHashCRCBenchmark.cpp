@@ -0,0 +1,72 @@
+#include "seadBenchmark.h"
+
+#include <basis/seadNew.h>
+#include <codec/seadHashCRC32.h>
+#include <codec/seadHashCRC64.h>
+#include <heap/seadHeap.h>
+#include <random/seadRandom.h>
+
+namespace sead::benchmark {
+
+namespace {
+
+const u32 cDataSize = 64 * 1024;
+const s32 cHashNum = 256;
+const s32 cBitwiseHashNum = 8;
+
+const u32 cPolyCRC32 = 0xEDB88320;
+const u64 cPolyCRC64 = 0xC96C5795D7870F42;
+
+// The definition of the reflected CRCs, one bit at a time
+template <typename T>
+T CalcBitwise(T poly, const u8* data, u32 size)
+{
+    T crc = static_cast<T>(~static_cast<T>(0));
+
+    for (u32 i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (s32 bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+    }
+
+    return static_cast<T>(~crc);
+}
+
+} // namespace
+
+// HashCRC32 and HashCRC64 on 64KB of random data against the bitwise definition
+void RunHashCRC(Heap* heap)
+{
+    u8* data = new(heap) u8[cDataSize];
+
+    Random random(0x5EAD);
+    for (u32 i = 0; i < cDataSize; i++)
+        data[i] = static_cast<u8>(random.getU32(256));
+
+    volatile u32 hash32 = 0;
+    volatile u64 hash64 = 0;
+
+    bool isMatched = HashCRC32::calcHash(data, cDataSize) == CalcBitwise(cPolyCRC32, data, cDataSize) &&
+                     HashCRC64::calcHash(data, cDataSize) == CalcBitwise(cPolyCRC64, data, cDataSize);
+
+    f64 crc32Nsec = Measure(cHashNum, [&](s32) { hash32 = HashCRC32::calcHash(data, cDataSize); });
+    f64 crc64Nsec = Measure(cHashNum, [&](s32) { hash64 = HashCRC64::calcHash(data, cDataSize); });
+    f64 bitwise32Nsec = Measure(cBitwiseHashNum, [&](s32) { hash32 = CalcBitwise(cPolyCRC32, data, cDataSize); });
+    f64 bitwise64Nsec = Measure(cBitwiseHashNum, [&](s32) { hash64 = CalcBitwise(cPolyCRC64, data, cDataSize); });
+
+    delete[] data;
+
+    if (!isMatched)
+    {
+        ReportNote("crc results do not match the bitwise definition, no timings");
+        return;
+    }
+
+    ReportThroughput("HashCRC32 calcHash", cDataSize, crc32Nsec);
+    ReportThroughput("CRC-32 bitwise", cDataSize, bitwise32Nsec);
+    ReportThroughput("HashCRC64 calcHash", cDataSize, crc64Nsec);
+    ReportThroughput("CRC-64 bitwise", cDataSize, bitwise64Nsec);
+}
+
+} // namespace sead::benchmark
@@ -0,0 +1,82 @@
+#include "seadBenchmark.h"
+
+#include <basis/seadNew.h>
+#include <container/seadHashMap.h>
+#include <container/seadStrTreeMap.h>
+#include <heap/seadHeap.h>
+#include <prim/seadSafeString.h>
+
+namespace sead::benchmark {
+
+namespace {
+
+const s32 cKeyStrN = 64;
+const s32 cKeyNum = 4000;
+const s32 cLookupRoundNum = 64;
+
+const char* const cDirs[] = { "Model", "Texture", "Shader", "Sound", "Layout", "Effect", "Actor", "Map" };
+
+using Key = FixedSafeString<cKeyStrN>;
+
+// Resource style names, sharing long prefixes like real archive paths do
+void GenerateKeys(Key* keys)
+{
+    for (s32 i = 0; i < cKeyNum; i++)
+    {
+        const char* dir = cDirs[i % (sizeof(cDirs) / sizeof(cDirs[0]))];
+        keys[i].format("%s/Obj%04d/%s_%04d.bfres", dir, i / 16, dir, i);
+    }
+}
+
+template <typename Map>
+f64 MeasureLookups(const Map& map, const Key* keys, s32* sum)
+{
+    return Measure(cKeyNum * cLookupRoundNum, [&](s32 i) {
+        // A stride so that consecutive lookups do not hit neighbouring keys
+        s32* value = map.find(keys[(i * 7) % cKeyNum]);
+        *sum += value ? *value : -1;
+    });
+}
+
+} // namespace
+
+// Successful string lookups, StrHashMap against StrTreeMap holding the same keys
+void RunHashMap(Heap* heap)
+{
+    Key* keys = new(heap) Key[cKeyNum];
+    GenerateKeys(keys);
+
+    StrHashMap<cKeyStrN, s32> hashMap;
+    hashMap.allocBuffer(cKeyNum, heap);
+
+    StrTreeMap<cKeyStrN, s32> treeMap;
+    treeMap.allocBuffer(cKeyNum, heap);
+
+    for (s32 i = 0; i < cKeyNum; i++)
+    {
+        hashMap.insert(keys[i], i);
+        treeMap.insert(keys[i], i);
+    }
+
+    // Both sums have to be the same, it also keeps the lookups from being optimized out
+    s32 hashSum = 0;
+    s32 treeSum = 0;
+
+    f64 hashNsec = MeasureLookups(hashMap, keys, &hashSum);
+    f64 treeNsec = MeasureLookups(treeMap, keys, &treeSum);
+
+    hashMap.freeBuffer();
+    treeMap.freeBuffer();
+    delete[] keys;
+
+    if (hashSum != treeSum)
+    {
+        ReportNote("hashmap lookups do not agree with StrTreeMap, no timings");
+        return;
+    }
+
+    Report("StrHashMap find", hashNsec);
+    Report("StrTreeMap find", treeNsec);
+}
+
+} // namespace sead::benchmark
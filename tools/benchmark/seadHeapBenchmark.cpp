@@ -0,0 +1,137 @@
+#include "seadBenchmark.h"
+
+#include <basis/seadNew.h>
+#include <heap/seadExpHeap.h>
+#include <heap/seadFrameHeap.h>
+#include <heap/seadHeapMgr.h>
+
+#include <cstdio>
+
+namespace sead::benchmark {
+
+namespace {
+
+const s32 cBatchSize = 1024;
+const s32 cBatchNum = 256;
+const size_t cBlockSize = 32;
+
+// Heaps this small put more heap boundaries on a page than the address index can hold
+const size_t cCrowdedHeapSize = 640;
+const s32 cCrowdedHeapNum = 8;
+
+void* sBlocks[cBatchSize];
+
+// Average nanoseconds of an alloc and free pair, blocks are allocated and freed a batch at a time
+template <typename Alloc, typename Free>
+f64 MeasurePairs(Heap* heap, Alloc alloc, Free free)
+{
+    s64 nsec = 0;
+
+    for (s32 batch = 0; batch < cBatchNum; batch++)
+    {
+        TickTime start;
+
+        for (s32 i = 0; i < cBatchSize; i++)
+            sBlocks[i] = alloc();
+
+        for (s32 i = 0; i < cBatchSize; i++)
+            free(sBlocks[i]);
+
+        nsec += start.diffToNow().toNanoSeconds();
+
+        // FrameHeap::free() does nothing
+        heap->freeAll();
+    }
+
+    return static_cast<f64>(nsec) / (cBatchNum * cBatchSize);
+}
+
+void RunPairs(const char* name, Heap* heap)
+{
+    char label[64];
+
+    // The owner is known, the lower bound of any free path
+    f64 direct = MeasurePairs(
+        heap, [heap]() { return heap->alloc(cBlockSize); }, [heap](void* ptr) { heap->free(ptr); });
+
+    // operator delete has to find the owner first
+    f64 deleted = MeasurePairs(
+        heap, [heap]() { return new(heap) u8[cBlockSize]; }, [](void* ptr) { delete[] static_cast<u8*>(ptr); });
+
+    std::snprintf(label, sizeof(label), "%s alloc + free", name);
+    Report(label, direct);
+    std::snprintf(label, sizeof(label), "%s new + delete", name);
+    Report(label, deleted);
+}
+
+// Alternates between two heaps so the per thread FindContainHeapCache can not serve the lookups
+void RunCrowdedLookup(const char* name, Heap* heapA, Heap* heapB)
+{
+    void* blocks[2] = { heapA->alloc(cBlockSize), heapB->alloc(cBlockSize) };
+
+    HeapMgr* heapMgr = HeapMgr::instance();
+    Heap* volatile found = nullptr;
+
+    f64 nsec = Measure(cBatchNum * cBatchSize, [&](s32 i) { found = heapMgr->findContainHeap(blocks[i & 1]); });
+
+    SEAD_ASSERT(found == heapA || found == heapB);
+    static_cast<void>(found);
+
+    Report(name, nsec);
+
+    heapA->free(blocks[0]);
+    heapB->free(blocks[1]);
+}
+
+} // namespace
+
+void RunHeap(Heap* heap)
+{
+    {
+        ExpHeap* expHeap = ExpHeap::create(cBatchSize * cBlockSize * 4, "ExpHeap", heap);
+        RunPairs("ExpHeap", expHeap);
+        expHeap->destroy();
+    }
+
+    {
+        FrameHeap* frameHeap = FrameHeap::tryCreate(cBatchSize * cBlockSize * 4, "FrameHeap", heap);
+        // Every free is a no-op the heap would warn about
+        frameHeap->setEnableWarning(false);
+        RunPairs("FrameHeap", frameHeap);
+        frameHeap->destroy();
+    }
+
+    if (!HeapMgr::getUnboundHeap())
+        HeapMgr::createUnboundHeap();
+
+    if (HeapMgr::getUnboundHeap())
+        RunPairs("UnboundHeap", HeapMgr::getUnboundHeap());
+
+    // Lookups on pages the address index gives up on: ExpHeap blocks carry the heap tag, FrameHeap blocks have no
+    // header and go through the heap tree
+    {
+        ExpHeap* crowded = ExpHeap::create(cCrowdedHeapSize * cCrowdedHeapNum * 4, "Crowded", heap);
+
+        Heap* expHeaps[cCrowdedHeapNum / 2];
+        Heap* frameHeaps[cCrowdedHeapNum / 2];
+        for (s32 i = 0; i < cCrowdedHeapNum / 2; i++)
+        {
+            expHeaps[i] = ExpHeap::create(cCrowdedHeapSize, "CrowdedExp", crowded);
+            frameHeaps[i] = FrameHeap::tryCreate(cCrowdedHeapSize, "CrowdedFrame", crowded);
+            frameHeaps[i]->setEnableWarning(false);
+        }
+
+        RunCrowdedLookup("crowded page findContainHeap, tagged", expHeaps[1], expHeaps[2]);
+        RunCrowdedLookup("crowded page findContainHeap, tree search", frameHeaps[1], frameHeaps[2]);
+
+        for (s32 i = 0; i < cCrowdedHeapNum / 2; i++)
+        {
+            expHeaps[i]->destroy();
+            frameHeaps[i]->destroy();
+        }
+
+        crowded->destroy();
+    }
+}
+
+} // namespace sead::benchmark
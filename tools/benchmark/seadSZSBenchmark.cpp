@@ -0,0 +1,245 @@
+#include "seadBenchmark.h"
+
+#include <basis/seadNew.h>
+#include <heap/seadHeap.h>
+#include <random/seadRandom.h>
+#include <resource/seadSZSDecompressor.h>
+
+#if defined(SEAD_PLATFORM_WINDOWS)
+#include <filedevice/win/seadWinNativeFileDeviceWin.h>
+#elif defined(SEAD_PLATFORM_POSIX)
+#include <filedevice/posix/seadPosixNativeFileDevicePosix.h>
+#endif // SEAD_PLATFORM_WINDOWS
+
+#include <cstdio>
+#include <cstring>
+
+namespace sead::benchmark {
+
+namespace {
+
+#if defined(SEAD_PLATFORM_WINDOWS)
+using NativeFileDevice = WinNativeFileDevice;
+#elif defined(SEAD_PLATFORM_POSIX)
+using NativeFileDevice = PosixNativeFileDevice;
+#endif // SEAD_PLATFORM_WINDOWS
+
+const char* const cFilePath = "sead_benchmark.szs";
+const u32 cDataSize = 8 * 1024 * 1024;
+const s32 cLoadNum = 8;
+
+const u32 cWindowSize = 0x1000;
+const u32 cMatchMin = 3;
+const u32 cMatchMax = 0x111;
+const u32 cHashBits = 14;
+
+// Text like data from a small vocabulary, compresses to about a third with Yaz0
+void GenerateData(u8* dst, u32 size)
+{
+    static const char* const cWords[] = {
+        "sead ", "heap ", "resource ", "decompressor ", "frame ", "task ", "method ", "tree ",
+        "thread ", "queue ", "file ", "device ", "archive ", "stream ", "buffer ", "\n",
+    };
+
+    Random random(0x5EAD);
+
+    u32 pos = 0;
+    while (pos < size)
+    {
+        const char* word = cWords[random.getU32(sizeof(cWords) / sizeof(cWords[0]))];
+        u32 len = static_cast<u32>(std::strlen(word));
+
+        for (u32 i = 0; i < len && pos < size; i++)
+        {
+            // Some noise so that not every match is a long one
+            dst[pos++] = random.getU32(16) == 0 ? static_cast<u8>(random.getU32(256)) : static_cast<u8>(word[i]);
+        }
+    }
+}
+
+u32 CalcHash(const u8* src)
+{
+    u32 value = static_cast<u32>(src[0]) << 16 | static_cast<u32>(src[1]) << 8 | src[2];
+    return (value * 2654435761u) >> (32 - cHashBits);
+}
+
+// Greedy Yaz0 encoder keeping the last position of each hash, dst has to hold calcYaz0SizeMax(srcSize) bytes
+u32 EncodeYaz0(u8* dst, const u8* src, u32 srcSize, u32* hashTable)
+{
+    std::memset(hashTable, 0xFF, sizeof(u32) << cHashBits);
+
+    std::memcpy(dst, "Yaz0", 4);
+    dst[4] = static_cast<u8>(srcSize >> 24);
+    dst[5] = static_cast<u8>(srcSize >> 16);
+    dst[6] = static_cast<u8>(srcSize >> 8);
+    dst[7] = static_cast<u8>(srcSize);
+    std::memset(dst + 8, 0, SZSDecompressor::cHeaderSize - 8);
+
+    u32 dstPos = SZSDecompressor::cHeaderSize;
+    u32 srcPos = 0;
+
+    while (srcPos < srcSize)
+    {
+        u32 flagPos = dstPos++;
+        u8 flags = 0;
+
+        for (s32 bit = 7; bit >= 0 && srcPos < srcSize; bit--)
+        {
+            u32 matchLen = 0;
+            u32 matchDist = 0;
+
+            if (srcPos + cMatchMin <= srcSize)
+            {
+                u32 hash = CalcHash(src + srcPos);
+                u32 candidate = hashTable[hash];
+                hashTable[hash] = srcPos;
+
+                if (candidate != 0xFFFFFFFF && srcPos - candidate <= cWindowSize)
+                {
+                    u32 lenMax = srcSize - srcPos < cMatchMax ? srcSize - srcPos : cMatchMax;
+                    while (matchLen < lenMax && src[candidate + matchLen] == src[srcPos + matchLen])
+                        matchLen++;
+
+                    matchDist = srcPos - candidate;
+                }
+            }
+
+            if (matchLen < cMatchMin)
+            {
+                flags |= 1 << bit;
+                dst[dstPos++] = src[srcPos++];
+                continue;
+            }
+
+            u32 dist = matchDist - 1;
+            if (matchLen < 0x12)
+            {
+                dst[dstPos++] = static_cast<u8>((matchLen - 2) << 4 | dist >> 8);
+                dst[dstPos++] = static_cast<u8>(dist);
+            }
+            else
+            {
+                dst[dstPos++] = static_cast<u8>(dist >> 8);
+                dst[dstPos++] = static_cast<u8>(dist);
+                dst[dstPos++] = static_cast<u8>(matchLen - 0x12);
+            }
+
+            srcPos += matchLen;
+        }
+
+        dst[flagPos] = flags;
+    }
+
+    return dstPos;
+}
+
+u32 CalcYaz0SizeMax(u32 srcSize)
+{
+    return SZSDecompressor::cHeaderSize + srcSize + (srcSize + 7) / 8;
+}
+
+bool WriteFile(FileDevice* device, const u8* data, u32 size)
+{
+    FileHandle handle;
+    if (!device->tryOpen(&handle, cFilePath, FileDevice::FileOpenFlag::eWriteOnly, 0))
+        return false;
+
+    u32 writeSize = 0;
+    bool success = handle.tryWrite(&writeSize, data, size) && writeSize == size;
+    return handle.tryClose() && success;
+}
+
+} // namespace
+
+// Streaming SZSDecompressor::tryDecompFromDevice() against loading the whole file and then running decomp() on it
+void RunSZS(Heap* heap)
+{
+    NativeFileDevice device;
+
+    u8* data = new(heap) u8[cDataSize];
+    GenerateData(data, cDataSize);
+
+    u32* hashTable = new(heap) u32[1 << cHashBits];
+    u8* compressed = new(heap) u8[CalcYaz0SizeMax(cDataSize)];
+    u32 compressedSize = EncodeYaz0(compressed, data, cDataSize, hashTable);
+    delete[] hashTable;
+
+    bool isWritten = WriteFile(&device, compressed, compressedSize);
+    delete[] compressed;
+
+    if (!isWritten)
+    {
+        ReportNote("szs failed to write the benchmark file");
+        delete[] data;
+        return;
+    }
+
+    SZSDecompressor decompressor;
+
+    ResourceMgr::LoadArg arg;
+    arg.path = cFilePath;
+    arg.device = &device;
+    arg.load_data_heap = heap;
+
+    // Each path returns the decompressed size or -1, dst has to be freed with delete[]
+    auto loadStream = [&](u8** dst) {
+        u32 size = 0;
+        u32 bufferSize = 0;
+        bool needDelete = false;
+        *dst = decompressor.tryDecompFromDevice(arg, nullptr, &size, &bufferSize, &needDelete);
+        return *dst ? static_cast<s32>(size) : -1;
+    };
+
+    auto loadTwoPass = [&](u8** dst) {
+        FileDevice::LoadArg loadArg;
+        loadArg.path = cFilePath;
+        loadArg.heap = heap;
+
+        u8* src = device.tryLoad(loadArg);
+        u32 decompSize = src ? SZSDecompressor::getDecompSize(src) : 0;
+
+        *dst = decompSize != 0 ? new(heap, FileDevice::cBufferMinAlignment, std::nothrow) u8[decompSize] : nullptr;
+        s32 size = *dst ? SZSDecompressor::decomp(*dst, decompSize, src, loadArg.read_size) : -1;
+
+        delete[] src;
+        return size;
+    };
+
+    bool isMatched;
+    {
+        u8* dst = nullptr;
+        isMatched = loadStream(&dst) == static_cast<s32>(cDataSize) && std::memcmp(dst, data, cDataSize) == 0;
+        delete[] dst;
+
+        dst = nullptr;
+        isMatched = isMatched && loadTwoPass(&dst) == static_cast<s32>(cDataSize) && std::memcmp(dst, data, cDataSize) == 0;
+        delete[] dst;
+    }
+
+    f64 streamNsec = Measure(cLoadNum, [&](s32) {
+        u8* dst = nullptr;
+        loadStream(&dst);
+        delete[] dst;
+    });
+
+    f64 twoPassNsec = Measure(cLoadNum, [&](s32) {
+        u8* dst = nullptr;
+        loadTwoPass(&dst);
+        delete[] dst;
+    });
+
+    // PosixFileDevice does not implement remove yet
+    std::remove(cFilePath);
+    delete[] data;
+
+    if (!isMatched)
+    {
+        ReportNote("szs decompressed data does not match the source, no timings");
+        return;
+    }
+
+    ReportThroughput("szs stream tryDecompFromDevice", cDataSize, streamNsec);
+    ReportThroughput("szs load + decomp", cDataSize, twoPassNsec);
+}
+
+} // namespace sead::benchmark
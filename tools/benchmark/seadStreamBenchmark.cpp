@@ -0,0 +1,96 @@
+#include "seadBenchmark.h"
+
+#include <basis/seadNew.h>
+#include <heap/seadHeap.h>
+#include <stream/seadRamStream.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace sead::benchmark {
+
+namespace {
+
+const u32 cValueNum = 100000;
+const s32 cReadNum = 32;
+
+void RunEndian(const char* name, Endian::Types endian, const u32* values, u32* dst, u8* buf, u32 bufSize)
+{
+    {
+        RamWriteStream stream(buf, bufSize, Stream::eBinary);
+        stream.setBinaryEndian(endian);
+        stream.writeU32Array(values, cValueNum);
+    }
+
+    // Both paths have to read back what was written
+    bool isMatched = true;
+    {
+        RamReadStream stream(buf, bufSize, Stream::eBinary);
+        stream.setBinaryEndian(endian);
+
+        for (u32 i = 0; i < cValueNum; i++)
+            dst[i] = stream.readU32();
+
+        isMatched = std::memcmp(dst, values, cValueNum * sizeof(u32)) == 0;
+    }
+    {
+        std::memset(dst, 0, cValueNum * sizeof(u32));
+
+        RamReadStream stream(buf, bufSize, Stream::eBinary);
+        stream.setBinaryEndian(endian);
+        stream.readU32Array(dst, cValueNum);
+
+        isMatched = isMatched && std::memcmp(dst, values, cValueNum * sizeof(u32)) == 0;
+    }
+
+    f64 scalarNsec = Measure(cReadNum, [&](s32) {
+        RamReadStream stream(buf, bufSize, Stream::eBinary);
+        stream.setBinaryEndian(endian);
+
+        for (u32 i = 0; i < cValueNum; i++)
+            dst[i] = stream.readU32();
+    });
+
+    f64 arrayNsec = Measure(cReadNum, [&](s32) {
+        RamReadStream stream(buf, bufSize, Stream::eBinary);
+        stream.setBinaryEndian(endian);
+        stream.readU32Array(dst, cValueNum);
+    });
+
+    if (!isMatched)
+    {
+        ReportNote("stream reads do not match the written values, no timings");
+        return;
+    }
+
+    char label[64];
+
+    std::snprintf(label, sizeof(label), "readU32 x %u, %s", cValueNum, name);
+    Report(label, scalarNsec);
+    std::snprintf(label, sizeof(label), "readU32Array(%u), %s", cValueNum, name);
+    Report(label, arrayNsec);
+}
+
+} // namespace
+
+// Binary stream reads of 100000 u32, one readU32() per element against a single readU32Array()
+void RunStream(Heap* heap)
+{
+    const u32 bufSize = cValueNum * sizeof(u32);
+
+    u32* values = new(heap) u32[cValueNum];
+    u32* dst = new(heap) u32[cValueNum];
+    u8* buf = new(heap) u8[bufSize];
+
+    for (u32 i = 0; i < cValueNum; i++)
+        values[i] = i * 2654435761u;
+
+    RunEndian("little endian", Endian::eLittle, values, dst, buf, bufSize);
+    RunEndian("big endian", Endian::eBig, values, dst, buf, bufSize);
+
+    delete[] values;
+    delete[] dst;
+    delete[] buf;
+}
+
+} // namespace sead::benchmark